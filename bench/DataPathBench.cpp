@@ -0,0 +1,459 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <regex>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#include "../src/BufferedWriter.h"
+#include "../src/GradeKernels.h"
+#include "../src/MappedFile.h"
+#include "../src/SortEngine.h"
+#include "../src/Student.h"
+#include "../src/StudentBinary.h"
+#include "../src/StudentGenerator.h"
+#include "../src/StudentParser.h"
+#include "../src/StudentQuery.h"
+#include "../src/StudentReader.h"
+#include "../src/StudentStatistics.h"
+#include "../src/StudentTable.h"
+
+using namespace database;
+
+/** @brief Settings of a benchmark run, taken from the command line. */
+struct BenchmarkSettings
+{
+	std::vector<std::size_t> sizes = { 1000, 100000, 10000000 };
+	GeneratorOptions generator;
+	double minTime = 0.5;
+	std::string filter;
+	std::string outputFilename;
+	std::string directory = ".";
+};
+
+/** @brief Measured time of one benchmark, per iteration. */
+struct BenchmarkResult
+{
+	std::string name;
+	std::size_t records{};
+	std::uint64_t iterations{};
+	double realTime{};
+	double cpuTime{};
+};
+
+static volatile std::size_t sink; ///< Keeps results of the measured code alive.
+
+/**
+ * @brief Runs a function until the minimum time has passed, at least once.
+ *
+ * The CPU time is the time of the whole process, so it includes worker threads.
+ *
+ * @param name Name of the benchmark.
+ * @param records Number of records one call processes.
+ * @param minTime Seconds the function is run for at least.
+ * @param body The function under test; it returns a value that is kept alive.
+ * @return The time per call.
+ */
+static BenchmarkResult measure(const std::string& name, std::size_t records, double minTime, const std::function<std::size_t()>& body)
+{
+	BenchmarkResult result;
+	result.name = name;
+	result.records = records;
+
+	const auto start = std::chrono::steady_clock::now();
+	const std::clock_t cpuStart = std::clock();
+	std::chrono::duration<double> elapsed{};
+
+	do
+	{
+		sink = body();
+		result.iterations++;
+		elapsed = std::chrono::steady_clock::now() - start;
+	} while (elapsed.count() < minTime);
+
+	result.realTime = elapsed.count() / result.iterations;
+	result.cpuTime = static_cast<double>(std::clock() - cpuStart) / CLOCKS_PER_SEC / result.iterations;
+	return result;
+}
+
+/**
+ * @brief Prints one result as a row of the console table.
+ * @param result The result to print.
+ */
+static void printResult(const BenchmarkResult& result)
+{
+	std::printf("%-44s %14.3f ms %14.3f ms %10llu %14.0f items/s\n",
+		result.name.c_str(), result.realTime * 1e3, result.cpuTime * 1e3,
+		static_cast<unsigned long long>(result.iterations), result.records / result.realTime);
+	std::fflush(stdout);
+}
+
+/**
+ * @brief Writes the results in the JSON format of Google Benchmark.
+ *
+ * The file can be compared with another run by the compare.py tool of Google Benchmark.
+ *
+ * @param filename Name of the file to write.
+ * @param settings The settings of the run.
+ * @param results The results to write.
+ * @return True if the file was written, false otherwise.
+ */
+static bool writeJson(const std::string& filename, const BenchmarkSettings& settings, const std::vector<BenchmarkResult>& results)
+{
+	std::ofstream out(filename);
+	if (!out)
+		return false;
+
+	char date[32] = "";
+	const std::time_t now = std::time(nullptr);
+	std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+
+#ifdef NDEBUG
+	const char* buildType = "release";
+#else
+	const char* buildType = "debug";
+#endif
+
+	out.precision(std::numeric_limits<double>::max_digits10);
+	out << "{\n  \"context\": {\n"
+		<< "    \"date\": \"" << date << "\",\n"
+		<< "    \"executable\": \"DataPathBench\",\n"
+		<< "    \"num_cpus\": " << std::thread::hardware_concurrency() << ",\n"
+		<< "    \"library_build_type\": \"" << buildType << "\",\n"
+		<< "    \"seed\": " << settings.generator.seed << ",\n"
+		<< "    \"scores_per_subject\": \"" << settings.generator.minScoresPerSubject << "-" << settings.generator.maxScoresPerSubject << "\",\n"
+		<< "    \"surnames\": " << settings.generator.surnameCount << ",\n"
+		<< "    \"surname_skew\": " << settings.generator.surnameSkew << "\n"
+		<< "  },\n  \"benchmarks\": [";
+
+	for (std::size_t i = 0; i < results.size(); i++)
+	{
+		const BenchmarkResult& result = results[i];
+		out << (i ? ",\n" : "\n")
+			<< "    {\n"
+			<< "      \"name\": \"" << result.name << "\",\n"
+			<< "      \"run_name\": \"" << result.name << "\",\n"
+			<< "      \"run_type\": \"iteration\",\n"
+			<< "      \"iterations\": " << result.iterations << ",\n"
+			<< "      \"real_time\": " << result.realTime * 1e9 << ",\n"
+			<< "      \"cpu_time\": " << result.cpuTime * 1e9 << ",\n"
+			<< "      \"time_unit\": \"ns\",\n"
+			<< "      \"items_per_second\": " << result.records / result.realTime << "\n"
+			<< "    }";
+	}
+	out << "\n  ]\n}\n";
+	return static_cast<bool>(out.flush());
+}
+
+/** @brief Runs the benchmarks that match the filter and collects their results. */
+class BenchmarkRunner
+{
+public:
+	explicit BenchmarkRunner(const BenchmarkSettings& settings)
+		: settings(settings), filter(settings.filter.empty() ? ".*" : settings.filter)
+	{
+	}
+
+	void run(const std::string& name, std::size_t records, const std::function<std::size_t()>& body)
+	{
+		if (!std::regex_search(name, filter))
+			return;
+
+		results.push_back(measure(name, records, settings.minTime, body));
+		printResult(results.back());
+	}
+
+	const std::vector<BenchmarkResult>& all() const { return results; }
+
+private:
+	const BenchmarkSettings& settings;
+	std::regex filter;
+	std::vector<BenchmarkResult> results;
+};
+
+/**
+ * @brief Runs every benchmark over a generated file of one size.
+ * @param runner Runs and records the benchmarks.
+ * @param settings The settings of the run.
+ * @param recordCount Number of generated records.
+ */
+static void runSuite(BenchmarkRunner& runner, const BenchmarkSettings& settings, std::size_t recordCount)
+{
+	const std::string suffix = "/" + std::to_string(recordCount);
+	const std::string textFilename = (std::filesystem::path(settings.directory) / "DataPathBench.txt").string();
+	const std::string binaryFilename = (std::filesystem::path(settings.directory) / "DataPathBench.bin").string();
+
+	const StudentGenerator generator(settings.generator);
+	StudentTable table;
+	Student student;
+
+	const auto generateTable = [&] {
+		table.clear();
+		table.reserve(recordCount);
+		for (std::size_t i = 0; i < recordCount; i++)
+		{
+			generator.generate(i, student);
+			table.append(student);
+		}
+		return table.size();
+	};
+	runner.run("generate" + suffix, recordCount, generateTable);
+	if (table.size() != recordCount)
+		generateTable();
+
+	// The parse benchmarks read the files the serialize benchmarks write
+	const auto writeText = [&] {
+		BufferedWriter out;
+		out.open(textFilename);
+		for (std::size_t i = 0; i < table.size(); i++)
+			writeStudent(out, table[i]);
+		out.close();
+		return static_cast<std::size_t>(out.position());
+	};
+	runner.run("serialize/text" + suffix, recordCount, writeText);
+	if (!std::filesystem::exists(textFilename))
+		writeText();
+
+	std::vector<StudentView> views(table.size());
+	for (std::size_t i = 0; i < table.size(); i++)
+		views[i] = table[i];
+
+	runner.run("serialize/binary" + suffix, recordCount, [&] {
+		return static_cast<std::size_t>(writeStudentsBinary(binaryFilename, views));
+		});
+	views = {};
+
+	// readStudents parses text on every hardware thread; the serial parser is the baseline
+	runner.run("parse/parseStudents/serial" + suffix, recordCount, [&] {
+		MappedFile file;
+		file.open(textFilename);
+		return parseStudents(file.data(), file.data() + file.size()).size();
+		});
+
+	std::vector<Student> students;
+	runner.run("parse/readStudents" + suffix, recordCount, [&] {
+		students = readStudents(textFilename);
+		return students.size();
+		});
+	runner.run("parse/readStudentTable" + suffix, recordCount, [&] {
+		StudentTable parsed;
+		readStudentTable(textFilename, parsed);
+		return parsed.size();
+		});
+	if (std::filesystem::exists(binaryFilename))
+	{
+		runner.run("parse/readStudentsBinary" + suffix, recordCount, [&] {
+			std::vector<Student> parsed;
+			readStudentsBinary(binaryFilename, parsed);
+			return parsed.size();
+			});
+	}
+
+	if (!students.empty())
+	{
+		runner.run("aggregate/calculateAverageGrade" + suffix, recordCount, [&] {
+			for (Student& parsed : students)
+				calculateAverageGrade(parsed);
+			return students.size();
+			});
+	}
+	students = {};
+
+	// The table keeps its averages, since every kernel computes the values it already holds
+	for (GradeKernel kernel : { ScalarGradeKernel, Sse2GradeKernel, Avx2GradeKernel })
+	{
+		if (!gradeKernelSupported(kernel))
+			continue;
+
+		runner.run(std::string("aggregate/recalculateAverages/") + gradeKernelName(kernel) + suffix, recordCount, [&table, kernel] {
+			recalculateAverages(table, kernel);
+			return table.size();
+			});
+	}
+
+	runner.run("aggregate/stats" + suffix, recordCount, [&] {
+		const std::span<const double> columns[] = {
+			table.averageGrades(), table.averagePhisicsGrades(), table.averageMathGrades(), table.averageInformGrades()
+		};
+		double checksum = 0;
+		for (const auto& column : columns)
+		{
+			double minimum = std::numeric_limits<double>::infinity(), maximum = -minimum, sum = 0;
+			for (double value : column)
+			{
+				minimum = (std::min)(minimum, value);
+				maximum = (std::max)(maximum, value);
+				sum += value;
+			}
+			checksum += minimum + maximum + sum / column.size();
+		}
+		std::unordered_set<std::uint64_t> groups(table.groupNumbers().begin(), table.groupNumbers().end());
+		return groups.size() + static_cast<std::size_t>(checksum);
+		});
+
+	runner.run("aggregate/statistics" + suffix, recordCount, [&] {
+		StudentStatistics statistics;
+		for (std::size_t i = 0; i < table.size(); i++)
+			statistics.add(table[i]);
+		return statistics.groups.size() + static_cast<std::size_t>(statistics.gpa.quantile(0.5));
+		});
+
+	StudentQuery individualTask;
+	individualTask.compile(individualTaskQuery);
+
+	runner.run("filter/individualTask" + suffix, recordCount, [&] {
+		std::size_t selected = 0;
+		for (std::size_t i = 0; i < table.size(); i++)
+			selected += individualTask.matches(table[i]);
+		return selected;
+		});
+
+	// Reading with the query pushed down against parsing every record and filtering afterwards
+	runner.run("filter/individualTask/pushdown" + suffix, recordCount, [&] {
+		std::size_t selected = 0;
+		for ([[maybe_unused]] const Student& parsed : StudentReader(textFilename, individualTask))
+			selected++;
+		return selected;
+		});
+	runner.run("filter/individualTask/parseAll" + suffix, recordCount, [&] {
+		std::size_t selected = 0;
+		for (const Student& parsed : StudentReader(textFilename))
+			selected += individualTask.matches(makeStudentView(parsed));
+		return selected;
+		});
+
+	const std::pair<SortingMethod, const char*> methods[] = {
+		{ SortBySurname, "surname" },
+		{ SortByAverageGrade, "gpa" },
+		{ SortByAveragePhisicsGrade, "physics" },
+		{ SortByAverageMathGrade, "math" },
+		{ SortByAverageInformGrade, "cs" }
+	};
+	const std::pair<SortingType, const char*> directions[] = { { Ascending, "asc" }, { Descending, "desc" } };
+
+	for (const auto& [method, methodName] : methods)
+	{
+		for (const auto& [direction, directionName] : directions)
+		{
+			runner.run(std::string("sort/") + methodName + "/" + directionName + suffix, recordCount, [&] {
+				return sortOrder(table, method, direction).size();
+				});
+		}
+	}
+
+	std::error_code error;
+	std::filesystem::remove(textFilename, error);
+	std::filesystem::remove(binaryFilename, error);
+}
+
+/**
+ * @brief Parses a comma-separated list of sizes.
+ * @param text The list.
+ * @param sizes Receives the sizes.
+ * @return True if every entry is a positive number, false otherwise.
+ */
+static bool parseSizes(const std::string& text, std::vector<std::size_t>& sizes)
+{
+	sizes.clear();
+	std::size_t start = 0;
+	while (start <= text.size())
+	{
+		const std::size_t end = (std::min)(text.find(',', start), text.size());
+		const std::size_t size = std::strtoull(text.substr(start, end - start).c_str(), nullptr, 10);
+		if (size == 0)
+			return false;
+		sizes.push_back(size);
+		start = end + 1;
+	}
+	return !sizes.empty();
+}
+
+/**
+ * @brief Prints the options of the benchmark.
+ * @param program Name of the program.
+ */
+static void printUsage(const char* program)
+{
+	std::fprintf(stderr,
+		"usage: %s [options]\n"
+		"  --sizes N[,N...]   record counts to run at (default 1000,100000,10000000)\n"
+		"  --filter REGEX     run only the benchmarks whose name matches\n"
+		"  --min-time SEC     run every benchmark for at least this long (default 0.5)\n"
+		"  --out FILE         also write the results as Google Benchmark JSON\n"
+		"  --dir DIR          directory for the temporary files (default .)\n"
+		"  --seed N           seed of the generated records (default 42)\n"
+		"  --scores MIN-MAX   scores per subject (default 3-8)\n"
+		"  --surnames N       number of distinct surnames (default 5000)\n"
+		"  --skew S           Zipf exponent of the surname frequencies (default 0, uniform)\n",
+		program);
+}
+
+int main(int argc, char* argv[])
+{
+	BenchmarkSettings settings;
+
+	for (int i = 1; i < argc; i++)
+	{
+		const std::string option = argv[i];
+		if (i + 1 == argc)
+		{
+			printUsage(argv[0]);
+			return 2;
+		}
+		const std::string value = argv[++i];
+
+		bool valid = true;
+		if (option == "--sizes")
+			valid = parseSizes(value, settings.sizes);
+		else if (option == "--filter")
+			settings.filter = value;
+		else if (option == "--min-time")
+			settings.minTime = std::atof(value.c_str());
+		else if (option == "--out")
+			settings.outputFilename = value;
+		else if (option == "--dir")
+			settings.directory = value;
+		else if (option == "--seed")
+			settings.generator.seed = std::strtoull(value.c_str(), nullptr, 10);
+		else if (option == "--scores")
+		{
+			char* end = nullptr;
+			settings.generator.minScoresPerSubject = std::strtoull(value.c_str(), &end, 10);
+			settings.generator.maxScoresPerSubject = *end == '-' ? std::strtoull(end + 1, nullptr, 10) : settings.generator.minScoresPerSubject;
+			valid = settings.generator.minScoresPerSubject > 0 && settings.generator.maxScoresPerSubject >= settings.generator.minScoresPerSubject;
+		}
+		else if (option == "--surnames")
+			valid = (settings.generator.surnameCount = std::strtoull(value.c_str(), nullptr, 10)) > 0;
+		else if (option == "--skew")
+			settings.generator.surnameSkew = std::atof(value.c_str());
+		else
+			valid = false;
+
+		if (!valid)
+		{
+			printUsage(argv[0]);
+			return 2;
+		}
+	}
+
+	std::printf("%-44s %17s %17s %10s %22s\n", "Benchmark", "Time", "CPU", "Iterations", "Throughput");
+
+	BenchmarkRunner runner(settings);
+	for (std::size_t size : settings.sizes)
+		runSuite(runner, settings, size);
+
+	if (!settings.outputFilename.empty() && !writeJson(settings.outputFilename, settings, runner.all()))
+	{
+		std::fprintf(stderr, "cannot write %s\n", settings.outputFilename.c_str());
+		return 1;
+	}
+	return 0;
+}
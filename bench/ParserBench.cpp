@@ -0,0 +1,132 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "../src/StudentParser.h"
+
+using namespace database;
+
+/**
+ * @brief Builds a text file image in the format produced by writeStudent.
+ * @param recordCount The number of records to generate.
+ * @return The generated text.
+ */
+static std::string generateText(std::size_t recordCount)
+{
+	std::mt19937 random(42);
+	std::uniform_int_distribution<int> score(2, 10);
+	std::uniform_int_distribution<int> scoreCount(3, 8);
+	std::uniform_int_distribution<int> group(4300, 4399);
+
+	std::ostringstream text;
+	for (std::size_t i = 0; i < recordCount; i++)
+	{
+		text << "STUDENT'S NAME: Surname" << i % 5000 << '\n';
+		text << "GROUP NUMBER: " << group(random) << '\n';
+
+		const char* labels[] = { "PHYSICS SCORE: ", "MATH SCORE: ", "CS SCORE: " };
+		const char* gpaLabels[] = { "PHISICS GPA: ", "MATH GPA: ", "CS GPA: " };
+		double total = 0;
+		for (int subject = 0; subject < 3; subject++)
+		{
+			const int count = scoreCount(random);
+			int sum = 0;
+			text << labels[subject];
+			for (int k = 0; k < count; k++)
+			{
+				const int value = score(random);
+				sum += value;
+				text << (k ? " " : "") << value;
+			}
+			text << '\n' << gpaLabels[subject] << static_cast<double>(sum) / count << '\n';
+			total += static_cast<double>(sum) / count;
+		}
+		text << "GPA: " << total / 3 << '\n';
+	}
+	return text.str();
+}
+
+/**
+ * @brief Parses the text the way readStudents did before the dedicated parser.
+ * @param text The text to parse.
+ * @return The parsed students.
+ */
+static std::vector<Student> parseWithStreams(const std::string& text)
+{
+	std::istringstream file(text);
+	std::vector<Student> students;
+	std::string line;
+
+	while (std::getline(file, line))
+	{
+		if (line.find("STUDENT'S NAME:") == std::string::npos)
+			continue;
+
+		Student student;
+		student.surname = line.substr(line.find(":") + 2);
+		std::getline(file, line);
+		student.groupNumber = std::stoull(line.substr(line.find(":") + 2));
+
+		std::vector<std::uint16_t>* scores[] = { &student.phisicsScores, &student.mathScores, &student.informScores };
+		double* averages[] = { &student.averagePhisicsGrade, &student.averageMathGrade, &student.averageInformGrade };
+		for (int subject = 0; subject < 3; subject++)
+		{
+			std::getline(file, line);
+			std::istringstream scoreStream(line.substr(line.find(":") + 2));
+			std::uint16_t score;
+			while (scoreStream >> score)
+				scores[subject]->push_back(score);
+
+			std::getline(file, line);
+			*averages[subject] = std::stod(line.substr(line.find(":") + 2));
+		}
+
+		std::getline(file, line);
+		student.averageGrade = std::stod(line.substr(line.find(":") + 2));
+		students.push_back(student);
+	}
+	return students;
+}
+
+/**
+ * @brief Runs a parse function repeatedly and prints its throughput.
+ * @param name Name of the benchmark.
+ * @param text The text to parse.
+ * @param iterations How many times the text is parsed.
+ * @param parse The parse function under test.
+ */
+template <typename ParseFunc>
+static void runBenchmark(const std::string& name, const std::string& text, int iterations, ParseFunc parse)
+{
+	std::size_t records = 0;
+	const auto start = std::chrono::steady_clock::now();
+
+	for (int i = 0; i < iterations; i++)
+		records += parse(text).size();
+
+	const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+	const double megabytes = static_cast<double>(text.size()) * iterations / (1024.0 * 1024.0);
+
+	std::printf("%-16s %10zu records %10.1f MB/s %12.0f records/s\n",
+		name.c_str(), records / iterations, megabytes / elapsed.count(), records / elapsed.count());
+}
+
+int main(int argc, char* argv[])
+{
+	const std::size_t recordCount = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 100000;
+	const int iterations = argc > 2 ? std::atoi(argv[2]) : 5;
+
+	const std::string text = generateText(recordCount);
+
+	runBenchmark("from_chars", text, iterations, [](const std::string& input) {
+		return parseStudents(input.data(), input.data() + input.size());
+		});
+	runBenchmark("istringstream", text, iterations, parseWithStreams);
+
+	return 0;
+}
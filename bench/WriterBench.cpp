@@ -0,0 +1,235 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+#include "../src/BufferedWriter.h"
+
+using namespace database;
+
+/** @brief Generated records and the storage their views refer to. */
+struct GeneratedStudents
+{
+	std::vector<std::string> surnames;
+	std::vector<std::vector<std::uint16_t>> scores;
+	std::vector<StudentView> views;
+};
+
+/**
+ * @brief Generates records like the ones in the parser benchmark.
+ * @param recordCount The number of records to generate.
+ * @return The generated records.
+ */
+static GeneratedStudents generateStudents(std::size_t recordCount)
+{
+	std::mt19937 random(42);
+	std::uniform_int_distribution<int> score(2, 10);
+	std::uniform_int_distribution<int> scoreCount(3, 8);
+	std::uniform_int_distribution<int> group(4300, 4399);
+
+	GeneratedStudents generated;
+	generated.surnames.reserve(recordCount);
+	generated.scores.reserve(3 * recordCount);
+	generated.views.resize(recordCount);
+
+	for (std::size_t i = 0; i < recordCount; i++)
+	{
+		StudentView& view = generated.views[i];
+		generated.surnames.push_back("Surname" + std::to_string(i % 5000));
+		view.surname = generated.surnames.back();
+		view.groupNumber = group(random);
+
+		std::span<const std::uint16_t>* scores[] = { &view.phisicsScores, &view.mathScores, &view.informScores };
+		double* averages[] = { &view.averagePhisicsGrade, &view.averageMathGrade, &view.averageInformGrade };
+		double total = 0;
+		for (int subject = 0; subject < 3; subject++)
+		{
+			auto& values = generated.scores.emplace_back(scoreCount(random));
+			int sum = 0;
+			for (auto& value : values)
+			{
+				value = static_cast<std::uint16_t>(score(random));
+				sum += value;
+			}
+			*scores[subject] = values;
+			*averages[subject] = static_cast<double>(sum) / values.size();
+			total += *averages[subject];
+		}
+		view.averageGrade = total / 3;
+	}
+	return generated;
+}
+
+/**
+ * @brief Stream buffer that passes every flushed chunk to an unbuffered file, counting the writes.
+ *
+ * It buffers like a default file stream, so an ostream over it issues the same
+ * writes, and each of them is exactly one system call.
+ */
+class CountingFileBuffer : public std::streambuf
+{
+public:
+	explicit CountingFileBuffer(const std::string& filename)
+		: file(std::fopen(filename.c_str(), "wb")), buffer(BUFSIZ)
+	{
+		if (file)
+			std::setvbuf(file, nullptr, _IONBF, 0);
+		setp(buffer.data(), buffer.data() + buffer.size());
+	}
+
+	~CountingFileBuffer() override
+	{
+		sync();
+		if (file)
+			std::fclose(file);
+	}
+
+	std::uint64_t syscallCount() const { return syscalls; }
+
+protected:
+	int overflow(int character) override
+	{
+		if (sync() != 0)
+			return traits_type::eof();
+		if (!traits_type::eq_int_type(character, traits_type::eof()))
+		{
+			*pptr() = traits_type::to_char_type(character);
+			pbump(1);
+		}
+		return traits_type::not_eof(character);
+	}
+
+	int sync() override
+	{
+		const std::size_t size = static_cast<std::size_t>(pptr() - pbase());
+		if (size == 0)
+			return 0;
+
+		syscalls++;
+		const bool written = file && std::fwrite(pbase(), 1, size, file) == size;
+		setp(buffer.data(), buffer.data() + buffer.size());
+		return written ? 0 : -1;
+	}
+
+private:
+	std::FILE* file;
+	std::vector<char> buffer;
+	std::uint64_t syscalls = 0;
+};
+
+/**
+ * @brief Writes scores separated by spaces to an output stream.
+ * @param out Output stream to write data to.
+ * @param scores The scores to write.
+ */
+static void writeScores(std::ostream& out, std::span<const std::uint16_t> scores)
+{
+	for (std::size_t i = 0; i < scores.size(); ++i)
+	{
+		if (i != 0)
+			out << ' ';
+		out << scores[i];
+	}
+}
+
+/**
+ * @brief Writes a record the way writeStudent did before the buffered writer, flushing every line.
+ * @param out Output stream to write data to.
+ * @param student The record to write.
+ */
+static void writeWithEndl(std::ostream& out, const StudentView& student)
+{
+	out << "STUDENT'S NAME: " << student.surname << std::endl;
+	out << "GROUP NUMBER: " << student.groupNumber << std::endl;
+	out << "PHYSICS SCORE: "; writeScores(out, student.phisicsScores); out << std::endl;
+	out << "PHISICS GPA: " << student.averagePhisicsGrade << std::endl;
+	out << "MATH SCORE: "; writeScores(out, student.mathScores); out << std::endl;
+	out << "MATH GPA: " << student.averageMathGrade << std::endl;
+	out << "CS SCORE: "; writeScores(out, student.informScores); out << std::endl;
+	out << "CS GPA: " << student.averageInformGrade << std::endl;
+	out << "GPA: " << student.averageGrade << std::endl;
+}
+
+/**
+ * @brief Writes a record through an ostream with newlines instead of flushes.
+ * @param out Output stream to write data to.
+ * @param student The record to write.
+ */
+static void writeWithNewlines(std::ostream& out, const StudentView& student)
+{
+	out << "STUDENT'S NAME: " << student.surname << '\n';
+	out << "GROUP NUMBER: " << student.groupNumber << '\n';
+	out << "PHYSICS SCORE: "; writeScores(out, student.phisicsScores); out << '\n';
+	out << "PHISICS GPA: " << student.averagePhisicsGrade << '\n';
+	out << "MATH SCORE: "; writeScores(out, student.mathScores); out << '\n';
+	out << "MATH GPA: " << student.averageMathGrade << '\n';
+	out << "CS SCORE: "; writeScores(out, student.informScores); out << '\n';
+	out << "CS GPA: " << student.averageInformGrade << '\n';
+	out << "GPA: " << student.averageGrade << '\n';
+}
+
+/**
+ * @brief Runs a write function repeatedly and prints its throughput and system calls.
+ * @param name Name of the benchmark.
+ * @param students The records to write.
+ * @param iterations How many times the records are written.
+ * @param write The write function under test; it returns the number of write system calls.
+ */
+template <typename WriteFunc>
+static void runBenchmark(const std::string& name, const std::vector<StudentView>& students, int iterations, WriteFunc write)
+{
+	std::uint64_t syscalls = 0;
+	const auto start = std::chrono::steady_clock::now();
+
+	for (int i = 0; i < iterations; i++)
+		syscalls += write(students);
+
+	const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+	const double records = static_cast<double>(students.size()) * iterations;
+
+	std::printf("%-16s %10zu records %12.0f records/s %10.4f syscalls/record\n",
+		name.c_str(), students.size(), records / elapsed.count(), syscalls / records);
+}
+
+int main(int argc, char* argv[])
+{
+	const std::size_t recordCount = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 100000;
+	const int iterations = argc > 2 ? std::atoi(argv[2]) : 5;
+	const std::string filename = argc > 3 ? argv[3] : "WriterBench.tmp";
+
+	const GeneratedStudents generated = generateStudents(recordCount);
+
+	runBenchmark("ostream endl", generated.views, iterations, [&](const std::vector<StudentView>& students) {
+		CountingFileBuffer buffer(filename);
+		std::ostream out(&buffer);
+		for (const auto& student : students)
+			writeWithEndl(out, student);
+		out.flush();
+		return buffer.syscallCount();
+		});
+	runBenchmark("ostream newline", generated.views, iterations, [&](const std::vector<StudentView>& students) {
+		CountingFileBuffer buffer(filename);
+		std::ostream out(&buffer);
+		for (const auto& student : students)
+			writeWithNewlines(out, student);
+		out.flush();
+		return buffer.syscallCount();
+		});
+	runBenchmark("BufferedWriter", generated.views, iterations, [&](const std::vector<StudentView>& students) {
+		BufferedWriter out;
+		out.open(filename);
+		for (const auto& student : students)
+			writeStudent(out, student);
+		out.close();
+		return out.syscallCount();
+		});
+
+	std::error_code error;
+	std::filesystem::remove(filename, error);
+	return 0;
+}
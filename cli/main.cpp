@@ -0,0 +1,6 @@
+#include "../src/CommandLine.h"
+
+int main(int argc, char* argv[])
+{
+	return database::runCommandLine(argc, argv);
+}
@@ -1,5 +1,6 @@
 #pragma once
 #include "cursor.h"
+#include "screen.h"
 #include "buttons.h"
 #include "Object.h"
 #include "window.h"
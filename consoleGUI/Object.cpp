@@ -1,4 +1,4 @@
-#include "object.h"
+#include "Object.h"
 
 void Object::show()
 {
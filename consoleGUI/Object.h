@@ -1,6 +1,6 @@
 
 #pragma once
-#include <Windows.h>
+#include "terminal.h"
 #include <vector>
 #include "objectInteraction.h"
 class Object
@@ -0,0 +1,422 @@
+#ifndef _WIN32
+#include "terminal.h"
+#include "screen.h"
+#include <cerrno>
+#include <csignal>
+#include <cstdio>
+#include <deque>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <termios.h>
+#include <unistd.h>
+
+namespace {
+	// The widgets draw in code page 437, which the terminal receives as UTF-8
+	const char* const codePage437[256] = {
+		" ", "\xe2\x98\xba", "\xe2\x98\xbb", "\xe2\x99\xa5", "\xe2\x99\xa6", "\xe2\x99\xa3", "\xe2\x99\xa0", "\xe2\x80\xa2", "\xe2\x97\x98", "\xe2\x97\x8b", "\xe2\x97\x99", "\xe2\x99\x82", "\xe2\x99\x80", "\xe2\x99\xaa", "\xe2\x99\xab", "\xe2\x98\xbc",
+		"\xe2\x96\xba", "\xe2\x97\x84", "\xe2\x86\x95", "\xe2\x80\xbc", "\xc2\xb6", "\xc2\xa7", "\xe2\x96\xac", "\xe2\x86\xa8", "\xe2\x86\x91", "\xe2\x86\x93", "\xe2\x86\x92", "\xe2\x86\x90", "\xe2\x88\x9f", "\xe2\x86\x94", "\xe2\x96\xb2", "\xe2\x96\xbc",
+		" ", "!", "\"", "#", "$", "%", "&", "'", "(", ")", "*", "+", ",", "-", ".", "/",
+		"0", "1", "2", "3", "4", "5", "6", "7", "8", "9", ":", ";", "<", "=", ">", "?",
+		"@", "A", "B", "C", "D", "E", "F", "G", "H", "I", "J", "K", "L", "M", "N", "O",
+		"P", "Q", "R", "S", "T", "U", "V", "W", "X", "Y", "Z", "[", "\\", "]", "^", "_",
+		"`", "a", "b", "c", "d", "e", "f", "g", "h", "i", "j", "k", "l", "m", "n", "o",
+		"p", "q", "r", "s", "t", "u", "v", "w", "x", "y", "z", "{", "|", "}", "~", "\xe2\x8c\x82",
+		"\xc3\x87", "\xc3\xbc", "\xc3\xa9", "\xc3\xa2", "\xc3\xa4", "\xc3\xa0", "\xc3\xa5", "\xc3\xa7", "\xc3\xaa", "\xc3\xab", "\xc3\xa8", "\xc3\xaf", "\xc3\xae", "\xc3\xac", "\xc3\x84", "\xc3\x85",
+		"\xc3\x89", "\xc3\xa6", "\xc3\x86", "\xc3\xb4", "\xc3\xb6", "\xc3\xb2", "\xc3\xbb", "\xc3\xb9", "\xc3\xbf", "\xc3\x96", "\xc3\x9c", "\xc2\xa2", "\xc2\xa3", "\xc2\xa5", "\xe2\x82\xa7", "\xc6\x92",
+		"\xc3\xa1", "\xc3\xad", "\xc3\xb3", "\xc3\xba", "\xc3\xb1", "\xc3\x91", "\xc2\xaa", "\xc2\xba", "\xc2\xbf", "\xe2\x8c\x90", "\xc2\xac", "\xc2\xbd", "\xc2\xbc", "\xc2\xa1", "\xc2\xab", "\xc2\xbb",
+		"\xe2\x96\x91", "\xe2\x96\x92", "\xe2\x96\x93", "\xe2\x94\x82", "\xe2\x94\xa4", "\xe2\x95\xa1", "\xe2\x95\xa2", "\xe2\x95\x96", "\xe2\x95\x95", "\xe2\x95\xa3", "\xe2\x95\x91", "\xe2\x95\x97", "\xe2\x95\x9d", "\xe2\x95\x9c", "\xe2\x95\x9b", "\xe2\x94\x90",
+		"\xe2\x94\x94", "\xe2\x94\xb4", "\xe2\x94\xac", "\xe2\x94\x9c", "\xe2\x94\x80", "\xe2\x94\xbc", "\xe2\x95\x9e", "\xe2\x95\x9f", "\xe2\x95\x9a", "\xe2\x95\x94", "\xe2\x95\xa9", "\xe2\x95\xa6", "\xe2\x95\xa0", "\xe2\x95\x90", "\xe2\x95\xac", "\xe2\x95\xa7",
+		"\xe2\x95\xa8", "\xe2\x95\xa4", "\xe2\x95\xa5", "\xe2\x95\x99", "\xe2\x95\x98", "\xe2\x95\x92", "\xe2\x95\x93", "\xe2\x95\xab", "\xe2\x95\xaa", "\xe2\x94\x98", "\xe2\x94\x8c", "\xe2\x96\x88", "\xe2\x96\x84", "\xe2\x96\x8c", "\xe2\x96\x90", "\xe2\x96\x80",
+		"\xce\xb1", "\xc3\x9f", "\xce\x93", "\xcf\x80", "\xce\xa3", "\xcf\x83", "\xc2\xb5", "\xcf\x84", "\xce\xa6", "\xce\x98", "\xce\xa9", "\xce\xb4", "\xe2\x88\x9e", "\xcf\x86", "\xce\xb5", "\xe2\x88\xa9",
+		"\xe2\x89\xa1", "\xc2\xb1", "\xe2\x89\xa5", "\xe2\x89\xa4", "\xe2\x8c\xa0", "\xe2\x8c\xa1", "\xc3\xb7", "\xe2\x89\x88", "\xc2\xb0", "\xe2\x88\x99", "\xc2\xb7", "\xe2\x88\x9a", "\xe2\x81\xbf", "\xc2\xb2", "\xe2\x96\xa0", "\xc2\xa0",
+	};
+
+	// Alternate screen, every mouse motion and SGR mouse coordinates
+	const char enterSequence[] = "\x1b[?1049h\x1b[?1003h\x1b[?1006h";
+	const char mouseSequence[] = "\x1b[?1003h\x1b[?1006h";
+	const char leaveSequence[] = "\x1b[0m\x1b[?1006l\x1b[?1003l\x1b[?25h\x1b[?1049l";
+
+	// A lone ESC is a key press once no sequence follows it within this time
+	const int escapeTimeout = 25;
+	// Interaction loops poll for input, so an idle poll waits this long instead of spinning
+	const int pollTimeout = 10;
+
+	termios savedMode;
+	bool modeSaved = false;
+
+	void writeAll(const char* data, size_t size)
+	{
+		while (size > 0)
+		{
+			const ssize_t written = ::write(STDOUT_FILENO, data, size);
+			if (written < 0)
+			{
+				if (errno == EINTR)
+					continue;
+				return;
+			}
+			data += written;
+			size -= static_cast<size_t>(written);
+		}
+	}
+
+	void restoreTerminal()
+	{
+		writeAll(leaveSequence, sizeof(leaveSequence) - 1);
+		if (modeSaved)
+			tcsetattr(STDIN_FILENO, TCSAFLUSH, &savedMode);
+	}
+
+	void handleSignal(int signal)
+	{
+		restoreTerminal();
+		std::signal(signal, SIG_DFL);
+		std::raise(signal);
+	}
+
+	// Console colors keep blue in the lowest bit, ANSI colors keep red there
+	int ansiColor(int color)
+	{
+		return ((color & 1) << 2) | (color & 2) | ((color & 4) >> 2);
+	}
+}
+
+class AnsiTerminal : public Terminal
+{
+public:
+	AnsiTerminal();
+	~AnsiTerminal() override;
+
+	TerminalInfo info() override;
+	void present(const ScreenBuffer& back, const std::vector<ScreenRun>& runs, COORD cursor, WORD attributes) override;
+	void hideCursor() override;
+	void setTitle(const std::string& title) override;
+
+	void enableMouseInput() override;
+	bool pollEvent(TerminalEvent& event) override;
+	void flushInput() override;
+	bool keyPending() override;
+	int readKey() override;
+	bool leftButtonDown() override { return leftButton; }
+	COORD mousePosition() override { return lastMousePosition; }
+private:
+	bool readInput(int timeout);
+	void parseInput();
+	bool parseEvent(TerminalEvent& event, bool complete);
+	bool nextEvent(TerminalEvent& event, int timeout);
+	void appendAttributes(WORD attributes);
+
+	std::string input;
+	std::deque<TerminalEvent> events;
+	std::string output;
+	int pendingKey = -1;
+	bool endOfInput = false;
+	bool parsedLeftButton = false;
+	bool leftButton = false;
+	COORD lastMousePosition{};
+	int presentedAttributes = -1;
+};
+
+Terminal& Terminal::get()
+{
+	static AnsiTerminal terminal;
+	return terminal;
+}
+
+AnsiTerminal::AnsiTerminal()
+{
+	if (tcgetattr(STDIN_FILENO, &savedMode) == 0)
+	{
+		modeSaved = true;
+		termios mode = savedMode;
+		mode.c_lflag &= ~(ICANON | ECHO);
+		mode.c_iflag &= ~(ICRNL | IXON);
+		mode.c_cc[VMIN] = 1;
+		mode.c_cc[VTIME] = 0;
+		tcsetattr(STDIN_FILENO, TCSAFLUSH, &mode);
+	}
+
+	std::signal(SIGINT, handleSignal);
+	std::signal(SIGTERM, handleSignal);
+	std::signal(SIGHUP, handleSignal);
+	writeAll(enterSequence, sizeof(enterSequence) - 1);
+}
+
+AnsiTerminal::~AnsiTerminal()
+{
+	restoreTerminal();
+}
+
+TerminalInfo AnsiTerminal::info()
+{
+	TerminalInfo terminalInfo;
+	winsize size{};
+	if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &size) == 0 && size.ws_col > 0 && size.ws_row > 0)
+	{
+		terminalInfo.width = size.ws_col;
+		terminalInfo.height = size.ws_row;
+	}
+	terminalInfo.windowBottom = terminalInfo.height - 1;
+	terminalInfo.attributes = 0x07;
+	return terminalInfo;
+}
+
+void AnsiTerminal::appendAttributes(WORD attributes)
+{
+	const int foreground = attributes & 0x0F;
+	const int background = (attributes >> 4) & 0x0F;
+	output += "\x1b[";
+	output += std::to_string((foreground & 8 ? 90 : 30) + ansiColor(foreground));
+	output += ';';
+	output += std::to_string((background & 8 ? 100 : 40) + ansiColor(background));
+	output += 'm';
+	presentedAttributes = attributes;
+}
+
+void AnsiTerminal::present(const ScreenBuffer& back, const std::vector<ScreenRun>& runs, COORD cursor, WORD attributes)
+{
+	if (runs.empty())
+		return;
+
+	// Every run, its colors and the final cursor position go out in one write
+	output.clear();
+	for (const ScreenRun& run : runs)
+	{
+		output += "\x1b[";
+		output += std::to_string(run.y + 1);
+		output += ';';
+		output += std::to_string(run.firstX + 1);
+		output += 'H';
+		for (int x = run.firstX; x <= run.lastX; x++)
+		{
+			const ScreenCell& cell = back.at(x, run.y);
+			if (cell.attributes != presentedAttributes)
+				appendAttributes(cell.attributes);
+			output += codePage437[static_cast<unsigned char>(cell.symbol)];
+		}
+	}
+	if (attributes != presentedAttributes)
+		appendAttributes(attributes);
+	output += "\x1b[";
+	output += std::to_string(cursor.Y + 1);
+	output += ';';
+	output += std::to_string(cursor.X + 1);
+	output += 'H';
+
+	writeAll(output.data(), output.size());
+}
+
+void AnsiTerminal::hideCursor()
+{
+	writeAll("\x1b[?25l", 6);
+}
+
+void AnsiTerminal::setTitle(const std::string& title)
+{
+	const std::string sequence = "\x1b]0;" + title + "\x07";
+	writeAll(sequence.data(), sequence.size());
+}
+
+void AnsiTerminal::enableMouseInput()
+{
+	writeAll(mouseSequence, sizeof(mouseSequence) - 1);
+}
+
+bool AnsiTerminal::readInput(int timeout)
+{
+	if (endOfInput)
+		return false;
+
+	pollfd descriptor{ STDIN_FILENO, POLLIN, 0 };
+	if (poll(&descriptor, 1, timeout) <= 0)
+		return false;
+
+	char buffer[256];
+	const ssize_t count = ::read(STDIN_FILENO, buffer, sizeof(buffer));
+	if (count <= 0)
+	{
+		if (count == 0 || errno != EINTR)
+			endOfInput = true;
+		return false;
+	}
+	input.append(buffer, static_cast<size_t>(count));
+	return true;
+}
+
+bool AnsiTerminal::parseEvent(TerminalEvent& event, bool complete)
+{
+	event = TerminalEvent();
+	const unsigned char first = static_cast<unsigned char>(input[0]);
+	if (first != 0x1b)
+	{
+		input.erase(0, 1);
+		event.type = TerminalEvent::Type::Key;
+		event.key = first == 127 ? '\b' : first;
+		return true;
+	}
+
+	// ESC alone, or followed by anything but a control sequence, is the ESC key
+	if (input.size() == 1 ? complete : input[1] != '[' && input[1] != 'O')
+	{
+		input.erase(0, 1);
+		event.type = TerminalEvent::Type::Key;
+		event.key = 27;
+		return true;
+	}
+
+	size_t end = 2;
+	while (end < input.size() && (input[end] < 0x40 || input[end] > 0x7E))
+		end++;
+	if (end >= input.size())
+	{
+		// A sequence cut short for good is dropped
+		if (complete)
+			input.clear();
+		return false;
+	}
+
+	const std::string parameters = input.substr(2, end - 2);
+	const char final = input[end];
+	input.erase(0, end + 1);
+
+	int button = 0;
+	int x = 0;
+	int y = 0;
+	if (!parameters.empty() && parameters[0] == '<' && (final == 'M' || final == 'm')
+		&& std::sscanf(parameters.c_str() + 1, "%d;%d;%d", &button, &x, &y) == 3)
+	{
+		event.type = TerminalEvent::Type::Mouse;
+		event.mousePosition.X = static_cast<short>(x - 1);
+		event.mousePosition.Y = static_cast<short>(y - 1);
+
+		// Bit 5 marks motion and bit 6 the wheel; the low bits name the button, 3 being none
+		event.leftButton = parsedLeftButton;
+		if (!(button & 64))
+		{
+			if (final == 'm' && (button & 3) == 0)
+				event.leftButton = false;
+			else if (final == 'M' && (button & 3) == 0)
+				event.leftButton = true;
+			else if (final == 'M' && (button & 3) == 3)
+				event.leftButton = false;
+		}
+		parsedLeftButton = event.leftButton;
+		return true;
+	}
+
+	// Cursor keys arrive as the two codes _getch returns for them
+	event.type = TerminalEvent::Type::Key;
+	event.key = 224;
+	switch (final) {
+	case 'A': event.extendedKey = 72; break;
+	case 'B': event.extendedKey = 80; break;
+	case 'C': event.extendedKey = 77; break;
+	case 'D': event.extendedKey = 75; break;
+	case 'H': event.extendedKey = 71; break;
+	case 'F': event.extendedKey = 79; break;
+	case '~':
+		if (parameters == "3")
+			event.extendedKey = 83;
+		break;
+	}
+	if (event.extendedKey == 0)
+		event.type = TerminalEvent::Type::None;
+	return true;
+}
+
+void AnsiTerminal::parseInput()
+{
+	TerminalEvent event;
+	while (!input.empty())
+	{
+		bool parsed = parseEvent(event, false);
+		if (!parsed)
+		{
+			readInput(escapeTimeout);
+			parsed = !input.empty() && parseEvent(event, true);
+		}
+		if (!parsed)
+			continue;
+		if (event.type != TerminalEvent::Type::None)
+			events.push_back(event);
+	}
+}
+
+bool AnsiTerminal::nextEvent(TerminalEvent& event, int timeout)
+{
+	if (events.empty())
+	{
+		while (readInput(events.empty() && input.empty() ? timeout : 0))
+			timeout = 0;
+		parseInput();
+	}
+	if (events.empty())
+		return false;
+
+	event = events.front();
+	events.pop_front();
+	if (event.type == TerminalEvent::Type::Mouse)
+	{
+		leftButton = event.leftButton;
+		lastMousePosition = event.mousePosition;
+	}
+	return true;
+}
+
+bool AnsiTerminal::pollEvent(TerminalEvent& event)
+{
+	return nextEvent(event, pollTimeout);
+}
+
+void AnsiTerminal::flushInput()
+{
+	// Buttons released among the discarded events must not stay pressed
+	TerminalEvent event;
+	while (nextEvent(event, 0))
+		continue;
+	pendingKey = -1;
+}
+
+bool AnsiTerminal::keyPending()
+{
+	if (pendingKey >= 0)
+		return true;
+
+	while (readInput(0))
+		continue;
+	parseInput();
+	for (const TerminalEvent& event : events)
+	{
+		if (event.type == TerminalEvent::Type::Key)
+			return true;
+	}
+	return false;
+}
+
+int AnsiTerminal::readKey()
+{
+	if (pendingKey >= 0)
+	{
+		const int key = pendingKey;
+		pendingKey = -1;
+		return key;
+	}
+
+	// Mouse events are skipped, as _getch skips them
+	TerminalEvent event;
+	while (true)
+	{
+		if (!nextEvent(event, -1))
+		{
+			if (endOfInput)
+				return -1;
+			continue;
+		}
+		if (event.type != TerminalEvent::Type::Key)
+			continue;
+		if (event.extendedKey != 0)
+			pendingKey = event.extendedKey;
+		return event.key;
+	}
+}
+#endif
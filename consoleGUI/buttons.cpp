@@ -219,12 +219,7 @@ void SliderButton::setValue(int value) {
 void SliderButton::show() {
 	if(isChanged)
 	{
-		for (int i = 0; i < sliderHeight; i++) {
-			for (int j = 0; j < sliderWidth; j++) {
-				setcur(sliderPositionX + j, sliderPositionY + i);  // 
-				std::cout << arr[i][j];
-			}
-		}
+		Screen::get().draw(sliderPositionX, sliderPositionY, arr, sliderWidth, sliderHeight);
 		isChanged = false;
 	}
 }
@@ -253,7 +248,7 @@ void SliderButton::handleMouseEvent(COORD mousePos) {
 		if (mousePos.X >= sliderPositionX && mousePos.X < sliderPositionX + sliderWidth &&
 			mousePos.Y >= sliderPositionY && mousePos.Y < sliderPositionY + sliderHeight) {
 			buttonPressed();
-			if (GetAsyncKeyState(VK_LBUTTON) & 0x8000) {
+			if (leftButtonPressed()) {
 				if ((mousePos.X == sliderPositionX && mousePos.Y == sliderPositionY + 2) || (mousePos.X == sliderPositionX && mousePos.Y == sliderPositionY + 3)) {
 					if (temp > minValue) {
 						temp--;
@@ -296,7 +291,7 @@ void SliderButton::handleMouseEvent(COORD mousePos) {
 		if (mousePos.X >= sliderPositionX && mousePos.X < sliderPositionX + sliderWidth &&
 			mousePos.Y >= sliderPositionY && mousePos.Y < sliderPositionY + sliderHeight) {
 			if (!isPressed) buttonPressed();
-			if (GetAsyncKeyState(VK_LBUTTON) & 0x8000) {
+			if (leftButtonPressed()) {
 				if (mousePos.X == sliderPositionX + sliderWidth / 2 + 1 && mousePos.Y == sliderPositionY + sliderHeight - 2) {
 					if (temp > minValue) {
 						temp--;
@@ -451,14 +446,7 @@ void PushButton::show()
 
 		setColorBackground(backgroundColor);
 
-		for (int i = 0; i < buttonHeight; i++)
-		{
-			for (int j = 0; j < buttonWidth; j++)
-			{
-				setcur(buttonPositionX + j, buttonPositionY + i);
-				std::cout << arr[i][j];
-			}
-		}
+		Screen::get().draw(buttonPositionX, buttonPositionY, arr, buttonWidth, buttonHeight);
 		restoreConsoleAttributes();
 		isChanged = false;
 	}
@@ -501,7 +489,7 @@ void PushButton::handleMouseEvent(COORD mousePos)
 		mousePos.Y >= buttonPositionY && mousePos.Y < buttonPositionY + buttonHeight)
 	{
 		buttonPressed();
-		if (GetAsyncKeyState(VK_LBUTTON) & 0x8000)
+		if (leftButtonPressed())
 		{
 			if (userFunction != nullptr)userFunction();
 		}
@@ -624,14 +612,7 @@ void SwitchButton::show()
 {
 	if(isChanged)
 	{
-		for (int i = 0; i < switchHeight; i++)
-		{
-			for (int j = 0; j < switchWidth; j++)
-			{
-				setcur(switchPositionX + j, switchPositionY + i);
-				std::cout << arr[i][j];
-			}
-		}
+		Screen::get().draw(switchPositionX, switchPositionY, arr, switchWidth, switchHeight);
 		if (switchName.size() != 0)
 		{
 			std::string s = switchName + state;
@@ -730,7 +711,7 @@ void SwitchButton::handleMouseEvent(COORD mousePos)
 	{
 		if (!isPressed) buttonPressed();
 
-		if (GetAsyncKeyState(VK_LBUTTON) & 0x8000)
+		if (leftButtonPressed())
 		{
 			if (!stateSwitch)
 			{
@@ -852,16 +833,14 @@ void ScrollButton::show()
 				if ((i == scrollHeight / 2 && j == 0) || (i == scrollHeight / 2 && j == scrollWidth - 1))
 				{
 					restoreConsoleAttributes();
-					setcur(scrollPositionX + j, scrollPositionY + i);
-					std::cout << arr[i][j];
+					Screen::get().put(scrollPositionX + j, scrollPositionY + i, arr[i][j]);
 					saveConsoleAttributes();
 					setColorBackground(backgroundColor);
 					setColorForeground(foregroundColor);
 				}
 				else
 				{
-					setcur(scrollPositionX + j, scrollPositionY + i);
-					std::cout << arr[i][j];
+					Screen::get().put(scrollPositionX + j, scrollPositionY + i, arr[i][j]);
 				}
 			}
 		}
@@ -890,8 +869,7 @@ void ScrollButton::nextSlide(int newSlideNumber)
 	{
 		for (int j = 0; j < scrollWidth; j++)
 		{
-			setcur(scrollPositionX + j, scrollPositionY + i);
-			std::cout << ' ';
+			Screen::get().put(scrollPositionX + j, scrollPositionY + i, ' ');
 		}
 	}
 	this->slideNumber = newSlideNumber;
@@ -923,7 +901,7 @@ void ScrollButton::handleMouseEvent(COORD mousePos)
 	if (mousePos.X >= scrollPositionX && mousePos.X < scrollPositionX + scrollWidth &&
 		mousePos.Y >= scrollPositionY && mousePos.Y < scrollPositionY + scrollHeight) {
 		buttonPressed();
-		if (GetAsyncKeyState(VK_LBUTTON) & 0x8000) {
+		if (leftButtonPressed()) {
 			if (orientation == Orientation::HORIZONTAL)
 			{
 				if (mousePos.X == scrollPositionX && mousePos.Y == scrollPositionY + scrollHeight / 2) {
@@ -1019,25 +997,11 @@ void CustomButton::show()
 		setColorForeground(foregroundColor);
 		if (isPressed)
 		{
-			for (int i = 0; i < texturePressed.size(); i++)
-			{
-				for (int j = 0; j < texturePressed[0].size(); j++)
-				{
-					setcur(buttonPositionX + j, buttonPositionY + i);
-					std::cout << texturePressed[i][j];
-				}
-			}
+			Screen::get().draw(buttonPositionX, buttonPositionY, texturePressed, texturePressed[0].size(), texturePressed.size());
 		}
 		else
 		{
-			for (int i = 0; i < textureDefault.size(); i++)
-			{
-				for (int j = 0; j < textureDefault[0].size(); j++)
-				{
-					setcur(buttonPositionX + j, buttonPositionY + i);
-					std::cout << textureDefault[i][j];
-				}
-			}
+			Screen::get().draw(buttonPositionX, buttonPositionY, textureDefault, textureDefault[0].size(), textureDefault.size());
 		}
 		restoreConsoleAttributes();
 		isChanged = false;
@@ -1057,7 +1021,7 @@ void CustomButton::handleMouseEvent(COORD mousePos)
 		mousePos.Y >= buttonPositionY && mousePos.Y < buttonPositionY + textureDefault.size())
 	{
 		buttonPressed();
-		if (GetAsyncKeyState(VK_LBUTTON) & 0x8000)
+		if (leftButtonPressed())
 		{
 			if (userFunction != nullptr)userFunction();
 		}
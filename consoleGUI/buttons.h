@@ -1,26 +1,18 @@
 #pragma once
-#include <Windows.h>
 #include <iostream>
 #include <vector>
 #include <string>
 #include <functional> 
-#include <conio.h>
 #include "colors.h"
 #include "cursor.h"
+#include "screen.h"
 #include "Object.h"
 
 namespace {
-	static HANDLE hin = GetStdHandle(STD_INPUT_HANDLE);
-	static INPUT_RECORD InputRecord;
-	static DWORD Events;
-	static COORD coord;
-	static DWORD prev_mode;
 	static bool setupInput = false;
 	void setupInputHandling() {
 		setupInput = true;
-		GetConsoleMode(hin, &prev_mode);
-		SetConsoleMode(GetStdHandle(STD_INPUT_HANDLE), ENABLE_EXTENDED_FLAGS | (prev_mode & ~ENABLE_QUICK_EDIT_MODE));
-		SetConsoleMode(hin, ENABLE_MOUSE_INPUT);
+		Terminal::get().enableMouseInput();
 	}
 }
 
@@ -321,8 +313,8 @@ void keyboardButtonInteraction(Args*... objects)
 	allButtons[activeButton]->buttonPressed();
 
 	//  
-	if (_kbhit()) {
-		int key = _getch();
+	if (keyPressed()) {
+		int key = readKey();
 
 		switch (key) {
 		case 72: // UP arrow key
@@ -358,6 +350,7 @@ void keyboardButtonInteraction(Args*... objects)
 	}
 	//    
 	(objects->show(), ...);
+	presentScreen();
 }
 
 
@@ -1,36 +1,26 @@
 #include "colors.h"
-#include <windows.h>
+#include "screen.h"
 
 WORD savedAttributes = 0;
-CONSOLE_SCREEN_BUFFER_INFO savedConsoleInfo;
 
 void setColorForeground(ConsoleColor color) {
-    HANDLE hConsole = GetStdHandle(STD_OUTPUT_HANDLE);
-    CONSOLE_SCREEN_BUFFER_INFO consoleInfo;
-    GetConsoleScreenBufferInfo(hConsole, &consoleInfo);
-    WORD attributes = consoleInfo.wAttributes;
+    WORD attributes = Screen::get().getAttributes();
     attributes &= 0xF0;
     attributes |= (WORD)color;
-    SetConsoleTextAttribute(hConsole, attributes);
+    Screen::get().setAttributes(attributes);
 }
 
 void setColorBackground(ConsoleColor color) {
-    HANDLE hConsole = GetStdHandle(STD_OUTPUT_HANDLE);
-    CONSOLE_SCREEN_BUFFER_INFO consoleInfo;
-    GetConsoleScreenBufferInfo(hConsole, &consoleInfo);
-    WORD attributes = consoleInfo.wAttributes;
+    WORD attributes = Screen::get().getAttributes();
     attributes &= 0x0F;
     attributes |= ((WORD)color << 4);
-    SetConsoleTextAttribute(hConsole, attributes);
+    Screen::get().setAttributes(attributes);
 }
 
 void saveConsoleAttributes() {
-    HANDLE hConsole = GetStdHandle(STD_OUTPUT_HANDLE);
-    GetConsoleScreenBufferInfo(hConsole, &savedConsoleInfo);
-    savedAttributes = savedConsoleInfo.wAttributes;
+    savedAttributes = Screen::get().getAttributes();
 }
 
 void restoreConsoleAttributes() {
-    HANDLE hConsole = GetStdHandle(STD_OUTPUT_HANDLE);
-    SetConsoleTextAttribute(hConsole, savedAttributes);
-}
\ No newline at end of file
+    Screen::get().setAttributes(savedAttributes);
+}
@@ -1,26 +1,39 @@
 	#pragma once
-#include <Windows.h>
+#include "terminal.h"
+#include "screen.h"
+
+inline bool keyPressed()
+{
+	return Terminal::get().keyPending();
+}
+
+inline int readKey()
+{
+	presentScreen();
+	return Terminal::get().readKey();
+}
+
+inline bool leftButtonPressed()
+{
+	return Terminal::get().leftButtonDown();
+}
 
 template<typename... Args>
 void mouseButtonInteraction(Args*... objects) {
-	INPUT_RECORD InputRecord;
-	DWORD Events = 0;
+	TerminalEvent event;
 
-	if (PeekConsoleInput(GetStdHandle(STD_INPUT_HANDLE), &InputRecord, 1, &Events))
+	if (Terminal::get().pollEvent(event))
 	{
-		if (Events > 0 && ReadConsoleInput(GetStdHandle(STD_INPUT_HANDLE), &InputRecord, 1, &Events))
+		if (event.type == TerminalEvent::Type::Mouse)
 		{
-			if (InputRecord.EventType == MOUSE_EVENT)
-			{
-				MOUSE_EVENT_RECORD mouseEvent = InputRecord.Event.MouseEvent;
-				COORD mousePos = mouseEvent.dwMousePosition;
+			COORD mousePos = event.mousePosition;
 
-				(objects->handleMouseEvent(mousePos), ...);
+			(objects->handleMouseEvent(mousePos), ...);
 
-				FlushConsoleInputBuffer(GetStdHandle(STD_INPUT_HANDLE));
-			}
+			Terminal::get().flushInput();
 		}
 	}
 
 	(objects->show(), ...);
+	presentScreen();
 }
\ No newline at end of file
@@ -0,0 +1,240 @@
+#include "screen.h"
+#include <algorithm>
+
+namespace {
+	// An unchanged gap this short is cheaper to write again than to skip
+	const int runMergeGap = 4;
+}
+
+void ScreenBuffer::resize(int width, int height, ScreenCell cell)
+{
+	bufferWidth = width;
+	bufferHeight = height;
+	cells.assign(static_cast<size_t>(width) * height, cell);
+}
+
+void ScreenBuffer::fill(ScreenCell cell)
+{
+	std::fill(cells.begin(), cells.end(), cell);
+}
+
+Screen& Screen::get()
+{
+	static Screen screen;
+	return screen;
+}
+
+Screen::Screen() :
+	terminal(Terminal::get()),
+	outputBuffer(*this), inputBuffer(*this)
+{
+	const TerminalInfo info = terminal.info();
+	windowBottom = info.windowBottom;
+	usedBottom = windowBottom;
+	attributes = info.attributes;
+	cursorPosition = info.cursor;
+
+	// What the terminal shows is unknown until a row is written in full
+	back.resize(info.width, info.height, ScreenCell{ ' ', attributes });
+	front.resize(info.width, info.height, ScreenCell{ ' ', attributes });
+	frontValid.assign(info.height, false);
+	dirtyTop = info.height;
+
+	previousOutput = std::cout.rdbuf(&outputBuffer);
+	previousInput = std::cin.rdbuf(&inputBuffer);
+}
+
+Screen::~Screen()
+{
+	present();
+	std::cout.rdbuf(previousOutput);
+	std::cin.rdbuf(previousInput);
+}
+
+void Screen::moveCursor(int x, int y)
+{
+	cursorPosition.X = static_cast<short>(x);
+	cursorPosition.Y = static_cast<short>(y);
+}
+
+void Screen::markDirty(int y)
+{
+	dirtyTop = (std::min)(dirtyTop, y);
+	dirtyBottom = (std::max)(dirtyBottom, y);
+	usedBottom = (std::max)(usedBottom, y);
+}
+
+void Screen::put(int x, int y, char symbol)
+{
+	if (x < 0 || y < 0 || x >= back.width() || y >= back.height())
+		return;
+
+	ScreenCell& cell = back.at(x, y);
+	if (cell.symbol != symbol || cell.attributes != attributes)
+	{
+		cell.symbol = symbol;
+		cell.attributes = attributes;
+		markDirty(y);
+	}
+}
+
+void Screen::write(char symbol)
+{
+	if (symbol == '\n')
+	{
+		cursorPosition.X = 0;
+		cursorPosition.Y++;
+		return;
+	}
+	if (symbol == '\r')
+	{
+		cursorPosition.X = 0;
+		return;
+	}
+
+	put(cursorPosition.X, cursorPosition.Y, symbol);
+	cursorPosition.X++;
+	if (cursorPosition.X >= back.width())
+	{
+		cursorPosition.X = 0;
+		cursorPosition.Y++;
+	}
+}
+
+void Screen::draw(int x, int y, const std::vector<std::vector<char>>& texture, size_t width, size_t height)
+{
+	for (size_t i = 0; i < height; i++)
+	{
+		for (size_t j = 0; j < width; j++)
+		{
+			put(x + static_cast<int>(j), y + static_cast<int>(i), texture[i][j]);
+		}
+	}
+	moveCursor(x + static_cast<int>(width), y + static_cast<int>(height) - 1);
+}
+
+void Screen::clear()
+{
+	back.fill(ScreenCell{ ' ', attributes });
+	dirtyTop = 0;
+	dirtyBottom = (std::max)(dirtyBottom, usedBottom);
+	usedBottom = windowBottom;
+	moveCursor(0, 0);
+}
+
+void Screen::findRuns()
+{
+	runs.clear();
+	for (int y = dirtyTop; y <= dirtyBottom; y++)
+	{
+		if (!frontValid[y])
+		{
+			runs.push_back(ScreenRun{ y, 0, back.width() - 1 });
+			for (int x = 0; x < back.width(); x++)
+				front.at(x, y) = back.at(x, y);
+			frontValid[y] = true;
+			continue;
+		}
+		for (int x = 0; x < back.width(); x++)
+		{
+			if (back.at(x, y) == front.at(x, y))
+				continue;
+			if (!runs.empty() && runs.back().y == y && x - runs.back().lastX <= runMergeGap)
+				runs.back().lastX = x;
+			else
+				runs.push_back(ScreenRun{ y, x, x });
+			front.at(x, y) = back.at(x, y);
+		}
+	}
+}
+
+void Screen::present()
+{
+	runs.clear();
+	if (dirtyTop <= dirtyBottom)
+	{
+		findRuns();
+		dirtyTop = back.height();
+		dirtyBottom = -1;
+	}
+	terminal.present(back, runs, cursorPosition, attributes);
+}
+
+bool Screen::readLine(std::string& line)
+{
+	line.clear();
+	while (true)
+	{
+		present();
+		const int key = terminal.readKey();
+		if (key < 0)
+			return !line.empty();
+
+		if (key == 0 || key == 224)
+		{
+			terminal.readKey(); // The arrows and the other extended keys do not edit the line
+		}
+		else if (key == '\r' || key == '\n')
+		{
+			write('\n');
+			line += '\n';
+			return true;
+		}
+		else if (key == '\b')
+		{
+			if (!line.empty())
+			{
+				line.pop_back();
+				if (cursorPosition.X > 0)
+					cursorPosition.X--;
+				else if (cursorPosition.Y > 0)
+					moveCursor(back.width() - 1, cursorPosition.Y - 1);
+				put(cursorPosition.X, cursorPosition.Y, ' ');
+			}
+		}
+		else if (key >= ' ' && key != 127)
+		{
+			line += static_cast<char>(key);
+			write(static_cast<char>(key));
+		}
+	}
+}
+
+Screen::OutputBuffer::int_type Screen::OutputBuffer::overflow(int_type symbol)
+{
+	if (!traits_type::eq_int_type(symbol, traits_type::eof()))
+		screen.write(traits_type::to_char_type(symbol));
+	return traits_type::not_eof(symbol);
+}
+
+std::streamsize Screen::OutputBuffer::xsputn(const char* symbols, std::streamsize count)
+{
+	for (std::streamsize i = 0; i < count; i++)
+		screen.write(symbols[i]);
+	return count;
+}
+
+int Screen::OutputBuffer::sync()
+{
+	screen.present();
+	return 0;
+}
+
+Screen::InputBuffer::int_type Screen::InputBuffer::underflow()
+{
+	if (!screen.readLine(line))
+		return traits_type::eof();
+
+	setg(line.data(), line.data(), line.data() + line.size());
+	return traits_type::to_int_type(line.front());
+}
+
+void presentScreen()
+{
+	Screen::get().present();
+}
+
+void clearScreen()
+{
+	Screen::get().clear();
+}
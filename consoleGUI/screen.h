@@ -0,0 +1,110 @@
+#pragma once
+#include <iostream>
+#include <streambuf>
+#include <string>
+#include <vector>
+#include "terminal.h"
+
+struct ScreenCell
+{
+	char symbol = ' ';
+	WORD attributes = 0;
+
+	bool operator==(const ScreenCell& other) const { return symbol == other.symbol && attributes == other.attributes; }
+	bool operator!=(const ScreenCell& other) const { return !(*this == other); }
+};
+
+// Cells of one row that differ between the back and the front buffer
+struct ScreenRun
+{
+	int y;
+	int firstX;
+	int lastX;
+};
+
+class ScreenBuffer
+{
+public:
+	void resize(int bufferWidth, int bufferHeight, ScreenCell cell);
+	void fill(ScreenCell cell);
+	int width() const { return bufferWidth; }
+	int height() const { return bufferHeight; }
+	ScreenCell& at(int x, int y) { return cells[static_cast<size_t>(y) * bufferWidth + x]; }
+	const ScreenCell& at(int x, int y) const { return cells[static_cast<size_t>(y) * bufferWidth + x]; }
+private:
+	std::vector<ScreenCell> cells;
+	int bufferWidth = 0;
+	int bufferHeight = 0;
+};
+
+// Widgets and std::cout draw into the back buffer; present() diffs it against the
+// front buffer, which holds what the terminal shows, and sends the changed runs to it
+class Screen
+{
+public:
+	static Screen& get();
+
+	~Screen();
+	Screen(const Screen&) = delete;
+	Screen& operator=(const Screen&) = delete;
+
+	void moveCursor(int x, int y);
+	COORD cursor() const { return cursorPosition; }
+	void setAttributes(WORD newAttributes) { attributes = newAttributes; }
+	WORD getAttributes() const { return attributes; }
+
+	void put(int x, int y, char symbol);
+	void write(char symbol);
+	void draw(int x, int y, const std::vector<std::vector<char>>& texture, size_t width, size_t height);
+	void clear();
+	void present();
+private:
+	class OutputBuffer : public std::streambuf
+	{
+	public:
+		explicit OutputBuffer(Screen& screen) : screen(screen) {}
+	protected:
+		int_type overflow(int_type symbol) override;
+		std::streamsize xsputn(const char* symbols, std::streamsize count) override;
+		int sync() override;
+	private:
+		Screen& screen;
+	};
+
+	// std::cin reads whole lines, which are edited and echoed on the screen itself
+	class InputBuffer : public std::streambuf
+	{
+	public:
+		explicit InputBuffer(Screen& screen) : screen(screen) {}
+	protected:
+		int_type underflow() override;
+	private:
+		Screen& screen;
+		std::string line;
+	};
+
+	Screen();
+	void markDirty(int y);
+	void findRuns();
+	bool readLine(std::string& line);
+
+	ScreenBuffer back;
+	ScreenBuffer front;
+	std::vector<bool> frontValid;
+	std::vector<ScreenRun> runs;
+	int dirtyTop = 0;
+	int dirtyBottom = -1;
+	int usedBottom = 0;
+	int windowBottom = 0;
+	COORD cursorPosition{};
+	WORD attributes = 0;
+	Terminal& terminal;
+	OutputBuffer outputBuffer;
+	InputBuffer inputBuffer;
+	std::streambuf* previousOutput;
+	std::streambuf* previousInput;
+};
+
+void presentScreen();
+
+void clearScreen();
@@ -0,0 +1,65 @@
+#pragma once
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+typedef unsigned short WORD;
+
+struct COORD
+{
+	short X;
+	short Y;
+};
+#endif
+
+class ScreenBuffer;
+struct ScreenRun;
+
+struct TerminalInfo
+{
+	int width = 80;
+	int height = 25;
+	int windowBottom = 24;
+	WORD attributes = 0x07;
+	COORD cursor{};
+};
+
+struct TerminalEvent
+{
+	enum class Type {
+		None,
+		Key,
+		Mouse
+	};
+
+	Type type = Type::None;
+	int key = 0;
+	int extendedKey = 0;
+	COORD mousePosition{};
+	bool leftButton = false;
+};
+
+// The console the screen is presented on; ansiTerminal.cpp drives VT100 terminals
+// through termios and win32Terminal.cpp drives the Windows console
+class Terminal
+{
+public:
+	static Terminal& get();
+
+	virtual ~Terminal() = default;
+
+	virtual TerminalInfo info() = 0;
+	virtual void present(const ScreenBuffer& back, const std::vector<ScreenRun>& runs, COORD cursor, WORD attributes) = 0;
+	virtual void hideCursor() = 0;
+	virtual void setTitle(const std::string& title) = 0;
+
+	virtual void enableMouseInput() = 0;
+	virtual bool pollEvent(TerminalEvent& event) = 0;
+	virtual void flushInput() = 0;
+	virtual bool keyPending() = 0;
+	virtual int readKey() = 0;
+	virtual bool leftButtonDown() = 0;
+	virtual COORD mousePosition() = 0;
+};
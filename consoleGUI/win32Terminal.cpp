@@ -0,0 +1,192 @@
+#ifdef _WIN32
+#include "terminal.h"
+#include "screen.h"
+#include <algorithm>
+#include <conio.h>
+
+namespace {
+	// Cells sent in one console write, kept below the limit of the console heap
+	const int maxBatchCells = 8192;
+}
+
+class Win32Terminal : public Terminal
+{
+public:
+	Win32Terminal();
+
+	TerminalInfo info() override;
+	void present(const ScreenBuffer& back, const std::vector<ScreenRun>& runs, COORD cursor, WORD attributes) override;
+	void hideCursor() override;
+	void setTitle(const std::string& title) override;
+
+	void enableMouseInput() override;
+	bool pollEvent(TerminalEvent& event) override;
+	void flushInput() override;
+	bool keyPending() override;
+	int readKey() override;
+	bool leftButtonDown() override;
+	COORD mousePosition() override;
+private:
+	HANDLE output;
+	HANDLE input;
+	std::vector<CHAR_INFO> outputCells;
+	COORD presentedCursor{ -1, -1 };
+	WORD presentedAttributes = 0;
+};
+
+Terminal& Terminal::get()
+{
+	static Win32Terminal terminal;
+	return terminal;
+}
+
+Win32Terminal::Win32Terminal() :
+	output(GetStdHandle(STD_OUTPUT_HANDLE)), input(GetStdHandle(STD_INPUT_HANDLE))
+{
+	CONSOLE_SCREEN_BUFFER_INFO consoleInfo{};
+	if (GetConsoleScreenBufferInfo(output, &consoleInfo))
+	{
+		presentedCursor = consoleInfo.dwCursorPosition;
+		presentedAttributes = consoleInfo.wAttributes;
+	}
+}
+
+TerminalInfo Win32Terminal::info()
+{
+	TerminalInfo terminalInfo;
+	CONSOLE_SCREEN_BUFFER_INFO consoleInfo{};
+	if (GetConsoleScreenBufferInfo(output, &consoleInfo))
+	{
+		terminalInfo.width = consoleInfo.dwSize.X;
+		terminalInfo.height = consoleInfo.dwSize.Y;
+		terminalInfo.windowBottom = consoleInfo.srWindow.Bottom;
+		terminalInfo.attributes = consoleInfo.wAttributes;
+		terminalInfo.cursor = consoleInfo.dwCursorPosition;
+	}
+	return terminalInfo;
+}
+
+void Win32Terminal::present(const ScreenBuffer& back, const std::vector<ScreenRun>& runs, COORD cursor, WORD attributes)
+{
+	if (!runs.empty())
+	{
+		// The console takes a rectangle per write, so the runs go out as their bounding box;
+		// the cells between them are unchanged and written again as they are
+		int left = back.width() - 1;
+		int right = 0;
+		for (const ScreenRun& run : runs)
+		{
+			left = (std::min)(left, run.firstX);
+			right = (std::max)(right, run.lastX);
+		}
+		const int width = right - left + 1;
+		const int bandHeight = (std::max)(1, maxBatchCells / width);
+
+		for (int top = runs.front().y; top <= runs.back().y; top += bandHeight)
+		{
+			const int bottom = (std::min)(top + bandHeight - 1, runs.back().y);
+			outputCells.resize(static_cast<size_t>(width) * (bottom - top + 1));
+			for (int y = top; y <= bottom; y++)
+			{
+				for (int x = left; x <= right; x++)
+				{
+					const ScreenCell& cell = back.at(x, y);
+					CHAR_INFO& outputCell = outputCells[static_cast<size_t>(y - top) * width + (x - left)];
+					outputCell.Char.AsciiChar = cell.symbol;
+					outputCell.Attributes = cell.attributes;
+				}
+			}
+
+			COORD size{ static_cast<SHORT>(width), static_cast<SHORT>(bottom - top + 1) };
+			SMALL_RECT region{ static_cast<SHORT>(left), static_cast<SHORT>(top), static_cast<SHORT>(right), static_cast<SHORT>(bottom) };
+			WriteConsoleOutputA(output, outputCells.data(), size, COORD{ 0, 0 }, &region);
+		}
+	}
+
+	if (attributes != presentedAttributes)
+	{
+		SetConsoleTextAttribute(output, attributes);
+		presentedAttributes = attributes;
+	}
+	if (cursor.X != presentedCursor.X || cursor.Y != presentedCursor.Y)
+	{
+		SetConsoleCursorPosition(output, cursor);
+		presentedCursor = cursor;
+	}
+}
+
+void Win32Terminal::hideCursor()
+{
+	CONSOLE_CURSOR_INFO curs = { 0 };
+	curs.dwSize = sizeof(curs);
+	curs.bVisible = FALSE;
+	::SetConsoleCursorInfo(output, &curs);
+}
+
+void Win32Terminal::setTitle(const std::string& title)
+{
+	SetConsoleTitleA(title.c_str());
+}
+
+void Win32Terminal::enableMouseInput()
+{
+	DWORD previousMode;
+	GetConsoleMode(input, &previousMode);
+	SetConsoleMode(input, ENABLE_EXTENDED_FLAGS | (previousMode & ~ENABLE_QUICK_EDIT_MODE));
+	SetConsoleMode(input, ENABLE_MOUSE_INPUT);
+}
+
+bool Win32Terminal::pollEvent(TerminalEvent& event)
+{
+	INPUT_RECORD inputRecord;
+	DWORD events = 0;
+	if (!PeekConsoleInput(input, &inputRecord, 1, &events) || events == 0)
+		return false;
+	if (!ReadConsoleInput(input, &inputRecord, 1, &events) || events == 0)
+		return false;
+
+	event = TerminalEvent();
+	if (inputRecord.EventType == MOUSE_EVENT)
+	{
+		event.type = TerminalEvent::Type::Mouse;
+		event.mousePosition = inputRecord.Event.MouseEvent.dwMousePosition;
+		event.leftButton = (inputRecord.Event.MouseEvent.dwButtonState & FROM_LEFT_1ST_BUTTON_PRESSED) != 0;
+	}
+	else if (inputRecord.EventType == KEY_EVENT && inputRecord.Event.KeyEvent.bKeyDown)
+	{
+		event.type = TerminalEvent::Type::Key;
+		event.key = inputRecord.Event.KeyEvent.wVirtualKeyCode == VK_ESCAPE
+			? 27 : static_cast<unsigned char>(inputRecord.Event.KeyEvent.uChar.AsciiChar);
+	}
+	return true;
+}
+
+void Win32Terminal::flushInput()
+{
+	FlushConsoleInputBuffer(input);
+}
+
+bool Win32Terminal::keyPending()
+{
+	return _kbhit() != 0;
+}
+
+int Win32Terminal::readKey()
+{
+	return _getch();
+}
+
+bool Win32Terminal::leftButtonDown()
+{
+	return (GetAsyncKeyState(VK_LBUTTON) & 0x8000) != 0;
+}
+
+COORD Win32Terminal::mousePosition()
+{
+	enableMouseInput();
+	INPUT_RECORD inputRecord{};
+	DWORD events = 0;
+	PeekConsoleInput(input, &inputRecord, 1, &events);
+	return inputRecord.Event.MouseEvent.dwMousePosition;
+}
+#endif
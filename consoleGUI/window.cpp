@@ -59,14 +59,7 @@ void Window::windowFill()
 
 void Window::show()
 {
-	for (size_t i = 0; i < windowHeight; i++)
-	{
-		for (size_t j = 0; j < windowWidth; j++)
-		{
-			setcur(windowPositionX + j, windowPositionY + i);
-			std::cout << arr[i][j];
-		}
-	}
+	Screen::get().draw(windowPositionX, windowPositionY, arr, windowWidth, windowHeight);
 }
 void Window::addWindowName(std::string windowName, size_t windowNamePositionX, size_t windowNamePositionY)
 {
@@ -2,9 +2,9 @@
 #pragma once
 #include <vector>
 #include <iostream>
-#include <Windows.h>
-#include "object.h"
+#include "Object.h"
 #include "cursor.h"
+#include "screen.h"
 
 class Window : public Object
 {
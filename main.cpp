@@ -1,6 +1,11 @@
 ﻿#include "src/Database.h"
+#include "src/CommandLine.h"
 
-int main()
+int main(int argc, char* argv[])
 {
+	// Any arguments select a headless command instead of the console interface
+	if (argc > 1)
+		return database::runCommandLine(argc, argv);
+
 	database::run();
 }
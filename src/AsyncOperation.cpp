@@ -0,0 +1,44 @@
+#include "AsyncOperation.h"
+
+#include <algorithm>
+
+namespace database
+{
+
+	/** @brief Creates a progress with no work done, timed from now. */
+	OperationProgress::OperationProgress()
+		: start(std::chrono::steady_clock::now())
+	{
+	}
+
+	/** @brief Returns the completed part of the operation, from 0 to 1; zero while the total is unknown. */
+	double OperationProgress::fraction() const
+	{
+		const std::uint64_t total = totalBytes();
+		if (total == 0)
+			return 0.0;
+
+		// Written text may be a little longer than the estimate, so the fraction is capped
+		const double done = static_cast<double>(bytesRead() + bytesWritten());
+		return (std::min)(1.0, done / static_cast<double>(total));
+	}
+
+	/**
+	 * @brief Estimates the time left from the rate of the work done so far.
+	 * @param timeLeft Receives the estimate.
+	 * @return True if an estimate exists, false while no work has been done or the total is unknown.
+	 */
+	bool OperationProgress::estimateTimeLeft(std::chrono::seconds& timeLeft) const
+	{
+		const double done = fraction();
+		if (done <= 0.0)
+			return false;
+
+		const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+		const double secondsLeft = elapsed.count() * (1.0 - done) / done;
+
+		timeLeft = std::chrono::seconds(static_cast<std::chrono::seconds::rep>(secondsLeft + 0.5));
+		return true;
+	}
+
+} // database
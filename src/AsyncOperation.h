@@ -0,0 +1,170 @@
+#ifndef ASYNC_OPERATION_H
+#define ASYNC_OPERATION_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include "ThreadPool.h"
+
+namespace database
+{
+
+	inline constexpr std::size_t progressReportRecords = 4096; ///< Records a loop processes between two progress reports.
+
+	/**
+	 * @brief Progress of a long file operation, shared by the thread doing it and the thread showing it.
+	 *
+	 * The operation sets the number of bytes it expects to read and write in all and
+	 * reports the records and bytes it has processed as it goes; every counter is
+	 * atomic, so a reader sees consistent values without locking. The operation also
+	 * polls cancelled() and returns early once the progress has been cancelled.
+	 */
+	class OperationProgress
+	{
+	public:
+		/** @brief Creates a progress with no work done, timed from now. */
+		OperationProgress();
+
+		/**
+		 * @brief Sets the number of bytes the operation expects to read and write in all.
+		 * @param bytes The expected bytes.
+		 */
+		void setTotalBytes(std::uint64_t bytes) { totalByteCount.store(bytes, std::memory_order_relaxed); }
+
+		/**
+		 * @brief Reports input that has been processed.
+		 * @param records Number of records parsed.
+		 * @param bytes Number of bytes consumed.
+		 */
+		void addRead(std::uint64_t records, std::uint64_t bytes)
+		{
+			recordCount.fetch_add(records, std::memory_order_relaxed);
+			readByteCount.fetch_add(bytes, std::memory_order_relaxed);
+		}
+
+		/**
+		 * @brief Reports output that has been written.
+		 * @param bytes Number of bytes written.
+		 */
+		void addWritten(std::uint64_t bytes) { writtenByteCount.fetch_add(bytes, std::memory_order_relaxed); }
+
+		/** @brief Returns the number of records parsed so far. */
+		std::uint64_t recordsRead() const { return recordCount.load(std::memory_order_relaxed); }
+
+		/** @brief Returns the number of bytes consumed so far. */
+		std::uint64_t bytesRead() const { return readByteCount.load(std::memory_order_relaxed); }
+
+		/** @brief Returns the number of bytes written so far. */
+		std::uint64_t bytesWritten() const { return writtenByteCount.load(std::memory_order_relaxed); }
+
+		/** @brief Returns the number of bytes the operation expects to read and write, or zero if unknown. */
+		std::uint64_t totalBytes() const { return totalByteCount.load(std::memory_order_relaxed); }
+
+		/** @brief Returns the completed part of the operation, from 0 to 1; zero while the total is unknown. */
+		double fraction() const;
+
+		/**
+		 * @brief Estimates the time left from the rate of the work done so far.
+		 * @param timeLeft Receives the estimate.
+		 * @return True if an estimate exists, false while no work has been done or the total is unknown.
+		 */
+		bool estimateTimeLeft(std::chrono::seconds& timeLeft) const;
+
+		/** @brief Asks the operation to stop. */
+		void cancel() { cancellation.cancel(); }
+
+		/** @brief Returns whether the operation has been asked to stop. */
+		bool cancelled() const { return cancellation.cancelled(); }
+
+	private:
+		std::atomic<std::uint64_t> recordCount{ 0 };
+		std::atomic<std::uint64_t> readByteCount{ 0 };
+		std::atomic<std::uint64_t> writtenByteCount{ 0 };
+		std::atomic<std::uint64_t> totalByteCount{ 0 };
+		std::chrono::steady_clock::time_point start;
+		CancellationToken cancellation;
+	};
+
+	/**
+	 * @brief File operation running on the shared thread pool.
+	 *
+	 * The thread that started it polls ready() and reads progress() in the meantime,
+	 * and may cancel() it; get() returns the result once the operation has finished.
+	 */
+	template <typename T>
+	class AsyncOperation
+	{
+	public:
+		/**
+		 * @brief Wraps a submitted task and the progress it reports to.
+		 * @param progress The progress of the operation.
+		 * @param task The task running the operation.
+		 */
+		AsyncOperation(std::shared_ptr<OperationProgress> progress, TaskFuture<T> task)
+			: state(std::move(progress)), task(std::move(task))
+		{
+		}
+
+		/** @brief Returns the progress of the operation. */
+		const OperationProgress& progress() const { return *state; }
+
+		/** @brief Returns whether the operation has finished, without blocking. */
+		bool ready() const { return task.ready(); }
+
+		/**
+		 * @brief Blocks until the operation has finished or a timeout has passed.
+		 * @param timeout The longest time to wait.
+		 * @return True if the operation has finished.
+		 */
+		bool waitFor(std::chrono::milliseconds timeout) const { return task.waitFor(timeout); }
+
+		/** @brief Asks the operation to stop; one that has not started yet is skipped. */
+		void cancel()
+		{
+			state->cancel();
+			task.cancel();
+		}
+
+		/** @brief Returns whether the operation has been asked to stop. */
+		bool cancelled() const { return state->cancelled(); }
+
+		/** @brief Waits for the operation and returns its result. */
+		T get() { return task.get(); }
+
+	private:
+		std::shared_ptr<OperationProgress> state;
+		TaskFuture<T> task;
+	};
+
+	/**
+	 * @brief Starts a file operation on the shared thread pool.
+	 *
+	 * @code
+	 * AsyncOperation<bool> sort = startOperation([](OperationProgress& progress) {
+	 *     return sortStudentFile("group.txt", "group.txt", SortBySurname, Ascending, defaultSortMemoryBudget, &progress);
+	 * });
+	 * @endcode
+	 *
+	 * @param function The operation; it is called with the OperationProgress it reports to.
+	 * @return The running operation.
+	 */
+	template <typename Function>
+	auto startOperation(Function&& function)
+	{
+		using Result = std::invoke_result_t<std::decay_t<Function>&, OperationProgress&>;
+
+		auto progress = std::make_shared<OperationProgress>();
+		TaskFuture<Result> task = ThreadPool::shared().submit(
+			[function = std::forward<Function>(function), progress]() mutable { return function(*progress); });
+
+		return AsyncOperation<Result>(std::move(progress), std::move(task));
+	}
+
+} // database
+
+#endif // ASYNC_OPERATION_H
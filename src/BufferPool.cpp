@@ -0,0 +1,227 @@
+#include "BufferPool.h"
+
+namespace database
+{
+
+	/**
+	 * @brief Creates a pool that caches up to a number of pages.
+	 * @param capacity The number of frames kept in memory.
+	 */
+	BufferPool::BufferPool(std::size_t capacity)
+		: capacity(capacity == 0 ? 1 : capacity)
+	{
+	}
+
+	BufferPool::~BufferPool()
+	{
+		close();
+	}
+
+	/**
+	 * @brief Opens a page file.
+	 * @param filename Name of the file to open.
+	 * @param truncate Whether to discard the existing contents of the file.
+	 * @return True if the file was opened, false otherwise.
+	 */
+	bool BufferPool::open(const std::string& filename, bool truncate)
+	{
+		close();
+
+		// std::fstream cannot create a file in read-write mode, so it is created first
+		if (truncate)
+			std::ofstream(filename, std::ios::binary | std::ios::trunc);
+
+		file.open(filename, std::ios::binary | std::ios::in | std::ios::out);
+		if (!file.is_open())
+			return false;
+
+		file.seekg(0, std::ios::end);
+		pages = static_cast<std::uint32_t>(static_cast<std::uint64_t>(file.tellg()) / pageSize);
+		return true;
+	}
+
+	/**
+	 * @brief Flushes the dirty pages and closes the file.
+	 * @return True if every page was written, false otherwise.
+	 */
+	bool BufferPool::close()
+	{
+		if (!file.is_open())
+			return true;
+
+		const bool flushed = flush();
+
+		file.close();
+		frames.clear();
+		frameOfPage.clear();
+		recencyList.clear();
+		pages = 0;
+
+		return flushed;
+	}
+
+	/**
+	 * @brief Pins a page in memory, loading it if needed.
+	 * @param pageId The page to pin.
+	 * @return The page contents, or nullptr if the page could not be read.
+	 */
+	char* BufferPool::pin(std::uint32_t pageId)
+	{
+		if (pageId >= pages)
+			return nullptr;
+
+		auto cached = frameOfPage.find(pageId);
+		if (cached != frameOfPage.end())
+		{
+			Frame& frame = *frames[cached->second];
+			frame.pinCount++;
+			touch(cached->second);
+			return frame.data.data();
+		}
+
+		const std::size_t index = acquireFrame();
+		if (index == frames.size())
+			return nullptr;
+
+		Frame& frame = *frames[index];
+		file.clear();
+		file.seekg(static_cast<std::streamoff>(pageId) * pageSize);
+		if (!file.read(frame.data.data(), pageSize))
+		{
+			file.clear();
+			return nullptr;
+		}
+
+		frame.pageId = pageId;
+		frame.pinCount = 1;
+		frame.dirty = false;
+		frame.used = true;
+		frameOfPage[pageId] = index;
+		touch(index);
+
+		return frame.data.data();
+	}
+
+	/**
+	 * @brief Appends a zero-filled page to the file and pins it.
+	 * @param pageId Receives the number of the new page.
+	 * @return The page contents, or nullptr if no frame could be freed.
+	 */
+	char* BufferPool::allocate(std::uint32_t& pageId)
+	{
+		const std::size_t index = acquireFrame();
+		if (index == frames.size())
+			return nullptr;
+
+		pageId = pages++;
+
+		Frame& frame = *frames[index];
+		frame.data.fill(0);
+		frame.pageId = pageId;
+		frame.pinCount = 1;
+		frame.dirty = true;
+		frame.used = true;
+		frameOfPage[pageId] = index;
+		touch(index);
+
+		return frame.data.data();
+	}
+
+	/**
+	 * @brief Releases a pin on a page.
+	 * @param pageId The page to unpin.
+	 * @param dirty Whether the page was modified while pinned.
+	 */
+	void BufferPool::unpin(std::uint32_t pageId, bool dirty)
+	{
+		auto cached = frameOfPage.find(pageId);
+		if (cached == frameOfPage.end())
+			return;
+
+		Frame& frame = *frames[cached->second];
+		if (frame.pinCount > 0)
+			frame.pinCount--;
+		frame.dirty = frame.dirty || dirty;
+	}
+
+	/**
+	 * @brief Writes every dirty page back to the file.
+	 * @return True if every page was written, false otherwise.
+	 */
+	bool BufferPool::flush()
+	{
+		bool written = true;
+		for (auto& frame : frames)
+		{
+			if (frame->used && frame->dirty)
+				written = writeFrame(*frame) && written;
+		}
+
+		file.flush();
+		return written && static_cast<bool>(file);
+	}
+
+	/**
+	 * @brief Finds a frame for a new page, evicting an unpinned page if the pool is full.
+	 * @return The frame index, or the frame count if a dirty page could not be written.
+	 */
+	std::size_t BufferPool::acquireFrame()
+	{
+		if (frames.size() < capacity)
+		{
+			frames.push_back(std::make_unique<Frame>());
+			recencyList.push_front(frames.size() - 1);
+			frames.back()->recency = recencyList.begin();
+			return frames.size() - 1;
+		}
+
+		for (auto it = recencyList.rbegin(); it != recencyList.rend(); ++it)
+		{
+			Frame& frame = *frames[*it];
+			if (frame.pinCount > 0)
+				continue;
+
+			if (frame.dirty && !writeFrame(frame))
+				return frames.size();
+
+			frameOfPage.erase(frame.pageId);
+			frame.used = false;
+			return *it;
+		}
+
+		// Every frame is pinned, so the pool grows past its capacity
+		frames.push_back(std::make_unique<Frame>());
+		recencyList.push_front(frames.size() - 1);
+		frames.back()->recency = recencyList.begin();
+		return frames.size() - 1;
+	}
+
+	/**
+	 * @brief Writes a frame to its page in the file.
+	 * @param frame The frame to write.
+	 * @return True if the page was written, false otherwise.
+	 */
+	bool BufferPool::writeFrame(Frame& frame)
+	{
+		file.clear();
+		file.seekp(static_cast<std::streamoff>(frame.pageId) * pageSize);
+		if (!file.write(frame.data.data(), pageSize))
+		{
+			file.clear();
+			return false;
+		}
+
+		frame.dirty = false;
+		return true;
+	}
+
+	/**
+	 * @brief Marks a frame as the most recently used one.
+	 * @param index The frame index.
+	 */
+	void BufferPool::touch(std::size_t index)
+	{
+		recencyList.splice(recencyList.begin(), recencyList, frames[index]->recency);
+	}
+
+} // database
@@ -0,0 +1,201 @@
+#ifndef BUFFER_POOL_H
+#define BUFFER_POOL_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace database
+{
+
+	/**
+	 * @brief Cache of fixed-size pages of a file.
+	 *
+	 * Pages are loaded on demand into a bounded number of frames. A page stays in
+	 * memory while it is pinned; unpinned pages are evicted in least-recently-used
+	 * order, and dirty pages are written back when they are evicted or flushed.
+	 * If every frame is pinned, the pool grows instead of failing.
+	 */
+	class BufferPool
+	{
+	public:
+		static constexpr std::size_t pageSize = 4096; ///< Size of one page in bytes.
+
+		/**
+		 * @brief Creates a pool that caches up to a number of pages.
+		 * @param capacity The number of frames kept in memory.
+		 */
+		explicit BufferPool(std::size_t capacity = 64);
+
+		~BufferPool();
+
+		BufferPool(const BufferPool&) = delete;
+		BufferPool& operator=(const BufferPool&) = delete;
+
+		/**
+		 * @brief Opens a page file.
+		 * @param filename Name of the file to open.
+		 * @param truncate Whether to discard the existing contents of the file.
+		 * @return True if the file was opened, false otherwise.
+		 */
+		bool open(const std::string& filename, bool truncate);
+
+		/**
+		 * @brief Flushes the dirty pages and closes the file.
+		 * @return True if every page was written, false otherwise.
+		 */
+		bool close();
+
+		/** @brief Checks whether a file is open. */
+		bool isOpen() const { return file.is_open(); }
+
+		/** @brief Returns the number of pages in the file. */
+		std::uint32_t pageCount() const { return pages; }
+
+		/**
+		 * @brief Pins a page in memory, loading it if needed.
+		 * @param pageId The page to pin.
+		 * @return The page contents, or nullptr if the page could not be read.
+		 */
+		char* pin(std::uint32_t pageId);
+
+		/**
+		 * @brief Appends a zero-filled page to the file and pins it.
+		 * @param pageId Receives the number of the new page.
+		 * @return The page contents, or nullptr if no frame could be freed.
+		 */
+		char* allocate(std::uint32_t& pageId);
+
+		/**
+		 * @brief Releases a pin on a page.
+		 * @param pageId The page to unpin.
+		 * @param dirty Whether the page was modified while pinned.
+		 */
+		void unpin(std::uint32_t pageId, bool dirty);
+
+		/**
+		 * @brief Writes every dirty page back to the file.
+		 * @return True if every page was written, false otherwise.
+		 */
+		bool flush();
+
+	private:
+		/** @brief One cached page. */
+		struct Frame
+		{
+			alignas(8) std::array<char, pageSize> data{};
+
+			std::uint32_t pageId = 0;
+			int pinCount = 0;
+			bool dirty = false;
+			bool used = false;
+
+			std::list<std::size_t>::iterator recency;
+		};
+
+		/**
+		 * @brief Finds a frame for a new page, evicting an unpinned page if the pool is full.
+		 * @return The frame index, or the frame count if a dirty page could not be written.
+		 */
+		std::size_t acquireFrame();
+
+		/**
+		 * @brief Writes a frame to its page in the file.
+		 * @param frame The frame to write.
+		 * @return True if the page was written, false otherwise.
+		 */
+		bool writeFrame(Frame& frame);
+
+		/**
+		 * @brief Marks a frame as the most recently used one.
+		 * @param index The frame index.
+		 */
+		void touch(std::size_t index);
+
+		std::fstream file;
+		std::uint32_t pages = 0;
+		std::size_t capacity;
+
+		std::vector<std::unique_ptr<Frame>> frames;
+		std::unordered_map<std::uint32_t, std::size_t> frameOfPage;
+		std::list<std::size_t> recencyList; ///< Frame indices, most recently used first.
+	};
+
+	/**
+	 * @brief Keeps a page pinned for the lifetime of the object.
+	 */
+	class PinnedPage
+	{
+	public:
+		/**
+		 * @brief Pins an existing page.
+		 * @param pool The pool that owns the page.
+		 * @param pageId The page to pin.
+		 */
+		PinnedPage(BufferPool& pool, std::uint32_t pageId) : pool(&pool), pageId(pageId), contents(pool.pin(pageId)) {}
+
+		/**
+		 * @brief Allocates and pins a new page.
+		 * @param pool The pool that owns the page.
+		 * @return The pinned page; check it before use.
+		 */
+		static PinnedPage allocate(BufferPool& pool)
+		{
+			PinnedPage page(pool);
+			page.contents = pool.allocate(page.pageId);
+			page.dirty = true;
+			return page;
+		}
+
+		PinnedPage(PinnedPage&& other) noexcept
+			: pool(other.pool), pageId(other.pageId), contents(other.contents), dirty(other.dirty)
+		{
+			other.contents = nullptr;
+		}
+
+		PinnedPage(const PinnedPage&) = delete;
+		PinnedPage& operator=(const PinnedPage&) = delete;
+		PinnedPage& operator=(PinnedPage&&) = delete;
+
+		~PinnedPage()
+		{
+			if (contents)
+				pool->unpin(pageId, dirty);
+		}
+
+		/** @brief Checks whether the page was pinned successfully. */
+		explicit operator bool() const { return contents != nullptr; }
+
+		/** @brief Returns the page number. */
+		std::uint32_t id() const { return pageId; }
+
+		/** @brief Returns the page contents interpreted as a node type, marking the page dirty. */
+		template <typename T>
+		T* as()
+		{
+			dirty = true;
+			return reinterpret_cast<T*>(contents);
+		}
+
+		/** @brief Returns the page contents interpreted as a node type for reading. */
+		template <typename T>
+		const T* read() const { return reinterpret_cast<const T*>(contents); }
+
+	private:
+		explicit PinnedPage(BufferPool& pool) : pool(&pool) {}
+
+		BufferPool* pool;
+		std::uint32_t pageId = 0;
+		char* contents = nullptr;
+		bool dirty = false;
+	};
+
+} // database
+
+#endif // BUFFER_POOL_H
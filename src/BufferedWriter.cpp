@@ -0,0 +1,326 @@
+#include "BufferedWriter.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <climits>
+#include <cstring>
+#include <filesystem>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#include <sys/stat.h>
+#else
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+namespace database
+{
+
+	/**
+	 * @brief Creates a writer that is not yet attached to a file.
+	 * @param bufferSize Size of the user-space buffer in bytes.
+	 */
+	BufferedWriter::BufferedWriter(std::size_t bufferSize)
+		: buffer((std::max)(bufferSize, std::size_t{ 64 }))
+	{
+	}
+
+	/**
+	 * @brief Opens a file for writing.
+	 * @param filename Name of the file.
+	 * @param append Whether to keep the contents and write at the end instead of truncating.
+	 * @return True if the file was opened, false otherwise.
+	 */
+	bool BufferedWriter::open(const std::string& filename, bool append)
+	{
+		close();
+
+#ifdef _WIN32
+		const int flags = _O_WRONLY | _O_CREAT | _O_BINARY | (append ? _O_APPEND : _O_TRUNC);
+		descriptor = _open(filename.c_str(), flags, _S_IREAD | _S_IWRITE);
+#else
+		const int flags = O_WRONLY | O_CREAT | (append ? O_APPEND : O_TRUNC);
+		descriptor = ::open(filename.c_str(), flags, 0644);
+#endif
+
+		used = 0;
+		failed = descriptor < 0;
+		flushedBytes = 0;
+		syscalls = 0;
+		return descriptor >= 0;
+	}
+
+	/**
+	 * @brief Flushes the buffer and closes the file.
+	 * @return True if every byte was written, false otherwise.
+	 */
+	bool BufferedWriter::close()
+	{
+		flush();
+		if (descriptor < 0)
+			return !failed;
+
+#ifdef _WIN32
+		const bool closed = _close(descriptor) == 0;
+#else
+		const bool closed = ::close(descriptor) == 0;
+#endif
+
+		descriptor = -1;
+		failed = failed || !closed;
+		return !failed;
+	}
+
+	/**
+	 * @brief Writes bytes to the file, retrying short writes.
+	 * @param data The bytes to write.
+	 * @param size The number of bytes.
+	 * @return True if every byte was written, false otherwise.
+	 */
+	bool BufferedWriter::writeAll(const char* data, std::size_t size)
+	{
+		while (size > 0)
+		{
+			syscalls++;
+#ifdef _WIN32
+			const int written = _write(descriptor, data, static_cast<unsigned>((std::min)(size, std::size_t{ INT_MAX })));
+#else
+			const ssize_t written = ::write(descriptor, data, size);
+			if (written < 0 && errno == EINTR)
+				continue;
+#endif
+			if (written <= 0)
+				return false;
+
+			data += written;
+			size -= static_cast<std::size_t>(written);
+			flushedBytes += static_cast<std::uint64_t>(written);
+		}
+		return true;
+	}
+
+	/**
+	 * @brief Writes the buffered bytes followed by a large block, in one gathered write where possible.
+	 * @param data The block to write after the buffer.
+	 * @param size The size of the block.
+	 * @return True if every byte was written, false otherwise.
+	 */
+	bool BufferedWriter::writeThrough(const char* data, std::size_t size)
+	{
+#ifndef _WIN32
+		if (used > 0)
+		{
+			iovec parts[2] = { { buffer.data(), used }, { const_cast<char*>(data), size } };
+
+			ssize_t written;
+			do
+			{
+				syscalls++;
+				written = ::writev(descriptor, parts, 2);
+			} while (written < 0 && errno == EINTR);
+
+			if (written < 0)
+				return false;
+
+			// A short gathered write is finished piece by piece
+			flushedBytes += static_cast<std::uint64_t>(written);
+			std::size_t done = static_cast<std::size_t>(written);
+			const std::size_t bufferedDone = (std::min)(done, used);
+			const bool bufferWritten = writeAll(buffer.data() + bufferedDone, used - bufferedDone);
+			used = 0;
+			done -= bufferedDone;
+			return bufferWritten && writeAll(data + done, size - done);
+		}
+#endif
+		const bool bufferWritten = flush();
+		return bufferWritten && writeAll(data, size);
+	}
+
+	/**
+	 * @brief Writes the buffered bytes to the file.
+	 * @return True if every byte was written, false otherwise.
+	 */
+	bool BufferedWriter::flush()
+	{
+		if (used > 0 && (descriptor < 0 || !writeAll(buffer.data(), used)))
+			failed = true;
+
+		used = 0;
+		return !failed;
+	}
+
+	/**
+	 * @brief Flushes the buffer and forces the file contents to the disk.
+	 * @return True if the data reached the disk, false otherwise.
+	 */
+	bool BufferedWriter::sync()
+	{
+		if (!flush() || descriptor < 0)
+			return false;
+
+#ifdef _WIN32
+		failed = _commit(descriptor) != 0;
+#else
+		failed = fsync(descriptor) != 0;
+#endif
+		return !failed;
+	}
+
+	/**
+	 * @brief Makes room for a number of bytes in the buffer.
+	 * @param size The number of bytes needed.
+	 * @return Pointer to the free space.
+	 */
+	char* BufferedWriter::reserve(std::size_t size)
+	{
+		if (buffer.size() - used < size)
+			flush();
+		return buffer.data() + used;
+	}
+
+	/**
+	 * @brief Writes raw bytes.
+	 * @param data The bytes to write.
+	 * @param size The number of bytes.
+	 */
+	void BufferedWriter::write(const void* data, std::size_t size)
+	{
+		const char* bytes = static_cast<const char*>(data);
+
+		if (size <= buffer.size() - used)
+		{
+			std::memcpy(buffer.data() + used, bytes, size);
+			used += size;
+			return;
+		}
+
+		// A block that does not fit is not copied; it goes to the kernel behind the buffered bytes
+		if (size >= buffer.size())
+		{
+			if (descriptor < 0 || !writeThrough(bytes, size))
+				failed = true;
+			used = 0;
+			return;
+		}
+
+		flush();
+		std::memcpy(buffer.data(), bytes, size);
+		used = size;
+	}
+
+	/**
+	 * @brief Writes one character.
+	 * @param character The character to write.
+	 */
+	void BufferedWriter::put(char character)
+	{
+		*reserve(1) = character;
+		used++;
+	}
+
+	/**
+	 * @brief Writes an unsigned integer in decimal.
+	 * @param value The value to write.
+	 */
+	void BufferedWriter::writeUnsigned(std::uint64_t value)
+	{
+		constexpr std::size_t maxDigits = 20;
+		char* first = reserve(maxDigits);
+		used = std::to_chars(first, first + maxDigits, value).ptr - buffer.data();
+	}
+
+	/**
+	 * @brief Writes a double the way an ostream with default flags prints it.
+	 * @param value The value to write.
+	 */
+	void BufferedWriter::writeDouble(double value)
+	{
+		// Six significant digits: sign, digit, point, five digits and a four-character exponent fit with room to spare
+		constexpr std::size_t maxChars = 32;
+		char* first = reserve(maxChars);
+		used = std::to_chars(first, first + maxChars, value, std::chars_format::general, 6).ptr - buffer.data();
+	}
+
+	/**
+	 * @brief Writes scores separated by spaces.
+	 * @param out Writer to write to.
+	 * @param scores The scores to write.
+	 */
+	static void writeScores(BufferedWriter& out, std::span<const std::uint16_t> scores)
+	{
+		for (std::size_t i = 0; i < scores.size(); ++i)
+		{
+			if (i != 0)
+				out.put(' ');
+			out.writeUnsigned(scores[i]);
+		}
+	}
+
+	/**
+	 * @brief Writes the student data referred to by a view in the text format.
+	 * @param out Writer to write to.
+	 * @param student The view of the student data to write.
+	 */
+	void writeStudent(BufferedWriter& out, const StudentView& student)
+	{
+		out.write("STUDENT'S NAME: "); out.write(student.surname); out.put('\n');
+		out.write("GROUP NUMBER: "); out.writeUnsigned(student.groupNumber); out.put('\n');
+		out.write("PHYSICS SCORE: "); writeScores(out, student.phisicsScores); out.put('\n');
+		out.write("PHISICS GPA: "); out.writeDouble(student.averagePhisicsGrade); out.put('\n');
+		out.write("MATH SCORE: "); writeScores(out, student.mathScores); out.put('\n');
+		out.write("MATH GPA: "); out.writeDouble(student.averageMathGrade); out.put('\n');
+		out.write("CS SCORE: "); writeScores(out, student.informScores); out.put('\n');
+		out.write("CS GPA: "); out.writeDouble(student.averageInformGrade); out.put('\n');
+		out.write("GPA: "); out.writeDouble(student.averageGrade); out.put('\n');
+	}
+
+	/**
+	 * @brief Makes a rename in the directory of a file durable.
+	 * @param filename A file in the directory.
+	 */
+	void syncDirectory(const std::string& filename)
+	{
+#ifndef _WIN32
+		std::string directory = std::filesystem::path(filename).parent_path().string();
+		if (directory.empty())
+			directory = ".";
+
+		const int descriptor = ::open(directory.c_str(), O_RDONLY);
+		if (descriptor >= 0)
+		{
+			fsync(descriptor);
+			::close(descriptor);
+		}
+#else
+		(void)filename; // NTFS journals renames itself
+#endif
+	}
+
+	/**
+	 * @brief Atomically replaces a file with a temporary file that was written and synced to the disk.
+	 * @param temporaryFilename Name of the temporary file.
+	 * @param filename Name of the file to replace.
+	 * @param written Whether the temporary file was written and synced completely.
+	 * @return True if the file was replaced, false otherwise; the temporary file is removed on failure.
+	 */
+	bool replaceWithTemporary(const std::string& temporaryFilename, const std::string& filename, bool written)
+	{
+		std::error_code error;
+		if (written)
+			std::filesystem::rename(temporaryFilename, filename, error);
+
+		if (!written || error)
+		{
+			std::filesystem::remove(temporaryFilename, error);
+			return false;
+		}
+
+		syncDirectory(filename);
+		return true;
+	}
+
+} // database
@@ -0,0 +1,191 @@
+#ifndef BUFFERED_WRITER_H
+#define BUFFERED_WRITER_H
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Student.h"
+
+namespace database
+{
+
+	inline constexpr std::size_t defaultWriterBufferSize = std::size_t{ 1 } << 20; ///< Size of the user-space buffer of a writer.
+
+	/**
+	 * @brief Output file with a large user-space buffer, flushed with one system call at a time.
+	 *
+	 * Numbers are formatted with std::to_chars straight into the buffer. Doubles use the
+	 * shortest general form with six significant digits, which is what an ostream with
+	 * default flags prints. A write larger than the free space is passed to the kernel
+	 * together with the buffered bytes in one gathered write where the platform has one.
+	 * Files are written in binary mode, so text lines end with a bare newline.
+	 */
+	class BufferedWriter
+	{
+	public:
+		/**
+		 * @brief Creates a writer that is not yet attached to a file.
+		 * @param bufferSize Size of the user-space buffer in bytes.
+		 */
+		explicit BufferedWriter(std::size_t bufferSize = defaultWriterBufferSize);
+		~BufferedWriter() { close(); }
+
+		BufferedWriter(const BufferedWriter&) = delete;
+		BufferedWriter& operator=(const BufferedWriter&) = delete;
+
+		/**
+		 * @brief Opens a file for writing.
+		 * @param filename Name of the file.
+		 * @param append Whether to keep the contents and write at the end instead of truncating.
+		 * @return True if the file was opened, false otherwise.
+		 */
+		bool open(const std::string& filename, bool append = false);
+
+		/**
+		 * @brief Flushes the buffer and closes the file.
+		 * @return True if every byte was written, false otherwise.
+		 */
+		bool close();
+
+		/** @brief Returns whether a file is open. */
+		bool isOpen() const { return descriptor >= 0; }
+
+		/** @brief Returns whether every write so far succeeded. */
+		bool good() const { return !failed; }
+
+		/** @brief Returns the number of bytes written since the file was opened, including buffered ones. */
+		std::uint64_t position() const { return flushedBytes + used; }
+
+		/** @brief Returns the number of write system calls issued since the file was opened. */
+		std::uint64_t syscallCount() const { return syscalls; }
+
+		/**
+		 * @brief Returns the bytes buffered since the last flush.
+		 *
+		 * A writer that is never opened keeps everything it is given in its buffer as long
+		 * as it fits, so a worker thread can format records into it and hand them over.
+		 */
+		std::string_view buffered() const { return { buffer.data(), used }; }
+
+		/** @brief Drops the buffered bytes without writing them. */
+		void discard() { used = 0; }
+
+		/**
+		 * @brief Writes the buffered bytes to the file.
+		 * @return True if every byte was written, false otherwise.
+		 */
+		bool flush();
+
+		/**
+		 * @brief Flushes the buffer and forces the file contents to the disk.
+		 * @return True if the data reached the disk, false otherwise.
+		 */
+		bool sync();
+
+		/**
+		 * @brief Writes raw bytes.
+		 * @param data The bytes to write.
+		 * @param size The number of bytes.
+		 */
+		void write(const void* data, std::size_t size);
+
+		/**
+		 * @brief Writes text.
+		 * @param text The text to write.
+		 */
+		void write(std::string_view text) { write(text.data(), text.size()); }
+
+		/**
+		 * @brief Writes one character.
+		 * @param character The character to write.
+		 */
+		void put(char character);
+
+		/**
+		 * @brief Writes an unsigned integer in decimal.
+		 * @param value The value to write.
+		 */
+		void writeUnsigned(std::uint64_t value);
+
+		/**
+		 * @brief Writes a double the way an ostream with default flags prints it.
+		 * @param value The value to write.
+		 */
+		void writeDouble(double value);
+
+		/**
+		 * @brief Writes a column of trivially copyable values as raw bytes.
+		 * @param column The values to write.
+		 */
+		template <typename T>
+		void writeColumn(std::span<const T> column)
+		{
+			write(column.data(), column.size_bytes());
+		}
+
+	private:
+		/**
+		 * @brief Makes room for a number of bytes in the buffer.
+		 * @param size The number of bytes needed.
+		 * @return Pointer to the free space.
+		 */
+		char* reserve(std::size_t size);
+
+		/**
+		 * @brief Writes bytes to the file, retrying short writes.
+		 * @param data The bytes to write.
+		 * @param size The number of bytes.
+		 * @return True if every byte was written, false otherwise.
+		 */
+		bool writeAll(const char* data, std::size_t size);
+
+		/**
+		 * @brief Writes the buffered bytes followed by a large block, in one gathered write where possible.
+		 * @param data The block to write after the buffer.
+		 * @param size The size of the block.
+		 * @return True if every byte was written, false otherwise.
+		 */
+		bool writeThrough(const char* data, std::size_t size);
+
+		std::vector<char> buffer;
+		std::size_t used = 0;
+
+		int descriptor = -1;
+		bool failed = false;
+
+		std::uint64_t flushedBytes = 0;
+		std::uint64_t syscalls = 0;
+	};
+
+	/**
+	 * @brief Writes the student data referred to by a view in the text format.
+	 * @param out Writer to write to.
+	 * @param student The view of the student data to write.
+	 */
+	void writeStudent(BufferedWriter& out, const StudentView& student);
+
+	/**
+	 * @brief Makes a rename in the directory of a file durable.
+	 * @param filename A file in the directory.
+	 */
+	void syncDirectory(const std::string& filename);
+
+	/**
+	 * @brief Atomically replaces a file with a temporary file that was written and synced to the disk.
+	 *
+	 * The directory is synced after the rename, so the new contents survive a crash once
+	 * the function returns.
+	 *
+	 * @param temporaryFilename Name of the temporary file.
+	 * @param filename Name of the file to replace.
+	 * @param written Whether the temporary file was written and synced completely.
+	 * @return True if the file was replaced, false otherwise; the temporary file is removed on failure.
+	 */
+	bool replaceWithTemporary(const std::string& temporaryFilename, const std::string& filename, bool written);
+
+} // database
+
+#endif // BUFFERED_WRITER_H
@@ -0,0 +1,553 @@
+#include "CommandLine.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <filesystem>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "BufferedWriter.h"
+#include "ExternalSort.h"
+#include "FileStorage.h"
+#include "Student.h"
+#include "StudentBinary.h"
+#include "StudentGenerator.h"
+#include "StudentImport.h"
+#include "StudentIndex.h"
+#include "StudentLog.h"
+#include "StudentQuery.h"
+#include "StudentReader.h"
+#include "StudentStatistics.h"
+#include "StudentTree.h"
+
+namespace database
+{
+
+	/** @brief Exit statuses of a command. */
+	enum ExitStatus
+	{
+		ExitSuccess = 0,
+		ExitFailure = 1,
+		ExitUsage = 2
+	};
+
+	/** @brief Operands and options of a command. */
+	struct CommandArguments
+	{
+		std::vector<std::string> operands;
+		std::map<std::string, std::string> options;
+		SortingType sortingType = Ascending;
+		bool registerFile = false;
+	};
+
+	static const char* const usageText =
+		"  sort --by FIELD [--asc | --desc] [--memory MIB] [-o OUTPUT] FILE\n"
+		"  import SOURCE TARGET\n"
+		"  export --format text|binary|csv -o OUTPUT FILE\n"
+		"  query FILE --surname NAME\n"
+		"  query FILE --prefix TEXT\n"
+		"  query FILE --group NUMBER\n"
+		"  query FILE --by FIELD [--min VALUE] [--max VALUE] [--asc | --desc]\n"
+		"  query FILE --where QUERY\n"
+		"  stats FILE\n"
+		"  generate --count N [--format text|binary] [--seed N] [--scores MIN-MAX] [--grades MIN-MAX]\n"
+		"           [--grade-weights W,W,...] [--surnames N] [--skew S] [--duplicates RATE]\n"
+		"           [--threads N] [--register] FILE\n"
+		"FIELD is one of surname, gpa, physics, math, cs; a surname --max is a prefix that includes every surname starting with it.\n"
+		"QUERY is an expression such as \"group = 4351 AND min(math) >= 4 AND gpa > 3.5\";\n"
+		"--where also filters the records found by the other query forms.\n";
+
+	static std::string programName = "Database"; ///< Name the program was started under, used in messages.
+
+	/**
+	 * @brief Prints the usage of the commands.
+	 * @param out Output stream to print to.
+	 */
+	static void printUsage(std::ostream& out)
+	{
+		out << "usage: " << programName << " <command> [options]\n" << usageText;
+	}
+
+	/** @brief Options that take a value. */
+	static const std::set<std::string> valueOptions = {
+		"--by", "--count", "--duplicates", "--format", "--grade-weights", "--grades", "--group", "--max", "--memory",
+		"--min", "--prefix", "--scores", "--seed", "--skew", "--surname", "--surnames", "--threads", "--where", "-o"
+	};
+
+	/**
+	 * @brief Reports a usage error.
+	 * @param message What is wrong with the command.
+	 * @return ExitUsage.
+	 */
+	static int usageError(const std::string& message)
+	{
+		std::cerr << programName << ": " << message << '\n';
+		printUsage(std::cerr);
+		return ExitUsage;
+	}
+
+	/**
+	 * @brief Reports a failed command.
+	 * @param message What failed.
+	 * @return ExitFailure.
+	 */
+	static int failure(const std::string& message)
+	{
+		std::cerr << programName << ": " << message << '\n';
+		return ExitFailure;
+	}
+
+	/**
+	 * @brief Splits the arguments following the command name into operands and options.
+	 * @param argc Number of arguments, including the program name.
+	 * @param argv The arguments.
+	 * @param arguments Receives the operands and options.
+	 * @param error Receives the problem if the arguments are invalid.
+	 * @return True if the arguments are valid, false otherwise.
+	 */
+	static bool parseArguments(int argc, char* argv[], CommandArguments& arguments, std::string& error)
+	{
+		for (int i = 2; i < argc; i++)
+		{
+			const std::string argument = argv[i];
+
+			if (argument == "--asc")
+				arguments.sortingType = Ascending;
+			else if (argument == "--desc")
+				arguments.sortingType = Descending;
+			else if (argument == "--register")
+				arguments.registerFile = true;
+			else if (valueOptions.count(argument))
+			{
+				if (i + 1 == argc)
+				{
+					error = "option " + argument + " needs a value";
+					return false;
+				}
+				arguments.options[argument] = argv[++i];
+			}
+			else if (argument.size() > 1 && argument[0] == '-')
+			{
+				error = "unknown option " + argument;
+				return false;
+			}
+			else
+				arguments.operands.push_back(argument);
+		}
+		return true;
+	}
+
+	/**
+	 * @brief Looks up the sorting method named on the command line.
+	 * @param name The field name.
+	 * @param sortingMethod Receives the method.
+	 * @return True if the name is known, false otherwise.
+	 */
+	static bool parseSortingMethod(const std::string& name, SortingMethod& sortingMethod)
+	{
+		static const std::map<std::string, SortingMethod> methods = {
+			{ "surname", SortBySurname },
+			{ "gpa", SortByAverageGrade },
+			{ "physics", SortByAveragePhisicsGrade },
+			{ "math", SortByAverageMathGrade },
+			{ "cs", SortByAverageInformGrade }
+		};
+
+		const auto method = methods.find(name);
+		if (method == methods.end())
+			return false;
+
+		sortingMethod = method->second;
+		return true;
+	}
+
+	/**
+	 * @brief Parses a number that must make up the whole argument.
+	 * @param text The argument.
+	 * @param value Receives the number.
+	 * @return True if the argument is a number, false otherwise.
+	 */
+	template <typename T>
+	static bool parseNumber(const std::string& text, T& value)
+	{
+		const auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+		return !text.empty() && result.ec == std::errc() && result.ptr == text.data() + text.size();
+	}
+
+	/**
+	 * @brief Parses a range written as MIN-MAX, or a single number for both ends.
+	 * @param text The argument.
+	 * @param low Receives the lower end.
+	 * @param high Receives the upper end.
+	 * @return True if the argument is a range with the lower end first, false otherwise.
+	 */
+	template <typename T>
+	static bool parseRange(const std::string& text, T& low, T& high)
+	{
+		const std::size_t dash = text.find('-');
+		if (dash == std::string::npos)
+			return parseNumber(text, low) && parseNumber(text, high);
+
+		return parseNumber(text.substr(0, dash), low) && parseNumber(text.substr(dash + 1), high) && low <= high;
+	}
+
+	/**
+	 * @brief Sorts a student file.
+	 * @param arguments The arguments of the command.
+	 * @return The exit status.
+	 */
+	static int sortCommand(const CommandArguments& arguments)
+	{
+		if (arguments.operands.size() != 1)
+			return usageError("sort needs one file");
+
+		SortingMethod sortingMethod{};
+		const auto field = arguments.options.find("--by");
+		if (field == arguments.options.end() || !parseSortingMethod(field->second, sortingMethod))
+			return usageError("sort needs --by FIELD");
+
+		std::size_t memoryBudget = defaultSortMemoryBudget;
+		if (const auto memory = arguments.options.find("--memory"); memory != arguments.options.end())
+		{
+			std::size_t megabytes = 0;
+			if (!parseNumber(memory->second, megabytes) || megabytes == 0)
+				return usageError("invalid memory budget " + memory->second);
+			memoryBudget = megabytes << 20;
+		}
+
+		const std::string& input = arguments.operands.front();
+		const auto output = arguments.options.find("-o");
+
+		if (!sortStudentFile(input, output != arguments.options.end() ? output->second : input,
+			sortingMethod, arguments.sortingType, memoryBudget))
+			return failure("cannot sort " + input);
+
+		return ExitSuccess;
+	}
+
+	/**
+	 * @brief Imports a CSV or TSV export into a student file.
+	 * @param arguments The arguments of the command.
+	 * @return The exit status.
+	 */
+	static int importCommand(const CommandArguments& arguments)
+	{
+		if (arguments.operands.size() != 2)
+			return usageError("import needs a source and a target file");
+
+		const std::string& source = arguments.operands[0];
+		const std::string& target = arguments.operands[1];
+
+		ImportSummary summary;
+		if (!importStudents(source, target, summary))
+			return failure("cannot import " + source + " into " + target);
+
+		std::cout << "imported " << summary.importedCount << " students into " << target << '\n';
+		if (summary.rejectedCount != 0)
+			std::cerr << "rejected " << summary.rejectedCount << " rows, see " << rejectFilename(source) << '\n';
+
+		return ExitSuccess;
+	}
+
+	/**
+	 * @brief Writes a student file in another format.
+	 * @param arguments The arguments of the command.
+	 * @return The exit status.
+	 */
+	static int exportCommand(const CommandArguments& arguments)
+	{
+		const auto format = arguments.options.find("--format");
+		const auto output = arguments.options.find("-o");
+
+		if (arguments.operands.size() != 1)
+			return usageError("export needs one file");
+		if (format == arguments.options.end() || output == arguments.options.end())
+			return usageError("export needs --format and -o");
+
+		const std::string& input = arguments.operands.front();
+		if (!checkpointStudentFile(input))
+			return failure("cannot read " + input);
+
+		bool exported = false;
+		if (format->second == "csv")
+			exported = exportStudentsCsv(input, output->second);
+		else if (format->second == "binary")
+		{
+			StudentReader reader(input);
+			std::vector<Student> students;
+			for (const Student& student : reader)
+				students.push_back(student);
+			exported = reader.isOpen() && writeStudentsBinary(output->second, students);
+		}
+		else if (format->second == "text")
+		{
+			StudentReader reader(input);
+			BufferedWriter writer;
+			if (reader.isOpen() && writer.open(output->second))
+			{
+				for (const Student& student : reader)
+					writeStudent(writer, makeStudentView(student));
+				exported = writer.close();
+			}
+		}
+		else
+			return usageError("unknown format " + format->second);
+
+		if (!exported)
+			return failure("cannot export " + input + " to " + output->second);
+
+		return ExitSuccess;
+	}
+
+	/**
+	 * @brief Prints the records of a file found through its sidecar index or B+-trees,
+	 * or by scanning it with a query.
+	 * @param arguments The arguments of the command.
+	 * @return The exit status.
+	 */
+	static int queryCommand(const CommandArguments& arguments)
+	{
+		if (arguments.operands.size() != 1)
+			return usageError("query needs one file");
+
+		const std::string& input = arguments.operands.front();
+		const auto& options = arguments.options;
+		const std::size_t criteria = options.count("--surname") + options.count("--prefix") + options.count("--group") + options.count("--by");
+		if (criteria > 1 || (criteria == 0 && !options.count("--where")))
+			return usageError("query needs exactly one of --surname, --prefix, --group and --by, or --where");
+
+		StudentQuery filter;
+		if (const auto where = options.find("--where"); where != options.end() && !filter.compile(where->second))
+			return usageError("invalid query: " + filter.error());
+
+		if (!checkpointStudentFile(input))
+			return failure("cannot read " + input);
+
+		// Without an index lookup the whole file is scanned with the query pushed down into the reader
+		if (criteria == 0)
+		{
+			StudentReader reader(input, filter);
+			if (!reader.isOpen())
+				return failure("cannot read " + input);
+
+			for (const Student& student : reader)
+				writeStudent(std::cout, student);
+			return std::cout.flush() ? ExitSuccess : ExitFailure;
+		}
+
+		std::vector<std::uint64_t> recordOffsets;
+
+		if (!options.count("--by"))
+		{
+			StudentIndex index;
+			if (!index.open(input))
+				return failure("cannot index " + input);
+
+			if (const auto surname = options.find("--surname"); surname != options.end())
+				recordOffsets = index.findBySurname(surname->second);
+			else if (const auto prefix = options.find("--prefix"); prefix != options.end())
+				recordOffsets = index.findBySurnamePrefix(prefix->second);
+			else
+			{
+				std::uint64_t groupNumber = 0;
+				if (!parseNumber(options.at("--group"), groupNumber))
+					return usageError("invalid group number " + options.at("--group"));
+				recordOffsets = index.findByGroup(groupNumber);
+			}
+		}
+		else
+		{
+			SortingMethod sortingMethod{};
+			if (!parseSortingMethod(options.at("--by"), sortingMethod))
+				return usageError("unknown field " + options.at("--by"));
+
+			StudentTree tree;
+			if (!tree.open(input, sortingMethod))
+				return failure("cannot index " + input);
+
+			const auto low = options.find("--min");
+			const auto high = options.find("--max");
+			bool scanned = false;
+
+			if (low == options.end() && high == options.end())
+				scanned = tree.scanAll(arguments.sortingType, recordOffsets);
+			else
+			{
+				if (sortingMethod == SortBySurname)
+				{
+					// --max is a prefix, so "--max M" includes every surname starting with M
+					scanned = tree.scanRange(low != options.end() ? low->second : std::string(),
+						high != options.end() ? high->second : std::string(), recordOffsets);
+				}
+				else
+				{
+					double lowValue = -std::numeric_limits<double>::infinity();
+					double highValue = std::numeric_limits<double>::infinity();
+					if ((low != options.end() && !parseNumber(low->second, lowValue))
+						|| (high != options.end() && !parseNumber(high->second, highValue)))
+						return usageError("invalid range");
+
+					scanned = tree.scanRange(lowValue, highValue, recordOffsets);
+				}
+
+				if (arguments.sortingType == Descending)
+					std::reverse(recordOffsets.begin(), recordOffsets.end());
+			}
+
+			if (!scanned)
+				return failure("cannot read the index of " + input);
+		}
+
+		std::vector<Student> students;
+		if (!readStudentsAt(input, recordOffsets, students))
+			return failure("cannot read " + input);
+
+		for (const auto& student : students)
+		{
+			if (filter.matches(makeStudentView(student)))
+				writeStudent(std::cout, student);
+		}
+
+		return std::cout.flush() ? ExitSuccess : ExitFailure;
+	}
+
+	/**
+	 * @brief Prints summary statistics of a student file.
+	 * @param arguments The arguments of the command.
+	 * @return The exit status.
+	 */
+	static int statsCommand(const CommandArguments& arguments)
+	{
+		if (arguments.operands.size() != 1)
+			return usageError("stats needs one file");
+
+		const std::string& input = arguments.operands.front();
+		StudentStatistics statistics;
+		if (!computeStatistics(input, statistics))
+			return failure("cannot read " + input);
+
+		printStatistics(std::cout, statistics);
+		return std::cout.flush() ? ExitSuccess : ExitFailure;
+	}
+
+	/**
+	 * @brief Writes a file of generated students for load tests.
+	 * @param arguments The arguments of the command.
+	 * @return The exit status.
+	 */
+	static int generateCommand(const CommandArguments& arguments)
+	{
+		if (arguments.operands.size() != 1)
+			return usageError("generate needs one file");
+
+		const auto& options = arguments.options;
+		const auto option = [&options](const char* name) {
+			const auto value = options.find(name);
+			return value != options.end() ? &value->second : nullptr;
+		};
+
+		std::uint64_t recordCount = 0;
+		if (!option("--count") || !parseNumber(*option("--count"), recordCount))
+			return usageError("generate needs --count N");
+
+		bool binary = false;
+		if (const std::string* format = option("--format"))
+		{
+			if (*format != "text" && *format != "binary")
+				return usageError("unknown format " + *format);
+			binary = *format == "binary";
+		}
+
+		GeneratorOptions generatorOptions;
+		std::size_t threadCount = 0;
+
+		if (const std::string* seed = option("--seed"); seed && !parseNumber(*seed, generatorOptions.seed))
+			return usageError("invalid seed " + *seed);
+		if (const std::string* scores = option("--scores");
+			scores && (!parseRange(*scores, generatorOptions.minScoresPerSubject, generatorOptions.maxScoresPerSubject) || generatorOptions.minScoresPerSubject == 0))
+			return usageError("invalid number of scores " + *scores);
+		if (const std::string* grades = option("--grades"); grades && !parseRange(*grades, generatorOptions.minScore, generatorOptions.maxScore))
+			return usageError("invalid grade range " + *grades);
+		if (const std::string* surnames = option("--surnames");
+			surnames && (!parseNumber(*surnames, generatorOptions.surnameCount) || generatorOptions.surnameCount == 0))
+			return usageError("invalid number of surnames " + *surnames);
+		if (const std::string* skew = option("--skew"); skew && (!parseNumber(*skew, generatorOptions.surnameSkew) || generatorOptions.surnameSkew < 0))
+			return usageError("invalid skew " + *skew);
+		if (const std::string* duplicates = option("--duplicates");
+			duplicates && (!parseNumber(*duplicates, generatorOptions.duplicateRate) || generatorOptions.duplicateRate < 0 || generatorOptions.duplicateRate > 1))
+			return usageError("invalid duplicate rate " + *duplicates);
+		if (const std::string* threads = option("--threads"); threads && !parseNumber(*threads, threadCount))
+			return usageError("invalid number of threads " + *threads);
+
+		if (const std::string* weights = option("--grade-weights"))
+		{
+			std::size_t start = 0;
+			while (start <= weights->size())
+			{
+				const std::size_t end = (std::min)(weights->find(',', start), weights->size());
+				double weight = 0;
+				if (!parseNumber(weights->substr(start, end - start), weight) || weight < 0)
+					return usageError("invalid grade weights " + *weights);
+				generatorOptions.scoreWeights.push_back(weight);
+				start = end + 1;
+			}
+		}
+
+		const std::string& output = arguments.operands.front();
+		if (!generateStudentFile(output, generatorOptions, recordCount, binary, threadCount))
+			return failure("cannot write " + output);
+
+		if (arguments.registerFile && !registerStorageFile(output))
+			return failure("cannot register " + output);
+
+		std::cout << "generated " << recordCount << " students into " << output << '\n';
+		return ExitSuccess;
+	}
+
+	/**
+	 * @brief Runs one command given on the command line, without the console interface.
+	 * @param argc Number of arguments, including the program name.
+	 * @param argv The arguments.
+	 * @return The exit status: 0 on success, 1 if the command failed, 2 on a usage error.
+	 */
+	int runCommandLine(int argc, char* argv[])
+	{
+		if (argc > 0 && argv[0][0] != '\0')
+			programName = std::filesystem::path(argv[0]).stem().string();
+
+		const std::string command = argc > 1 ? argv[1] : "";
+		if (command == "help" || command == "--help" || command == "-h")
+		{
+			printUsage(std::cout);
+			return ExitSuccess;
+		}
+		if (command.empty())
+			return usageError("missing command");
+
+		CommandArguments arguments;
+		std::string error;
+		if (!parseArguments(argc, argv, arguments, error))
+			return usageError(error);
+
+		if (command == "sort")
+			return sortCommand(arguments);
+		if (command == "import")
+			return importCommand(arguments);
+		if (command == "export")
+			return exportCommand(arguments);
+		if (command == "query")
+			return queryCommand(arguments);
+		if (command == "stats")
+			return statsCommand(arguments);
+		if (command == "generate")
+			return generateCommand(arguments);
+
+		return usageError("unknown command " + command);
+	}
+
+} // database
@@ -0,0 +1,37 @@
+#ifndef COMMAND_LINE_H
+#define COMMAND_LINE_H
+
+namespace database
+{
+
+	/**
+	 * @brief Runs one command given on the command line, without the console interface.
+	 *
+	 * Commands:
+	 * - sort --by FIELD [--asc | --desc] [--memory MIB] [-o OUTPUT] FILE
+	 * - import SOURCE TARGET
+	 * - export --format text|binary|csv -o OUTPUT FILE
+	 * - query FILE (--surname NAME | --prefix TEXT | --group NUMBER | --by FIELD [--min VALUE] [--max VALUE] [--asc | --desc]) [--where QUERY]
+	 * - query FILE --where QUERY
+	 * - stats FILE
+	 * - generate --count N [--format text|binary] [--seed N] [--scores MIN-MAX] [--grades MIN-MAX]
+	 *   [--grade-weights W,W,...] [--surnames N] [--skew S] [--duplicates RATE] [--threads N] [--register] FILE
+	 *
+	 * FIELD is one of surname, gpa, physics, math and cs. Queries print the matching
+	 * records in the text format on the standard output, using the sidecar index for
+	 * surname and group lookups and the B+-tree of the field otherwise; a --where query
+	 * in the language of StudentQuery filters their results, or alone scans the file
+	 * with the query pushed down into the reader. Generated files are added to the file
+	 * list of their directory with --register, so the console interface shows them when
+	 * they are written to its storage directory. Stats prints field quantiles, failing
+	 * students, a GPA histogram and a table of the groups.
+	 *
+	 * @param argc Number of arguments, including the program name.
+	 * @param argv The arguments.
+	 * @return The exit status: 0 on success, 1 if the command failed, 2 on a usage error.
+	 */
+	int runCommandLine(int argc, char* argv[]);
+
+} // database
+
+#endif // COMMAND_LINE_H
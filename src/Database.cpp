@@ -1,9 +1,10 @@
 #include "Database.h"
 #include "global.h"
 #include "Utils.h"
+#include "StudentLog.h"
 #include "Menu/MainMenu.h"
+#include "../consoleGUI/terminal.h"
 
-#include <Windows.h>
 #include <filesystem>
 #include <fstream>
 
@@ -17,7 +18,7 @@ namespace database
      */
     static void setup()
     {
-        SetConsoleTitleA("Database");
+        Terminal::get().setTitle("Database");
 
         namespace fs = std::filesystem;
 
@@ -42,6 +43,12 @@ namespace database
         }
 
         Utils::loadFiles(pathToFileStorage, mainDirectory); ///< Loads files from the specified storage path.
+
+        // Recovery: changes logged before a crash are replayed into their files
+        for (const auto& filename : mainDirectory) {
+            if (!checkpointStudentFile(folderPath + "/" + filename))
+                Utils::applicationErrorWindow("ERROR RECOVERING " + filename, 61, 9, 30, 10);
+        }
     }
 
     /**
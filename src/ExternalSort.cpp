@@ -0,0 +1,382 @@
+#include "ExternalSort.h"
+
+#include <filesystem>
+#include <queue>
+#include <vector>
+
+#include "AsyncOperation.h"
+#include "BufferedWriter.h"
+#include "MappedFile.h"
+#include "MappedStudentFile.h"
+#include "StudentBinary.h"
+#include "StudentLog.h"
+#include "StudentParser.h"
+#include "StudentTable.h"
+
+namespace database
+{
+
+	/** @brief Bytes of sort keys and ordering buffers needed per record while a run is sorted. */
+	static constexpr std::size_t sortOverheadPerRecord = 64;
+
+	/** @brief Names of the run files of a sort, removed once the sort finishes. */
+	struct RunFiles
+	{
+		std::vector<std::string> names;
+
+		~RunFiles()
+		{
+			std::error_code error;
+			for (const auto& name : names)
+				std::filesystem::remove(name, error);
+		}
+	};
+
+	/** @brief Position of the merge in one run file. */
+	struct RunCursor
+	{
+		MappedFile file;
+		StudentParser parser{ nullptr, nullptr };
+		Student current;
+	};
+
+	/**
+	 * @brief Returns the numeric field a sorting method orders by.
+	 * @param student The student to read the field from.
+	 * @param sortingMethod The numeric sorting method.
+	 * @return The value of the field.
+	 */
+	static double sortField(const Student& student, SortingMethod sortingMethod)
+	{
+		switch (sortingMethod)
+		{
+		case SortByAveragePhisicsGrade:
+			return student.averagePhisicsGrade;
+		case SortByAverageMathGrade:
+			return student.averageMathGrade;
+		case SortByAverageInformGrade:
+			return student.averageInformGrade;
+		default:
+			return student.averageGrade;
+		}
+	}
+
+	/**
+	 * @brief Checks whether a record sorts strictly before another one.
+	 * @param a The first student.
+	 * @param b The second student.
+	 * @param sortingMethod The field to sort by.
+	 * @param sortingType The sorting order (ascending or descending).
+	 * @return True if a comes before b, false if it comes after or they are equal.
+	 */
+	static bool precedes(const Student& a, const Student& b, SortingMethod sortingMethod, SortingType sortingType)
+	{
+		if (sortingMethod == SortBySurname)
+			return sortingType == Descending ? b.surname < a.surname : a.surname < b.surname;
+
+		return sortKey(sortField(a, sortingMethod), sortingType) < sortKey(sortField(b, sortingMethod), sortingType);
+	}
+
+	/**
+	 * @brief Reports the bytes a writer has written since the last report.
+	 * @param progress Progress that receives the bytes, or null.
+	 * @param file The writer.
+	 * @param reportedBytes Bytes of the writer reported so far; updated.
+	 * @return False if the progress has been cancelled, true otherwise.
+	 */
+	static bool reportWritten(OperationProgress* progress, const BufferedWriter& file, std::uint64_t& reportedBytes)
+	{
+		if (progress == nullptr)
+			return true;
+
+		progress->addWritten(file.position() - reportedBytes);
+		reportedBytes = file.position();
+		return !progress->cancelled();
+	}
+
+	/**
+	 * @brief Writes rows of a table in the text format, reporting the bytes written.
+	 * @param file Writer to write to.
+	 * @param table The rows.
+	 * @param order The positions of the rows to write, in output order.
+	 * @param progress Progress that receives the bytes written, or null.
+	 * @return False if the progress was cancelled, true otherwise.
+	 */
+	static bool writeRows(BufferedWriter& file, const StudentTable& table, const std::vector<std::size_t>& order, OperationProgress* progress)
+	{
+		std::uint64_t reportedBytes = file.position();
+		for (std::size_t i = 0; i < order.size(); i++)
+		{
+			writeStudent(file, table[order[i]]);
+			if ((i + 1) % progressReportRecords == 0 && !reportWritten(progress, file, reportedBytes))
+				return false;
+		}
+		return reportWritten(progress, file, reportedBytes);
+	}
+
+	/**
+	 * @brief Sorts the rows of a table and writes them to a run file in the text format.
+	 * @param table The rows of the run.
+	 * @param filename Name of the run file.
+	 * @param sortingMethod The field to sort by.
+	 * @param sortingType The sorting order (ascending or descending).
+	 * @param durable Whether to force the run to the disk, because it becomes the output file.
+	 * @param progress Progress that receives the bytes written, or null.
+	 * @return True if the run was written, false otherwise or if the progress was cancelled.
+	 */
+	static bool writeRun(const StudentTable& table, const std::string& filename, SortingMethod sortingMethod, SortingType sortingType,
+		bool durable, OperationProgress* progress)
+	{
+		BufferedWriter file;
+		if (!file.open(filename))
+			return false;
+
+		bool written = writeRows(file, table, sortOrder(table, sortingMethod, sortingType), progress);
+		if (durable)
+			written = file.sync() && written;
+		return file.close() && written;
+	}
+
+	/**
+	 * @brief Splits the input into sorted runs whose records fit in the memory budget.
+	 * @param inputFilename Name of the text file to sort.
+	 * @param runPrefix Prefix of the run file names.
+	 * @param sortingMethod The field to sort by.
+	 * @param sortingType The sorting order (ascending or descending).
+	 * @param memoryBudget Number of bytes the records of one run may occupy.
+	 * @param runs Receives the names of the written runs, in input order.
+	 * @param progress Progress that receives the records read and the bytes read and written, or null.
+	 * @return True if every run was written, false otherwise or if the progress was cancelled.
+	 */
+	static bool writeRuns(const std::string& inputFilename, const std::string& runPrefix,
+		SortingMethod sortingMethod, SortingType sortingType, std::size_t memoryBudget, RunFiles& runs, OperationProgress* progress)
+	{
+		MappedFile input;
+		if (!input.open(inputFilename))
+			return false;
+
+		StudentParser parser(input.data(), input.data() + input.size());
+		StudentTable table;
+		Student student;
+
+		const char* reportedPosition = input.data();
+		const auto reportRead = [&](std::size_t records) {
+			if (progress == nullptr)
+				return true;
+
+			progress->addRead(records, static_cast<std::uint64_t>(parser.position() - reportedPosition));
+			reportedPosition = parser.position();
+			return !progress->cancelled();
+		};
+
+		bool hasRecord = parser.next(student);
+		while (hasRecord)
+		{
+			table.clear();
+			do
+			{
+				table.append(student);
+				if (table.size() % progressReportRecords == 0 && !reportRead(progressReportRecords))
+					return false;
+				hasRecord = parser.next(student);
+			} while (hasRecord && table.memoryUsage() + table.size() * sortOverheadPerRecord < memoryBudget);
+
+			if (!reportRead(table.size() % progressReportRecords))
+				return false;
+
+			// A single run is renamed over the output, so only that one has to reach the disk
+			const bool onlyRun = runs.names.empty() && !hasRecord;
+			runs.names.push_back(runPrefix + std::to_string(runs.names.size()) + ".tmp");
+			if (!writeRun(table, runs.names.back(), sortingMethod, sortingType, onlyRun, progress))
+				return false;
+		}
+
+		return true;
+	}
+
+	/**
+	 * @brief Merges sorted run files into one text file.
+	 * @param runs The run files, in input order.
+	 * @param filename Name of the merged file.
+	 * @param sortingMethod The field to sort by.
+	 * @param sortingType The sorting order (ascending or descending).
+	 * @param progress Progress that receives the bytes written, or null.
+	 * @return True if the merged file was written, false otherwise or if the progress was cancelled.
+	 */
+	static bool mergeRuns(const RunFiles& runs, const std::string& filename, SortingMethod sortingMethod, SortingType sortingType,
+		OperationProgress* progress)
+	{
+		std::vector<RunCursor> cursors(runs.names.size());
+
+		// The top of the heap is the run whose current record comes first; ties go to the earlier run
+		auto comesAfter = [&](std::size_t x, std::size_t y) {
+			const Student& a = cursors[x].current;
+			const Student& b = cursors[y].current;
+
+			if (precedes(b, a, sortingMethod, sortingType))
+				return true;
+			return !precedes(a, b, sortingMethod, sortingType) && y < x;
+			};
+		std::priority_queue<std::size_t, std::vector<std::size_t>, decltype(comesAfter)> heap(comesAfter);
+
+		for (std::size_t run = 0; run < cursors.size(); run++)
+		{
+			RunCursor& cursor = cursors[run];
+			if (!cursor.file.open(runs.names[run]))
+				return false;
+
+			cursor.parser = StudentParser(cursor.file.data(), cursor.file.data() + cursor.file.size());
+			if (cursor.parser.next(cursor.current))
+				heap.push(run);
+		}
+
+		BufferedWriter output;
+		if (!output.open(filename))
+			return false;
+
+		std::uint64_t reportedBytes = 0;
+		for (std::size_t written = 1; !heap.empty(); written++)
+		{
+			const std::size_t run = heap.top();
+			heap.pop();
+
+			writeStudent(output, makeStudentView(cursors[run].current));
+			if (cursors[run].parser.next(cursors[run].current))
+				heap.push(run);
+
+			if (written % progressReportRecords == 0 && !reportWritten(progress, output, reportedBytes))
+				return false;
+		}
+
+		if (!reportWritten(progress, output, reportedBytes))
+			return false;
+
+		const bool written = output.sync();
+		return output.close() && written;
+	}
+
+	/**
+	 * @brief Sorts a text student file that may not fit in memory.
+	 *
+	 * The input is parsed in chunks whose in-memory size stays within the budget. Every
+	 * chunk is sorted and spilled as a run file next to the output file, and the runs
+	 * are then combined with a k-way heap merge. Ties between runs are resolved in run
+	 * order, so the result is identical to a stable in-memory sort.
+	 *
+	 * The sorted records are written to a temporary file which atomically replaces the
+	 * output file, so the output may be the input file itself.
+	 *
+	 * @param inputFilename Name of the text file to sort.
+	 * @param outputFilename Name of the file that receives the sorted records.
+	 * @param sortingMethod The field to sort by.
+	 * @param sortingType The sorting order (ascending or descending).
+	 * @param memoryBudget Number of bytes the records of one run may occupy.
+	 * @param progress Progress that receives the records read and the bytes read and written, or null.
+	 * @return True if the file was sorted, false if a file could not be read or written or the progress was cancelled.
+	 */
+	bool externalSortStudents(const std::string& inputFilename, const std::string& outputFilename,
+		SortingMethod sortingMethod, SortingType sortingType, std::size_t memoryBudget, OperationProgress* progress)
+	{
+		if (progress != nullptr)
+		{
+			// The input is read once and written twice, as runs and as the merged file
+			std::error_code error;
+			progress->setTotalBytes(3 * std::filesystem::file_size(inputFilename, error));
+		}
+
+		RunFiles runs;
+		if (!writeRuns(inputFilename, outputFilename + ".run", sortingMethod, sortingType, memoryBudget, runs, progress))
+			return false;
+
+		// A single run is already the sorted file
+		if (runs.names.size() == 1)
+			return replaceWithTemporary(runs.names.front(), outputFilename, true);
+
+		const std::string temporaryFilename = outputFilename + ".tmp";
+		const bool merged = mergeRuns(runs, temporaryFilename, sortingMethod, sortingType, progress);
+		return replaceWithTemporary(temporaryFilename, outputFilename, merged);
+	}
+
+	/**
+	 * @brief Sorts a text or binary student file in the fastest way that fits the memory budget.
+	 *
+	 * Binary files are sorted through a memory mapping. Text files have their write-ahead
+	 * log folded in first; they are sorted in memory when they fit the budget and with
+	 * externalSortStudents otherwise. The sorted records are written to a temporary file
+	 * which atomically replaces the output file, so the output may be the input file itself.
+	 *
+	 * @param inputFilename Name of the file to sort.
+	 * @param outputFilename Name of the file that receives the sorted records, in the format of the input.
+	 * @param sortingMethod The field to sort by.
+	 * @param sortingType The sorting order (ascending or descending).
+	 * @param memoryBudget Size of the largest text file sorted in memory, in bytes.
+	 * @param progress Progress that receives the records read and the bytes read and written, or null.
+	 * @return True if the file was sorted, false if a file could not be read or written or the progress was cancelled.
+	 */
+	bool sortStudentFile(const std::string& inputFilename, const std::string& outputFilename,
+		SortingMethod sortingMethod, SortingType sortingType, std::size_t memoryBudget, OperationProgress* progress)
+	{
+		const std::string temporaryFilename = outputFilename + ".tmp";
+
+		if (isBinaryStudentFile(inputFilename))
+		{
+			MappedStudentFile file;
+			if (!file.open(inputFilename))
+				return false;
+
+			// The columns are mapped rather than parsed, so progress is reported once per step
+			std::error_code error;
+			const std::uintmax_t fileSize = std::filesystem::file_size(inputFilename, error);
+			if (progress != nullptr)
+				progress->setTotalBytes(2 * fileSize);
+
+			std::vector<StudentView> sortedStudents;
+			sortedStudents.reserve(file.size());
+			for (std::size_t index : sortOrder(file, sortingMethod, sortingType))
+				sortedStudents.push_back(file[index]);
+
+			if (progress != nullptr)
+			{
+				progress->addRead(file.size(), fileSize);
+				if (progress->cancelled())
+					return false;
+			}
+
+			const bool written = writeStudentsBinary(temporaryFilename, sortedStudents);
+			sortedStudents.clear();
+			file.close();
+
+			if (progress != nullptr)
+				progress->addWritten(fileSize);
+			return replaceWithTemporary(temporaryFilename, outputFilename, written);
+		}
+
+		// Changes still in the write-ahead log are folded in before the file is read
+		if (!checkpointStudentFile(inputFilename))
+			return false;
+
+		std::error_code error;
+		const std::uintmax_t fileSize = std::filesystem::file_size(inputFilename, error);
+		if (error)
+			return false;
+
+		if (fileSize > memoryBudget)
+			return externalSortStudents(inputFilename, outputFilename, sortingMethod, sortingType, memoryBudget, progress);
+
+		if (progress != nullptr)
+			progress->setTotalBytes(2 * fileSize);
+
+		StudentTable table;
+		if (!readStudentTable(inputFilename, table, progress))
+			return false;
+
+		BufferedWriter file;
+		if (!file.open(temporaryFilename))
+			return false;
+
+		bool written = writeRows(file, table, sortOrder(table, sortingMethod, sortingType), progress);
+		written = file.sync() && written;
+		return replaceWithTemporary(temporaryFilename, outputFilename, file.close() && written);
+	}
+
+} // database
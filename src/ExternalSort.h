@@ -0,0 +1,63 @@
+#ifndef EXTERNAL_SORT_H
+#define EXTERNAL_SORT_H
+
+#include <cstddef>
+#include <string>
+
+#include "SortEngine.h"
+
+namespace database
+{
+
+	class OperationProgress;
+
+	inline constexpr std::size_t defaultSortMemoryBudget = std::size_t{ 256 } << 20; ///< Default memory budget of a sort, in bytes.
+
+	/**
+	 * @brief Sorts a text student file that may not fit in memory.
+	 *
+	 * The input is parsed in chunks whose in-memory size stays within the budget. Every
+	 * chunk is sorted and spilled as a run file next to the output file, and the runs
+	 * are then combined with a k-way heap merge. Ties between runs are resolved in run
+	 * order, so the result is identical to a stable in-memory sort.
+	 *
+	 * The sorted records are written to a temporary file which atomically replaces the
+	 * output file, so the output may be the input file itself.
+	 *
+	 * @param inputFilename Name of the text file to sort.
+	 * @param outputFilename Name of the file that receives the sorted records.
+	 * @param sortingMethod The field to sort by.
+	 * @param sortingType The sorting order (ascending or descending).
+	 * @param memoryBudget Number of bytes the records of one run may occupy.
+	 * @param progress Progress that receives the records read and the bytes read and written, or null.
+	 *        Once it is cancelled the sort stops, removes its run files and leaves the output untouched.
+	 * @return True if the file was sorted, false if a file could not be read or written or the progress was cancelled.
+	 */
+	bool externalSortStudents(const std::string& inputFilename, const std::string& outputFilename,
+		SortingMethod sortingMethod, SortingType sortingType, std::size_t memoryBudget = defaultSortMemoryBudget,
+		OperationProgress* progress = nullptr);
+
+	/**
+	 * @brief Sorts a text or binary student file in the fastest way that fits the memory budget.
+	 *
+	 * Binary files are sorted through a memory mapping. Text files have their write-ahead
+	 * log folded in first; they are sorted in memory when they fit the budget and with
+	 * externalSortStudents otherwise. The sorted records are written to a temporary file
+	 * which atomically replaces the output file, so the output may be the input file itself.
+	 *
+	 * @param inputFilename Name of the file to sort.
+	 * @param outputFilename Name of the file that receives the sorted records, in the format of the input.
+	 * @param sortingMethod The field to sort by.
+	 * @param sortingType The sorting order (ascending or descending).
+	 * @param memoryBudget Size of the largest text file sorted in memory, in bytes.
+	 * @param progress Progress that receives the records read and the bytes read and written, or null.
+	 *        Once it is cancelled the sort stops and leaves the output untouched.
+	 * @return True if the file was sorted, false if a file could not be read or written or the progress was cancelled.
+	 */
+	bool sortStudentFile(const std::string& inputFilename, const std::string& outputFilename,
+		SortingMethod sortingMethod, SortingType sortingType, std::size_t memoryBudget = defaultSortMemoryBudget,
+		OperationProgress* progress = nullptr);
+
+} // database
+
+#endif // EXTERNAL_SORT_H
@@ -0,0 +1,69 @@
+#include "FileStorage.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+
+namespace database
+{
+
+	/**
+	 * @brief Reads the list of student files of a storage directory.
+	 * @param path Path to the file list.
+	 * @param files Vector the names are added to; it is sorted alphabetically afterwards.
+	 * @return True if the list was read, false if it could not be opened.
+	 */
+	bool readFileList(const std::string& path, std::vector<std::string>& files)
+	{
+		std::ifstream file(path);
+		if (!file.is_open())
+			return false;
+
+		std::string line;
+		while (std::getline(file, line))
+			files.push_back(line);
+
+		std::sort(files.begin(), files.end());
+		return true;
+	}
+
+	/**
+	 * @brief Writes the list of student files of a storage directory.
+	 * @param path Path to the file list.
+	 * @param files The names of the files, one per line.
+	 * @return True if the list was written, false otherwise.
+	 */
+	bool writeFileList(const std::string& path, const std::vector<std::string>& files)
+	{
+		std::ofstream file(path);
+		if (!file.is_open())
+			return false;
+
+		for (const auto& fileName : files)
+			file << fileName << '\n';
+
+		return static_cast<bool>(file.flush());
+	}
+
+	/**
+	 * @brief Adds a student file to the file list of the directory it is in.
+	 * @param dataFilename Path to the student file.
+	 * @return True if the file is listed, false if the list could not be written.
+	 */
+	bool registerStorageFile(const std::string& dataFilename)
+	{
+		const std::filesystem::path data(dataFilename);
+		const std::string listPath = (data.parent_path() / fileStorageName).string();
+		const std::string name = data.filename().string();
+
+		std::vector<std::string> files;
+		readFileList(listPath, files);
+		if (std::find(files.begin(), files.end(), name) != files.end())
+			return true;
+
+		files.push_back(name);
+		std::sort(files.begin(), files.end());
+		return writeFileList(listPath, files);
+	}
+
+} // database
@@ -0,0 +1,41 @@
+#ifndef FILE_STORAGE_H
+#define FILE_STORAGE_H
+
+#include <string>
+#include <vector>
+
+namespace database
+{
+
+	inline constexpr char fileStorageName[] = "fileStorage.txt"; ///< Name of the list of student files in a storage directory.
+
+	/**
+	 * @brief Reads the list of student files of a storage directory.
+	 * @param path Path to the file list.
+	 * @param files Vector the names are added to; it is sorted alphabetically afterwards.
+	 * @return True if the list was read, false if it could not be opened.
+	 */
+	bool readFileList(const std::string& path, std::vector<std::string>& files);
+
+	/**
+	 * @brief Writes the list of student files of a storage directory.
+	 * @param path Path to the file list.
+	 * @param files The names of the files, one per line.
+	 * @return True if the list was written, false otherwise.
+	 */
+	bool writeFileList(const std::string& path, const std::vector<std::string>& files);
+
+	/**
+	 * @brief Adds a student file to the file list of the directory it is in.
+	 *
+	 * The console interface shows the files of that list, so a file created outside
+	 * of it in the storage directory can be opened there once it is registered.
+	 *
+	 * @param dataFilename Path to the student file.
+	 * @return True if the file is listed, false if the list could not be written.
+	 */
+	bool registerStorageFile(const std::string& dataFilename);
+
+} // database
+
+#endif // FILE_STORAGE_H
@@ -0,0 +1,381 @@
+#include "GradeKernels.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "StudentTable.h"
+
+#if defined(_M_X64) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define GRADE_KERNELS_SSE2
+#include <emmintrin.h>
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define AVX2_TARGET
+#else
+#define AVX2_TARGET __attribute__((target("avx2")))
+#endif
+#endif
+
+namespace database
+{
+
+	static constexpr std::size_t kernelBatchRanges = 3072; ///< Ranges whose sums are kept on the stack at a time.
+
+	/**
+	 * @brief Sums a range of scores one at a time; the reference for the vector kernels.
+	 * @param scores The flattened scores.
+	 * @param first Position of the first score.
+	 * @param last Position after the last score.
+	 * @return The sum of the range.
+	 */
+	static std::uint64_t sumRangeScalar(const std::uint16_t* scores, std::uint64_t first, std::uint64_t last)
+	{
+		std::uint64_t sum = 0;
+		for (std::uint64_t i = first; i < last; i++)
+			sum += scores[i];
+		return sum;
+	}
+
+#ifdef GRADE_KERNELS_SSE2
+
+	// Every vector step adds two scores of at most 65535 to each 32-bit lane, so a lane
+	// holds the sum of this many steps without overflowing
+	static constexpr std::uint64_t laneBlockSteps = 32768;
+
+	/// Sixteen set lanes followed by sixteen clear ones; loading from 16 - n gives a mask of the first n lanes.
+	alignas(32) static const std::uint16_t laneMasks[32] = {
+		0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF,
+		0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF
+	};
+
+	/**
+	 * @brief Adds the 32-bit lanes of a vector.
+	 * @param lanes The vector.
+	 * @return The sum of its lanes.
+	 */
+	static std::uint64_t sumLanes(__m128i lanes)
+	{
+		alignas(16) std::uint32_t values[4];
+		_mm_store_si128(reinterpret_cast<__m128i*>(values), lanes);
+		return std::uint64_t{ values[0] } + values[1] + values[2] + values[3];
+	}
+
+	/**
+	 * @brief Adds the 32-bit lanes of a vector whose total fits in 32 bits, without leaving the registers.
+	 * @param lanes The vector.
+	 * @return The sum of its lanes.
+	 */
+	static std::uint32_t sumSmallLanes(__m128i lanes)
+	{
+		lanes = _mm_add_epi32(lanes, _mm_shuffle_epi32(lanes, 0x4E));
+		lanes = _mm_add_epi32(lanes, _mm_shuffle_epi32(lanes, 0xB1));
+		return static_cast<std::uint32_t>(_mm_cvtsi128_si32(lanes));
+	}
+
+	/**
+	 * @brief Sums a range of scores eight at a time with SSE2.
+	 *
+	 * A tail shorter than a vector is loaded whole with its extra lanes masked off
+	 * when the array extends far enough, and summed one at a time otherwise.
+	 *
+	 * @param scores The flattened scores.
+	 * @param size Number of scores in the array.
+	 * @param first Position of the first score.
+	 * @param last Position after the last score.
+	 * @return The sum of the range.
+	 */
+	static std::uint64_t sumRangeSse2(const std::uint16_t* scores, std::uint64_t size, std::uint64_t first, std::uint64_t last)
+	{
+		const __m128i zero = _mm_setzero_si128();
+		std::uint64_t sum = 0;
+
+		while (last - first >= 8)
+		{
+			const std::uint64_t blockEnd = first + (std::min)((last - first) / 8, laneBlockSteps) * 8;
+			__m128i lanes = zero;
+			for (; first < blockEnd; first += 8)
+			{
+				const __m128i values = _mm_loadu_si128(reinterpret_cast<const __m128i*>(scores + first));
+				lanes = _mm_add_epi32(lanes, _mm_add_epi32(_mm_unpacklo_epi16(values, zero), _mm_unpackhi_epi16(values, zero)));
+			}
+			sum += sumLanes(lanes);
+		}
+
+		const std::uint64_t rest = last - first;
+		if (rest == 0)
+			return sum;
+		if (first + 8 > size)
+			return sum + sumRangeScalar(scores, first, last);
+
+		// Fewer than eight scores sum to less than 2^19, so the lanes are added in 32 bits
+		const __m128i mask = _mm_loadu_si128(reinterpret_cast<const __m128i*>(laneMasks + 16 - rest));
+		const __m128i values = _mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(scores + first)), mask);
+		return sum + sumSmallLanes(_mm_add_epi32(_mm_unpacklo_epi16(values, zero), _mm_unpackhi_epi16(values, zero)));
+	}
+
+	/**
+	 * @brief Sums ranges of scores with SSE2.
+	 * @param scores The flattened scores.
+	 * @param offsets The range boundaries.
+	 * @param sums Receives the sums.
+	 */
+	static void sumRangesSse2(std::span<const std::uint16_t> scores, std::span<const std::uint64_t> offsets, std::span<std::uint64_t> sums)
+	{
+		for (std::size_t i = 0; i < sums.size(); i++)
+			sums[i] = sumRangeSse2(scores.data(), scores.size(), offsets[i], offsets[i + 1]);
+	}
+
+	/**
+	 * @brief Widens sixteen scores to 32 bits and adds them to eight lanes.
+	 * @param lanes The running lane sums.
+	 * @param values The scores.
+	 * @return The new lane sums.
+	 */
+	AVX2_TARGET static __m256i addWidened(__m256i lanes, __m256i values)
+	{
+		const __m256i low = _mm256_cvtepu16_epi32(_mm256_castsi256_si128(values));
+		const __m256i high = _mm256_cvtepu16_epi32(_mm256_extracti128_si256(values, 1));
+		return _mm256_add_epi32(lanes, _mm256_add_epi32(low, high));
+	}
+
+	/**
+	 * @brief Adds the 32-bit lanes of a 256-bit vector.
+	 * @param lanes The vector.
+	 * @return The sum of its lanes.
+	 */
+	AVX2_TARGET static std::uint64_t sumLanes(__m256i lanes)
+	{
+		alignas(32) std::uint32_t values[8];
+		_mm256_store_si256(reinterpret_cast<__m256i*>(values), lanes);
+
+		std::uint64_t sum = 0;
+		for (std::uint32_t value : values)
+			sum += value;
+		return sum;
+	}
+
+	/**
+	 * @brief Sums a range of scores sixteen at a time with AVX2.
+	 *
+	 * Nothing compiled without AVX is called from here: legacy SSE code run while the
+	 * upper halves of the registers are in use stalls on every instruction.
+	 *
+	 * @param scores The flattened scores.
+	 * @param size Number of scores in the array.
+	 * @param first Position of the first score.
+	 * @param last Position after the last score.
+	 * @return The sum of the range.
+	 */
+	AVX2_TARGET static std::uint64_t sumRangeAvx2(const std::uint16_t* scores, std::uint64_t size, std::uint64_t first, std::uint64_t last)
+	{
+		std::uint64_t sum = 0;
+
+		while (last - first >= 16)
+		{
+			const std::uint64_t blockEnd = first + (std::min)((last - first) / 16, laneBlockSteps) * 16;
+			__m256i lanes = _mm256_setzero_si256();
+			for (; first < blockEnd; first += 16)
+				lanes = addWidened(lanes, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(scores + first)));
+			sum += sumLanes(lanes);
+		}
+
+		const std::uint64_t rest = last - first;
+		if (rest == 0)
+			return sum;
+		if (first + 16 > size)
+		{
+			for (; first < last; first++)
+				sum += scores[first];
+			return sum;
+		}
+
+		const __m256i mask = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(laneMasks + 16 - rest));
+		const __m256i values = _mm256_and_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(scores + first)), mask);
+		const __m256i lanes = addWidened(_mm256_setzero_si256(), values);
+		return sum + sumSmallLanes(_mm_add_epi32(_mm256_castsi256_si128(lanes), _mm256_extracti128_si256(lanes, 1)));
+	}
+
+	/**
+	 * @brief Sums ranges of scores with AVX2, and those shorter than one vector with SSE2.
+	 *
+	 * The function itself is not compiled for AVX2, so the SSE2 loop is inlined for the
+	 * short ranges and only a range long enough to gain from the wider loop pays for a call.
+	 *
+	 * @param scores The flattened scores.
+	 * @param offsets The range boundaries.
+	 * @param sums Receives the sums.
+	 */
+	static void sumRangesAvx2(std::span<const std::uint16_t> scores, std::span<const std::uint64_t> offsets, std::span<std::uint64_t> sums)
+	{
+		for (std::size_t i = 0; i < sums.size(); i++)
+		{
+			sums[i] = offsets[i + 1] - offsets[i] >= 16
+				? sumRangeAvx2(scores.data(), scores.size(), offsets[i], offsets[i + 1])
+				: sumRangeSse2(scores.data(), scores.size(), offsets[i], offsets[i + 1]);
+		}
+	}
+
+	/**
+	 * @brief Checks whether the processor and the operating system support AVX2.
+	 * @return True if AVX2 instructions can be executed, false otherwise.
+	 */
+	static bool detectAvx2()
+	{
+#ifdef _MSC_VER
+		int info[4];
+		__cpuid(info, 0);
+		if (info[0] < 7)
+			return false;
+
+		// The operating system has to save the YMM registers on context switches
+		__cpuid(info, 1);
+		const bool osSavesYmm = (info[2] & (1 << 27)) && (_xgetbv(0) & 6) == 6;
+		__cpuidex(info, 7, 0);
+		return osSavesYmm && (info[1] & (1 << 5));
+#else
+		return __builtin_cpu_supports("avx2");
+#endif
+	}
+
+#endif // GRADE_KERNELS_SSE2
+
+	/**
+	 * @brief Returns the fastest grade kernel the processor supports.
+	 * @return AVX2 or SSE2 on x86 processors that have them, the scalar kernel otherwise.
+	 */
+	GradeKernel bestGradeKernel()
+	{
+		static const GradeKernel best = gradeKernelSupported(Avx2GradeKernel) ? Avx2GradeKernel
+			: gradeKernelSupported(Sse2GradeKernel) ? Sse2GradeKernel : ScalarGradeKernel;
+		return best;
+	}
+
+	/**
+	 * @brief Checks whether the processor can run a grade kernel.
+	 * @param kernel The kernel to check.
+	 * @return True if the kernel can be used, false otherwise.
+	 */
+	bool gradeKernelSupported(GradeKernel kernel)
+	{
+		switch (kernel)
+		{
+		case ScalarGradeKernel:
+			return true;
+#ifdef GRADE_KERNELS_SSE2
+		case Sse2GradeKernel:
+			return true;
+		case Avx2GradeKernel:
+		{
+			static const bool avx2 = detectAvx2();
+			return avx2;
+		}
+#endif
+		default:
+			return false;
+		}
+	}
+
+	/**
+	 * @brief Returns the name of a grade kernel.
+	 * @param kernel The kernel.
+	 * @return "scalar", "sse2" or "avx2".
+	 */
+	const char* gradeKernelName(GradeKernel kernel)
+	{
+		switch (kernel)
+		{
+		case Sse2GradeKernel:
+			return "sse2";
+		case Avx2GradeKernel:
+			return "avx2";
+		default:
+			return "scalar";
+		}
+	}
+
+	/**
+	 * @brief Sums consecutive ranges of a flattened score array.
+	 * @param scores The flattened scores.
+	 * @param offsets The range boundaries, one more than the number of ranges.
+	 * @param sums Receives the sum of every range; holds one entry per range.
+	 * @param kernel The kernel to use; it falls back to the scalar one if unsupported.
+	 */
+	void sumScoreRanges(std::span<const std::uint16_t> scores, std::span<const std::uint64_t> offsets,
+		std::span<std::uint64_t> sums, GradeKernel kernel)
+	{
+		if (!gradeKernelSupported(kernel))
+			kernel = ScalarGradeKernel;
+
+#ifdef GRADE_KERNELS_SSE2
+		if (kernel == Avx2GradeKernel)
+		{
+			sumRangesAvx2(scores, offsets, sums);
+			return;
+		}
+		if (kernel == Sse2GradeKernel)
+		{
+			sumRangesSse2(scores, offsets, sums);
+			return;
+		}
+#endif
+
+		for (std::size_t i = 0; i < sums.size(); i++)
+			sums[i] = sumRangeScalar(scores.data(), offsets[i], offsets[i + 1]);
+	}
+
+	/**
+	 * @brief Computes the mean of consecutive ranges of a flattened score array.
+	 * @param scores The flattened scores.
+	 * @param offsets The range boundaries, one more than the number of ranges.
+	 * @param means Receives the mean of every range; holds one entry per range.
+	 * @param kernel The kernel to use; it falls back to the scalar one if unsupported.
+	 */
+	void averageScoreRanges(std::span<const std::uint16_t> scores, std::span<const std::uint64_t> offsets,
+		std::span<double> means, GradeKernel kernel)
+	{
+		std::uint64_t sums[kernelBatchRanges];
+		for (std::size_t first = 0; first < means.size(); first += kernelBatchRanges)
+		{
+			const std::size_t count = (std::min)(means.size() - first, kernelBatchRanges);
+			sumScoreRanges(scores, offsets.subspan(first, count + 1), std::span<std::uint64_t>(sums, count), kernel);
+
+			// The sums are exact, so the division gives what calculateAverageValue gives
+			for (std::size_t i = 0; i < count; i++)
+				means[first + i] = static_cast<double>(sums[i]) / static_cast<double>(offsets[first + i + 1] - offsets[first + i]);
+		}
+	}
+
+	/**
+	 * @brief Recomputes the subject averages and the GPA of every student of a table.
+	 * @param table The table whose averages are recomputed.
+	 * @param kernel The kernel to use; it falls back to the scalar one if unsupported.
+	 */
+	void recalculateAverages(StudentTable& table, GradeKernel kernel)
+	{
+		const std::span<const std::uint64_t> offsets = table.scoreOffsets();
+		const std::span<double> phisics = table.averagePhisicsGrades();
+		const std::span<double> math = table.averageMathGrades();
+		const std::span<double> inform = table.averageInformGrades();
+		const std::span<double> overall = table.averageGrades();
+
+		double means[kernelBatchRanges];
+		constexpr std::size_t batchStudents = kernelBatchRanges / 3;
+
+		for (std::size_t first = 0; first < table.size(); first += batchStudents)
+		{
+			const std::size_t count = (std::min)(table.size() - first, batchStudents);
+			averageScoreRanges(table.scores(), offsets.subspan(3 * first, 3 * count + 1), std::span<double>(means, 3 * count), kernel);
+
+			for (std::size_t i = 0; i < count; i++)
+			{
+				phisics[first + i] = means[3 * i];
+				math[first + i] = means[3 * i + 1];
+				inform[first + i] = means[3 * i + 2];
+				overall[first + i] = (std::round(means[3 * i]) + std::round(means[3 * i + 1]) + std::round(means[3 * i + 2])) / 3;
+			}
+		}
+	}
+
+} // namespace database
@@ -0,0 +1,83 @@
+#ifndef GRADE_KERNELS_H
+#define GRADE_KERNELS_H
+
+#include <cstdint>
+#include <span>
+
+namespace database
+{
+	class StudentTable;
+
+	enum GradeKernel : std::uint8_t
+	{
+		ScalarGradeKernel,
+		Sse2GradeKernel,
+		Avx2GradeKernel
+	};
+
+	/**
+	 * @brief Returns the fastest grade kernel the processor supports.
+	 *
+	 * The AVX2 kernel runs its wide loop only on ranges of at least sixteen scores and
+	 * sums shorter ones with SSE2, so it is never slower than the SSE2 kernel.
+	 *
+	 * @return AVX2 or SSE2 on x86 processors that have them, the scalar kernel otherwise.
+	 */
+	GradeKernel bestGradeKernel();
+
+	/**
+	 * @brief Checks whether the processor can run a grade kernel.
+	 * @param kernel The kernel to check.
+	 * @return True if the kernel can be used, false otherwise.
+	 */
+	bool gradeKernelSupported(GradeKernel kernel);
+
+	/**
+	 * @brief Returns the name of a grade kernel.
+	 * @param kernel The kernel.
+	 * @return "scalar", "sse2" or "avx2".
+	 */
+	const char* gradeKernelName(GradeKernel kernel);
+
+	/**
+	 * @brief Sums consecutive ranges of a flattened score array.
+	 *
+	 * Range i spans [offsets[i], offsets[i + 1]). The vector kernels widen the scores
+	 * to 32-bit lanes and move the lanes into the 64-bit result before they can
+	 * overflow, so every kernel returns the exact sums.
+	 *
+	 * @param scores The flattened scores.
+	 * @param offsets The range boundaries, one more than the number of ranges.
+	 * @param sums Receives the sum of every range; holds one entry per range.
+	 * @param kernel The kernel to use; it falls back to the scalar one if unsupported.
+	 */
+	void sumScoreRanges(std::span<const std::uint16_t> scores, std::span<const std::uint64_t> offsets,
+		std::span<std::uint64_t> sums, GradeKernel kernel = bestGradeKernel());
+
+	/**
+	 * @brief Computes the mean of consecutive ranges of a flattened score array.
+	 *
+	 * The means are bit-identical to calculateAverageValue of the same scores.
+	 *
+	 * @param scores The flattened scores.
+	 * @param offsets The range boundaries, one more than the number of ranges.
+	 * @param means Receives the mean of every range; holds one entry per range.
+	 * @param kernel The kernel to use; it falls back to the scalar one if unsupported.
+	 */
+	void averageScoreRanges(std::span<const std::uint16_t> scores, std::span<const std::uint64_t> offsets,
+		std::span<double> means, GradeKernel kernel = bestGradeKernel());
+
+	/**
+	 * @brief Recomputes the subject averages and the GPA of every student of a table.
+	 *
+	 * The results are bit-identical to calculateAverageValue and calculateAverageGrade
+	 * applied to every student.
+	 *
+	 * @param table The table whose averages are recomputed.
+	 * @param kernel The kernel to use; it falls back to the scalar one if unsupported.
+	 */
+	void recalculateAverages(StudentTable& table, GradeKernel kernel = bestGradeKernel());
+
+} // namespace database
+
+#endif // GRADE_KERNELS_H
@@ -0,0 +1,169 @@
+#include "MappedFile.h"
+
+#include <utility>
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace database
+{
+
+	MappedFile::~MappedFile()
+	{
+		close();
+	}
+
+	MappedFile::MappedFile(MappedFile&& other) noexcept
+	{
+		*this = std::move(other);
+	}
+
+	MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+	{
+		if (this != &other)
+		{
+			close();
+
+			mappedData = std::exchange(other.mappedData, nullptr);
+			mappedSize = std::exchange(other.mappedSize, 0);
+			opened = std::exchange(other.opened, false);
+#ifdef _WIN32
+			fileHandle = std::exchange(other.fileHandle, nullptr);
+			mappingHandle = std::exchange(other.mappingHandle, nullptr);
+#else
+			fileDescriptor = std::exchange(other.fileDescriptor, -1);
+#endif
+		}
+		return *this;
+	}
+
+#ifdef _WIN32
+
+	/**
+	 * @brief Maps a file into memory for reading.
+	 * @param filename Name of the file to map.
+	 * @return True if the file was mapped successfully, false otherwise.
+	 */
+	bool MappedFile::open(const std::string& filename)
+	{
+		close();
+
+		HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+			OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if (file == INVALID_HANDLE_VALUE)
+			return false;
+
+		LARGE_INTEGER fileSize{};
+		if (!GetFileSizeEx(file, &fileSize))
+		{
+			CloseHandle(file);
+			return false;
+		}
+
+		fileHandle = file;
+		opened = true;
+
+		if (fileSize.QuadPart == 0)
+			return true;
+
+		HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (mapping == nullptr)
+		{
+			close();
+			return false;
+		}
+		mappingHandle = mapping;
+
+		void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+		if (view == nullptr)
+		{
+			close();
+			return false;
+		}
+
+		mappedData = static_cast<const char*>(view);
+		mappedSize = static_cast<std::size_t>(fileSize.QuadPart);
+		return true;
+	}
+
+	/** @brief Unmaps the file and releases all handles. */
+	void MappedFile::close()
+	{
+		if (mappedData != nullptr)
+			UnmapViewOfFile(mappedData);
+		if (mappingHandle != nullptr)
+			CloseHandle(mappingHandle);
+		if (fileHandle != nullptr)
+			CloseHandle(fileHandle);
+
+		mappedData = nullptr;
+		mappedSize = 0;
+		mappingHandle = nullptr;
+		fileHandle = nullptr;
+		opened = false;
+	}
+
+#else
+
+	/**
+	 * @brief Maps a file into memory for reading.
+	 * @param filename Name of the file to map.
+	 * @return True if the file was mapped successfully, false otherwise.
+	 */
+	bool MappedFile::open(const std::string& filename)
+	{
+		close();
+
+		int descriptor = ::open(filename.c_str(), O_RDONLY);
+		if (descriptor < 0)
+			return false;
+
+		struct stat fileInfo {};
+		if (fstat(descriptor, &fileInfo) != 0)
+		{
+			::close(descriptor);
+			return false;
+		}
+
+		fileDescriptor = descriptor;
+		opened = true;
+
+		if (fileInfo.st_size == 0)
+			return true;
+
+		void* view = mmap(nullptr, static_cast<std::size_t>(fileInfo.st_size), PROT_READ, MAP_PRIVATE, descriptor, 0);
+		if (view == MAP_FAILED)
+		{
+			close();
+			return false;
+		}
+		madvise(view, static_cast<std::size_t>(fileInfo.st_size), MADV_SEQUENTIAL);
+
+		mappedData = static_cast<const char*>(view);
+		mappedSize = static_cast<std::size_t>(fileInfo.st_size);
+		return true;
+	}
+
+	/** @brief Unmaps the file and releases all handles. */
+	void MappedFile::close()
+	{
+		if (mappedData != nullptr)
+			munmap(const_cast<char*>(mappedData), mappedSize);
+		if (fileDescriptor >= 0)
+			::close(fileDescriptor);
+
+		mappedData = nullptr;
+		mappedSize = 0;
+		fileDescriptor = -1;
+		opened = false;
+	}
+
+#endif
+
+} // database
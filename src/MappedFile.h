@@ -0,0 +1,62 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <string>
+
+namespace database
+{
+
+	/**
+	 * @brief Read-only memory mapping of a whole file.
+	 *
+	 * The mapping is released when the object is closed or destroyed. Empty files
+	 * are opened successfully with a null data pointer and a size of zero.
+	 */
+	class MappedFile
+	{
+	public:
+		MappedFile() = default;
+		~MappedFile();
+
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+
+		MappedFile(MappedFile&& other) noexcept;
+		MappedFile& operator=(MappedFile&& other) noexcept;
+
+		/**
+		 * @brief Maps a file into memory for reading.
+		 * @param filename Name of the file to map.
+		 * @return True if the file was mapped successfully, false otherwise.
+		 */
+		bool open(const std::string& filename);
+
+		/** @brief Unmaps the file and releases all handles. */
+		void close();
+
+		/** @brief Checks whether a file is currently mapped. */
+		bool isOpen() const { return opened; }
+
+		/** @brief Returns the first byte of the mapping. */
+		const char* data() const { return mappedData; }
+
+		/** @brief Returns the size of the mapping in bytes. */
+		std::size_t size() const { return mappedSize; }
+
+	private:
+		const char* mappedData = nullptr;
+		std::size_t mappedSize = 0;
+		bool opened = false;
+
+#ifdef _WIN32
+		void* fileHandle = nullptr;
+		void* mappingHandle = nullptr;
+#else
+		int fileDescriptor = -1;
+#endif
+	};
+
+} // database
+
+#endif // MAPPED_FILE_H
@@ -0,0 +1,146 @@
+#include "MappedStudentFile.h"
+
+#include <bit>
+#include <cstring>
+
+#include "StudentBinary.h"
+
+namespace database
+{
+
+	static_assert(std::endian::native == std::endian::little, "The mapped columns are read in host byte order");
+
+	/**
+	 * @brief Returns a typed pointer to a section of the mapped file.
+	 * @param base First byte of the mapping.
+	 * @param offset Byte offset of the section.
+	 * @return Pointer to the first element of the section.
+	 */
+	template <typename T>
+	static const T* sectionAt(const char* base, std::uint64_t offset)
+	{
+		return reinterpret_cast<const T*>(base + offset);
+	}
+
+	/**
+	 * @brief Checks that an offset column is monotonic and stays within its heap.
+	 * @param offsets The offsets to validate.
+	 * @param heapSize The number of elements in the heap the offsets point into.
+	 * @return True if the offsets are consistent, false otherwise.
+	 */
+	static bool checkOffsets(std::span<const std::uint64_t> offsets, std::uint64_t heapSize)
+	{
+		for (std::size_t i = 1; i < offsets.size(); i++)
+		{
+			if (offsets[i] < offsets[i - 1])
+				return false;
+		}
+		return !offsets.empty() && offsets.front() == 0 && offsets.back() == heapSize;
+	}
+
+	/**
+	 * @brief Maps a binary student file and validates its layout.
+	 * @param filename Name of the file to open.
+	 * @return True if the file is a valid binary student file, false otherwise.
+	 */
+	bool MappedStudentFile::open(const std::string& filename)
+	{
+		close();
+
+		if (!file.open(filename) || file.size() < sizeof(BinaryFileHeader))
+		{
+			close();
+			return false;
+		}
+
+		BinaryFileHeader header{};
+		std::memcpy(&header, file.data(), sizeof(header));
+
+		if (std::memcmp(header.magic, binaryFileMagic, sizeof(header.magic)) != 0 || header.version != binaryFileVersion)
+		{
+			close();
+			return false;
+		}
+
+		// Reject counts that cannot possibly fit before computing the layout, so it cannot overflow
+		const std::uint64_t fileSize = file.size();
+		if (header.studentCount > fileSize || header.surnameHeapSize > fileSize || header.scoreHeapSize > fileSize)
+		{
+			close();
+			return false;
+		}
+
+		const BinaryFileLayout layout = computeBinaryLayout(header);
+		if (layout.fileSize != fileSize)
+		{
+			close();
+			return false;
+		}
+
+		const std::size_t count = static_cast<std::size_t>(header.studentCount);
+		const char* base = file.data();
+
+		groupNumberColumn = { sectionAt<std::uint64_t>(base, layout.groupNumbers), count };
+		averagePhisicsGradeColumn = { sectionAt<double>(base, layout.averagePhisicsGrades), count };
+		averageMathGradeColumn = { sectionAt<double>(base, layout.averageMathGrades), count };
+		averageInformGradeColumn = { sectionAt<double>(base, layout.averageInformGrades), count };
+		averageGradeColumn = { sectionAt<double>(base, layout.averageGrades), count };
+		surnameOffsets = { sectionAt<std::uint64_t>(base, layout.surnameOffsets), count + 1 };
+		scoreOffsets = { sectionAt<std::uint64_t>(base, layout.scoreOffsets), 3 * count + 1 };
+		surnameHeap = base + layout.surnameHeap;
+		scoreHeap = sectionAt<std::uint16_t>(base, layout.scoreHeap);
+
+		if (!checkOffsets(surnameOffsets, header.surnameHeapSize) || !checkOffsets(scoreOffsets, header.scoreHeapSize))
+		{
+			close();
+			return false;
+		}
+
+		return true;
+	}
+
+	/** @brief Unmaps the file; views obtained earlier become invalid. */
+	void MappedStudentFile::close()
+	{
+		file.close();
+
+		groupNumberColumn = {};
+		averagePhisicsGradeColumn = {};
+		averageMathGradeColumn = {};
+		averageInformGradeColumn = {};
+		averageGradeColumn = {};
+		surnameOffsets = {};
+		scoreOffsets = {};
+		surnameHeap = nullptr;
+		scoreHeap = nullptr;
+	}
+
+	/** @brief Returns the surname of the student at the given position without building a full view. */
+	std::string_view MappedStudentFile::surname(std::size_t index) const
+	{
+		return { surnameHeap + surnameOffsets[index], static_cast<std::size_t>(surnameOffsets[index + 1] - surnameOffsets[index]) };
+	}
+
+	/**
+	 * @brief Returns a view of the student at the given position.
+	 * @param index Position of the student in the file.
+	 * @return A view pointing into the mapped file.
+	 */
+	StudentView MappedStudentFile::operator[](std::size_t index) const
+	{
+		const std::uint64_t* scores = scoreOffsets.data() + 3 * index;
+
+		StudentView view;
+		view.surname = surname(index);
+		view.groupNumber = groupNumberColumn[index];
+		view.phisicsScores = { scoreHeap + scores[0], static_cast<std::size_t>(scores[1] - scores[0]) };
+		view.mathScores = { scoreHeap + scores[1], static_cast<std::size_t>(scores[2] - scores[1]) };
+		view.informScores = { scoreHeap + scores[2], static_cast<std::size_t>(scores[3] - scores[2]) };
+		view.averagePhisicsGrade = averagePhisicsGradeColumn[index];
+		view.averageMathGrade = averageMathGradeColumn[index];
+		view.averageInformGrade = averageInformGradeColumn[index];
+		view.averageGrade = averageGradeColumn[index];
+		return view;
+	}
+
+} // database
@@ -0,0 +1,68 @@
+#ifndef MAPPED_STUDENT_FILE_H
+#define MAPPED_STUDENT_FILE_H
+
+#include <cstdint>
+#include <span>
+#include <string>
+
+#include "MappedFile.h"
+#include "Student.h"
+
+namespace database
+{
+
+	/**
+	 * @brief Zero-copy reader for binary student files.
+	 *
+	 * The file is mapped into memory and every record is exposed as a StudentView
+	 * pointing straight into the mapped columns, so reading a record allocates nothing.
+	 */
+	class MappedStudentFile
+	{
+	public:
+		/**
+		 * @brief Maps a binary student file and validates its layout.
+		 * @param filename Name of the file to open.
+		 * @return True if the file is a valid binary student file, false otherwise.
+		 */
+		bool open(const std::string& filename);
+
+		/** @brief Unmaps the file; views obtained earlier become invalid. */
+		void close();
+
+		/** @brief Returns the number of students in the file. */
+		std::size_t size() const { return groupNumberColumn.size(); }
+
+		/**
+		 * @brief Returns a view of the student at the given position.
+		 * @param index Position of the student in the file.
+		 * @return A view pointing into the mapped file.
+		 */
+		StudentView operator[](std::size_t index) const;
+
+		/** @brief Returns the surname of the student at the given position without building a full view. */
+		std::string_view surname(std::size_t index) const;
+
+		std::span<const std::uint64_t> groupNumbers() const { return groupNumberColumn; }
+		std::span<const double> averagePhisicsGrades() const { return averagePhisicsGradeColumn; }
+		std::span<const double> averageMathGrades() const { return averageMathGradeColumn; }
+		std::span<const double> averageInformGrades() const { return averageInformGradeColumn; }
+		std::span<const double> averageGrades() const { return averageGradeColumn; }
+
+	private:
+		MappedFile file;
+
+		std::span<const std::uint64_t> groupNumberColumn;
+		std::span<const double> averagePhisicsGradeColumn;
+		std::span<const double> averageMathGradeColumn;
+		std::span<const double> averageInformGradeColumn;
+		std::span<const double> averageGradeColumn;
+		std::span<const std::uint64_t> surnameOffsets;
+		std::span<const std::uint64_t> scoreOffsets;
+		const char* surnameHeap = nullptr;
+		const std::uint16_t* scoreHeap = nullptr;
+	};
+
+} // database
+
+#endif // MAPPED_STUDENT_FILE_H
@@ -1,9 +1,13 @@
 #include "AddFileMenu.h"
-#include <fstream>
 #include "../../consoleGUI/GUI.h"
 #include "../Utils.h"
 #include "../global.h"
 #include "../Student.h"
+#include "../StudentInput.h"
+#include "../StudentBinary.h"
+#include "../StudentImport.h"
+#include "../StudentLog.h"
+#include "../StudentSidecars.h"
 #include "../Widgets/FileSlider.h"
 
 using namespace widgets;
@@ -43,26 +47,77 @@ namespace database {
 
     /**
      * @brief Adds a student to a specified file.
-     * Opens a file, creates a new student, and appends the student information to the file.
+     * Creates a new student and adds its information to the file. Text files take the
+     * record through their write-ahead log, which is folded into the file once it grows
+     * past the checkpoint threshold; binary files are rewritten with the record appended,
+     * and their sidecar index and existing B+-trees are updated with it.
      *
      * @param path The path to the file where the student will be added.
      */
     static void addStudentToFile(const std::string& path) {
         Student student = createStudent();
-        std::ofstream file("storage/" + path, std::ios::app);
 
-        if (!file.is_open()) {
+        // Binary files keep their columns at fixed offsets, so they are rewritten as a whole
+        if (isBinaryStudentFile("storage/" + path)) {
+            StudentSidecars sidecars;
+            sidecars.open("storage/" + path);
+
+            std::vector<Student> students;
+            if (!readStudentsBinary("storage/" + path, students)) {
+                Utils::applicationErrorWindow("ERROR OPENING FILE", 61, 9, 30, 10);
+                return;
+            }
+
+            const std::uint64_t recordOffset = students.size();
+            students.push_back(student);
+            if (!writeStudentsBinary("storage/" + path, students)) {
+                Utils::applicationErrorWindow("ERROR OPENING FILE", 61, 9, 30, 10);
+                return;
+            }
+
+            sidecars.append(makeStudentView(student), recordOffset);
+            return;
+        }
+
+        StudentLog log;
+        if (!log.open("storage/" + path)) {
             Utils::applicationErrorWindow("ERROR OPENING FILE", 61, 9, 30, 10);
             return;
         }
 
-        writeStudent(file, student);
-        file.close();
+        log.addStudent(student);
+        if (!log.commit() || (log.size() >= logCheckpointThreshold && !log.checkpoint()))
+            Utils::applicationErrorWindow("ERROR WRITING FILE", 61, 9, 30, 10);
     }
 
     /**
-     * @brief Handles file interaction by adding a student to the file.
-     * If the path is valid, the function will add the student to the file and re-render the menu.
+     * @brief Imports students from a CSV or TSV export into a specified file.
+     * Asks for the path of the export, imports it and reports how many rows were added
+     * and how many were written to the reject file.
+     *
+     * @param path The path to the file where the students will be added.
+     */
+    static void importStudentsToFile(const std::string& path) {
+        std::string sourcePath;
+        std::cout << "ENTER THE PATH OF THE CSV OR TSV FILE:" << std::endl;
+        getline(std::cin, sourcePath);
+
+        ImportSummary summary;
+        if (!importStudents(sourcePath, "storage/" + path, summary)) {
+            Utils::applicationErrorWindow("ERROR IMPORTING FILE", 61, 9, 30, 10);
+            return;
+        }
+
+        std::string message = "IMPORTED " + std::to_string(summary.importedCount) + " STUDENTS";
+        if (summary.rejectedCount != 0)
+            message += ", " + std::to_string(summary.rejectedCount) + " ROWS REJECTED";
+        Utils::notificationWindow(message, 61, 9, 30, 10);
+    }
+
+    /**
+     * @brief Handles file interaction by adding students to the file.
+     * If the path is valid, the function asks whether to import a CSV/TSV export or to
+     * enter one student, adds the students to the file and re-renders the menu.
      *
      * @param path The path to the file being processed.
      */
@@ -71,7 +126,14 @@ namespace database {
             return;
 
         Utils::paintOverBackground();
-        addStudentToFile(path);
+        if (Utils::confirmDialog("IMPORT STUDENTS FROM A CSV/TSV FILE?", 61, 9, 30, 10)) {
+            Utils::paintOverBackground();
+            importStudentsToFile(path);
+        }
+        else {
+            Utils::paintOverBackground();
+            addStudentToFile(path);
+        }
         Utils::paintOverBackground();
         renderAddFileMenu();
 
@@ -76,19 +76,14 @@ namespace database
     /**
      * @brief Checks if a file with the given name already exists.
      *
+     * The main directory is kept sorted, so the lookup is a binary search.
+     *
      * @param path The file name to check.
      * @return true if the file exists, false otherwise.
      */
     static bool isFileNameDuplicate(const std::string& path)
     {
-        for (const auto& fileName : mainDirectory)
-        {
-            if (fileName == path)
-            {
-                return true;
-            }
-        }
-        return false;
+        return std::binary_search(mainDirectory.begin(), mainDirectory.end(), path);
     }
 
     /**
@@ -271,7 +266,7 @@ namespace database
      */
     static void handleInput(FileMenuState& state)
     {
-        int key = _getch();
+        int key = readKey();
 
         if (key == 13) {
             handleEnterKey(state);
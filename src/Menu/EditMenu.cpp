@@ -6,6 +6,7 @@
 #include "../../consoleGUI/GUI.h"
 #include "../Utils.h"
 #include "../global.h"
+#include "../StudentBinary.h"
 
 #include "../Widgets/FileSlider.h"
 #include "../Widgets/EditBox.h"
@@ -84,16 +85,28 @@ namespace database
 	{
 		if (path.empty()) return;
 
+		if (isBinaryStudentFile("storage/" + path))
+		{
+			Utils::notificationWindow("BINARY FILES CANNOT BE EDITED AS TEXT!", 61, 9, 30, 10);
+			Utils::paintOverBackground();
+			renderFileMenu();
+			setupInputHandling();
+			return;
+		}
+
 		Utils::paintOverBackground();
 		setupInputHandling();
 
+		// A file whose pending changes cannot be folded in is not opened, so it cannot be overwritten
 		displayExitMessage();
-		editBox::setup(path);
-		editBox::handleEditBox();
-
-		if (Utils::confirmDialog("SAVE THE CHANGES?", 65, 9, 27, 10))
+		if (editBox::setup(path))
 		{
-			editBox::saveChanges("storage/" + path);
+			editBox::handleEditBox();
+
+			if (Utils::confirmDialog("SAVE THE CHANGES?", 65, 9, 27, 10))
+			{
+				editBox::saveChanges("storage/" + path);
+			}
 		}
 
 		Utils::paintOverBackground();
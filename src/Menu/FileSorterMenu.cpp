@@ -1,12 +1,9 @@
 #include "FileSorterMenu.h"
 
-#include <fstream>
-#include <algorithm>
-
 #include "../../consoleGUI/GUI.h"
 #include "../Utils.h"
 #include "../global.h"
-#include "../Student.h"
+#include "../ExternalSort.h"
 #include "../Widgets/FileSlider.h"
 
 using namespace widgets;
@@ -16,7 +13,6 @@ namespace database
     // Static declarations
     static PushButton backButton;
     static SortingMethod currentSortingMethod;
-    static std::vector<Student> students;
 
     bool isFileSorterMenuActive = false;
 
@@ -92,54 +88,6 @@ namespace database
         return selectedSortingType;
     }
 
-    /**
-     * @brief Sorts the student list by the specified field and order.
-     *
-     * @param sortingType The sorting order (ascending or descending).
-     */
-    template <typename SortFunc>
-    void sortByField(SortingType sortingType, SortFunc sortFunc)
-    {
-        switch (sortingType)
-        {
-        case Ascending:
-            std::sort(students.begin(), students.end(), sortFunc);
-            break;
-        case Descending:
-            std::sort(students.begin(), students.end(), [&sortFunc](const Student& a, const Student& b) {
-                return sortFunc(b, a);
-                });
-            break;
-        }
-    }
-
-    /**
-     * @brief Sorts the student list based on the selected sorting method.
-     *
-     * @param sortingType The sorting order (ascending or descending).
-     */
-    void performSortByField(SortingType sortingType)
-    {
-        switch (currentSortingMethod)
-        {
-        case SortBySurname:
-            sortByField(sortingType, [](const Student& a, const Student& b) { return a.surname < b.surname; });
-            break;
-        case SortByAverageGrade:
-            sortByField(sortingType, [](const Student& a, const Student& b) { return a.averageGrade < b.averageGrade; });
-            break;
-        case SortByAveragePhisicsGrade:
-            sortByField(sortingType, [](const Student& a, const Student& b) { return a.averagePhisicsGrade < b.averagePhisicsGrade; });
-            break;
-        case SortByAverageMathGrade:
-            sortByField(sortingType, [](const Student& a, const Student& b) { return a.averageMathGrade < b.averageMathGrade; });
-            break;
-        case SortByAverageInformGrade:
-            sortByField(sortingType, [](const Student& a, const Student& b) { return a.averageInformGrade < b.averageInformGrade; });
-            break;
-        }
-    }
-
     /**
      * @brief Displays a message window instructing the user to select a file.
      */
@@ -170,30 +118,33 @@ namespace database
     /**
      * @brief Processes the file for sorting and updates the results.
      *
+     * Text files larger than the sort memory budget are sorted out of core; every other
+     * file is sorted in memory. Either way the sorted file replaces the original only
+     * once it is complete. The sort runs off the input thread with a progress window,
+     * and cancelling it with ESC leaves the file unchanged.
+     *
      * @param filePath The path to the file being worked on.
      */
     static void processFile(const std::string& filePath)
     {
         if (filePath.empty()) return;
 
-        students = readStudents("storage/" + filePath);
         SortingType selectedSortingType = promptUserForSortingType();
 
-        performSortByField(selectedSortingType);
+        // The sort runs on the thread pool while its progress is shown, and ESC cancels it
+        const std::string path = "storage/" + filePath;
+        bool cancelled = false;
+        const bool sorted = Utils::runOperation("SORTING FILE",
+            [path, sortingMethod = currentSortingMethod, selectedSortingType, memoryBudget = sortMemoryBudget](OperationProgress& progress) {
+                return sortStudentFile(path, path, sortingMethod, selectedSortingType, memoryBudget, &progress);
+            }, cancelled);
         renderFileSorterMenu();
 
-        std::ofstream outFile("storage/" + filePath);
-        if (!outFile.is_open()) {
-            Utils::notificationWindow("FILE OPENING ERROR", 61, 9, 30, 10);
+        // A cancelled sort leaves the file as it was
+        if (!sorted) {
+            Utils::notificationWindow(cancelled ? "SORTING CANCELLED" : "FILE SORTING ERROR", 61, 9, 30, 10);
             renderFileSorterMenu();
-            return;
         }
-
-        for (const auto& student : students)
-            writeStudent(outFile, student);
-
-        outFile.close();
-        students.clear();
     }
 
     /**
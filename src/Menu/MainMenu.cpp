@@ -10,6 +10,7 @@
 #include "SortMenu.h"
 #include "RemoveMenu.h"
 #include "IndividTaskMenu.h"
+#include "StatsMenu.h"
 #include "EditMenu.h"
 
 namespace database
@@ -21,6 +22,7 @@ namespace database
 		PushButton viewFile;        // Button to view a file
 		PushButton addToFile;       // Button to add to a file
 		PushButton individualTask;   // Button for individual tasks
+		PushButton statistics;      // Button to show file statistics
 		PushButton editFile;        // Button to edit a file
 		PushButton removeFile;      // Button to remove a file
 		PushButton sort;            // Button to sort files
@@ -41,6 +43,7 @@ namespace database
 		buttons.viewFile.allowChanges(); buttons.viewFile.show();
 		buttons.addToFile.allowChanges(); buttons.addToFile.show();
 		buttons.individualTask.allowChanges(); buttons.individualTask.show();
+		buttons.statistics.allowChanges(); buttons.statistics.show();
 		buttons.editFile.allowChanges(); buttons.editFile.show();
 		buttons.removeFile.allowChanges(); buttons.removeFile.show();
 		buttons.sort.allowChanges(); buttons.sort.show();
@@ -54,15 +57,16 @@ namespace database
 	 */
 	void createButtons(Buttons& buttons)
 	{
-		// Initialize each button with its position and label
-		buttons.createFile = PushButton(20, 5, "CREATE FILE", 10, 15);
-		buttons.viewFile = PushButton(20, 5, "VIEW FILE", 35, 15);
-		buttons.addToFile = PushButton(20, 5, "ADD TO FILE", 60, 15);
-		buttons.individualTask = PushButton(20, 5, "INDIVIDUAL TASK", 85, 15);
-		buttons.editFile = PushButton(20, 5, "EDIT FILE", 10, 22);
-		buttons.removeFile = PushButton(20, 5, "REMOVE FILE", 35, 22);
-		buttons.sort = PushButton(20, 5, "SORT", 60, 22);
-		buttons.quit = PushButton(20, 5, "QUIT", 85, 22);
+		// Initialize each button with its position and label; the shorter second row is centered
+		buttons.createFile = PushButton(18, 5, "CREATE FILE", 8, 15);
+		buttons.viewFile = PushButton(18, 5, "VIEW FILE", 30, 15);
+		buttons.addToFile = PushButton(18, 5, "ADD TO FILE", 52, 15);
+		buttons.individualTask = PushButton(18, 5, "INDIVIDUAL TASK", 74, 15);
+		buttons.statistics = PushButton(18, 5, "STATISTICS", 96, 15);
+		buttons.editFile = PushButton(18, 5, "EDIT FILE", 19, 22);
+		buttons.removeFile = PushButton(18, 5, "REMOVE FILE", 41, 22);
+		buttons.sort = PushButton(18, 5, "SORT", 63, 22);
+		buttons.quit = PushButton(18, 5, "QUIT", 85, 22);
 	}
 
 	/**
@@ -81,6 +85,8 @@ namespace database
 		buttons.addToFile.setForegroundColor(Black);
 		buttons.individualTask.setBackgroundColor(White);
 		buttons.individualTask.setForegroundColor(Black);
+		buttons.statistics.setBackgroundColor(White);
+		buttons.statistics.setForegroundColor(Black);
 		buttons.editFile.setBackgroundColor(White);
 		buttons.editFile.setForegroundColor(Black);
 		buttons.removeFile.setBackgroundColor(White);
@@ -134,6 +140,15 @@ namespace database
 			render(buttons);
 			});
 
+		// Connect actions for showing file statistics
+		buttons.statistics.connect([&]() {
+			Utils::paintOverBackground();
+			statsMenu();
+			Utils::paintOverBackground();
+			setupInputHandling();
+			render(buttons);
+			});
+
 		// Connect actions for editing a file
 		buttons.editFile.connect([&]() {
 			Utils::paintOverBackground();
@@ -201,6 +216,7 @@ namespace database
 				&buttons.viewFile,
 				&buttons.addToFile,
 				&buttons.individualTask,
+				&buttons.statistics,
 				&buttons.editFile,
 				&buttons.removeFile,
 				&buttons.sort,
@@ -4,6 +4,7 @@
 #include "../../consoleGUI/GUI.h"
 #include "../global.h"
 #include "../Utils.h"
+#include "../StudentSidecars.h"
 #include "../Widgets/FileSlider.h"
 
 using namespace widgets;
@@ -53,6 +54,7 @@ namespace database
 				mainDirectory.erase(it);
 
 				std::string filename = "storage/" + pathCopy;
+				removeStudentSidecars(filename);
 				if (std::remove(filename.c_str()) == 0) {
 					Utils::notificationWindow("FILE SUCCESSFULLY DELETED", 61, 9, 30, 10);
 				}
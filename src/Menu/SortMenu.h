@@ -3,23 +3,10 @@
 
 #include <iostream>
 
+#include "../SortEngine.h"
+
 namespace database
 {
-    enum SortingType : std::uint8_t
-    {
-        Descending,
-        Ascending
-    };
-
-    enum SortingMethod : std::uint8_t
-    {
-        SortBySurname,
-        SortByAverageGrade,
-        SortByAveragePhisicsGrade,
-        SortByAverageMathGrade,
-        SortByAverageInformGrade
-    };
-
     /** @brief Displays the sorting menu. */
     void sortMenu();
 
@@ -0,0 +1,55 @@
+#include "StatsMenu.h"
+
+#include <vector>
+#include <sstream>
+
+#include "../Utils.h"
+#include "../StudentStatistics.h"
+#include "../Widgets/ScrollableTextBox.h"
+#include "../Widgets/FileContentView.h"
+
+using namespace widgets;
+
+namespace database
+{
+    /**
+     * @brief Computes the statistics of a specified file and shows them as text.
+     *
+     * @param path The path of the file to summarize.
+     */
+    static void getFileContent(const std::string& path) {
+        // The file is summarized off the input thread while its progress is shown, and ESC cancels it;
+        // it is read in one pass and only the report is kept in memory
+        StudentStatistics statistics;
+        bool cancelled = false;
+        const bool opened = Utils::runOperation("COMPUTING STATISTICS", [&path, &statistics](OperationProgress& progress) {
+            return computeStatistics("storage/" + path, statistics, &progress);
+            }, cancelled);
+
+        // A cancelled summary shows no report and no error
+        std::vector<std::string> lines;
+        if (!opened && !cancelled) {
+            Utils::applicationErrorWindow("ERROR OPENING FILE", 61, 9, 30, 10);
+        }
+        else if (!cancelled) {
+            std::stringstream text;
+            printStatistics(text, statistics);
+
+            std::string line;
+            while (getline(text, line)) {
+                lines.push_back(line);
+            }
+        }
+
+        scrollableTextBox::setContent(std::move(lines));
+    }
+
+    /**
+     * @brief Main function to run the statistics menu.
+     */
+    void statsMenu()
+    {
+        fileContentView::run(getFileContent);
+    }
+
+} // namespace database
@@ -0,0 +1,13 @@
+#ifndef STATS_MENU_H
+#define STATS_MENU_H
+
+namespace database
+{
+    /**
+     * @brief Displays the statistics of a file: field quantiles, failing students,
+     * the GPA histogram and a table of the groups.
+     */
+    void statsMenu();
+} // namespace database
+
+#endif // STATS_MENU_H
@@ -0,0 +1,179 @@
+#include "ParallelParser.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <iterator>
+
+#include "AsyncOperation.h"
+#include "StudentParser.h"
+#include "ThreadPool.h"
+
+namespace database
+{
+
+	/** @brief Records parsed from one byte range of a text. */
+	template <typename Output>
+	struct ParsedRange
+	{
+		const char* first = nullptr; ///< Start of the range.
+		const char* last = nullptr; ///< End of the range; records starting here belong to the next one.
+		const char* firstRecord = nullptr; ///< First line of the first record parsed, if any.
+		const char* stop = nullptr; ///< Where the parser stopped, at or after the end of the range.
+		Output records;
+	};
+
+	/** @brief Adds a parsed student to a vector, leaving the student's buffers behind. */
+	static void addRecord(std::vector<Student>& records, Student& student)
+	{
+		records.push_back(std::move(student));
+	}
+
+	/** @brief Adds a parsed student to a table. */
+	static void addRecord(StudentTable& records, Student& student)
+	{
+		records.append(student);
+	}
+
+	/**
+	 * @brief Returns the first line start at or after a position.
+	 * @param position The position.
+	 * @param begin First character of the text.
+	 * @param end One past the last character of the text.
+	 * @return The position itself if a line starts there, otherwise the start of the next line.
+	 */
+	static const char* lineStartFrom(const char* position, const char* begin, const char* end)
+	{
+		if (position == begin || position[-1] == '\n')
+			return position;
+
+		const char* lineEnd = static_cast<const char*>(std::memchr(position, '\n', end - position));
+		return lineEnd ? lineEnd + 1 : end;
+	}
+
+	/**
+	 * @brief Parses the records that start in a range, replacing those parsed before.
+	 * @param from Line start to parse from.
+	 * @param end One past the last character of the text.
+	 * @param range The range; receives its records, the first record and the stop position.
+	 */
+	template <typename Output>
+	static void parseRange(const char* from, const char* end, ParsedRange<Output>& range)
+	{
+		StudentParser parser(from, end, range.last);
+		Student student;
+
+		range.records = Output();
+		range.firstRecord = nullptr;
+		while (parser.next(student))
+		{
+			if (range.firstRecord == nullptr)
+				range.firstRecord = parser.recordPosition();
+			addRecord(range.records, student);
+		}
+		range.stop = parser.position();
+	}
+
+	/**
+	 * @brief Splits a text into ranges and parses them on the shared thread pool.
+	 * @param begin First character of the text.
+	 * @param end One past the last character of the text.
+	 * @param threadCount Number of ranges parsed at once; zero picks the pool threads plus the calling thread.
+	 * @param progress Progress that receives every parsed range, or null.
+	 * @return The parsed ranges in text order, or an incomplete set if the progress was cancelled.
+	 */
+	template <typename Output>
+	static std::vector<ParsedRange<Output>> parseRanges(const char* begin, const char* end, std::size_t threadCount, OperationProgress* progress)
+	{
+		ThreadPool& pool = ThreadPool::shared();
+		if (threadCount == 0)
+			threadCount = pool.size() + 1;
+
+		const std::size_t size = static_cast<std::size_t>(end - begin);
+		const std::size_t rangeCount = threadCount == 1 ? 1 : (std::max)(std::size_t{ 1 }, (size + parallelParseRangeSize - 1) / parallelParseRangeSize);
+
+		std::vector<ParsedRange<Output>> ranges(rangeCount);
+		for (std::size_t i = 0; i < rangeCount; i++)
+		{
+			ranges[i].first = begin + size * i / rangeCount;
+			ranges[i].last = begin + size * (i + 1) / rangeCount;
+		}
+
+		std::atomic<std::size_t> nextRange{ 0 };
+		const auto work = [&]() {
+			for (std::size_t i = nextRange++; i < rangeCount; i = nextRange++)
+			{
+				if (progress != nullptr && progress->cancelled())
+					return;
+
+				parseRange(lineStartFrom(ranges[i].first, begin, end), end, ranges[i]);
+				if (progress != nullptr)
+					progress->addRead(ranges[i].records.size(), static_cast<std::uint64_t>(ranges[i].last - ranges[i].first));
+			}
+		};
+
+		pool.parallelFor((std::min)(threadCount, rangeCount), [&](std::size_t) { work(); });
+		if (progress != nullptr && progress->cancelled())
+			return ranges;
+
+		// The serial parser reaches each range where the one before it stopped; a range that
+		// resynchronized on a line inside that last record is parsed again from there
+		const char* expected = begin;
+		for (auto& range : ranges)
+		{
+			if (range.firstRecord != nullptr && range.firstRecord < expected)
+				parseRange(expected, end, range);
+			range.stop = (std::max)(range.stop, expected);
+			expected = range.stop;
+		}
+
+		return ranges;
+	}
+
+	/**
+	 * @brief Parses every record of a text buffer on several threads.
+	 * @param begin First character of the text.
+	 * @param end One past the last character of the text.
+	 * @param threadCount Number of ranges parsed at once; zero picks the pool threads plus the calling thread.
+	 * @param progress Progress that receives the parsed records and bytes, or null.
+	 * @return A vector containing the parsed students.
+	 */
+	std::vector<Student> parseStudentsParallel(const char* begin, const char* end, std::size_t threadCount, OperationProgress* progress)
+	{
+		std::vector<ParsedRange<std::vector<Student>>> ranges = parseRanges<std::vector<Student>>(begin, end, threadCount, progress);
+		if (ranges.size() == 1)
+			return std::move(ranges.front().records);
+
+		std::size_t recordCount = 0;
+		for (const auto& range : ranges)
+			recordCount += range.records.size();
+
+		std::vector<Student> students;
+		students.reserve(recordCount);
+		for (auto& range : ranges)
+			std::move(range.records.begin(), range.records.end(), std::back_inserter(students));
+		return students;
+	}
+
+	/**
+	 * @brief Parses every record of a text buffer on several threads into a table.
+	 * @param begin First character of the text.
+	 * @param end One past the last character of the text.
+	 * @param table Table that receives the students; existing rows are kept.
+	 * @param threadCount Number of ranges parsed at once; zero picks the pool threads plus the calling thread.
+	 * @param progress Progress that receives the parsed records and bytes, or null.
+	 */
+	void parseStudentTableParallel(const char* begin, const char* end, StudentTable& table, std::size_t threadCount, OperationProgress* progress)
+	{
+		const std::vector<ParsedRange<StudentTable>> ranges = parseRanges<StudentTable>(begin, end, threadCount, progress);
+
+		std::size_t recordCount = table.size();
+		for (const auto& range : ranges)
+			recordCount += range.records.size();
+
+		table.reserve(recordCount);
+		for (const auto& range : ranges)
+			table.append(range.records);
+	}
+
+} // database
@@ -0,0 +1,56 @@
+#ifndef PARALLEL_PARSER_H
+#define PARALLEL_PARSER_H
+
+#include <cstddef>
+#include <vector>
+
+#include "Student.h"
+#include "StudentTable.h"
+
+namespace database
+{
+
+	class OperationProgress;
+
+	inline constexpr std::size_t parallelParseRangeSize = std::size_t{ 4 } << 20; ///< Bytes of text one thread parses at a time.
+
+	/**
+	 * @brief Parses every record of a text buffer on several threads.
+	 *
+	 * The text is split into byte ranges of parallelParseRangeSize. Each range is
+	 * resynchronized on the next line holding "STUDENT'S NAME:" and parsed by the
+	 * next free thread of the shared pool into a buffer of its own, and the buffers
+	 * are concatenated in the order of the ranges. A range whose first record lies
+	 * inside the last record of the range before it is parsed again from where that
+	 * record ends, so the records are identical to those of parseStudents even in
+	 * malformed text.
+	 *
+	 * @param begin First character of the text.
+	 * @param end One past the last character of the text.
+	 * @param threadCount Number of ranges parsed at once; zero picks the pool threads plus the calling thread.
+	 * @param progress Progress that receives the records and bytes of every parsed range, or null. Once it
+	 *        is cancelled no further range is parsed and the result is incomplete.
+	 * @return A vector containing the parsed students.
+	 */
+	std::vector<Student> parseStudentsParallel(const char* begin, const char* end, std::size_t threadCount = 0,
+		OperationProgress* progress = nullptr);
+
+	/**
+	 * @brief Parses every record of a text buffer on several threads into a table.
+	 *
+	 * The text is split and parsed as by parseStudentsParallel, with every range
+	 * parsed into a table of its own whose columns are then appended in order.
+	 *
+	 * @param begin First character of the text.
+	 * @param end One past the last character of the text.
+	 * @param table Table that receives the students; existing rows are kept.
+	 * @param threadCount Number of ranges parsed at once; zero picks the pool threads plus the calling thread.
+	 * @param progress Progress that receives the records and bytes of every parsed range, or null. Once it
+	 *        is cancelled no further range is parsed and the table is incomplete.
+	 */
+	void parseStudentTableParallel(const char* begin, const char* end, StudentTable& table, std::size_t threadCount = 0,
+		OperationProgress* progress = nullptr);
+
+} // database
+
+#endif // PARALLEL_PARSER_H
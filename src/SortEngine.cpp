@@ -0,0 +1,289 @@
+#include "SortEngine.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <span>
+#include <string_view>
+
+#include "MappedStudentFile.h"
+#include "StudentTable.h"
+#include "ThreadPool.h"
+
+namespace database
+{
+
+	/** @brief Numeric sort key paired with the position of its record. */
+	struct NumericKey
+	{
+		std::uint64_t key;
+		std::size_t index;
+	};
+
+	/** @brief Surname sort key paired with the position of its record. */
+	struct SurnameKey
+	{
+		std::string_view key;
+		std::size_t index;
+	};
+
+	/**
+	 * @brief Maps a double to an unsigned integer with the same ordering.
+	 * @param value The value to convert.
+	 * @return A key whose unsigned order matches the numeric order of the values.
+	 */
+	std::uint64_t orderPreservingKey(double value)
+	{
+		if (value == 0.0)
+			value = 0.0; // Folds -0.0 into +0.0
+		if (std::isnan(value))
+			return ~std::uint64_t{ 0 };
+
+		const std::uint64_t bits = std::bit_cast<std::uint64_t>(value);
+		const std::uint64_t signBit = std::uint64_t{ 1 } << 63;
+
+		return (bits & signBit) ? ~bits : bits | signBit;
+	}
+
+	/**
+	 * @brief Maps a double to an unsigned integer whose ascending order is the requested order.
+	 * @param value The value to convert.
+	 * @param sortingType The sorting order (ascending or descending).
+	 * @return A key whose unsigned order matches the requested order of the values.
+	 */
+	std::uint64_t sortKey(double value, SortingType sortingType)
+	{
+		if (std::isnan(value))
+			return ~std::uint64_t{ 0 };
+
+		// Inverting the key turns the ascending order into a descending one; no number maps to ~0 either way
+		const std::uint64_t key = orderPreservingKey(value);
+		return sortingType == Descending ? ~key : key;
+	}
+
+	/**
+	 * @brief Picks the number of threads used to sort a number of records.
+	 * @param recordCount The number of records to sort.
+	 * @return One below the parallel threshold, otherwise up to the pool threads plus the calling thread.
+	 */
+	std::size_t sortThreadCount(std::size_t recordCount)
+	{
+		if (recordCount < parallelSortThreshold)
+			return 1;
+
+		const std::size_t poolThreads = ThreadPool::shared().size() + 1;
+		const std::size_t minimumChunk = parallelSortThreshold / 4;
+
+		return (std::min)(poolThreads, recordCount / minimumChunk);
+	}
+
+	/**
+	 * @brief Sorts numeric keys with a stable least-significant-digit radix sort.
+	 *
+	 * Byte positions on which all keys agree are skipped.
+	 *
+	 * @param keys The keys to sort.
+	 */
+	static void radixSort(std::span<NumericKey> keys)
+	{
+		std::vector<NumericKey> buffer(keys.size());
+		std::span<NumericKey> source = keys;
+		std::span<NumericKey> target = buffer;
+
+		for (int shift = 0; shift < 64; shift += 8)
+		{
+			std::array<std::size_t, 256> counts{};
+			for (const auto& entry : source)
+				counts[(entry.key >> shift) & 0xFF]++;
+
+			if (std::find(counts.begin(), counts.end(), source.size()) != counts.end())
+				continue;
+
+			std::size_t position = 0;
+			for (auto& count : counts)
+			{
+				const std::size_t bucketSize = count;
+				count = position;
+				position += bucketSize;
+			}
+
+			for (const auto& entry : source)
+				target[counts[(entry.key >> shift) & 0xFF]++] = entry;
+
+			std::swap(source, target);
+		}
+
+		if (source.data() != keys.data())
+			std::copy(source.begin(), source.end(), keys.begin());
+	}
+
+	/**
+	 * @brief Sorts keys with a parallel merge sort.
+	 *
+	 * The keys are split into one contiguous chunk per thread, every chunk is sorted
+	 * with the stable serial algorithm, and neighbouring chunks are merged pairwise
+	 * until one run remains. Merges prefer the left chunk on ties, so the result is
+	 * identical to sorting all keys serially. The chunk sorts and the merges of every
+	 * round run on the shared thread pool.
+	 *
+	 * @param keys The keys to sort.
+	 * @param threadCount The number of threads to use.
+	 * @param sortChunk Stable serial sort applied to a span of keys.
+	 * @param less Ordering of the keys used when merging.
+	 */
+	template <typename Key, typename SortChunk, typename Less>
+	static void parallelSort(std::vector<Key>& keys, std::size_t threadCount, SortChunk sortChunk, Less less)
+	{
+		if (threadCount <= 1 || keys.size() < 2 * threadCount)
+		{
+			sortChunk(std::span<Key>(keys));
+			return;
+		}
+
+		std::vector<std::size_t> bounds(threadCount + 1);
+		for (std::size_t i = 0; i <= threadCount; i++)
+			bounds[i] = keys.size() * i / threadCount;
+
+		ThreadPool& pool = ThreadPool::shared();
+		pool.parallelFor(threadCount, [&](std::size_t i) {
+			sortChunk(std::span<Key>(keys.data() + bounds[i], bounds[i + 1] - bounds[i]));
+			});
+
+		std::vector<Key> buffer(keys.size());
+		while (bounds.size() > 2)
+		{
+			std::vector<std::size_t> mergedBounds{ 0 };
+			for (std::size_t i = 0; i + 2 < bounds.size(); i += 2)
+				mergedBounds.push_back(bounds[i + 2]);
+
+			const std::size_t mergeCount = (bounds.size() - 1) / 2;
+			pool.parallelFor(mergeCount, [&](std::size_t merge) {
+				const std::size_t first = bounds[2 * merge];
+				const std::size_t middle = bounds[2 * merge + 1];
+				const std::size_t last = bounds[2 * merge + 2];
+				std::merge(keys.begin() + first, keys.begin() + middle,
+					keys.begin() + middle, keys.begin() + last,
+					buffer.begin() + first, less);
+				});
+
+			// An odd chunk out is carried over to the next round unchanged
+			if (bounds.size() % 2 == 0)
+			{
+				const std::size_t i = bounds.size() - 2;
+				std::copy(keys.begin() + bounds[i], keys.begin() + bounds[i + 1], buffer.begin() + bounds[i]);
+				mergedBounds.push_back(bounds[i + 1]);
+			}
+
+			keys.swap(buffer);
+			bounds.swap(mergedBounds);
+		}
+	}
+
+	/**
+	 * @brief Orders records by a numeric column.
+	 * @param column The column holding the key of every record.
+	 * @param sortingType The sorting order (ascending or descending).
+	 * @param threadCount The number of threads to use.
+	 * @return The positions of the records in sorted order.
+	 */
+	static std::vector<std::size_t> sortByColumn(std::span<const double> column, SortingType sortingType, std::size_t threadCount)
+	{
+		std::vector<NumericKey> keys(column.size());
+		for (std::size_t i = 0; i < column.size(); i++)
+			keys[i] = { sortKey(column[i], sortingType), i };
+
+		parallelSort(keys, threadCount, radixSort, [](const NumericKey& a, const NumericKey& b) { return a.key < b.key; });
+
+		std::vector<std::size_t> order(keys.size());
+		for (std::size_t i = 0; i < keys.size(); i++)
+			order[i] = keys[i].index;
+		return order;
+	}
+
+	/**
+	 * @brief Orders records by surname.
+	 * @param records The records to order.
+	 * @param sortingType The sorting order (ascending or descending).
+	 * @param threadCount The number of threads to use.
+	 * @return The positions of the records in sorted order.
+	 */
+	template <typename Records>
+	static std::vector<std::size_t> sortBySurname(const Records& records, SortingType sortingType, std::size_t threadCount)
+	{
+		std::vector<SurnameKey> keys(records.size());
+		for (std::size_t i = 0; i < records.size(); i++)
+			keys[i] = { records.surname(i), i };
+
+		const bool descending = sortingType == Descending;
+		const auto less = [descending](const SurnameKey& a, const SurnameKey& b) {
+			return descending ? b.key < a.key : a.key < b.key;
+			};
+
+		parallelSort(keys, threadCount, [&less](std::span<SurnameKey> chunk) {
+			std::stable_sort(chunk.begin(), chunk.end(), less);
+			}, less);
+
+		std::vector<std::size_t> order(keys.size());
+		for (std::size_t i = 0; i < keys.size(); i++)
+			order[i] = keys[i].index;
+		return order;
+	}
+
+	/**
+	 * @brief Computes the sorted order of any record source exposing surnames and GPA columns.
+	 * @param records The records to order.
+	 * @param sortingMethod The field to sort by.
+	 * @param sortingType The sorting order (ascending or descending).
+	 * @param threadCount The number of threads to use, or zero to pick it from the record count.
+	 * @return The positions of the records in sorted order.
+	 */
+	template <typename Records>
+	static std::vector<std::size_t> sortRecords(const Records& records, SortingMethod sortingMethod, SortingType sortingType, std::size_t threadCount)
+	{
+		if (threadCount == 0)
+			threadCount = sortThreadCount(records.size());
+
+		switch (sortingMethod)
+		{
+		case SortBySurname:
+			return sortBySurname(records, sortingType, threadCount);
+		case SortByAverageGrade:
+			return sortByColumn(records.averageGrades(), sortingType, threadCount);
+		case SortByAveragePhisicsGrade:
+			return sortByColumn(records.averagePhisicsGrades(), sortingType, threadCount);
+		case SortByAverageMathGrade:
+			return sortByColumn(records.averageMathGrades(), sortingType, threadCount);
+		case SortByAverageInformGrade:
+			return sortByColumn(records.averageInformGrades(), sortingType, threadCount);
+		}
+		return {};
+	}
+
+	/**
+	 * @brief Computes the sorted order of a table's rows.
+	 * @param table The table to order.
+	 * @param sortingMethod The field to sort by.
+	 * @param sortingType The sorting order (ascending or descending).
+	 * @param threadCount The number of threads to use, or zero to pick it from the record count.
+	 * @return The positions of the rows in sorted order.
+	 */
+	std::vector<std::size_t> sortOrder(const StudentTable& table, SortingMethod sortingMethod, SortingType sortingType, std::size_t threadCount)
+	{
+		return sortRecords(table, sortingMethod, sortingType, threadCount);
+	}
+
+	/**
+	 * @brief Computes the sorted order of the records of a mapped binary file.
+	 * @param file The mapped file to order.
+	 * @param sortingMethod The field to sort by.
+	 * @param sortingType The sorting order (ascending or descending).
+	 * @param threadCount The number of threads to use, or zero to pick it from the record count.
+	 * @return The positions of the records in sorted order.
+	 */
+	std::vector<std::size_t> sortOrder(const MappedStudentFile& file, SortingMethod sortingMethod, SortingType sortingType, std::size_t threadCount)
+	{
+		return sortRecords(file, sortingMethod, sortingType, threadCount);
+	}
+
+} // namespace database
@@ -0,0 +1,89 @@
+#ifndef SORT_ENGINE_H
+#define SORT_ENGINE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace database
+{
+	class StudentTable;
+	class MappedStudentFile;
+
+	enum SortingType : std::uint8_t
+	{
+		Descending,
+		Ascending
+	};
+
+	enum SortingMethod : std::uint8_t
+	{
+		SortBySurname,
+		SortByAverageGrade,
+		SortByAveragePhisicsGrade,
+		SortByAverageMathGrade,
+		SortByAverageInformGrade
+	};
+
+	inline constexpr std::size_t parallelSortThreshold = 65536; ///< Record count from which sorting uses several threads.
+
+	/**
+	 * @brief Picks the number of threads used to sort a number of records.
+	 * @param recordCount The number of records to sort.
+	 * @return One below the parallel threshold, otherwise up to the pool threads plus the calling thread.
+	 */
+	std::size_t sortThreadCount(std::size_t recordCount);
+
+	/**
+	 * @brief Maps a double to an unsigned integer with the same ordering.
+	 *
+	 * Negative and positive zero map to the same key; NaN values order after every number.
+	 *
+	 * @param value The value to convert.
+	 * @return A key whose unsigned order matches the numeric order of the values.
+	 */
+	std::uint64_t orderPreservingKey(double value);
+
+	/**
+	 * @brief Maps a double to an unsigned integer whose ascending order is the requested order.
+	 *
+	 * NaN values order after every number in both directions.
+	 *
+	 * @param value The value to convert.
+	 * @param sortingType The sorting order (ascending or descending).
+	 * @return A key whose unsigned order matches the requested order of the values.
+	 */
+	std::uint64_t sortKey(double value, SortingType sortingType);
+
+	/**
+	 * @brief Computes the sorted order of a table's rows.
+	 *
+	 * The selected key is extracted into a compact (key, index) array which is sorted
+	 * on its own: GPA keys with an LSD radix sort over order-preserving bit patterns,
+	 * surnames with a stable comparison sort. Both directions are handled in the same
+	 * pass, and rows with equal keys keep their original relative order.
+	 *
+	 * Large inputs are sorted by a parallel merge sort over the extracted keys; its
+	 * result is identical to the serial order.
+	 *
+	 * @param table The table to order.
+	 * @param sortingMethod The field to sort by.
+	 * @param sortingType The sorting order (ascending or descending).
+	 * @param threadCount The number of threads to use, or zero to pick it from the record count.
+	 * @return The positions of the rows in sorted order.
+	 */
+	std::vector<std::size_t> sortOrder(const StudentTable& table, SortingMethod sortingMethod, SortingType sortingType, std::size_t threadCount = 0);
+
+	/**
+	 * @brief Computes the sorted order of the records of a mapped binary file.
+	 * @param file The mapped file to order.
+	 * @param sortingMethod The field to sort by.
+	 * @param sortingType The sorting order (ascending or descending).
+	 * @param threadCount The number of threads to use, or zero to pick it from the record count.
+	 * @return The positions of the records in sorted order.
+	 */
+	std::vector<std::size_t> sortOrder(const MappedStudentFile& file, SortingMethod sortingMethod, SortingType sortingType, std::size_t threadCount = 0);
+
+} // namespace database
+
+#endif // SORT_ENGINE_H
@@ -1,48 +1,16 @@
 #include "Student.h"
 
-#include <fstream>
-#include <sstream>
+#include <cmath>
+#include <ostream>
 
-#include "Utils.h"
-#include "../consoleGUI/GUI.h"
+#include "MappedFile.h"
+#include "ParallelParser.h"
+#include "StudentBinary.h"
+#include "StudentReader.h"
 
 namespace database
 {
 
-	/**
-	 * @brief Checks if the given size is valid (non-negative).
-	 * @param size The size to check.
-	 * @return True if size is valid, false otherwise.
-	 */
-	bool checkArraySize(const int& size)
-	{
-		if (size < 0)
-		{
-			std::cout << "THE NUMBER OF RATING CANNOT BE NEGATIVE!" << std::endl;
-			return false;
-		}
-		else
-		{
-			return true;
-		}
-	}
-
-	/**
-	 * @brief Inputs grades for a specific subject into the provided vector.
-	 * @param grade A reference to the vector where grades will be stored.
-	 * @param length The number of grades to input.
-	 */
-	void inputAllGradesForSubject(std::vector<uint16_t>& grade, std::size_t length)
-	{
-		for (int i = 0; i < length; i++)
-		{
-			grade.push_back(0);
-
-			std::string prompt = "ENTER " + std::to_string(i + 1) + "-GRADE:";
-			Utils::inputValue(prompt, grade[i]);
-		}
-	}
-
 	/**
 	 * @brief Calculates the average value of a given set of marks.
 	 * @param marks A vector of marks to calculate the average from.
@@ -51,7 +19,7 @@ namespace database
 	double calculateAverageValue(const std::vector<std::uint16_t>& marks)
 	{
 		std::size_t count = marks.size();
-		std::uint16_t sum = 0;
+		std::uint64_t sum = 0;
 
 		for (const auto& el : marks)
 			sum += el;
@@ -65,189 +33,133 @@ namespace database
 	 */
 	void calculateAverageGrade(Student& student)
 	{
-		int sumOfPhisicsGrades = 0;
-		for (int i = 0; i < student.phisicsScores.size(); i++)
-			sumOfPhisicsGrades += student.phisicsScores[i];
-
-		int sumOfMathGrades = 0;
-		for (int i = 0; i < student.mathScores.size(); i++)
-			sumOfMathGrades += student.mathScores[i];
+		const double avgPhisics = calculateAverageValue(student.phisicsScores);
+		const double avgMath = calculateAverageValue(student.mathScores);
+		const double avgInform = calculateAverageValue(student.informScores);
 
-		int sumOfInformGrades = 0;
-		for (int i = 0; i < student.informScores.size(); i++)
-			sumOfInformGrades += student.informScores[i];
-
-		double avgPhisics = static_cast<double>(sumOfPhisicsGrades) / student.phisicsScores.size();
-		double avgMath = static_cast<double>(sumOfMathGrades) / student.mathScores.size();
-		double avgInform = static_cast<double>(sumOfInformGrades) / student.informScores.size();
-
-		student.averageGrade = (round(avgPhisics) + round(avgMath) + round(avgInform)) / 3;
+		student.averageGrade = (std::round(avgPhisics) + std::round(avgMath) + std::round(avgInform)) / 3;
 	}
 
 	/**
-	 * @brief Writes a student's data to a specified output file.
-	 * @param outFile Output file stream to write data to.
-	 * @param student The student object containing data to write.
+	 * @brief Checks whether any of the scores of a subject is a failing grade.
+	 * @param scores The scores of one subject.
+	 * @return True if a score is below failingScore, false otherwise.
 	 */
-	void writeStudent(std::ofstream& outFile, const Student& student)
+	bool hasFailingScore(std::span<const std::uint16_t> scores)
 	{
-		outFile << "STUDENT'S NAME: " << student.surname << std::endl;
-		outFile << "GROUP NUMBER: " << student.groupNumber << std::endl;
-		outFile << "PHYSICS SCORE: " << Utils::arrayToString(student.phisicsScores) << std::endl;
-		outFile << "PHISICS GPA: " << student.averagePhisicsGrade << std::endl;
-		outFile << "MATH SCORE: " << Utils::arrayToString(student.mathScores) << std::endl;
-		outFile << "MATH GPA: " << student.averageMathGrade << std::endl;
-		outFile << "CS SCORE: " << Utils::arrayToString(student.informScores) << std::endl;
-		outFile << "CS GPA: " << student.averageInformGrade << std::endl;
-		outFile << "GPA: " << student.averageGrade << std::endl;
+		for (auto score : scores)
+		{
+			if (score < failingScore)
+				return true;
+		}
+		return false;
 	}
 
 	/**
-	 * @brief Creates a new Student object by gathering input from the user.
-	 * @return A Student object filled with user input.
+	 * @brief Writes a student's data to a specified output stream.
+	 * @param outFile Output stream to write data to.
+	 * @param student The student object containing data to write.
 	 */
-	Student createStudent()
+	void writeStudent(std::ostream& outFile, const Student& student)
 	{
-		Student student{};
-		std::cout << "ENTER THE STUDENT'S LAST NAME:" << std::endl;
-		getline(std::cin, student.surname);
-
-		Utils::inputValue("ENTER THE STUDENT'S GROUP NUMBER:", student.groupNumber);
-
-		int numOfPhisicsMarks{};
-		Utils::inputValue("ENTER THE NUMBER OF MARKS IN PHYSICS:", numOfPhisicsMarks, checkArraySize);
-		inputAllGradesForSubject(student.phisicsScores, numOfPhisicsMarks);
-		student.averagePhisicsGrade = calculateAverageValue(student.phisicsScores);
-
-		int numOfMathMarks{};
-		Utils::inputValue("ENTER THE NUMBER OF MARKS IN MATH:", numOfMathMarks, checkArraySize);
-		inputAllGradesForSubject(student.mathScores, numOfMathMarks);
-		student.averageMathGrade = calculateAverageValue(student.mathScores);
-
-		int numOfInformMarks{};
-		Utils::inputValue("ENTER THE NUMBER OF MARKS IN COMPUTER SCIENCE:", numOfInformMarks, checkArraySize);
-		inputAllGradesForSubject(student.informScores, numOfInformMarks);
-		student.averageInformGrade = calculateAverageValue(student.informScores);
-
-		calculateAverageGrade(student);
-
-		Utils::eatline();
-
-		return student;
+		writeStudent(outFile, makeStudentView(student));
 	}
 
 	/**
-	 * @brief Parses a string into a vector of unsigned integers.
-	 * @param str The string to parse.
-	 * @return A vector containing the parsed unsigned integers.
+	 * @brief Writes scores separated by spaces to an output stream.
+	 * @param outFile Output stream to write data to.
+	 * @param scores The scores to write.
 	 */
-	std::vector<uint16_t> parseArray(const std::string& str)
+	static void writeScores(std::ostream& outFile, std::span<const std::uint16_t> scores)
 	{
-		std::vector<uint16_t> array;
-		std::stringstream ss(str);
-		uint16_t number;
-
-		while (ss >> number)
+		for (std::size_t i = 0; i < scores.size(); ++i)
 		{
-			array.push_back(number);
+			if (i != 0)
+				outFile << ' ';
+			outFile << scores[i];
 		}
-		return array;
 	}
 
 	/**
-	 * @brief Reads a student's data from an input file stream.
-	 * @param inFile Input file stream to read data from.
-	 * @param student Reference to the student object to populate with data.
-	 * @return True if the data was read successfully, false otherwise.
+	 * @brief Writes the student data referred to by a view to a specified output stream.
+	 * @param outFile Output stream to write data to.
+	 * @param student The view of the student data to write.
 	 */
-	bool readStudent(std::ifstream& inFile, Student& student)
+	void writeStudent(std::ostream& outFile, const StudentView& student)
 	{
-		std::string groupNumberStr, arrayStr, averageGradeStr, overallAverageGradeStr;
-
-		if (getline(inFile, student.surname) &&
-			getline(inFile, groupNumberStr) &&
-			getline(inFile, arrayStr) &&
-			getline(inFile, averageGradeStr)) {
-
-			student.groupNumber = stoull(groupNumberStr);
-			student.phisicsScores = parseArray(arrayStr);
-			student.averagePhisicsGrade = stod(averageGradeStr);
-
-			getline(inFile, arrayStr);
-			getline(inFile, averageGradeStr);
-			student.mathScores = parseArray(arrayStr);
-			student.averageMathGrade = stod(averageGradeStr);
-
-			getline(inFile, arrayStr);
-			getline(inFile, averageGradeStr);
-			student.informScores = parseArray(arrayStr);
-			student.averageInformGrade = stod(averageGradeStr);
+		outFile << "STUDENT'S NAME: " << student.surname << '\n';
+		outFile << "GROUP NUMBER: " << student.groupNumber << '\n';
+		outFile << "PHYSICS SCORE: "; writeScores(outFile, student.phisicsScores); outFile << '\n';
+		outFile << "PHISICS GPA: " << student.averagePhisicsGrade << '\n';
+		outFile << "MATH SCORE: "; writeScores(outFile, student.mathScores); outFile << '\n';
+		outFile << "MATH GPA: " << student.averageMathGrade << '\n';
+		outFile << "CS SCORE: "; writeScores(outFile, student.informScores); outFile << '\n';
+		outFile << "CS GPA: " << student.averageInformGrade << '\n';
+		outFile << "GPA: " << student.averageGrade << '\n';
+	}
 
-			getline(inFile, overallAverageGradeStr);
-			student.averageGrade = stod(overallAverageGradeStr);
+	/**
+	 * @brief Creates a view referring to the data of a student object.
+	 * @param student The student to view.
+	 * @return A view of the student.
+	 */
+	StudentView makeStudentView(const Student& student)
+	{
+		StudentView view;
+		view.surname = student.surname;
+		view.groupNumber = student.groupNumber;
+		view.phisicsScores = student.phisicsScores;
+		view.mathScores = student.mathScores;
+		view.informScores = student.informScores;
+		view.averagePhisicsGrade = student.averagePhisicsGrade;
+		view.averageMathGrade = student.averageMathGrade;
+		view.averageInformGrade = student.averageInformGrade;
+		view.averageGrade = student.averageGrade;
+		return view;
+	}
 
-			return true;
-		}
-		return false;
+	/**
+	 * @brief Copies the data referred to by a view into a new student object.
+	 * @param view The view to copy from.
+	 * @return A Student object owning a copy of the data.
+	 */
+	Student toStudent(const StudentView& view)
+	{
+		Student student;
+		student.surname.assign(view.surname);
+		student.groupNumber = view.groupNumber;
+		student.phisicsScores.assign(view.phisicsScores.begin(), view.phisicsScores.end());
+		student.mathScores.assign(view.mathScores.begin(), view.mathScores.end());
+		student.informScores.assign(view.informScores.begin(), view.informScores.end());
+		student.averagePhisicsGrade = view.averagePhisicsGrade;
+		student.averageMathGrade = view.averageMathGrade;
+		student.averageInformGrade = view.averageInformGrade;
+		student.averageGrade = view.averageGrade;
+		return student;
 	}
 
 	/**
 	 * @brief Reads multiple students' data from a specified file.
 	 * @param filename Name of the file to read from.
-	 * @return A vector of Student objects read from the file.
+	 * @return A vector of Student objects read from the file, empty if it cannot be opened.
 	 */
 	std::vector<Student> readStudents(const std::string& filename)
 	{
-		std::ifstream file(filename);
-		if (!file.is_open())
-			Utils::applicationErrorWindow("ERROR OPENING FILE", 61, 9, 30, 10);
+		if (!isBinaryStudentFile(filename))
+		{
+			MappedFile file;
+			if (!file.open(filename))
+				return {};
+			return parseStudentsParallel(file.data(), file.data() + file.size());
+		}
 
 		std::vector<Student> students;
-		std::string line;
-
-		while (std::getline(file, line)) {
-			if (line.find("STUDENT'S NAME:") != std::string::npos)
-			{
-				Student student;
-				student.surname = line.substr(line.find(":") + 2);
-
-				std::getline(file, line);
-				student.groupNumber = std::stoull(line.substr(line.find(":") + 2));
-
-				std::getline(file, line);
-				std::istringstream phisicsStream(line.substr(line.find(":") + 2));
-				std::uint16_t score;
-				while (phisicsStream >> score) {
-					student.phisicsScores.push_back(score);
-				}
-
-				std::getline(file, line);
-				student.averagePhisicsGrade = std::stod(line.substr(line.find(":") + 2));
-
-				std::getline(file, line);
-				std::istringstream mathStream(line.substr(line.find(":") + 2));
-				while (mathStream >> score) {
-					student.mathScores.push_back(score);
-				}
-
-				std::getline(file, line);
-				student.averageMathGrade = std::stod(line.substr(line.find(":") + 2));
-
-				std::getline(file, line);
-				std::istringstream informStream(line.substr(line.find(":") + 2));
-				while (informStream >> score) {
-					student.informScores.push_back(score);
-				}
-
-				std::getline(file, line);
-				student.averageInformGrade = std::stod(line.substr(line.find(":") + 2));
-
-				std::getline(file, line);
-				student.averageGrade = std::stod(line.substr(line.find(":") + 2));
-
-				students.push_back(student);
-			}
-		}
+		StudentReader reader(filename);
+		if (!reader.isOpen())
+			return students;
+
+		for (const Student& student : reader)
+			students.push_back(student);
 
 		return students;
 	}
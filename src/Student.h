@@ -1,12 +1,18 @@
 #ifndef STUDENT_H
 #define STUDENT_H
 
+#include <cstdint>
+#include <iosfwd>
+#include <span>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace database
 {
 
+	inline constexpr std::uint16_t failingScore = 4; ///< Scores below this one are failing grades.
+
 	struct Student
 	{
 		std::string surname{};
@@ -25,22 +31,64 @@ namespace database
 	};
 
 	/**
-	 * @brief Creates a new Student object by gathering input from the user.
-	 * @return A Student object filled with user input.
+	 * @brief Non-owning view of a student record.
+	 *
+	 * Views refer either to a Student object or directly to the bytes of a
+	 * memory-mapped binary file, and stay valid only as long as their source.
+	 */
+	struct StudentView
+	{
+		std::string_view surname{};
+
+		std::uint64_t groupNumber{};
+
+		std::span<const std::uint16_t> phisicsScores{},
+			mathScores{},
+			informScores{};
+
+		double averagePhisicsGrade{},
+			averageMathGrade{},
+			averageInformGrade{};
+
+		double averageGrade{};
+	};
+
+	/**
+	 * @brief Creates a view referring to the data of a student object.
+	 * @param student The student to view.
+	 * @return A view of the student.
+	 */
+	StudentView makeStudentView(const Student& student);
+
+	/**
+	 * @brief Copies the data referred to by a view into a new student object.
+	 * @param view The view to copy from.
+	 * @return A Student object owning a copy of the data.
 	 */
-	Student createStudent();
+	Student toStudent(const StudentView& view);
 
 	/**
-	 * @brief Writes a student's data to a specified output file.
-	 * @param outFile Output file stream to write data to.
+	 * @brief Writes a student's data to a specified output stream.
+	 * @param outFile Output stream to write data to.
 	 * @param student The student object containing data to write.
 	 */
-	void writeStudent(std::ofstream& outFile, const Student& student);
+	void writeStudent(std::ostream& outFile, const Student& student);
+
+	/**
+	 * @brief Writes the student data referred to by a view to a specified output stream.
+	 * @param outFile Output stream to write data to.
+	 * @param student The view of the student data to write.
+	 */
+	void writeStudent(std::ostream& outFile, const StudentView& student);
 
 	/**
 	 * @brief Reads student data from a file.
+	 *
+	 * Large text files are parsed on several threads with the same result as a
+	 * sequential read.
+	 *
 	 * @param filename Name of the file to read from.
-	 * @return A vector containing Student objects read from the file.
+	 * @return A vector containing Student objects read from the file, empty if it cannot be opened.
 	 */
 	std::vector<Student> readStudents(const std::string& filename);
 
@@ -58,18 +106,11 @@ namespace database
 	double calculateAverageValue(const std::vector<std::uint16_t>& marks);
 
 	/**
-	 * @brief Inputs grades for a specific subject into the provided vector.
-	 * @param grade A reference to the vector where grades will be stored.
-	 * @param length The number of grades to input.
-	 */
-	void inputAllGradesForSubject(std::vector<uint16_t>& grade, std::size_t length);
-
-	/**
-	 * @brief Checks if the given size is valid (non-negative).
-	 * @param size The size to check.
-	 * @return True if size is valid, false otherwise.
+	 * @brief Checks whether any of the scores of a subject is a failing grade.
+	 * @param scores The scores of one subject.
+	 * @return True if a score is below failingScore, false otherwise.
 	 */
-	bool checkArraySize(const int& size);
+	bool hasFailingScore(std::span<const std::uint16_t> scores);
 
 } // database
 
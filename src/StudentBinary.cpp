@@ -0,0 +1,229 @@
+#include "StudentBinary.h"
+
+#include <bit>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+#include "BufferedWriter.h"
+#include "MappedFile.h"
+#include "MappedStudentFile.h"
+#include "ParallelParser.h"
+
+namespace database
+{
+
+	static_assert(std::endian::native == std::endian::little, "The binary student format is written in host byte order");
+
+	/**
+	 * @brief Rounds a byte offset up to the next multiple of eight.
+	 * @param offset The offset to align.
+	 * @return The aligned offset.
+	 */
+	static std::uint64_t alignToEight(std::uint64_t offset)
+	{
+		return (offset + 7) & ~static_cast<std::uint64_t>(7);
+	}
+
+	/**
+	 * @brief Computes the section offsets described by a header.
+	 * @param header Header of the binary file.
+	 * @return The layout of the file sections.
+	 */
+	BinaryFileLayout computeBinaryLayout(const BinaryFileHeader& header)
+	{
+		const std::uint64_t count = header.studentCount;
+		const std::uint64_t columnSize = count * sizeof(std::uint64_t);
+
+		BinaryFileLayout layout{};
+		layout.groupNumbers = sizeof(BinaryFileHeader);
+		layout.averagePhisicsGrades = layout.groupNumbers + columnSize;
+		layout.averageMathGrades = layout.averagePhisicsGrades + columnSize;
+		layout.averageInformGrades = layout.averageMathGrades + columnSize;
+		layout.averageGrades = layout.averageInformGrades + columnSize;
+		layout.surnameOffsets = layout.averageGrades + columnSize;
+		layout.scoreOffsets = layout.surnameOffsets + (count + 1) * sizeof(std::uint64_t);
+		layout.surnameHeap = layout.scoreOffsets + (3 * count + 1) * sizeof(std::uint64_t);
+		layout.scoreHeap = alignToEight(layout.surnameHeap + header.surnameHeapSize);
+		layout.fileSize = layout.scoreHeap + header.scoreHeapSize * sizeof(std::uint16_t);
+		return layout;
+	}
+
+	/**
+	 * @brief Checks whether a file is stored in the binary columnar format.
+	 * @param filename Name of the file to check.
+	 * @return True if the file starts with the binary header, false otherwise.
+	 */
+	bool isBinaryStudentFile(const std::string& filename)
+	{
+		std::ifstream file(filename, std::ios::binary);
+		char magic[sizeof(binaryFileMagic)]{};
+
+		if (!file.read(magic, sizeof(magic)))
+			return false;
+
+		return std::memcmp(magic, binaryFileMagic, sizeof(magic)) == 0;
+	}
+
+	/**
+	 * @brief Writes a column of trivially copyable values to a file.
+	 * @param file Output stream to write to.
+	 * @param column The values to write.
+	 */
+	template <typename T>
+	static void writeColumn(BufferedWriter& file, const std::vector<T>& column)
+	{
+		file.writeColumn(std::span<const T>(column));
+	}
+
+	/**
+	 * @brief Writes students to a file in the binary columnar format.
+	 * @param filename Name of the file to write to.
+	 * @param students Students to write.
+	 * @return True if the file was written and synced to the disk, false otherwise.
+	 */
+	bool writeStudentsBinary(const std::string& filename, const std::vector<Student>& students)
+	{
+		std::vector<StudentView> views;
+		views.reserve(students.size());
+
+		for (const auto& student : students)
+			views.push_back(makeStudentView(student));
+
+		return writeStudentsBinary(filename, views);
+	}
+
+	/**
+	 * @brief Writes the students referred to by views to a file in the binary columnar format.
+	 * @param filename Name of the file to write to.
+	 * @param students Views of the students to write.
+	 * @return True if the file was written and synced to the disk, false otherwise.
+	 */
+	bool writeStudentsBinary(const std::string& filename, const std::vector<StudentView>& students)
+	{
+		const std::size_t count = students.size();
+
+		std::vector<std::uint64_t> groupNumbers(count);
+		std::vector<double> averagePhisicsGrades(count), averageMathGrades(count),
+			averageInformGrades(count), averageGrades(count);
+		std::vector<std::uint64_t> surnameOffsets(count + 1), scoreOffsets(3 * count + 1);
+
+		std::string surnameHeap;
+		std::vector<std::uint16_t> scoreHeap;
+
+		for (std::size_t i = 0; i < count; i++)
+		{
+			const StudentView& student = students[i];
+
+			groupNumbers[i] = student.groupNumber;
+			averagePhisicsGrades[i] = student.averagePhisicsGrade;
+			averageMathGrades[i] = student.averageMathGrade;
+			averageInformGrades[i] = student.averageInformGrade;
+			averageGrades[i] = student.averageGrade;
+
+			surnameOffsets[i] = surnameHeap.size();
+			surnameHeap += student.surname;
+
+			scoreOffsets[3 * i] = scoreHeap.size();
+			scoreHeap.insert(scoreHeap.end(), student.phisicsScores.begin(), student.phisicsScores.end());
+			scoreOffsets[3 * i + 1] = scoreHeap.size();
+			scoreHeap.insert(scoreHeap.end(), student.mathScores.begin(), student.mathScores.end());
+			scoreOffsets[3 * i + 2] = scoreHeap.size();
+			scoreHeap.insert(scoreHeap.end(), student.informScores.begin(), student.informScores.end());
+		}
+		surnameOffsets[count] = surnameHeap.size();
+		scoreOffsets[3 * count] = scoreHeap.size();
+
+		BinaryFileHeader header{};
+		std::memcpy(header.magic, binaryFileMagic, sizeof(header.magic));
+		header.version = binaryFileVersion;
+		header.studentCount = count;
+		header.surnameHeapSize = surnameHeap.size();
+		header.scoreHeapSize = scoreHeap.size();
+
+		const BinaryFileLayout layout = computeBinaryLayout(header);
+
+		BufferedWriter file;
+		if (!file.open(filename))
+			return false;
+
+		file.write(&header, sizeof(header));
+		writeColumn(file, groupNumbers);
+		writeColumn(file, averagePhisicsGrades);
+		writeColumn(file, averageMathGrades);
+		writeColumn(file, averageInformGrades);
+		writeColumn(file, averageGrades);
+		writeColumn(file, surnameOffsets);
+		writeColumn(file, scoreOffsets);
+		file.write(surnameHeap.data(), surnameHeap.size());
+
+		const std::uint64_t padding = layout.scoreHeap - (layout.surnameHeap + surnameHeap.size());
+		const char zeros[8]{};
+		file.write(zeros, padding);
+		writeColumn(file, scoreHeap);
+
+		// Synced so that the file may replace another one by a rename
+		const bool written = file.sync();
+		return file.close() && written;
+	}
+
+	/**
+	 * @brief Reads students from a file in the binary columnar format.
+	 * @param filename Name of the file to read from.
+	 * @param students Vector that receives the students read from the file.
+	 * @return True if the file was read successfully, false if it could not be opened or is corrupt.
+	 */
+	bool readStudentsBinary(const std::string& filename, std::vector<Student>& students)
+	{
+		MappedStudentFile file;
+		if (!file.open(filename))
+			return false;
+
+		students.clear();
+		students.reserve(file.size());
+
+		for (std::size_t i = 0; i < file.size(); i++)
+			students.push_back(toStudent(file[i]));
+
+		return true;
+	}
+
+	/**
+	 * @brief Reads a binary student file and renders it as lines of the text format.
+	 * @param filename Name of the file to read from.
+	 * @param lines Vector that receives the rendered lines.
+	 * @return True if the file was read successfully, false otherwise.
+	 */
+	bool readStudentsBinaryAsText(const std::string& filename, std::vector<std::string>& lines)
+	{
+		MappedStudentFile file;
+		if (!file.open(filename))
+			return false;
+
+		std::stringstream text;
+		for (std::size_t i = 0; i < file.size(); i++)
+			writeStudent(text, file[i]);
+
+		std::string line;
+		while (std::getline(text, line))
+			lines.push_back(line);
+
+		return true;
+	}
+
+	/**
+	 * @brief Converts a text student file into the binary columnar format.
+	 * @param textFilename Name of the text file to convert.
+	 * @param binaryFilename Name of the binary file to create.
+	 * @return True if the conversion succeeded, false if the text file could not be read or the binary file written.
+	 */
+	bool convertTextToBinary(const std::string& textFilename, const std::string& binaryFilename)
+	{
+		MappedFile file;
+		if (!file.open(textFilename))
+			return false;
+
+		return writeStudentsBinary(binaryFilename, parseStudentsParallel(file.data(), file.data() + file.size()));
+	}
+
+} // database
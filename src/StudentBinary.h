@@ -0,0 +1,110 @@
+#ifndef STUDENT_BINARY_H
+#define STUDENT_BINARY_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Student.h"
+
+namespace database
+{
+
+	/**
+	 * @brief Binary columnar layout of a student file.
+	 *
+	 * The file starts with a fixed header followed by 8-byte aligned sections:
+	 * the group number column, the four GPA columns, the surname offsets
+	 * (count + 1 entries), the score offsets (3 * count + 1 entries, subjects in
+	 * physics/math/CS order), the surname heap and the packed uint16_t score heap.
+	 * All values are stored in little-endian byte order. They are written and mapped
+	 * as they are in memory, so the format is only built on little-endian hosts.
+	 */
+	struct BinaryFileHeader
+	{
+		char magic[4]{};
+
+		std::uint32_t version{};
+
+		std::uint64_t studentCount{};
+		std::uint64_t surnameHeapSize{};
+		std::uint64_t scoreHeapSize{};
+	};
+
+	/**
+	 * @brief Byte offsets of every section of a binary student file.
+	 */
+	struct BinaryFileLayout
+	{
+		std::uint64_t groupNumbers{};
+		std::uint64_t averagePhisicsGrades{};
+		std::uint64_t averageMathGrades{};
+		std::uint64_t averageInformGrades{};
+		std::uint64_t averageGrades{};
+		std::uint64_t surnameOffsets{};
+		std::uint64_t scoreOffsets{};
+		std::uint64_t surnameHeap{};
+		std::uint64_t scoreHeap{};
+		std::uint64_t fileSize{};
+	};
+
+	/**
+	 * @brief Computes the section offsets described by a header.
+	 * @param header Header of the binary file.
+	 * @return The layout of the file sections.
+	 */
+	BinaryFileLayout computeBinaryLayout(const BinaryFileHeader& header);
+
+	inline constexpr char binaryFileMagic[4] = { 'S', 'D', 'B', 'C' }; ///< Marks a binary student file.
+	inline constexpr std::uint32_t binaryFileVersion = 1; ///< Current version of the binary layout.
+
+	/**
+	 * @brief Checks whether a file is stored in the binary columnar format.
+	 * @param filename Name of the file to check.
+	 * @return True if the file starts with the binary header, false otherwise.
+	 */
+	bool isBinaryStudentFile(const std::string& filename);
+
+	/**
+	 * @brief Writes students to a file in the binary columnar format.
+	 * @param filename Name of the file to write to.
+	 * @param students Students to write.
+	 * @return True if the file was written and synced to the disk, false otherwise.
+	 */
+	bool writeStudentsBinary(const std::string& filename, const std::vector<Student>& students);
+
+	/**
+	 * @brief Writes the students referred to by views to a file in the binary columnar format.
+	 * @param filename Name of the file to write to.
+	 * @param students Views of the students to write.
+	 * @return True if the file was written and synced to the disk, false otherwise.
+	 */
+	bool writeStudentsBinary(const std::string& filename, const std::vector<StudentView>& students);
+
+	/**
+	 * @brief Reads students from a file in the binary columnar format.
+	 * @param filename Name of the file to read from.
+	 * @param students Vector that receives the students read from the file.
+	 * @return True if the file was read successfully, false if it could not be opened or is corrupt.
+	 */
+	bool readStudentsBinary(const std::string& filename, std::vector<Student>& students);
+
+	/**
+	 * @brief Reads a binary student file and renders it as lines of the text format.
+	 * @param filename Name of the file to read from.
+	 * @param lines Vector that receives the rendered lines.
+	 * @return True if the file was read successfully, false otherwise.
+	 */
+	bool readStudentsBinaryAsText(const std::string& filename, std::vector<std::string>& lines);
+
+	/**
+	 * @brief Converts a text student file into the binary columnar format.
+	 * @param textFilename Name of the text file to convert.
+	 * @param binaryFilename Name of the binary file to create.
+	 * @return True if the conversion succeeded, false if the text file could not be read or the binary file written.
+	 */
+	bool convertTextToBinary(const std::string& textFilename, const std::string& binaryFilename);
+
+} // database
+
+#endif // STUDENT_BINARY_H
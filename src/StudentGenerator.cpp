@@ -0,0 +1,303 @@
+#include "StudentGenerator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+
+#include "BufferedWriter.h"
+#include "StudentBinary.h"
+#include "StudentTable.h"
+#include "ThreadPool.h"
+
+namespace database
+{
+
+	/** @brief Small generator of the SplitMix64 sequence, cheap to seed once per record. */
+	class RecordRandom
+	{
+	public:
+		RecordRandom(std::uint64_t seed, std::uint64_t index)
+			: state(seed ^ (index * 0xD1B54A32D192ED03ull))
+		{
+			next();
+		}
+
+		std::uint64_t next()
+		{
+			std::uint64_t value = (state += 0x9E3779B97F4A7C15ull);
+			value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+			value = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+			return value ^ (value >> 31);
+		}
+
+		/** @brief Returns a value below the bound, or zero if the bound is zero. */
+		std::uint64_t below(std::uint64_t bound)
+		{
+			return bound == 0 ? 0 : next() % bound;
+		}
+
+		/** @brief Returns a value in [0, 1). */
+		double fraction()
+		{
+			return static_cast<double>(next() >> 11) * 0x1.0p-53;
+		}
+
+	private:
+		std::uint64_t state;
+	};
+
+	/**
+	 * @brief Builds the cumulative frequencies of weighted choices.
+	 * @param weights The relative frequency of every choice.
+	 * @return The running sums of the weights.
+	 */
+	static std::vector<double> cumulativeDistribution(const std::vector<double>& weights)
+	{
+		std::vector<double> distribution(weights.size());
+		double total = 0;
+		for (std::size_t i = 0; i < weights.size(); i++)
+		{
+			total += (std::max)(weights[i], 0.0);
+			distribution[i] = total;
+		}
+		return distribution;
+	}
+
+	/**
+	 * @brief Draws a choice from cumulative frequencies.
+	 * @param distribution The running sums of the weights.
+	 * @param random The random sequence of the record.
+	 * @return The position of the chosen entry.
+	 */
+	static std::uint64_t drawWeighted(const std::vector<double>& distribution, RecordRandom& random)
+	{
+		const double point = random.fraction() * distribution.back();
+		const std::uint64_t choice = std::upper_bound(distribution.begin(), distribution.end(), point) - distribution.begin();
+		return (std::min)(choice, static_cast<std::uint64_t>(distribution.size() - 1));
+	}
+
+	/**
+	 * @brief Creates a generator.
+	 * @param options Shape of the records.
+	 */
+	StudentGenerator::StudentGenerator(const GeneratorOptions& options)
+		: generatorOptions(options)
+	{
+		generatorOptions.minScoresPerSubject = (std::max)(generatorOptions.minScoresPerSubject, std::size_t{ 1 });
+		generatorOptions.maxScoresPerSubject = (std::max)(generatorOptions.maxScoresPerSubject, generatorOptions.minScoresPerSubject);
+		generatorOptions.maxScore = (std::max)(generatorOptions.maxScore, generatorOptions.minScore);
+		generatorOptions.surnameCount = (std::max)(generatorOptions.surnameCount, std::size_t{ 1 });
+		generatorOptions.groupCount = (std::max)(generatorOptions.groupCount, std::size_t{ 1 });
+
+		generatorOptions.duplicateRate = (std::clamp)(generatorOptions.duplicateRate, 0.0, 1.0);
+
+		if (generatorOptions.surnameSkew > 0)
+		{
+			std::vector<double> weights(generatorOptions.surnameCount);
+			for (std::size_t i = 0; i < weights.size(); i++)
+				weights[i] = 1 / std::pow(static_cast<double>(i + 1), generatorOptions.surnameSkew);
+			surnameDistribution = cumulativeDistribution(weights);
+		}
+
+		// Weights that are all zero leave the scores uniform over the range they span
+		if (!generatorOptions.scoreWeights.empty())
+		{
+			generatorOptions.scoreWeights.resize((std::min)(generatorOptions.scoreWeights.size(), std::size_t{ 65536 } - generatorOptions.minScore));
+			generatorOptions.maxScore = static_cast<std::uint16_t>(generatorOptions.minScore + generatorOptions.scoreWeights.size() - 1);
+			scoreDistribution = cumulativeDistribution(generatorOptions.scoreWeights);
+			if (scoreDistribution.back() <= 0)
+				scoreDistribution.clear();
+		}
+	}
+
+	/**
+	 * @brief Returns an upper bound of the size of one record in the text format.
+	 *
+	 * The labels, a surname of up to 16 syllables, a 20-digit group number and four
+	 * doubles of at most 13 characters take less than 256 bytes; every score takes at
+	 * most six more.
+	 *
+	 * @return The most bytes writeStudent writes for a generated record.
+	 */
+	std::size_t StudentGenerator::maxTextRecordSize() const
+	{
+		return 256 + 3 * 6 * generatorOptions.maxScoresPerSubject;
+	}
+
+	/**
+	 * @brief Returns one of the surnames the generator draws from.
+	 *
+	 * The surname spells the index in base 16 with one syllable per digit, at least
+	 * two of them, so different indexes give different surnames.
+	 *
+	 * @param surnameIndex Position of the surname, below the surname count.
+	 * @return The surname.
+	 */
+	std::string StudentGenerator::surname(std::uint64_t surnameIndex)
+	{
+		static const char* const syllables[16] = {
+			"ba", "ve", "ko", "li", "mo", "na", "pe", "ra",
+			"si", "to", "du", "ga", "ze", "ni", "ka", "ro"
+		};
+
+		std::string name;
+		for (int digits = 0; digits < 2 || surnameIndex != 0; digits++)
+		{
+			name += syllables[surnameIndex % 16];
+			surnameIndex /= 16;
+		}
+		name += "ov";
+		name[0] = static_cast<char>(name[0] - 'a' + 'A');
+		return name;
+	}
+
+	/**
+	 * @brief Generates one record.
+	 * @param index Position of the record.
+	 * @param student Receives the record; its buffers are reused.
+	 */
+	void StudentGenerator::generate(std::uint64_t index, Student& student) const
+	{
+		// A duplicate takes the position of the record it copies, until one is not a duplicate
+		while (index > 0 && generatorOptions.duplicateRate > 0)
+		{
+			RecordRandom duplicate(~generatorOptions.seed, index);
+			if (duplicate.fraction() >= generatorOptions.duplicateRate)
+				break;
+			index = duplicate.below(index);
+		}
+
+		RecordRandom random(generatorOptions.seed, index);
+
+		const std::uint64_t surnameIndex = surnameDistribution.empty()
+			? random.below(generatorOptions.surnameCount)
+			: drawWeighted(surnameDistribution, random);
+		student.surname = surname(surnameIndex);
+		student.groupNumber = generatorOptions.firstGroupNumber + random.below(generatorOptions.groupCount);
+
+		const std::uint64_t scoreCounts = generatorOptions.maxScoresPerSubject - generatorOptions.minScoresPerSubject + 1;
+		const std::uint64_t scoreValues = generatorOptions.maxScore - generatorOptions.minScore + 1;
+
+		std::vector<std::uint16_t>* scores[] = { &student.phisicsScores, &student.mathScores, &student.informScores };
+		double* averages[] = { &student.averagePhisicsGrade, &student.averageMathGrade, &student.averageInformGrade };
+		for (int subject = 0; subject < 3; subject++)
+		{
+			scores[subject]->resize(generatorOptions.minScoresPerSubject + random.below(scoreCounts));
+			for (auto& score : *scores[subject])
+			{
+				const std::uint64_t offset = scoreDistribution.empty() ? random.below(scoreValues) : drawWeighted(scoreDistribution, random);
+				score = static_cast<std::uint16_t>(generatorOptions.minScore + offset);
+			}
+			*averages[subject] = calculateAverageValue(*scores[subject]);
+		}
+
+		calculateAverageGrade(student);
+	}
+
+	/**
+	 * @brief Formats a range of generated records in the text format.
+	 * @param generator The generator of the records.
+	 * @param first Position of the first record.
+	 * @param last Position after the last record.
+	 * @param out Unopened writer whose buffer receives the text.
+	 */
+	static void formatChunk(const StudentGenerator& generator, std::uint64_t first, std::uint64_t last, BufferedWriter& out)
+	{
+		Student student;
+		for (std::uint64_t index = first; index < last; index++)
+		{
+			generator.generate(index, student);
+			writeStudent(out, makeStudentView(student));
+		}
+	}
+
+	/**
+	 * @brief Generates a range of records into a table.
+	 * @param generator The generator of the records.
+	 * @param first Position of the first record.
+	 * @param last Position after the last record.
+	 * @param table Table that receives the records.
+	 */
+	static void generateChunk(const StudentGenerator& generator, std::uint64_t first, std::uint64_t last, StudentTable& table)
+	{
+		Student student;
+		table.reserve(last - first);
+		for (std::uint64_t index = first; index < last; index++)
+		{
+			generator.generate(index, student);
+			table.append(student);
+		}
+	}
+
+	/**
+	 * @brief Writes a file of generated records.
+	 * @param filename Name of the file to write.
+	 * @param options Shape of the records.
+	 * @param recordCount Number of records.
+	 * @param binary Whether to write the binary columnar format instead of text.
+	 * @param threadCount Number of chunks generated at once; zero picks the pool threads plus the calling thread.
+	 * @return True if the file was written, false otherwise.
+	 */
+	bool generateStudentFile(const std::string& filename, const GeneratorOptions& options,
+		std::uint64_t recordCount, bool binary, std::size_t threadCount)
+	{
+		const StudentGenerator generator(options);
+		const std::uint64_t chunkCount = (recordCount + generatorChunkRecords - 1) / generatorChunkRecords;
+
+		if (threadCount == 0)
+			threadCount = ThreadPool::shared().size() + 1;
+		threadCount = static_cast<std::size_t>((std::min)(static_cast<std::uint64_t>(threadCount), (std::max)(chunkCount, std::uint64_t{ 1 })));
+
+		const auto runBatch = [](std::uint64_t firstChunk, std::uint64_t batchSize, const auto& work) {
+			ThreadPool::shared().parallelFor(static_cast<std::size_t>(batchSize), [&work, firstChunk](std::size_t i) { work(firstChunk + i, i); });
+		};
+		const auto chunkEnd = [recordCount](std::uint64_t chunk) {
+			return (std::min)((chunk + 1) * generatorChunkRecords, recordCount);
+		};
+
+		if (binary)
+		{
+			std::vector<StudentTable> tables(static_cast<std::size_t>(chunkCount));
+			for (std::uint64_t chunk = 0; chunk < chunkCount; chunk += threadCount)
+			{
+				runBatch(chunk, (std::min)(static_cast<std::uint64_t>(threadCount), chunkCount - chunk), [&](std::uint64_t current, std::size_t) {
+					generateChunk(generator, current * generatorChunkRecords, chunkEnd(current), tables[static_cast<std::size_t>(current)]);
+					});
+			}
+
+			std::vector<StudentView> views;
+			views.reserve(static_cast<std::size_t>(recordCount));
+			for (const auto& table : tables)
+			{
+				for (std::size_t i = 0; i < table.size(); i++)
+					views.push_back(table[i]);
+			}
+			return writeStudentsBinary(filename, views);
+		}
+
+		BufferedWriter out;
+		if (!out.open(filename))
+			return false;
+
+		std::vector<std::unique_ptr<BufferedWriter>> chunkText;
+		for (std::size_t i = 0; i < threadCount; i++)
+			chunkText.push_back(std::make_unique<BufferedWriter>(generatorChunkRecords * generator.maxTextRecordSize()));
+
+		for (std::uint64_t chunk = 0; chunk < chunkCount && out.good(); chunk += threadCount)
+		{
+			const std::uint64_t batchSize = (std::min)(static_cast<std::uint64_t>(threadCount), chunkCount - chunk);
+			runBatch(chunk, batchSize, [&](std::uint64_t current, std::size_t slot) {
+				formatChunk(generator, current * generatorChunkRecords, chunkEnd(current), *chunkText[slot]);
+				});
+
+			for (std::uint64_t i = 0; i < batchSize; i++)
+			{
+				out.write(chunkText[static_cast<std::size_t>(i)]->buffered());
+				chunkText[static_cast<std::size_t>(i)]->discard();
+			}
+		}
+
+		return out.close();
+	}
+
+} // database
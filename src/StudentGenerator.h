@@ -0,0 +1,111 @@
+#ifndef STUDENT_GENERATOR_H
+#define STUDENT_GENERATOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Student.h"
+
+namespace database
+{
+
+	/** @brief Shape of the records made by a StudentGenerator. */
+	struct GeneratorOptions
+	{
+		std::uint64_t seed = 42; ///< Seed every record is derived from.
+
+		std::size_t minScoresPerSubject = 3; ///< Fewest scores of a subject.
+		std::size_t maxScoresPerSubject = 8; ///< Most scores of a subject.
+
+		std::uint16_t minScore = 2; ///< Lowest score.
+		std::uint16_t maxScore = 10; ///< Highest score.
+		std::vector<double> scoreWeights; ///< Relative frequency of every score from minScore up; empty draws them uniformly.
+
+		std::size_t surnameCount = 5000; ///< Number of distinct surnames.
+		double surnameSkew = 0; ///< Zipf exponent of the surname frequencies; zero draws them uniformly.
+
+		std::uint64_t firstGroupNumber = 4300; ///< Lowest group number.
+		std::size_t groupCount = 100; ///< Number of distinct group numbers.
+
+		double duplicateRate = 0; ///< Share of records that repeat an earlier record.
+	};
+
+	inline constexpr std::size_t generatorChunkRecords = 16384; ///< Records one thread generates at a time when writing a file.
+
+	/**
+	 * @brief Makes deterministic synthetic student records.
+	 *
+	 * Every record is derived from the seed and its own position only, so the
+	 * same options always produce the same file, and records can be generated
+	 * in any order or by several threads at once. Averages are computed the way
+	 * records entered in the console interface get them.
+	 *
+	 * A duplicate is a copy of a record at a random earlier position, which is
+	 * itself drawn the same way, so duplicates stay independent of generation order.
+	 * Non-empty score weights set the score range to minScore up to minScore plus
+	 * their count minus one.
+	 */
+	class StudentGenerator
+	{
+	public:
+		/**
+		 * @brief Creates a generator.
+		 * @param options Shape of the records.
+		 */
+		explicit StudentGenerator(const GeneratorOptions& options);
+
+		/**
+		 * @brief Returns the options of the generator.
+		 * @return The options the generator was created with.
+		 */
+		const GeneratorOptions& options() const { return generatorOptions; }
+
+		/**
+		 * @brief Generates one record.
+		 * @param index Position of the record.
+		 * @param student Receives the record; its buffers are reused.
+		 */
+		void generate(std::uint64_t index, Student& student) const;
+
+		/**
+		 * @brief Returns an upper bound of the size of one record in the text format.
+		 * @return The most bytes writeStudent writes for a generated record.
+		 */
+		std::size_t maxTextRecordSize() const;
+
+		/**
+		 * @brief Returns one of the surnames the generator draws from.
+		 * @param surnameIndex Position of the surname, below the surname count.
+		 * @return The surname.
+		 */
+		static std::string surname(std::uint64_t surnameIndex);
+
+	private:
+		GeneratorOptions generatorOptions;
+
+		std::vector<double> surnameDistribution; ///< Cumulative surname frequencies, empty when uniform.
+		std::vector<double> scoreDistribution; ///< Cumulative score frequencies, empty when uniform.
+	};
+
+	/**
+	 * @brief Writes a file of generated records.
+	 *
+	 * Text files are generated and formatted in chunks by several threads and written in
+	 * order, so memory use is bounded by a few chunks per thread. Binary files hold their
+	 * columns in sections, so all records are generated before the file is written.
+	 *
+	 * @param filename Name of the file to write.
+	 * @param options Shape of the records.
+	 * @param recordCount Number of records.
+	 * @param binary Whether to write the binary columnar format instead of text.
+	 * @param threadCount Number of chunks generated at once; zero picks the pool threads plus the calling thread.
+	 * @return True if the file was written, false otherwise.
+	 */
+	bool generateStudentFile(const std::string& filename, const GeneratorOptions& options,
+		std::uint64_t recordCount, bool binary, std::size_t threadCount = 0);
+
+} // database
+
+#endif // STUDENT_GENERATOR_H
@@ -0,0 +1,433 @@
+#include "StudentImport.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <filesystem>
+#include <string_view>
+#include <vector>
+
+#include "BufferedWriter.h"
+#include "GradeKernels.h"
+#include "MappedFile.h"
+#include "Student.h"
+#include "StudentBinary.h"
+#include "StudentLog.h"
+#include "StudentReader.h"
+#include "StudentTable.h"
+#include "ThreadPool.h"
+
+namespace database
+{
+
+	/** @brief A row that failed validation. */
+	struct RejectedRow
+	{
+		std::size_t line;        ///< Line of the row within its chunk, counted from zero.
+		const char* reason;      ///< Why the row was rejected.
+		std::string_view text;   ///< The row as it appears in the input.
+	};
+
+	/** @brief A range of input lines and the result of parsing them. */
+	struct ImportChunk
+	{
+		const char* first = nullptr;
+		const char* last = nullptr;
+
+		StudentTable students;
+		std::vector<RejectedRow> rejects;
+		std::size_t lineCount = 0;
+	};
+
+	/**
+	 * @brief Removes leading and trailing spaces and tabs.
+	 * @param text The text to trim.
+	 * @return The trimmed text.
+	 */
+	static std::string_view trimBlanks(std::string_view text)
+	{
+		const std::size_t first = text.find_first_not_of(" \t");
+		if (first == std::string_view::npos)
+			return {};
+
+		const std::size_t last = text.find_last_not_of(" \t");
+		return text.substr(first, last - first + 1);
+	}
+
+	/**
+	 * @brief Splits a row into fields, resolving double-quoted fields.
+	 * @param line The row without its line terminator.
+	 * @param delimiter The field separator.
+	 * @param fields Receives the fields.
+	 * @return Nullptr on success, or the reason the row cannot be split.
+	 */
+	static const char* splitFields(std::string_view line, char delimiter, std::vector<std::string>& fields)
+	{
+		fields.clear();
+
+		std::size_t position = 0;
+		while (true)
+		{
+			std::string& field = fields.emplace_back();
+
+			// Blanks before an opening quote are not part of the field
+			std::size_t start = position;
+			while (start < line.size() && line[start] == ' ')
+				start++;
+
+			if (start < line.size() && line[start] == '"')
+			{
+				position = start + 1;
+				while (true)
+				{
+					const std::size_t quote = line.find('"', position);
+					if (quote == std::string_view::npos)
+						return "unterminated quoted field";
+
+					field.append(line.substr(position, quote - position));
+					position = quote + 1;
+
+					if (position < line.size() && line[position] == '"')
+					{
+						field += '"';
+						position++;
+						continue;
+					}
+					break;
+				}
+
+				while (position < line.size() && line[position] == ' ')
+					position++;
+				if (position < line.size() && line[position] != delimiter)
+					return "text after a quoted field";
+			}
+			else
+			{
+				const std::size_t end = (std::min)(line.find(delimiter, position), line.size());
+				field.append(line.substr(position, end - position));
+				position = end;
+			}
+
+			if (position >= line.size())
+				return nullptr;
+			position++; // Skip the delimiter
+		}
+	}
+
+	/**
+	 * @brief Parses an unsigned integer that must make up the whole text.
+	 * @param text The text to parse.
+	 * @param value Receives the value.
+	 * @return True if the text is a number in the range of the type, false otherwise.
+	 */
+	template <typename T>
+	static bool parseWholeNumber(std::string_view text, T& value)
+	{
+		const auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+		return !text.empty() && result.ec == std::errc() && result.ptr == text.data() + text.size();
+	}
+
+	/**
+	 * @brief Parses the scores of one subject.
+	 * @param field The field holding the scores, separated by spaces or semicolons.
+	 * @param scores Receives the scores.
+	 * @return Nullptr on success, or the reason the field is invalid.
+	 */
+	static const char* parseScoreField(std::string_view field, std::vector<std::uint16_t>& scores)
+	{
+		scores.clear();
+
+		while (true)
+		{
+			const std::size_t first = field.find_first_not_of(" ;");
+			if (first == std::string_view::npos)
+				break;
+			field.remove_prefix(first);
+
+			const std::size_t length = (std::min)(field.find_first_of(" ;"), field.size());
+			std::uint16_t score = 0;
+			if (!parseWholeNumber(field.substr(0, length), score))
+				return "invalid score";
+
+			scores.push_back(score);
+			field.remove_prefix(length);
+		}
+
+		return scores.empty() ? "subject without scores" : nullptr;
+	}
+
+	/**
+	 * @brief Parses and validates a row; the averages are left to the chunk.
+	 * @param line The row without its line terminator.
+	 * @param delimiter The field separator.
+	 * @param student Receives the student.
+	 * @param fields Scratch storage for the fields of the row.
+	 * @return Nullptr on success, or the reason the row is rejected.
+	 */
+	static const char* parseRow(std::string_view line, char delimiter, Student& student, std::vector<std::string>& fields)
+	{
+		if (const char* reason = splitFields(line, delimiter, fields))
+			return reason;
+		if (fields.size() != 5)
+			return "expected 5 fields";
+
+		student.surname.assign(trimBlanks(fields[0]));
+		if (student.surname.empty())
+			return "missing surname";
+
+		if (!parseWholeNumber(trimBlanks(fields[1]), student.groupNumber))
+			return "invalid group number";
+
+		if (const char* reason = parseScoreField(fields[2], student.phisicsScores))
+			return reason;
+		if (const char* reason = parseScoreField(fields[3], student.mathScores))
+			return reason;
+		if (const char* reason = parseScoreField(fields[4], student.informScores))
+			return reason;
+
+		return nullptr;
+	}
+
+	/**
+	 * @brief Parses every row of a chunk and computes the averages of the students; blank lines are skipped.
+	 * @param chunk The chunk to parse.
+	 * @param delimiter The field separator.
+	 */
+	static void parseChunk(ImportChunk& chunk, char delimiter)
+	{
+		std::vector<std::string> fields;
+		Student student;
+
+		const char* position = chunk.first;
+		while (position < chunk.last)
+		{
+			const char* lineEnd = static_cast<const char*>(std::memchr(position, '\n', chunk.last - position));
+			const char* next = lineEnd ? lineEnd + 1 : chunk.last;
+			if (!lineEnd)
+				lineEnd = chunk.last;
+
+			std::string_view line(position, lineEnd - position);
+			if (!line.empty() && line.back() == '\r')
+				line.remove_suffix(1);
+
+			if (!trimBlanks(line).empty())
+			{
+				if (const char* reason = parseRow(line, delimiter, student, fields))
+					chunk.rejects.push_back({ chunk.lineCount, reason, line });
+				else
+					chunk.students.append(student);
+			}
+
+			chunk.lineCount++;
+			position = next;
+		}
+
+		// The averages of the whole chunk are computed at once over its flattened scores
+		recalculateAverages(chunk.students);
+	}
+
+	/**
+	 * @brief Returns the name of the reject file of an import source.
+	 * @param inputFilename Name of the CSV or TSV file.
+	 * @return The name of the file that receives its rejected rows.
+	 */
+	std::string rejectFilename(const std::string& inputFilename)
+	{
+		return inputFilename + ".rejects";
+	}
+
+	/**
+	 * @brief Imports students from a CSV or TSV export into a student file.
+	 *
+	 * The input is split into chunks at line boundaries, which are parsed, validated and
+	 * given their averages in parallel. The chunks are then appended to the target file
+	 * in input order, so memory use is bounded by a few chunks per thread. Rows that fail
+	 * validation are written, with their line number and the reason, to the reject file.
+	 *
+	 * @param inputFilename Name of the CSV or TSV file.
+	 * @param outputFilename Name of the text or binary student file the rows are added to.
+	 * @param summary Receives the number of imported and rejected rows.
+	 * @param threadCount Number of chunks parsed at once; zero picks the pool threads plus the calling thread.
+	 * @return True if the import finished, false if a file could not be read or written.
+	 */
+	bool importStudents(const std::string& inputFilename, const std::string& outputFilename,
+		ImportSummary& summary, std::size_t threadCount)
+	{
+		summary = {};
+
+		MappedFile input;
+		if (!input.open(inputFilename))
+			return false;
+
+		const char* position = input.data();
+		const char* const end = input.data() + input.size();
+
+		// The first line decides the delimiter and may be a header
+		const char* firstLineEnd = position ? static_cast<const char*>(std::memchr(position, '\n', end - position)) : nullptr;
+		const std::string_view firstLine(position, (firstLineEnd ? firstLineEnd : end) - position);
+		const char delimiter = firstLine.find('\t') != std::string_view::npos ? '\t' : ',';
+
+		std::size_t lineNumber = 0;
+		std::vector<std::string> fields;
+		std::uint64_t groupNumber = 0;
+		if (!splitFields(firstLine, delimiter, fields) && fields.size() > 1
+			&& !parseWholeNumber(trimBlanks(fields[1]), groupNumber))
+		{
+			position = firstLineEnd ? firstLineEnd + 1 : end;
+			lineNumber = 1;
+		}
+
+		// Text files take the rows at their end; binary files are rewritten with them appended
+		const bool binary = isBinaryStudentFile(outputFilename);
+		std::vector<Student> binaryStudents;
+		BufferedWriter output;
+
+		if (binary)
+		{
+			if (!readStudentsBinary(outputFilename, binaryStudents))
+				return false;
+		}
+		else if (!checkpointStudentFile(outputFilename) || !output.open(outputFilename, true))
+			return false;
+
+		BufferedWriter rejects;
+
+		if (threadCount == 0)
+			threadCount = ThreadPool::shared().size() + 1;
+
+		while (position < end)
+		{
+			std::vector<ImportChunk> batch;
+			while (position < end && batch.size() < threadCount)
+			{
+				ImportChunk& chunk = batch.emplace_back();
+				chunk.first = position;
+				chunk.last = end;
+
+				if (static_cast<std::size_t>(end - position) > importChunkSize)
+				{
+					const char* lineEnd = static_cast<const char*>(std::memchr(position + importChunkSize, '\n', end - position - importChunkSize));
+					if (lineEnd)
+						chunk.last = lineEnd + 1;
+				}
+				position = chunk.last;
+			}
+
+			ThreadPool::shared().parallelFor(batch.size(), [&batch, delimiter](std::size_t i) { parseChunk(batch[i], delimiter); });
+
+			for (auto& chunk : batch)
+			{
+				for (const auto& reject : chunk.rejects)
+				{
+					if (!rejects.isOpen() && !rejects.open(rejectFilename(inputFilename)))
+						return false;
+
+					rejects.write("line ");
+					rejects.writeUnsigned(lineNumber + reject.line + 1);
+					rejects.write(": ");
+					rejects.write(reject.reason);
+					rejects.write(": ");
+					rejects.write(reject.text);
+					rejects.put('\n');
+				}
+
+				for (std::size_t i = 0; i < chunk.students.size(); i++)
+				{
+					if (binary)
+						binaryStudents.push_back(chunk.students.toStudent(i));
+					else
+						writeStudent(output, chunk.students[i]);
+				}
+
+				summary.importedCount += chunk.students.size();
+				summary.rejectedCount += chunk.rejects.size();
+				lineNumber += chunk.lineCount;
+			}
+		}
+
+		// A reject file from an earlier import of the same source is stale once every row passes
+		if (rejects.isOpen())
+		{
+			if (!rejects.close())
+				return false;
+		}
+		else
+		{
+			std::error_code error;
+			std::filesystem::remove(rejectFilename(inputFilename), error);
+		}
+
+		return binary ? writeStudentsBinary(outputFilename, binaryStudents) : output.close();
+	}
+
+	/**
+	 * @brief Writes scores separated by spaces.
+	 * @param out Writer to write to.
+	 * @param scores The scores to write.
+	 */
+	static void writeScoreField(BufferedWriter& out, const std::vector<std::uint16_t>& scores)
+	{
+		for (std::size_t i = 0; i < scores.size(); ++i)
+		{
+			if (i != 0)
+				out.put(' ');
+			out.writeUnsigned(scores[i]);
+		}
+	}
+
+	/**
+	 * @brief Exports a student file as CSV that importStudents reads back.
+	 *
+	 * The first line is a header; every row holds the surname, the group number and the
+	 * space-separated scores of the three subjects. Surnames are quoted when needed.
+	 *
+	 * @param inputFilename Name of the text or binary student file.
+	 * @param outputFilename Name of the CSV file to write.
+	 * @return True if the file was exported, false if a file could not be read or written.
+	 */
+	bool exportStudentsCsv(const std::string& inputFilename, const std::string& outputFilename)
+	{
+		if (!checkpointStudentFile(inputFilename))
+			return false;
+
+		StudentReader reader(inputFilename);
+		if (!reader.isOpen())
+			return false;
+
+		BufferedWriter out;
+		if (!out.open(outputFilename))
+			return false;
+
+		out.write("surname,group,physics,math,cs\n");
+		for (const Student& student : reader)
+		{
+			const std::string_view surname = student.surname;
+			if (surname.find_first_of(",\"") != std::string_view::npos || trimBlanks(surname) != surname)
+			{
+				out.put('"');
+				for (char character : surname)
+				{
+					if (character == '"')
+						out.put('"');
+					out.put(character);
+				}
+				out.put('"');
+			}
+			else
+				out.write(surname);
+
+			out.put(',');
+			out.writeUnsigned(student.groupNumber);
+			out.put(',');
+			writeScoreField(out, student.phisicsScores);
+			out.put(',');
+			writeScoreField(out, student.mathScores);
+			out.put(',');
+			writeScoreField(out, student.informScores);
+			out.put('\n');
+		}
+
+		return out.close();
+	}
+
+} // database
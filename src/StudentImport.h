@@ -0,0 +1,63 @@
+#ifndef STUDENT_IMPORT_H
+#define STUDENT_IMPORT_H
+
+#include <cstddef>
+#include <string>
+
+namespace database
+{
+
+	inline constexpr std::size_t importChunkSize = std::size_t{ 4 } << 20; ///< Bytes of input one import thread parses at a time.
+
+	/** @brief Outcome of a bulk import. */
+	struct ImportSummary
+	{
+		std::size_t importedCount{}; ///< Rows added to the target file.
+		std::size_t rejectedCount{}; ///< Rows written to the reject file instead.
+	};
+
+	/**
+	 * @brief Returns the name of the reject file of an import source.
+	 * @param inputFilename Name of the CSV or TSV file.
+	 * @return The name of the file that receives its rejected rows.
+	 */
+	std::string rejectFilename(const std::string& inputFilename);
+
+	/**
+	 * @brief Imports students from a CSV or TSV export into a student file.
+	 *
+	 * Every row holds five fields: surname, group number, physics scores, math scores
+	 * and computer science scores, with the scores of a subject separated by spaces or
+	 * semicolons. Fields are separated by tabs if the first line contains one and by
+	 * commas otherwise; CSV fields may be double-quoted. A first line whose group number
+	 * is not a number is taken as a header and skipped.
+	 *
+	 * The input is split into chunks at line boundaries, which are parsed, validated and
+	 * given their averages in parallel. The chunks are then appended to the target file
+	 * in input order, so memory use is bounded by a few chunks per thread. Rows that fail
+	 * validation are written, with their line number and the reason, to the reject file.
+	 *
+	 * @param inputFilename Name of the CSV or TSV file.
+	 * @param outputFilename Name of the text or binary student file the rows are added to.
+	 * @param summary Receives the number of imported and rejected rows.
+	 * @param threadCount Number of chunks parsed at once; zero picks the pool threads plus the calling thread.
+	 * @return True if the import finished, false if a file could not be read or written.
+	 */
+	bool importStudents(const std::string& inputFilename, const std::string& outputFilename,
+		ImportSummary& summary, std::size_t threadCount = 0);
+
+	/**
+	 * @brief Exports a student file as CSV that importStudents reads back.
+	 *
+	 * The first line is a header; every row holds the surname, the group number and the
+	 * space-separated scores of the three subjects. Surnames are quoted when needed.
+	 *
+	 * @param inputFilename Name of the text or binary student file.
+	 * @param outputFilename Name of the CSV file to write.
+	 * @return True if the file was exported, false if a file could not be read or written.
+	 */
+	bool exportStudentsCsv(const std::string& inputFilename, const std::string& outputFilename);
+
+} // database
+
+#endif // STUDENT_IMPORT_H
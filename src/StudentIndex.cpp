@@ -0,0 +1,587 @@
+#include "StudentIndex.h"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+#include "BufferedWriter.h"
+#include "MappedFile.h"
+#include "MappedStudentFile.h"
+#include "StudentBinary.h"
+#include "StudentParser.h"
+
+namespace database
+{
+
+	/**
+	 * @brief Returns the name of the sidecar index of a data file.
+	 * @param dataFilename Name of the data file.
+	 * @return The name of its index file.
+	 */
+	std::string indexFilename(const std::string& dataFilename)
+	{
+		return dataFilename + ".idx";
+	}
+
+	/**
+	 * @brief Reads the size and modification time of a data file.
+	 * @param filename Name of the data file.
+	 * @param size Receives the size of the file in bytes.
+	 * @param modified Receives the modification time of the file.
+	 * @return True if the file exists, false otherwise.
+	 */
+	bool readDataStamp(const std::string& filename, std::uint64_t& size, std::int64_t& modified)
+	{
+		std::error_code error;
+		size = std::filesystem::file_size(filename, error);
+		if (error)
+			return false;
+
+		const auto time = std::filesystem::last_write_time(filename, error);
+		if (error)
+			return false;
+
+		modified = static_cast<std::int64_t>(time.time_since_epoch().count());
+		return true;
+	}
+
+	/**
+	 * @brief Visits every record of a data file in file order.
+	 * @param filename Name of the text or binary data file.
+	 * @param visit Called with every record and its record offset.
+	 * @return True if the file was read, false if it could not be opened.
+	 */
+	bool forEachRecord(const std::string& filename, const std::function<void(const StudentView&, std::uint64_t)>& visit)
+	{
+		if (isBinaryStudentFile(filename))
+		{
+			MappedStudentFile file;
+			if (!file.open(filename))
+				return false;
+
+			for (std::size_t i = 0; i < file.size(); i++)
+				visit(file[i], i);
+			return true;
+		}
+
+		MappedFile file;
+		if (!file.open(filename))
+			return false;
+
+		StudentParser parser(file.data(), file.data() + file.size());
+		Student student;
+
+		std::uint64_t recordOffset = 0;
+		while (parser.next(student))
+		{
+			visit(makeStudentView(student), recordOffset);
+			recordOffset = parser.position() - file.data();
+		}
+		return true;
+	}
+
+	/**
+	 * @brief Returns the size of the header and base section described by a header.
+	 * @param header The header of a sidecar file.
+	 * @return The offset of the first delta entry.
+	 */
+	static std::uint64_t baseEnd(const IndexFileHeader& header)
+	{
+		return sizeof(IndexFileHeader) + (4 * header.entryCount + 1) * sizeof(std::uint64_t) + header.surnameHeapSize;
+	}
+
+	/**
+	 * @brief Writes a column of trivially copyable values.
+	 * @param file Writer to write to.
+	 * @param column The values to write.
+	 */
+	template <typename T>
+	static void writeColumn(BufferedWriter& file, const std::vector<T>& column)
+	{
+		file.writeColumn(std::span<const T>(column));
+	}
+
+	/**
+	 * @brief Opens the indexes of a data file, rebuilding them if they are missing or stale.
+	 * @param dataFilename Name of the data file.
+	 * @return True if the indexes are available, false if the data file could not be read.
+	 */
+	bool StudentIndex::open(const std::string& dataFilename)
+	{
+		this->dataFilename = dataFilename;
+
+		if (load())
+			return true;
+
+		return rebuild();
+	}
+
+	/**
+	 * @brief Rebuilds the indexes from the data file and saves them.
+	 *
+	 * Failing to save the sidecar file is not an error; the indexes are then kept in
+	 * memory and rebuilt again on the next open.
+	 *
+	 * @return True if the indexes were rebuilt, false if the data file could not be read.
+	 */
+	bool StudentIndex::rebuild()
+	{
+		std::vector<SurnameEntry> surnameEntries;
+		std::vector<GroupEntry> groupEntries;
+
+		const bool read = forEachRecord(dataFilename, [&](const StudentView& student, std::uint64_t recordOffset) {
+			surnameEntries.push_back({ std::string(student.surname), recordOffset });
+			groupEntries.push_back({ student.groupNumber, recordOffset });
+			});
+		if (!read)
+			return false;
+
+		// Entries were collected in file order, so stable sorting keeps equal keys in file order
+		std::stable_sort(surnameEntries.begin(), surnameEntries.end(), [](const SurnameEntry& a, const SurnameEntry& b) {
+			return a.surname < b.surname;
+			});
+		std::stable_sort(groupEntries.begin(), groupEntries.end(), [](const GroupEntry& a, const GroupEntry& b) {
+			return a.groupNumber < b.groupNumber;
+			});
+
+		BaseColumns columns;
+		columns.surnameOffsets.reserve(surnameEntries.size() + 1);
+		columns.surnameOffsets.push_back(0);
+		for (const auto& entry : surnameEntries)
+		{
+			columns.surnameHeap += entry.surname;
+			columns.surnameOffsets.push_back(columns.surnameHeap.size());
+			columns.surnameRecords.push_back(entry.recordOffset);
+		}
+		for (const auto& entry : groupEntries)
+		{
+			columns.groupNumbers.push_back(entry.groupNumber);
+			columns.groupRecords.push_back(entry.recordOffset);
+		}
+
+		store(std::move(columns));
+		return true;
+	}
+
+	/**
+	 * @brief Adds a record appended to the data file and saves it as a delta entry.
+	 *
+	 * The indexes must have been opened before the data file was modified.
+	 *
+	 * @param student The appended student.
+	 * @param recordOffset Offset of the appended record in the data file.
+	 * @return True if the updated indexes were saved, false otherwise.
+	 */
+	bool StudentIndex::append(const StudentView& student, std::uint64_t recordOffset)
+	{
+		// The appended record has the largest offset, so it goes after every equal key
+		auto surnamePosition = std::upper_bound(surnameDelta.begin(), surnameDelta.end(), student.surname,
+			[](std::string_view surname, const SurnameEntry& entry) { return surname < entry.surname; });
+		surnameDelta.insert(surnamePosition, { std::string(student.surname), recordOffset });
+
+		auto groupPosition = std::upper_bound(groupDelta.begin(), groupDelta.end(), student.groupNumber,
+			[](std::uint64_t groupNumber, const GroupEntry& entry) { return groupNumber < entry.groupNumber; });
+		groupDelta.insert(groupPosition, { student.groupNumber, recordOffset });
+
+		if (surnameDelta.size() >= indexDeltaLimit)
+			return mergeDelta();
+
+		// A sidecar that does not hold the current base must not receive entries for it
+		if (!persisted)
+			return false;
+
+		// The entry is written after the last one and the header is restamped; until the header is
+		// written the sidecar stays stale, so a crash in between only costs a rebuild
+#ifdef _WIN32
+		sidecar.close(); // A mapped file cannot be opened for writing, so the base is mapped again below
+#endif
+		bool written = false;
+		{
+			std::fstream file(indexFilename(dataFilename), std::ios::binary | std::ios::in | std::ios::out);
+
+			const IndexDeltaEntry entry{ student.groupNumber, recordOffset, student.surname.size() };
+			file.seekp(static_cast<std::streamoff>(baseEnd(header) + header.deltaSize));
+			file.write(reinterpret_cast<const char*>(&entry), sizeof(entry));
+			file.write(student.surname.data(), static_cast<std::streamsize>(student.surname.size()));
+			header.deltaSize += sizeof(entry) + student.surname.size();
+
+			if (file && readDataStamp(dataFilename, header.dataSize, header.dataModified))
+			{
+				file.seekp(0);
+				file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+				written = static_cast<bool>(file.flush());
+			}
+		}
+
+		// Entries that did not reach the sidecar stay in memory, and the stale sidecar is rebuilt on the next open
+		const bool mapped = mapBase();
+		persisted = written && mapped;
+		return persisted;
+	}
+
+	/**
+	 * @brief Finds the records with the given surname.
+	 * @param surname The surname to look up.
+	 * @return The record offsets, in file order.
+	 */
+	std::vector<std::uint64_t> StudentIndex::findBySurname(std::string_view surname) const
+	{
+		std::vector<std::uint64_t> recordOffsets;
+		for (std::size_t i = lowerBaseSurname(surname); i < surnameRecords.size() && baseSurname(i) == surname; i++)
+			recordOffsets.push_back(surnameRecords[i]);
+
+		// Delta entries were appended after every base record, so they follow it in file order
+		auto it = std::lower_bound(surnameDelta.begin(), surnameDelta.end(), surname,
+			[](const SurnameEntry& entry, std::string_view key) { return entry.surname < key; });
+		for (; it != surnameDelta.end() && it->surname == surname; ++it)
+			recordOffsets.push_back(it->recordOffset);
+
+		return recordOffsets;
+	}
+
+	/**
+	 * @brief Finds the records whose surname starts with a prefix.
+	 * @param prefix The prefix to look up.
+	 * @return The record offsets, in surname order.
+	 */
+	std::vector<std::uint64_t> StudentIndex::findBySurnamePrefix(std::string_view prefix) const
+	{
+		using Match = std::pair<std::string_view, std::uint64_t>;
+
+		std::vector<Match> baseMatches;
+		for (std::size_t i = lowerBaseSurname(prefix); i < surnameRecords.size() && baseSurname(i).starts_with(prefix); i++)
+			baseMatches.emplace_back(baseSurname(i), surnameRecords[i]);
+
+		std::vector<Match> deltaMatches;
+		auto it = std::lower_bound(surnameDelta.begin(), surnameDelta.end(), prefix,
+			[](const SurnameEntry& entry, std::string_view key) { return entry.surname < key; });
+		for (; it != surnameDelta.end() && it->surname.starts_with(prefix); ++it)
+			deltaMatches.emplace_back(it->surname, it->recordOffset);
+
+		// Merging takes base entries first on equal surnames, which keeps those in file order
+		std::vector<Match> matches(baseMatches.size() + deltaMatches.size());
+		std::merge(baseMatches.begin(), baseMatches.end(), deltaMatches.begin(), deltaMatches.end(), matches.begin(),
+			[](const Match& a, const Match& b) { return a.first < b.first; });
+
+		std::vector<std::uint64_t> recordOffsets;
+		recordOffsets.reserve(matches.size());
+		for (const auto& match : matches)
+			recordOffsets.push_back(match.second);
+
+		return recordOffsets;
+	}
+
+	/**
+	 * @brief Finds the records of a group.
+	 * @param groupNumber The group number to look up.
+	 * @return The record offsets, in file order.
+	 */
+	std::vector<std::uint64_t> StudentIndex::findByGroup(std::uint64_t groupNumber) const
+	{
+		std::vector<std::uint64_t> recordOffsets;
+		const auto first = std::lower_bound(groupNumbers.begin(), groupNumbers.end(), groupNumber);
+		for (std::size_t i = first - groupNumbers.begin(); i < groupNumbers.size() && groupNumbers[i] == groupNumber; i++)
+			recordOffsets.push_back(groupRecords[i]);
+
+		auto it = std::lower_bound(groupDelta.begin(), groupDelta.end(), groupNumber,
+			[](const GroupEntry& entry, std::uint64_t key) { return entry.groupNumber < key; });
+		for (; it != groupDelta.end() && it->groupNumber == groupNumber; ++it)
+			recordOffsets.push_back(it->recordOffset);
+
+		return recordOffsets;
+	}
+
+	/**
+	 * @brief Loads the sidecar file if it matches the data file.
+	 *
+	 * Only the delta entries are read; the base stays in the mapping.
+	 *
+	 * @return True if a fresh index was loaded, false otherwise.
+	 */
+	bool StudentIndex::load()
+	{
+		std::uint64_t dataSize = 0;
+		std::int64_t dataModified = 0;
+		if (!readDataStamp(dataFilename, dataSize, dataModified))
+			return false;
+
+		MappedFile file;
+		if (!file.open(indexFilename(dataFilename)) || file.size() < sizeof(IndexFileHeader))
+			return false;
+
+		IndexFileHeader loaded{};
+		std::memcpy(&loaded, file.data(), sizeof(loaded));
+		if (std::memcmp(loaded.magic, indexFileMagic, sizeof(loaded.magic)) != 0 || loaded.version != indexFileVersion
+			|| loaded.dataSize != dataSize || loaded.dataModified != dataModified)
+			return false;
+
+		// Reject sizes that cannot fit in the sidecar file before computing offsets from them
+		const std::uint64_t fileSize = file.size();
+		if (loaded.entryCount > fileSize / (4 * sizeof(std::uint64_t)) || loaded.surnameHeapSize > fileSize
+			|| loaded.deltaSize > fileSize || baseEnd(loaded) + loaded.deltaSize > fileSize)
+			return false;
+
+		std::vector<SurnameEntry> surnames;
+		std::vector<GroupEntry> groups;
+		for (std::uint64_t position = baseEnd(loaded); position < baseEnd(loaded) + loaded.deltaSize;)
+		{
+			IndexDeltaEntry entry{};
+			if (baseEnd(loaded) + loaded.deltaSize - position < sizeof(entry))
+				return false;
+			std::memcpy(&entry, file.data() + position, sizeof(entry));
+			position += sizeof(entry);
+
+			if (entry.surnameSize > baseEnd(loaded) + loaded.deltaSize - position)
+				return false;
+			std::string surname(file.data() + position, static_cast<std::size_t>(entry.surnameSize));
+			position += entry.surnameSize;
+
+			// Entries are stored in file order, so inserting after equal keys keeps them in file order
+			auto surnamePosition = std::upper_bound(surnames.begin(), surnames.end(), surname,
+				[](const std::string& key, const SurnameEntry& other) { return key < other.surname; });
+			surnames.insert(surnamePosition, { std::move(surname), entry.recordOffset });
+
+			auto groupPosition = std::upper_bound(groups.begin(), groups.end(), entry.groupNumber,
+				[](std::uint64_t key, const GroupEntry& other) { return key < other.groupNumber; });
+			groups.insert(groupPosition, { entry.groupNumber, entry.recordOffset });
+		}
+
+		sidecar = std::move(file);
+		header = loaded;
+		if (!mapBase())
+			return false;
+
+		owned = BaseColumns{};
+		surnameDelta = std::move(surnames);
+		groupDelta = std::move(groups);
+		persisted = true;
+		return true;
+	}
+
+	/**
+	 * @brief Maps the sidecar file and points the base columns at it.
+	 * @return True if the file holds the base described by the header, false otherwise.
+	 */
+	bool StudentIndex::mapBase()
+	{
+		surnameOffsets = {};
+		surnameRecords = {};
+		groupNumbers = {};
+		groupRecords = {};
+		surnameHeap = {};
+
+		if (!sidecar.isOpen() && !sidecar.open(indexFilename(dataFilename)))
+			return false;
+		if (sidecar.size() < baseEnd(header))
+			return false;
+
+		// The columns start 8-byte aligned, since the mapping is page aligned and the header is a multiple of 8 bytes
+		static_assert(sizeof(IndexFileHeader) % sizeof(std::uint64_t) == 0);
+		const auto* columns = reinterpret_cast<const std::uint64_t*>(sidecar.data() + sizeof(IndexFileHeader));
+		const std::size_t count = static_cast<std::size_t>(header.entryCount);
+
+		surnameOffsets = { columns, count + 1 };
+		surnameRecords = { columns + count + 1, count };
+		groupNumbers = { columns + 2 * count + 1, count };
+		groupRecords = { columns + 3 * count + 1, count };
+		surnameHeap = { reinterpret_cast<const char*>(columns + 4 * count + 1), static_cast<std::size_t>(header.surnameHeapSize) };
+		return true;
+	}
+
+	/**
+	 * @brief Replaces the base with new columns and the delta with nothing, and saves them.
+	 *
+	 * If the sidecar file cannot be written, the columns are kept in memory instead.
+	 *
+	 * @param columns The new base.
+	 * @return True if the sidecar file was written, false otherwise.
+	 */
+	bool StudentIndex::store(BaseColumns columns)
+	{
+		surnameDelta.clear();
+		groupDelta.clear();
+		persisted = false;
+		sidecar.close();
+
+		header = IndexFileHeader{};
+		std::memcpy(header.magic, indexFileMagic, sizeof(header.magic));
+		header.version = indexFileVersion;
+		header.entryCount = columns.surnameRecords.size();
+		header.surnameHeapSize = columns.surnameHeap.size();
+
+		// The index is written next to its final name and renamed, so readers never see a partial file
+		const std::string filename = indexFilename(dataFilename);
+		const std::string temporaryFilename = filename + ".tmp";
+
+		bool written = readDataStamp(dataFilename, header.dataSize, header.dataModified);
+		if (written)
+		{
+			BufferedWriter file;
+			written = file.open(temporaryFilename);
+
+			file.write(&header, sizeof(header));
+			writeColumn(file, columns.surnameOffsets);
+			writeColumn(file, columns.surnameRecords);
+			writeColumn(file, columns.groupNumbers);
+			writeColumn(file, columns.groupRecords);
+			file.write(columns.surnameHeap);
+
+			written = file.sync() && written;
+			written = file.close() && written;
+			written = replaceWithTemporary(temporaryFilename, filename, written);
+		}
+
+		if (written && mapBase())
+		{
+			owned = BaseColumns{};
+			persisted = true;
+			return true;
+		}
+
+		// The indexes still serve lookups from memory until the next open
+		owned = std::move(columns);
+		surnameOffsets = owned.surnameOffsets;
+		surnameRecords = owned.surnameRecords;
+		groupNumbers = owned.groupNumbers;
+		groupRecords = owned.groupRecords;
+		surnameHeap = owned.surnameHeap;
+		return false;
+	}
+
+	/**
+	 * @brief Merges the delta entries into the base and saves it.
+	 * @return True if the sidecar file was written, false otherwise.
+	 */
+	bool StudentIndex::mergeDelta()
+	{
+		const std::size_t count = surnameRecords.size() + surnameDelta.size();
+
+		BaseColumns columns;
+		columns.surnameOffsets.reserve(count + 1);
+		columns.surnameRecords.reserve(count);
+		columns.groupNumbers.reserve(count);
+		columns.groupRecords.reserve(count);
+		columns.surnameHeap.reserve(surnameHeap.size());
+		columns.surnameOffsets.push_back(0);
+
+		const auto addSurname = [&columns](std::string_view surname, std::uint64_t recordOffset) {
+			columns.surnameHeap += surname;
+			columns.surnameOffsets.push_back(columns.surnameHeap.size());
+			columns.surnameRecords.push_back(recordOffset);
+			};
+		const auto addGroup = [&columns](std::uint64_t groupNumber, std::uint64_t recordOffset) {
+			columns.groupNumbers.push_back(groupNumber);
+			columns.groupRecords.push_back(recordOffset);
+			};
+
+		// Base entries precede delta entries with equal keys, since they come first in the data file
+		std::size_t base = 0;
+		for (const auto& entry : surnameDelta)
+		{
+			for (; base < surnameRecords.size() && !(entry.surname < baseSurname(base)); base++)
+				addSurname(baseSurname(base), surnameRecords[base]);
+			addSurname(entry.surname, entry.recordOffset);
+		}
+		for (; base < surnameRecords.size(); base++)
+			addSurname(baseSurname(base), surnameRecords[base]);
+
+		base = 0;
+		for (const auto& entry : groupDelta)
+		{
+			for (; base < groupNumbers.size() && groupNumbers[base] <= entry.groupNumber; base++)
+				addGroup(groupNumbers[base], groupRecords[base]);
+			addGroup(entry.groupNumber, entry.recordOffset);
+		}
+		for (; base < groupNumbers.size(); base++)
+			addGroup(groupNumbers[base], groupRecords[base]);
+
+		return store(std::move(columns));
+	}
+
+	/**
+	 * @brief Returns the surname of a base entry.
+	 * @param position Position of the entry in surname order.
+	 * @return The surname, or an empty one if the sidecar file is damaged.
+	 */
+	std::string_view StudentIndex::baseSurname(std::size_t position) const
+	{
+		const std::uint64_t begin = surnameOffsets[position];
+		const std::uint64_t end = surnameOffsets[position + 1];
+		if (begin > end || end > surnameHeap.size())
+			return {};
+
+		return surnameHeap.substr(static_cast<std::size_t>(begin), static_cast<std::size_t>(end - begin));
+	}
+
+	/**
+	 * @brief Finds the first base entry whose surname is not less than a key.
+	 * @param key The surname to look for.
+	 * @return The position of the entry, or the number of entries if there is none.
+	 */
+	std::size_t StudentIndex::lowerBaseSurname(std::string_view key) const
+	{
+		std::size_t first = 0;
+		std::size_t count = surnameRecords.size();
+		while (count > 0)
+		{
+			const std::size_t step = count / 2;
+			if (baseSurname(first + step) < key)
+			{
+				first += step + 1;
+				count -= step + 1;
+			}
+			else
+				count = step;
+		}
+		return first;
+	}
+
+	/**
+	 * @brief Reads the records at the given offsets of a data file.
+	 * @param filename Name of the text or binary data file.
+	 * @param recordOffsets Offsets returned by a StudentIndex lookup.
+	 * @param students Vector that receives the students, in the order of the offsets.
+	 * @return True if every record was read, false otherwise.
+	 */
+	bool readStudentsAt(const std::string& filename, std::span<const std::uint64_t> recordOffsets, std::vector<Student>& students)
+	{
+		students.clear();
+		students.reserve(recordOffsets.size());
+
+		if (isBinaryStudentFile(filename))
+		{
+			MappedStudentFile file;
+			if (!file.open(filename))
+				return false;
+
+			for (std::uint64_t recordOffset : recordOffsets)
+			{
+				if (recordOffset >= file.size())
+					return false;
+
+				students.push_back(toStudent(file[static_cast<std::size_t>(recordOffset)]));
+			}
+			return true;
+		}
+
+		MappedFile file;
+		if (!file.open(filename))
+			return false;
+
+		Student student;
+		for (std::uint64_t recordOffset : recordOffsets)
+		{
+			if (recordOffset >= file.size())
+				return false;
+
+			StudentParser parser(file.data() + recordOffset, file.data() + file.size());
+			if (!parser.next(student))
+				return false;
+
+			students.push_back(student);
+		}
+		return true;
+	}
+
+} // database
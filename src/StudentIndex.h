@@ -0,0 +1,242 @@
+#ifndef STUDENT_INDEX_H
+#define STUDENT_INDEX_H
+
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "MappedFile.h"
+#include "Student.h"
+
+namespace database
+{
+
+	/**
+	 * @brief Header of a sidecar index file.
+	 *
+	 * The header is followed by the sorted base section, made of 8-byte aligned
+	 * columns: the surname offsets (count + 1 entries), the record offsets in surname
+	 * order, the group numbers and record offsets in group order, and the surname heap.
+	 * Records appended since the base was written follow it as delta entries. The size
+	 * and modification time of the data file are recorded so a stale index is detected.
+	 */
+	struct IndexFileHeader
+	{
+		char magic[4]{};
+
+		std::uint32_t version{};
+
+		std::uint64_t dataSize{};
+		std::int64_t dataModified{};
+
+		std::uint64_t entryCount{};
+		std::uint64_t surnameHeapSize{};
+
+		std::uint64_t deltaSize{};
+	};
+
+	/**
+	 * @brief Fixed part of a delta entry of a sidecar index file; the surname bytes follow it.
+	 */
+	struct IndexDeltaEntry
+	{
+		std::uint64_t groupNumber{};
+		std::uint64_t recordOffset{};
+		std::uint64_t surnameSize{};
+	};
+
+	inline constexpr char indexFileMagic[4] = { 'S', 'D', 'B', 'I' }; ///< Marks a sidecar index file.
+	inline constexpr std::uint32_t indexFileVersion = 2; ///< Current version of the index layout.
+	inline constexpr std::size_t indexDeltaLimit = 4096; ///< Number of delta entries that are merged into the base.
+
+	/**
+	 * @brief Returns the name of the sidecar index of a data file.
+	 * @param dataFilename Name of the data file.
+	 * @return The name of its index file.
+	 */
+	std::string indexFilename(const std::string& dataFilename);
+
+	/**
+	 * @brief Reads the size and modification time of a data file.
+	 * @param filename Name of the data file.
+	 * @param size Receives the size of the file in bytes.
+	 * @param modified Receives the modification time of the file.
+	 * @return True if the file exists, false otherwise.
+	 */
+	bool readDataStamp(const std::string& filename, std::uint64_t& size, std::int64_t& modified);
+
+	/**
+	 * @brief Visits every record of a data file in file order.
+	 *
+	 * The record offset is the byte offset of the record in a text file, or the record
+	 * position in a binary file.
+	 *
+	 * @param filename Name of the text or binary data file.
+	 * @param visit Called with every record and its record offset.
+	 * @return True if the file was read, false if it could not be opened.
+	 */
+	bool forEachRecord(const std::string& filename, const std::function<void(const StudentView&, std::uint64_t)>& visit);
+
+	/**
+	 * @brief Secondary indexes of a student file on surname and group number.
+	 *
+	 * Both indexes map keys to record offsets: the byte offset of the record in a text
+	 * file, or the record position in a binary file. The surname index is sorted by
+	 * surname and supports exact and prefix lookups; the group index is a sorted
+	 * group number to record multimap. Lookups cost O(log n) plus the size of the result.
+	 *
+	 * The indexes persist in a sidecar file next to the data file and are rebuilt
+	 * automatically when the data file's size or modification time no longer match.
+	 * The sorted base of the sidecar is memory-mapped and binary searched in place.
+	 * Appended records are written to the end of the sidecar as delta entries, which
+	 * are kept sorted in memory and merged into a rewritten base once there are
+	 * indexDeltaLimit of them.
+	 */
+	class StudentIndex
+	{
+	public:
+		/**
+		 * @brief Opens the indexes of a data file, rebuilding them if they are missing or stale.
+		 * @param dataFilename Name of the data file.
+		 * @return True if the indexes are available, false if the data file could not be read.
+		 */
+		bool open(const std::string& dataFilename);
+
+		/**
+		 * @brief Rebuilds the indexes from the data file and saves them.
+		 *
+		 * Failing to save the sidecar file is not an error; the indexes are then kept in
+		 * memory and rebuilt again on the next open.
+		 *
+		 * @return True if the indexes were rebuilt, false if the data file could not be read.
+		 */
+		bool rebuild();
+
+		/**
+		 * @brief Adds a record appended to the data file and saves it as a delta entry.
+		 *
+		 * The indexes must have been opened before the data file was modified.
+		 *
+		 * @param student The appended student.
+		 * @param recordOffset Offset of the appended record in the data file.
+		 * @return True if the updated indexes were saved, false otherwise.
+		 */
+		bool append(const StudentView& student, std::uint64_t recordOffset);
+
+		/** @brief Returns the number of indexed records. */
+		std::size_t size() const { return surnameRecords.size() + surnameDelta.size(); }
+
+		/**
+		 * @brief Finds the records with the given surname.
+		 * @param surname The surname to look up.
+		 * @return The record offsets, in file order.
+		 */
+		std::vector<std::uint64_t> findBySurname(std::string_view surname) const;
+
+		/**
+		 * @brief Finds the records whose surname starts with a prefix.
+		 * @param prefix The prefix to look up.
+		 * @return The record offsets, in surname order.
+		 */
+		std::vector<std::uint64_t> findBySurnamePrefix(std::string_view prefix) const;
+
+		/**
+		 * @brief Finds the records of a group.
+		 * @param groupNumber The group number to look up.
+		 * @return The record offsets, in file order.
+		 */
+		std::vector<std::uint64_t> findByGroup(std::uint64_t groupNumber) const;
+
+	private:
+		/** @brief Surname of a record paired with its offset. */
+		struct SurnameEntry
+		{
+			std::string surname;
+			std::uint64_t recordOffset;
+		};
+
+		/** @brief Group number of a record paired with its offset. */
+		struct GroupEntry
+		{
+			std::uint64_t groupNumber;
+			std::uint64_t recordOffset;
+		};
+
+		/** @brief Columns of a base section held in memory. */
+		struct BaseColumns
+		{
+			std::vector<std::uint64_t> surnameOffsets, surnameRecords, groupNumbers, groupRecords;
+			std::string surnameHeap;
+		};
+
+		/**
+		 * @brief Loads the sidecar file if it matches the data file.
+		 * @return True if a fresh index was loaded, false otherwise.
+		 */
+		bool load();
+
+		/**
+		 * @brief Maps the sidecar file and points the base columns at it.
+		 * @return True if the file holds the base described by the header, false otherwise.
+		 */
+		bool mapBase();
+
+		/**
+		 * @brief Replaces the base with new columns and the delta with nothing, and saves them.
+		 *
+		 * If the sidecar file cannot be written, the columns are kept in memory instead.
+		 *
+		 * @param columns The new base.
+		 * @return True if the sidecar file was written, false otherwise.
+		 */
+		bool store(BaseColumns columns);
+
+		/**
+		 * @brief Merges the delta entries into the base and saves it.
+		 * @return True if the sidecar file was written, false otherwise.
+		 */
+		bool mergeDelta();
+
+		/**
+		 * @brief Returns the surname of a base entry.
+		 * @param position Position of the entry in surname order.
+		 * @return The surname, or an empty one if the sidecar file is damaged.
+		 */
+		std::string_view baseSurname(std::size_t position) const;
+
+		/**
+		 * @brief Finds the first base entry whose surname is not less than a key.
+		 * @param key The surname to look for.
+		 * @return The position of the entry, or the number of entries if there is none.
+		 */
+		std::size_t lowerBaseSurname(std::string_view key) const;
+
+		std::string dataFilename;
+
+		IndexFileHeader header{};
+		MappedFile sidecar;
+		bool persisted = false; ///< Whether the sidecar file holds the base and the delta.
+
+		BaseColumns owned; ///< The base while it is not mapped from the sidecar file.
+		std::span<const std::uint64_t> surnameOffsets, surnameRecords, groupNumbers, groupRecords;
+		std::string_view surnameHeap;
+
+		std::vector<SurnameEntry> surnameDelta;
+		std::vector<GroupEntry> groupDelta;
+	};
+
+	/**
+	 * @brief Reads the records at the given offsets of a data file.
+	 * @param filename Name of the text or binary data file.
+	 * @param recordOffsets Offsets returned by a StudentIndex lookup.
+	 * @param students Vector that receives the students, in the order of the offsets.
+	 * @return True if every record was read, false otherwise.
+	 */
+	bool readStudentsAt(const std::string& filename, std::span<const std::uint64_t> recordOffsets, std::vector<Student>& students);
+
+} // database
+
+#endif // STUDENT_INDEX_H
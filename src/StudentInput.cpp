@@ -0,0 +1,79 @@
+#include "StudentInput.h"
+
+#include <iostream>
+#include <string>
+
+#include "Utils.h"
+
+namespace database
+{
+
+	/**
+	 * @brief Checks if the given size is valid (non-negative).
+	 * @param size The size to check.
+	 * @return True if size is valid, false otherwise.
+	 */
+	bool checkArraySize(const int& size)
+	{
+		if (size < 0)
+		{
+			std::cout << "THE NUMBER OF RATING CANNOT BE NEGATIVE!" << std::endl;
+			return false;
+		}
+		else
+		{
+			return true;
+		}
+	}
+
+	/**
+	 * @brief Inputs grades for a specific subject into the provided vector.
+	 * @param grade A reference to the vector where grades will be stored.
+	 * @param length The number of grades to input.
+	 */
+	void inputAllGradesForSubject(std::vector<uint16_t>& grade, std::size_t length)
+	{
+		for (int i = 0; i < length; i++)
+		{
+			grade.push_back(0);
+
+			std::string prompt = "ENTER " + std::to_string(i + 1) + "-GRADE:";
+			Utils::inputValue(prompt, grade[i]);
+		}
+	}
+
+	/**
+	 * @brief Creates a new Student object by gathering input from the user.
+	 * @return A Student object filled with user input.
+	 */
+	Student createStudent()
+	{
+		Student student{};
+		std::cout << "ENTER THE STUDENT'S LAST NAME:" << std::endl;
+		getline(std::cin, student.surname);
+
+		Utils::inputValue("ENTER THE STUDENT'S GROUP NUMBER:", student.groupNumber);
+
+		int numOfPhisicsMarks{};
+		Utils::inputValue("ENTER THE NUMBER OF MARKS IN PHYSICS:", numOfPhisicsMarks, checkArraySize);
+		inputAllGradesForSubject(student.phisicsScores, numOfPhisicsMarks);
+		student.averagePhisicsGrade = calculateAverageValue(student.phisicsScores);
+
+		int numOfMathMarks{};
+		Utils::inputValue("ENTER THE NUMBER OF MARKS IN MATH:", numOfMathMarks, checkArraySize);
+		inputAllGradesForSubject(student.mathScores, numOfMathMarks);
+		student.averageMathGrade = calculateAverageValue(student.mathScores);
+
+		int numOfInformMarks{};
+		Utils::inputValue("ENTER THE NUMBER OF MARKS IN COMPUTER SCIENCE:", numOfInformMarks, checkArraySize);
+		inputAllGradesForSubject(student.informScores, numOfInformMarks);
+		student.averageInformGrade = calculateAverageValue(student.informScores);
+
+		calculateAverageGrade(student);
+
+		Utils::eatline();
+
+		return student;
+	}
+
+} // database
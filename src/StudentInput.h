@@ -0,0 +1,35 @@
+#ifndef STUDENT_INPUT_H
+#define STUDENT_INPUT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Student.h"
+
+namespace database
+{
+
+	/**
+	 * @brief Creates a new Student object by gathering input from the user.
+	 * @return A Student object filled with user input.
+	 */
+	Student createStudent();
+
+	/**
+	 * @brief Inputs grades for a specific subject into the provided vector.
+	 * @param grade A reference to the vector where grades will be stored.
+	 * @param length The number of grades to input.
+	 */
+	void inputAllGradesForSubject(std::vector<uint16_t>& grade, std::size_t length);
+
+	/**
+	 * @brief Checks if the given size is valid (non-negative).
+	 * @param size The size to check.
+	 * @return True if size is valid, false otherwise.
+	 */
+	bool checkArraySize(const int& size);
+
+} // database
+
+#endif // STUDENT_INPUT_H
@@ -0,0 +1,676 @@
+#include "StudentLog.h"
+
+#include <array>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string_view>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+#include "BufferedWriter.h"
+#include "StudentIndex.h"
+#include "StudentParser.h"
+#include "StudentSidecars.h"
+
+namespace database
+{
+
+	/** @brief How a checkpoint folds the log into the base file. */
+	enum CheckpointMode : std::uint32_t
+	{
+		CheckpointAppend = 1,  ///< The log only adds records, which are appended to the base file in place.
+		CheckpointRewrite      ///< A new base file is written and renamed over the old one.
+	};
+
+	/** @brief A record read back from the log. */
+	struct LogRecord
+	{
+		LogRecordType type;
+		std::string payload;
+	};
+
+	/** @brief Lookup table of the reflected CRC-32 polynomial. */
+	static constexpr std::array<std::uint32_t, 256> crcTable = [] {
+		std::array<std::uint32_t, 256> table{};
+		for (std::uint32_t i = 0; i < 256; i++)
+		{
+			std::uint32_t crc = i;
+			for (int bit = 0; bit < 8; bit++)
+				crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320u : crc >> 1;
+			table[i] = crc;
+		}
+		return table;
+		}();
+
+	/**
+	 * @brief Continues a CRC-32 over more bytes.
+	 * @param crc The running value; start with ~0 and invert the final value.
+	 * @param data The bytes to add.
+	 * @param size The number of bytes.
+	 * @return The updated running value.
+	 */
+	static std::uint32_t updateCrc(std::uint32_t crc, const void* data, std::size_t size)
+	{
+		const auto* bytes = static_cast<const unsigned char*>(data);
+		for (std::size_t i = 0; i < size; i++)
+			crc = crcTable[(crc ^ bytes[i]) & 0xFF] ^ (crc >> 8);
+		return crc;
+	}
+
+	/**
+	 * @brief Computes the checksum of a record.
+	 * @param header The record header; its checksum field is ignored.
+	 * @param payload The payload of the record.
+	 * @return The checksum.
+	 */
+	static std::uint32_t recordChecksum(const LogRecordHeader& header, std::string_view payload)
+	{
+		std::uint32_t crc = ~std::uint32_t{ 0 };
+		crc = updateCrc(crc, &header.type, sizeof(header.type));
+		crc = updateCrc(crc, &header.size, sizeof(header.size));
+		crc = updateCrc(crc, payload.data(), payload.size());
+		return ~crc;
+	}
+
+	/**
+	 * @brief Flushes a file through to the disk.
+	 * @param file The file to flush.
+	 * @return True if the data reached the disk, false otherwise.
+	 */
+	static bool syncFile(std::FILE* file)
+	{
+		if (std::fflush(file) != 0)
+			return false;
+#ifdef _WIN32
+		return _commit(_fileno(file)) == 0;
+#else
+		return fsync(fileno(file)) == 0;
+#endif
+	}
+
+	/**
+	 * @brief Appends a 64-bit value to a payload.
+	 * @param payload The payload to extend.
+	 * @param value The value to append.
+	 */
+	static void putValue(std::string& payload, std::uint64_t value)
+	{
+		payload.append(reinterpret_cast<const char*>(&value), sizeof(value));
+	}
+
+	/**
+	 * @brief Takes a 64-bit value from the front of a payload.
+	 * @param payload The remaining payload; the value is removed from it.
+	 * @param value Receives the value.
+	 * @return True if the payload held a value, false otherwise.
+	 */
+	static bool takeValue(std::string_view& payload, std::uint64_t& value)
+	{
+		if (payload.size() < sizeof(value))
+			return false;
+
+		std::memcpy(&value, payload.data(), sizeof(value));
+		payload.remove_prefix(sizeof(value));
+		return true;
+	}
+
+	/**
+	 * @brief Renders a student in the text format.
+	 * @param student The student to render.
+	 * @return The lines of the record, each terminated by a newline.
+	 */
+	static std::string studentText(const Student& student)
+	{
+		std::ostringstream text;
+		writeStudent(text, student);
+		return text.str();
+	}
+
+	/**
+	 * @brief Splits text into lines, dropping the line terminators.
+	 * @param text The text to split.
+	 * @param lines Vector the lines are appended to.
+	 */
+	static void splitLines(std::string_view text, std::vector<std::string>& lines)
+	{
+		while (!text.empty())
+		{
+			const std::size_t end = text.find('\n');
+			std::string_view line = text.substr(0, end);
+			if (!line.empty() && line.back() == '\r')
+				line.remove_suffix(1);
+
+			lines.emplace_back(line);
+			if (end == std::string_view::npos)
+				break;
+			text.remove_prefix(end + 1);
+		}
+	}
+
+	/**
+	 * @brief Reads the valid prefix of a log.
+	 * @param filename Name of the log file.
+	 * @param header Receives the log header.
+	 * @param records Receives the records up to the first torn or corrupt one.
+	 * @param validSize Receives the size of the valid prefix in bytes.
+	 * @return True if the log has a valid header, false otherwise.
+	 */
+	static bool readLog(const std::string& filename, LogFileHeader& header, std::vector<LogRecord>& records, std::uint64_t& validSize)
+	{
+		records.clear();
+
+		std::ifstream file(filename, std::ios::binary);
+		if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)))
+			return false;
+		if (std::memcmp(header.magic, logFileMagic, sizeof(header.magic)) != 0 || header.version != logFileVersion)
+			return false;
+
+		std::error_code error;
+		const std::uint64_t fileSize = std::filesystem::file_size(filename, error);
+		if (error)
+			return false;
+
+		validSize = sizeof(header);
+
+		LogRecordHeader recordHeader{};
+		while (file.read(reinterpret_cast<char*>(&recordHeader), sizeof(recordHeader)))
+		{
+			if (recordHeader.size > fileSize - validSize - sizeof(recordHeader))
+				break;
+
+			std::string payload(static_cast<std::size_t>(recordHeader.size), '\0');
+			if (!file.read(payload.data(), payload.size()))
+				break;
+			if (recordChecksum(recordHeader, payload) != recordHeader.checksum)
+				break;
+
+			records.push_back({ static_cast<LogRecordType>(recordHeader.type), std::move(payload) });
+			validSize += sizeof(recordHeader) + recordHeader.size;
+		}
+		return true;
+	}
+
+	/**
+	 * @brief Reads a text file as lines.
+	 * @param filename Name of the file.
+	 * @param lines Receives the lines without their terminators.
+	 * @return True if the file was read, false otherwise.
+	 */
+	static bool readLines(const std::string& filename, std::vector<std::string>& lines)
+	{
+		std::ifstream file(filename, std::ios::binary);
+		if (!file.is_open())
+			return false;
+
+		std::ostringstream text;
+		text << file.rdbuf();
+		splitLines(text.str(), lines);
+		return true;
+	}
+
+	/**
+	 * @brief Finds the lines on which records start.
+	 * @param lines The lines of a text student file.
+	 * @return The indices of the lines holding the record marker.
+	 */
+	static std::vector<std::size_t> recordStarts(const std::vector<std::string>& lines)
+	{
+		std::vector<std::size_t> starts;
+		for (std::size_t i = 0; i < lines.size(); i++)
+		{
+			if (lines[i].find(studentRecordMarker) != std::string::npos)
+				starts.push_back(i);
+		}
+		return starts;
+	}
+
+	/**
+	 * @brief Replaces a range of lines, clamping the range to the file.
+	 * @param lines The lines to modify.
+	 * @param first Index of the first line to replace.
+	 * @param count Number of lines to replace.
+	 * @param replacement The lines inserted in their place.
+	 */
+	static void spliceLines(std::vector<std::string>& lines, std::uint64_t first, std::uint64_t count, std::vector<std::string>&& replacement)
+	{
+		first = (std::min)(first, static_cast<std::uint64_t>(lines.size()));
+		count = (std::min)(count, lines.size() - first);
+
+		const auto begin = lines.begin() + static_cast<std::ptrdiff_t>(first);
+		lines.erase(begin, begin + static_cast<std::ptrdiff_t>(count));
+		lines.insert(lines.begin() + static_cast<std::ptrdiff_t>(first),
+			std::make_move_iterator(replacement.begin()), std::make_move_iterator(replacement.end()));
+	}
+
+	/**
+	 * @brief Applies one logged change to the lines of a file.
+	 * @param lines The lines of the file.
+	 * @param record The change.
+	 */
+	static void applyRecord(std::vector<std::string>& lines, const LogRecord& record)
+	{
+		std::string_view payload = record.payload;
+		std::vector<std::string> replacement;
+
+		switch (record.type)
+		{
+		case LogAddStudent:
+			splitLines(payload, lines);
+			break;
+
+		case LogUpdateStudent:
+		case LogRemoveStudent:
+		{
+			std::uint64_t recordIndex = 0;
+			if (!takeValue(payload, recordIndex))
+				break;
+
+			const std::vector<std::size_t> starts = recordStarts(lines);
+			if (recordIndex >= starts.size())
+				break;
+
+			const std::size_t first = starts[recordIndex];
+			const std::size_t last = recordIndex + 1 < starts.size() ? starts[recordIndex + 1] : lines.size();
+
+			if (record.type == LogUpdateStudent)
+				splitLines(payload, replacement);
+			spliceLines(lines, first, last - first, std::move(replacement));
+			break;
+		}
+
+		case LogReplaceLines:
+		{
+			std::uint64_t firstLine = 0, lineCount = 0;
+			if (!takeValue(payload, firstLine) || !takeValue(payload, lineCount))
+				break;
+
+			splitLines(payload, replacement);
+			spliceLines(lines, firstLine, lineCount, std::move(replacement));
+			break;
+		}
+
+		default:
+			break;
+		}
+	}
+
+	/**
+	 * @brief Folds a log of additions by appending them to the base file in place.
+	 *
+	 * The base file is first cut back to its size when the checkpoint started, so a
+	 * fold interrupted half way is simply redone.
+	 *
+	 * @param dataFilename Name of the base file.
+	 * @param records The logged additions.
+	 * @param baseSize Size of the base file before the fold.
+	 * @return True if the additions are durable, false otherwise.
+	 */
+	static bool foldByAppending(const std::string& dataFilename, const std::vector<LogRecord>& records, std::uint64_t baseSize)
+	{
+		std::error_code error;
+		std::filesystem::resize_file(dataFilename, baseSize, error);
+		if (error)
+			return false;
+
+		StudentSidecars sidecars;
+		sidecars.open(dataFilename);
+
+		BufferedWriter file;
+		if (!file.open(dataFilename, true))
+			return false;
+
+		std::vector<std::uint64_t> recordOffsets;
+		for (const auto& record : records)
+		{
+			recordOffsets.push_back(baseSize + file.position());
+			file.write(record.payload);
+		}
+
+		const bool written = file.sync();
+		if (!file.close() || !written)
+			return false;
+
+		Student student;
+		for (std::size_t i = 0; i < records.size(); i++)
+		{
+			StudentParser parser(records[i].payload.data(), records[i].payload.data() + records[i].payload.size());
+			if (parser.next(student))
+				sidecars.append(makeStudentView(student), recordOffsets[i]);
+		}
+		return true;
+	}
+
+	/**
+	 * @brief Folds a log by writing a new base file and renaming it over the old one.
+	 * @param dataFilename Name of the base file.
+	 * @param records The logged changes.
+	 * @return True if the new base file is in place, false otherwise.
+	 */
+	static bool foldByRewriting(const std::string& dataFilename, const std::vector<LogRecord>& records)
+	{
+		std::vector<std::string> lines;
+		if (!readLines(dataFilename, lines))
+			return false;
+
+		for (const auto& record : records)
+			applyRecord(lines, record);
+
+		const std::string temporaryFilename = dataFilename + ".tmp";
+		BufferedWriter file;
+		if (!file.open(temporaryFilename))
+			return false;
+
+		for (const auto& line : lines)
+		{
+			file.write(line);
+			file.put('\n');
+		}
+
+		bool written = file.sync();
+		written = file.close() && written;
+		return replaceWithTemporary(temporaryFilename, dataFilename, written);
+	}
+
+	/**
+	 * @brief Returns the name of the write-ahead log of a data file.
+	 * @param dataFilename Name of the data file.
+	 * @return The name of its log file.
+	 */
+	std::string logFilename(const std::string& dataFilename)
+	{
+		return dataFilename + ".wal";
+	}
+
+	/**
+	 * @brief Opens the log of a data file, starting a new log if there is none.
+	 *
+	 * A torn record left at the end of the log by a crash is cut off, and a checkpoint
+	 * left unfinished is completed before the log accepts new changes.
+	 *
+	 * @param dataFilename Name of the text data file.
+	 * @return True if the log is ready for writing, false otherwise.
+	 */
+	bool StudentLog::open(const std::string& dataFilename)
+	{
+		close();
+		this->dataFilename = dataFilename;
+
+		const std::string filename = logFilename(dataFilename);
+
+		LogFileHeader header{};
+		std::vector<LogRecord> records;
+		std::uint64_t validSize = 0;
+
+		if (!readLog(filename, header, records, validSize))
+			return reset();
+
+		std::error_code error;
+		std::filesystem::resize_file(filename, validSize, error);
+		if (error)
+			return false;
+
+		file = std::fopen(filename.c_str(), "ab");
+		logSize = validSize;
+		if (!file)
+			return false;
+
+		if (!records.empty() && records.back().type == LogCheckpointBegin)
+			return checkpoint();
+
+		return true;
+	}
+
+	/** @brief Closes the log; uncommitted changes are discarded. */
+	void StudentLog::close()
+	{
+		if (file)
+			std::fclose(file);
+
+		file = nullptr;
+		logSize = 0;
+		pending.clear();
+	}
+
+	/**
+	 * @brief Queues the addition of a student at the end of the file.
+	 * @param student The student to add.
+	 */
+	void StudentLog::addStudent(const Student& student)
+	{
+		queue(LogAddStudent, studentText(student));
+	}
+
+	/**
+	 * @brief Queues the replacement of a record.
+	 * @param recordIndex Position of the record in the file.
+	 * @param student The new contents of the record.
+	 */
+	void StudentLog::updateStudent(std::uint64_t recordIndex, const Student& student)
+	{
+		std::string payload;
+		putValue(payload, recordIndex);
+		payload += studentText(student);
+		queue(LogUpdateStudent, payload);
+	}
+
+	/**
+	 * @brief Queues the removal of a record.
+	 * @param recordIndex Position of the record in the file.
+	 */
+	void StudentLog::removeStudent(std::uint64_t recordIndex)
+	{
+		std::string payload;
+		putValue(payload, recordIndex);
+		queue(LogRemoveStudent, payload);
+	}
+
+	/**
+	 * @brief Queues the replacement of a range of lines.
+	 * @param firstLine Index of the first line to replace.
+	 * @param lineCount Number of lines to replace.
+	 * @param lines The lines inserted in their place.
+	 */
+	void StudentLog::replaceLines(std::uint64_t firstLine, std::uint64_t lineCount, const std::vector<std::string>& lines)
+	{
+		std::string payload;
+		putValue(payload, firstLine);
+		putValue(payload, lineCount);
+		for (const auto& line : lines)
+		{
+			payload += line;
+			payload += '\n';
+		}
+		queue(LogReplaceLines, payload);
+	}
+
+	/**
+	 * @brief Queues a record.
+	 * @param type The operation.
+	 * @param payload The payload of the record.
+	 */
+	void StudentLog::queue(LogRecordType type, const std::string& payload)
+	{
+		LogRecordHeader header{};
+		header.type = type;
+		header.size = payload.size();
+		header.checksum = recordChecksum(header, payload);
+
+		pending.append(reinterpret_cast<const char*>(&header), sizeof(header));
+		pending += payload;
+	}
+
+	/**
+	 * @brief Writes the queued changes to the log and flushes them to disk.
+	 * @return True if the changes are durable, false otherwise.
+	 */
+	bool StudentLog::commit()
+	{
+		if (pending.empty())
+			return true;
+		if (!file)
+			return false;
+
+		// The first batch of an empty log restamps it, in case the base file was replaced meanwhile
+		if (logSize <= sizeof(LogFileHeader))
+		{
+			std::string batch = std::move(pending);
+			if (!reset())
+				return false;
+			pending = std::move(batch);
+		}
+
+		const bool written = std::fwrite(pending.data(), 1, pending.size(), file) == pending.size();
+		if (!syncFile(file) || !written)
+			return false;
+
+		logSize += pending.size();
+		pending.clear();
+		return true;
+	}
+
+	/**
+	 * @brief Folds the committed changes into the base file and empties the log.
+	 *
+	 * Queued changes are committed first. Appended records are also added to the
+	 * file's sidecar index and B+-trees.
+	 *
+	 * @return True if the base file holds every committed change, false otherwise.
+	 */
+	bool StudentLog::checkpoint()
+	{
+		if (!commit())
+			return false;
+
+		LogFileHeader header{};
+		std::vector<LogRecord> records;
+		std::uint64_t validSize = 0;
+
+		if (!readLog(logFilename(dataFilename), header, records, validSize))
+			return reset();
+
+		std::uint32_t mode = 0;
+		std::uint64_t baseSize = 0;
+
+		if (!records.empty() && records.back().type == LogCheckpointBegin)
+		{
+			// A checkpoint was interrupted; finish it the same way it started
+			std::string_view payload = records.back().payload;
+			std::uint64_t storedMode = 0;
+			takeValue(payload, storedMode);
+			takeValue(payload, baseSize);
+			mode = static_cast<std::uint32_t>(storedMode);
+			records.pop_back();
+
+			std::uint64_t currentSize = 0;
+			std::int64_t currentModified = 0;
+			readDataStamp(dataFilename, currentSize, currentModified);
+
+			// The rename already happened if the base file is no longer the one the log started from
+			if (mode == CheckpointRewrite && (currentSize != header.baseSize || currentModified != header.baseModified))
+				return reset();
+		}
+		else
+		{
+			if (records.empty())
+				return reset();
+
+			bool appendOnly = true;
+			for (const auto& record : records)
+				appendOnly = appendOnly && record.type == LogAddStudent;
+
+			std::int64_t baseModified = 0;
+			if (!readDataStamp(dataFilename, baseSize, baseModified))
+				return false;
+
+			mode = appendOnly ? CheckpointAppend : CheckpointRewrite;
+
+			std::string payload;
+			putValue(payload, mode);
+			putValue(payload, baseSize);
+			queue(LogCheckpointBegin, payload);
+			if (!commit())
+				return false;
+		}
+
+		const bool folded = mode == CheckpointAppend
+			? foldByAppending(dataFilename, records, baseSize)
+			: foldByRewriting(dataFilename, records);
+
+		return folded && reset();
+	}
+
+	/**
+	 * @brief Truncates the log to a fresh header stamped with the base file.
+	 * @return True if the new log is durable, false otherwise.
+	 */
+	bool StudentLog::reset()
+	{
+		if (file)
+			std::fclose(file);
+		file = nullptr;
+		logSize = 0;
+
+		LogFileHeader header{};
+		std::memcpy(header.magic, logFileMagic, sizeof(header.magic));
+		header.version = logFileVersion;
+		if (!readDataStamp(dataFilename, header.baseSize, header.baseModified))
+			return false;
+
+		const std::string filename = logFilename(dataFilename);
+		std::FILE* fresh = std::fopen(filename.c_str(), "wb");
+		if (!fresh)
+			return false;
+
+		const bool written = std::fwrite(&header, sizeof(header), 1, fresh) == 1;
+		const bool synced = syncFile(fresh);
+		std::fclose(fresh);
+		if (!written || !synced)
+			return false;
+
+		file = std::fopen(filename.c_str(), "ab");
+		logSize = sizeof(header);
+		return file != nullptr;
+	}
+
+	/**
+	 * @brief Folds the pending log of a data file, if it has one, into the file.
+	 *
+	 * This also completes a checkpoint interrupted by a crash, so it is the recovery
+	 * step as well.
+	 *
+	 * @param dataFilename Name of the data file.
+	 * @return True if the data file is up to date, false otherwise.
+	 */
+	bool checkpointStudentFile(const std::string& dataFilename)
+	{
+		std::error_code error;
+		const std::uint64_t size = std::filesystem::file_size(logFilename(dataFilename), error);
+		if (error || size <= sizeof(LogFileHeader))
+			return true;
+
+		StudentLog log;
+		return log.open(dataFilename) && log.checkpoint();
+	}
+
+	/**
+	 * @brief Folds the pending log of a data file into it and opens the file for reading.
+	 * @param dataFilename Name of the data file.
+	 * @param file Receives the opened file.
+	 * @return True if the file is up to date and open, false otherwise.
+	 */
+	bool openCheckpointed(const std::string& dataFilename, std::ifstream& file)
+	{
+		if (!checkpointStudentFile(dataFilename))
+			return false;
+
+		file.open(dataFilename);
+		return file.is_open();
+	}
+
+} // database
@@ -0,0 +1,183 @@
+#ifndef STUDENT_LOG_H
+#define STUDENT_LOG_H
+
+#include <cstdint>
+#include <cstdio>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+#include "Student.h"
+
+namespace database
+{
+
+	/**
+	 * @brief Header at the start of a write-ahead log.
+	 *
+	 * The size and modification time of the base file are recorded when the log is
+	 * started, which tells recovery whether an interrupted checkpoint already replaced
+	 * the base file.
+	 */
+	struct LogFileHeader
+	{
+		char magic[4]{};
+
+		std::uint32_t version{};
+
+		std::uint64_t baseSize{};
+		std::int64_t baseModified{};
+	};
+
+	/**
+	 * @brief Header of one log record; the payload follows it.
+	 *
+	 * The checksum is the CRC-32 of the type, the size and the payload, so torn or
+	 * corrupt records at the end of the log are detected and dropped.
+	 */
+	struct LogRecordHeader
+	{
+		std::uint32_t checksum{};
+		std::uint32_t type{};
+		std::uint64_t size{};
+	};
+
+	/** @brief Operations recorded in the log. */
+	enum LogRecordType : std::uint32_t
+	{
+		LogAddStudent = 1,     ///< Appends a record; the payload is its text.
+		LogUpdateStudent,      ///< Replaces the n-th record; the payload is n and the new text.
+		LogRemoveStudent,      ///< Removes the n-th record; the payload is n.
+		LogReplaceLines,       ///< Replaces a range of lines; the payload is the range and the new text.
+		LogCheckpointBegin     ///< Marks a checkpoint in progress; the payload is its mode and the base size.
+	};
+
+	inline constexpr char logFileMagic[4] = { 'S', 'D', 'B', 'W' }; ///< Marks a write-ahead log.
+	inline constexpr std::uint32_t logFileVersion = 1; ///< Current version of the log layout.
+	inline constexpr std::uint64_t logCheckpointThreshold = std::uint64_t{ 1 } << 20; ///< Log size from which writers fold the log.
+
+	/**
+	 * @brief Returns the name of the write-ahead log of a data file.
+	 * @param dataFilename Name of the data file.
+	 * @return The name of its log file.
+	 */
+	std::string logFilename(const std::string& dataFilename);
+
+	/**
+	 * @brief Append-only write-ahead log of the changes to a text student file.
+	 *
+	 * Changes are queued in memory and written by commit() as one batch followed by a
+	 * single fsync, so a group of changes costs one disk flush. The base file itself is
+	 * only modified by checkpoint(), which folds the committed changes into it: a log of
+	 * appends only is folded by appending to the base file in place, any other log by
+	 * writing a new base file and atomically renaming it over the old one. A checkpoint
+	 * interrupted by a crash is completed by the next one.
+	 */
+	class StudentLog
+	{
+	public:
+		StudentLog() = default;
+		~StudentLog() { close(); }
+
+		StudentLog(const StudentLog&) = delete;
+		StudentLog& operator=(const StudentLog&) = delete;
+
+		/**
+		 * @brief Opens the log of a data file, starting a new log if there is none.
+		 * @param dataFilename Name of the text data file.
+		 * @return True if the log is ready for writing, false otherwise.
+		 */
+		bool open(const std::string& dataFilename);
+
+		/** @brief Closes the log; uncommitted changes are discarded. */
+		void close();
+
+		/**
+		 * @brief Queues the addition of a student at the end of the file.
+		 * @param student The student to add.
+		 */
+		void addStudent(const Student& student);
+
+		/**
+		 * @brief Queues the replacement of a record.
+		 * @param recordIndex Position of the record in the file.
+		 * @param student The new contents of the record.
+		 */
+		void updateStudent(std::uint64_t recordIndex, const Student& student);
+
+		/**
+		 * @brief Queues the removal of a record.
+		 * @param recordIndex Position of the record in the file.
+		 */
+		void removeStudent(std::uint64_t recordIndex);
+
+		/**
+		 * @brief Queues the replacement of a range of lines.
+		 * @param firstLine Index of the first line to replace.
+		 * @param lineCount Number of lines to replace.
+		 * @param lines The lines inserted in their place.
+		 */
+		void replaceLines(std::uint64_t firstLine, std::uint64_t lineCount, const std::vector<std::string>& lines);
+
+		/**
+		 * @brief Writes the queued changes to the log and flushes them to disk.
+		 * @return True if the changes are durable, false otherwise.
+		 */
+		bool commit();
+
+		/** @brief Returns the size of the log file in bytes. */
+		std::uint64_t size() const { return logSize; }
+
+		/**
+		 * @brief Folds the committed changes into the base file and empties the log.
+		 *
+		 * Queued changes are committed first. Appended records are also added to the
+		 * file's sidecar index and B+-trees.
+		 *
+		 * @return True if the base file holds every committed change, false otherwise.
+		 */
+		bool checkpoint();
+
+	private:
+		/**
+		 * @brief Queues a record.
+		 * @param type The operation.
+		 * @param payload The payload of the record.
+		 */
+		void queue(LogRecordType type, const std::string& payload);
+
+		/**
+		 * @brief Truncates the log to a fresh header stamped with the base file.
+		 * @return True if the new log is durable, false otherwise.
+		 */
+		bool reset();
+
+		std::string dataFilename;
+		std::FILE* file = nullptr;
+
+		std::uint64_t logSize = 0;
+		std::string pending;
+	};
+
+	/**
+	 * @brief Folds the pending log of a data file, if it has one, into the file.
+	 *
+	 * This also completes a checkpoint interrupted by a crash, so it is the recovery
+	 * step as well.
+	 *
+	 * @param dataFilename Name of the data file.
+	 * @return True if the data file is up to date, false otherwise.
+	 */
+	bool checkpointStudentFile(const std::string& dataFilename);
+
+	/**
+	 * @brief Folds the pending log of a data file into it and opens the file for reading.
+	 * @param dataFilename Name of the data file.
+	 * @param file Receives the opened file.
+	 * @return True if the file is up to date and open, false otherwise.
+	 */
+	bool openCheckpointed(const std::string& dataFilename, std::ifstream& file);
+
+} // database
+
+#endif // STUDENT_LOG_H
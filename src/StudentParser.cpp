@@ -0,0 +1,273 @@
+#include "StudentParser.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+
+#include "StudentQuery.h"
+
+namespace database
+{
+
+	/**
+	 * @brief Returns the value part of a "LABEL: value" line.
+	 * @param line The line to split.
+	 * @return The text following the first colon and the space after it.
+	 */
+	static std::string_view fieldValue(std::string_view line)
+	{
+		if (line.empty())
+			return {};
+
+		const void* colon = std::memchr(line.data(), ':', line.size());
+		if (colon == nullptr)
+			return {};
+
+		const std::size_t valueStart = static_cast<const char*>(colon) - line.data() + 2;
+		return valueStart < line.size() ? line.substr(valueStart) : std::string_view{};
+	}
+
+	/**
+	 * @brief Skips leading spaces and tabs.
+	 * @param first First character of the text.
+	 * @param last One past the last character of the text.
+	 * @return The first character that is not blank.
+	 */
+	static const char* skipBlanks(const char* first, const char* last)
+	{
+		while (first != last && (*first == ' ' || *first == '\t'))
+			++first;
+		return first;
+	}
+
+	/**
+	 * @brief Parses an unsigned integer value, yielding zero if there is none.
+	 * @param text The text holding the value.
+	 * @return The parsed value.
+	 */
+	static std::uint64_t parseUnsigned(std::string_view text)
+	{
+		const char* last = text.data() + text.size();
+		std::uint64_t value = 0;
+		std::from_chars(skipBlanks(text.data(), last), last, value);
+		return value;
+	}
+
+	/**
+	 * @brief Parses a floating-point value, yielding zero if there is none.
+	 * @param text The text holding the value.
+	 * @return The parsed value.
+	 */
+	static double parseDouble(std::string_view text)
+	{
+		const char* last = text.data() + text.size();
+		double value = 0.0;
+		std::from_chars(skipBlanks(text.data(), last), last, value);
+		return value;
+	}
+
+	/**
+	 * @brief Parses space-separated scores into a vector, replacing its contents.
+	 * @param text The text holding the scores.
+	 * @param scores Vector that receives the scores; its capacity is reused.
+	 */
+	void parseScores(std::string_view text, std::vector<std::uint16_t>& scores)
+	{
+		scores.clear();
+		scores.reserve(std::count(text.begin(), text.end(), ' ') + 1);
+
+		const char* first = text.data();
+		const char* last = first + text.size();
+
+		while (true)
+		{
+			first = skipBlanks(first, last);
+
+			std::uint16_t score = 0;
+			const auto [next, error] = std::from_chars(first, last, score);
+			if (error != std::errc{})
+				break;
+
+			scores.push_back(score);
+			first = next;
+		}
+	}
+
+	/**
+	 * @brief Creates a parser over a range of characters.
+	 * @param begin First character of the text.
+	 * @param end One past the last character of the text.
+	 */
+	StudentParser::StudentParser(const char* begin, const char* end)
+		: current(begin), last(end), recordEnd(end)
+	{
+	}
+
+	/**
+	 * @brief Creates a parser over a range of characters that stops before a given record position.
+	 * @param begin First character of the text.
+	 * @param end One past the last character of the text.
+	 * @param recordEnd Position at which no further record may start.
+	 */
+	StudentParser::StudentParser(const char* begin, const char* end, const char* recordEnd)
+		: current(begin), last(end), recordEnd(recordEnd)
+	{
+	}
+
+	/**
+	 * @brief Extracts the next line without its line terminator.
+	 * @return The line, or an empty view at the end of the text.
+	 */
+	std::string_view StudentParser::nextLine()
+	{
+		if (current == last)
+			return {};
+
+		const char* lineStart = current;
+		const char* lineEnd = static_cast<const char*>(std::memchr(current, '\n', last - current));
+
+		if (lineEnd == nullptr)
+		{
+			lineEnd = last;
+			current = last;
+		}
+		else
+		{
+			current = lineEnd + 1;
+		}
+
+		if (lineEnd != lineStart && lineEnd[-1] == '\r')
+			--lineEnd;
+
+		return { lineStart, static_cast<std::size_t>(lineEnd - lineStart) };
+	}
+
+	/**
+	 * @brief Parses the next record of the text.
+	 * @param student Student object that receives the parsed record.
+	 * @return True if a record was parsed, false if the end of the text was reached.
+	 */
+	bool StudentParser::next(Student& student)
+	{
+		while (current != last && current < recordEnd)
+		{
+			const char* lineStart = current;
+			const std::string_view line = nextLine();
+			if (line.find(studentRecordMarker) == std::string_view::npos)
+				continue;
+
+			recordStart = lineStart;
+			student.surname.assign(fieldValue(line));
+			student.groupNumber = parseUnsigned(fieldValue(nextLine()));
+
+			parseScores(fieldValue(nextLine()), student.phisicsScores);
+			student.averagePhisicsGrade = parseDouble(fieldValue(nextLine()));
+
+			parseScores(fieldValue(nextLine()), student.mathScores);
+			student.averageMathGrade = parseDouble(fieldValue(nextLine()));
+
+			parseScores(fieldValue(nextLine()), student.informScores);
+			student.averageInformGrade = parseDouble(fieldValue(nextLine()));
+
+			student.averageGrade = parseDouble(fieldValue(nextLine()));
+			return true;
+		}
+		return false;
+	}
+
+	/**
+	 * @brief Parses one field of a record from its lines.
+	 * @param lines The lines of the record, starting with the surname line.
+	 * @param column The QueryColumn of the field.
+	 * @param student Student object that receives the field.
+	 */
+	static void parseColumn(const std::string_view (&lines)[studentRecordLines], unsigned column, Student& student)
+	{
+		switch (column)
+		{
+		case QuerySurname: student.surname.assign(fieldValue(lines[0])); break;
+		case QueryGroupNumber: student.groupNumber = parseUnsigned(fieldValue(lines[1])); break;
+		case QueryPhisicsScores: parseScores(fieldValue(lines[2]), student.phisicsScores); break;
+		case QueryAveragePhisicsGrade: student.averagePhisicsGrade = parseDouble(fieldValue(lines[3])); break;
+		case QueryMathScores: parseScores(fieldValue(lines[4]), student.mathScores); break;
+		case QueryAverageMathGrade: student.averageMathGrade = parseDouble(fieldValue(lines[5])); break;
+		case QueryInformScores: parseScores(fieldValue(lines[6]), student.informScores); break;
+		case QueryAverageInformGrade: student.averageInformGrade = parseDouble(fieldValue(lines[7])); break;
+		case QueryAverageGrade: student.averageGrade = parseDouble(fieldValue(lines[8])); break;
+		}
+	}
+
+	/**
+	 * @brief Parses the next record that matches a query.
+	 * @param student Student object that receives the parsed record; it may hold partial data when false is returned.
+	 * @param query The query records must match.
+	 * @return True if a matching record was parsed, false if the end of the text was reached.
+	 */
+	bool StudentParser::next(Student& student, const StudentQuery& query)
+	{
+		if (query.empty())
+			return next(student);
+
+		while (current != last && current < recordEnd)
+		{
+			const char* lineStart = current;
+			std::string_view lines[studentRecordLines];
+			lines[0] = nextLine();
+			if (lines[0].find(studentRecordMarker) == std::string_view::npos)
+				continue;
+
+			recordStart = lineStart;
+			for (std::size_t i = 1; i < studentRecordLines; i++)
+				lines[i] = nextLine();
+
+			// Columns are numbered cheapest first, so the lowest bits are tried first
+			unsigned known = 0;
+			QueryResult result = QueryUnknown;
+			for (unsigned column = 1; column <= QueryAllColumns && result == QueryUnknown; column <<= 1)
+			{
+				if ((query.columns() & column) == 0)
+					continue;
+
+				parseColumn(lines, column, student);
+				known |= column;
+				result = query.evaluate(makeStudentView(student), known);
+			}
+
+			if (result == QueryFalse)
+				continue;
+
+			for (unsigned column = 1; column <= QueryAllColumns; column <<= 1)
+			{
+				if ((known & column) == 0)
+					parseColumn(lines, column, student);
+			}
+			return true;
+		}
+		return false;
+	}
+
+	/**
+	 * @brief Parses every record of a text buffer.
+	 * @param begin First character of the text.
+	 * @param end One past the last character of the text.
+	 * @return A vector containing the parsed students.
+	 */
+	std::vector<Student> parseStudents(const char* begin, const char* end)
+	{
+		std::vector<Student> students;
+		StudentParser parser(begin, end);
+
+		while (true)
+		{
+			Student& student = students.emplace_back();
+			if (!parser.next(student))
+			{
+				students.pop_back();
+				break;
+			}
+		}
+
+		return students;
+	}
+
+} // database
@@ -0,0 +1,111 @@
+#ifndef STUDENT_PARSER_H
+#define STUDENT_PARSER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include "Student.h"
+
+namespace database
+{
+
+	inline constexpr std::string_view studentRecordMarker = "STUDENT'S NAME:"; ///< Label of the first line of every record.
+	inline constexpr std::size_t studentRecordLines = 9; ///< Number of lines of every record.
+
+	class StudentQuery;
+
+	/**
+	 * @brief Single-pass parser for the text format produced by writeStudent.
+	 *
+	 * The parser works directly on a character buffer: lines are located with memchr,
+	 * numbers are converted with std::from_chars and nothing is copied besides the
+	 * surname. Both "\n" and "\r\n" line endings are accepted.
+	 */
+	class StudentParser
+	{
+	public:
+		/**
+		 * @brief Creates a parser over a range of characters.
+		 * @param begin First character of the text.
+		 * @param end One past the last character of the text.
+		 */
+		StudentParser(const char* begin, const char* end);
+
+		/**
+		 * @brief Creates a parser over a range of characters that stops before a given record position.
+		 *
+		 * Records whose first line starts at or after recordEnd are left unparsed, but the
+		 * lines of a record that starts before it are read even where they extend past it.
+		 * This lets a text be parsed in independent byte ranges.
+		 *
+		 * @param begin First character of the text.
+		 * @param end One past the last character of the text.
+		 * @param recordEnd Position at which no further record may start.
+		 */
+		StudentParser(const char* begin, const char* end, const char* recordEnd);
+
+		/**
+		 * @brief Parses the next record of the text.
+		 *
+		 * Lines before the next "STUDENT'S NAME:" label are skipped. The buffers of the
+		 * given student are reused, so parsing into the same object repeatedly does not
+		 * allocate once its capacity suffices.
+		 *
+		 * @param student Student object that receives the parsed record.
+		 * @return True if a record was parsed, false if the end of the text was reached.
+		 */
+		bool next(Student& student);
+
+		/**
+		 * @brief Parses the next record that matches a query.
+		 *
+		 * The lines of a record are located first. The fields the query depends on are
+		 * parsed one at a time, single numbers before score lists, and the query is
+		 * evaluated after each; a record is skipped as soon as the query is false for
+		 * it, so the rest of its fields are never parsed.
+		 *
+		 * @param student Student object that receives the parsed record; it may hold partial data when false is returned.
+		 * @param query The query records must match.
+		 * @return True if a matching record was parsed, false if the end of the text was reached.
+		 */
+		bool next(Student& student, const StudentQuery& query);
+
+		/** @brief Returns the position of the first character not yet consumed. */
+		const char* position() const { return current; }
+
+		/** @brief Returns the start of the first line of the record parsed last. */
+		const char* recordPosition() const { return recordStart; }
+
+	private:
+		/**
+		 * @brief Extracts the next line without its line terminator.
+		 * @return The line, or an empty view at the end of the text.
+		 */
+		std::string_view nextLine();
+
+		const char* current;
+		const char* last;
+		const char* recordEnd;
+		const char* recordStart = nullptr;
+	};
+
+	/**
+	 * @brief Parses space-separated scores into a vector, replacing its contents.
+	 * @param text The text holding the scores.
+	 * @param scores Vector that receives the scores; its capacity is reused.
+	 */
+	void parseScores(std::string_view text, std::vector<std::uint16_t>& scores);
+
+	/**
+	 * @brief Parses every record of a text buffer.
+	 * @param begin First character of the text.
+	 * @param end One past the last character of the text.
+	 * @return A vector containing the parsed students.
+	 */
+	std::vector<Student> parseStudents(const char* begin, const char* end);
+
+} // database
+
+#endif // STUDENT_PARSER_H
@@ -0,0 +1,559 @@
+#include "StudentQuery.h"
+
+#include <charconv>
+#include <limits>
+
+namespace database
+{
+
+	inline constexpr int maxQueryDepth = 256; ///< Deepest nesting of parentheses and NOT a query may use.
+
+	/**
+	 * @brief Compares two values with a comparison operator.
+	 * @param left The value on the left of the operator.
+	 * @param comparison The operator, numbered in the order of StudentQuery::Comparison.
+	 * @param right The value on the right of the operator.
+	 * @return The outcome of the comparison.
+	 */
+	template <typename T>
+	static bool applyComparison(T left, int comparison, T right)
+	{
+		switch (comparison)
+		{
+		case 0: return left == right;
+		case 1: return left != right;
+		case 2: return left < right;
+		case 3: return left <= right;
+		case 4: return left > right;
+		default: return left >= right;
+		}
+	}
+
+	/**
+	 * @brief Lowercases ASCII letters of a name.
+	 * @param text The name.
+	 * @return The lowercased name.
+	 */
+	static std::string lowercase(std::string_view text)
+	{
+		std::string result(text);
+		for (char& c : result)
+		{
+			if (c >= 'A' && c <= 'Z')
+				c = static_cast<char>(c - 'A' + 'a');
+		}
+		return result;
+	}
+
+	/** @brief Recursive descent compiler from query text to the node vector of a StudentQuery. */
+	class StudentQuery::Compiler
+	{
+	public:
+		Compiler(std::string_view text, StudentQuery& query)
+			: text(text), query(query)
+		{
+		}
+
+		/**
+		 * @brief Compiles the whole text.
+		 * @return True if the text is a valid query, false otherwise.
+		 */
+		bool run()
+		{
+			if (!advance())
+				return false;
+
+			std::uint32_t root = 0;
+			if (!parseOr(root, 0))
+				return false;
+			if (token.kind != EndToken)
+				return unexpected();
+			return true;
+		}
+
+	private:
+		enum TokenKind
+		{
+			EndToken,
+			WordToken,
+			NumberToken,
+			StringToken,
+			OperatorToken,
+			OpenToken,
+			CloseToken
+		};
+
+		struct Token
+		{
+			TokenKind kind = EndToken;
+			std::string_view text{};
+			std::size_t position = 0;
+		};
+
+		/** @brief Checks whether a character ends a word or a number. */
+		static bool isDelimiter(char c)
+		{
+			return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '(' || c == ')'
+				|| c == '=' || c == '!' || c == '<' || c == '>' || c == '\'' || c == '"';
+		}
+
+		/**
+		 * @brief Reads the next token.
+		 * @return True if a token was read, false if the text holds an invalid one.
+		 */
+		bool advance()
+		{
+			while (offset < text.size() && (text[offset] == ' ' || text[offset] == '\t' || text[offset] == '\r' || text[offset] == '\n'))
+				offset++;
+
+			token.position = offset;
+			if (offset == text.size())
+			{
+				token.kind = EndToken;
+				token.text = {};
+				return true;
+			}
+
+			const char c = text[offset];
+			const std::size_t start = offset;
+
+			if (c == '(' || c == ')')
+			{
+				token.kind = c == '(' ? OpenToken : CloseToken;
+				token.text = text.substr(offset++, 1);
+				return true;
+			}
+
+			if (c == '=' || c == '!' || c == '<' || c == '>')
+			{
+				offset++;
+				if (offset < text.size() && (text[offset] == '=' || (c == '<' && text[offset] == '>')))
+					offset++;
+				token.kind = OperatorToken;
+				token.text = text.substr(start, offset - start);
+				if (token.text == "!")
+					return fail("expected != at position " + std::to_string(start + 1));
+				return true;
+			}
+
+			if (c == '\'' || c == '"')
+			{
+				const std::size_t close = text.find(c, offset + 1);
+				if (close == std::string_view::npos)
+					return fail("unterminated string at position " + std::to_string(start + 1));
+				token.kind = StringToken;
+				token.text = text.substr(offset + 1, close - offset - 1);
+				offset = close + 1;
+				return true;
+			}
+
+			while (offset < text.size() && !isDelimiter(text[offset]))
+				offset++;
+			token.text = text.substr(start, offset - start);
+			token.kind = (c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.' ? NumberToken : WordToken;
+			return true;
+		}
+
+		/**
+		 * @brief Records a compile error.
+		 * @param message The problem.
+		 * @return False.
+		 */
+		bool fail(const std::string& message)
+		{
+			query.errorMessage = message;
+			return false;
+		}
+
+		/** @brief Records an error about the current token. */
+		bool unexpected()
+		{
+			if (token.kind == EndToken)
+				return fail("unexpected end of query");
+			return fail("unexpected '" + std::string(token.text) + "' at position " + std::to_string(token.position + 1));
+		}
+
+		/** @brief Checks whether the current token is a keyword, ignoring case. */
+		bool isKeyword(std::string_view keyword) const
+		{
+			return token.kind == WordToken && lowercase(token.text) == keyword;
+		}
+
+		/**
+		 * @brief Appends a node and returns its position.
+		 * @param node The node to append.
+		 * @return Position of the node in the vector.
+		 */
+		std::uint32_t addNode(Node node)
+		{
+			query.nodes.push_back(std::move(node));
+			return static_cast<std::uint32_t>(query.nodes.size() - 1);
+		}
+
+		/**
+		 * @brief Appends a node joining two subtrees.
+		 * @param kind AndNode or OrNode.
+		 * @param left Position of the left subtree.
+		 * @param right Position of the right subtree.
+		 * @return Position of the new node.
+		 */
+		std::uint32_t addJoin(NodeKind kind, std::uint32_t left, std::uint32_t right)
+		{
+			Node node;
+			node.kind = kind;
+			node.left = left;
+			node.right = right;
+			return addNode(std::move(node));
+		}
+
+		/** @brief or := and ("OR" and)* */
+		bool parseOr(std::uint32_t& index, int depth)
+		{
+			if (!parseAnd(index, depth))
+				return false;
+
+			while (isKeyword("or"))
+			{
+				std::uint32_t right = 0;
+				if (!advance() || !parseAnd(right, depth))
+					return false;
+				index = addJoin(OrNode, index, right);
+			}
+			return true;
+		}
+
+		/** @brief and := not ("AND" not)* */
+		bool parseAnd(std::uint32_t& index, int depth)
+		{
+			if (!parseNot(index, depth))
+				return false;
+
+			while (isKeyword("and"))
+			{
+				std::uint32_t right = 0;
+				if (!advance() || !parseNot(right, depth))
+					return false;
+				index = addJoin(AndNode, index, right);
+			}
+			return true;
+		}
+
+		/** @brief not := "NOT" not | "(" or ")" | comparison */
+		bool parseNot(std::uint32_t& index, int depth)
+		{
+			if (depth >= maxQueryDepth)
+				return fail("query is nested too deeply");
+
+			if (isKeyword("not"))
+			{
+				std::uint32_t operand = 0;
+				if (!advance() || !parseNot(operand, depth + 1))
+					return false;
+
+				Node node;
+				node.kind = NotNode;
+				node.left = operand;
+				index = addNode(std::move(node));
+				return true;
+			}
+
+			if (token.kind == OpenToken)
+			{
+				if (!advance() || !parseOr(index, depth + 1))
+					return false;
+				if (token.kind != CloseToken)
+					return token.kind == EndToken ? fail("missing ')'") : unexpected();
+				return advance();
+			}
+
+			return parseComparison(index);
+		}
+
+		/**
+		 * @brief Parses the name of a subject.
+		 * @param subject Receives 0 for physics, 1 for math and 2 for CS.
+		 * @return True if the current token names a subject, false otherwise.
+		 */
+		bool parseSubject(int& subject)
+		{
+			const std::string name = token.kind == WordToken ? lowercase(token.text) : std::string();
+			if (name == "physics")
+				subject = 0;
+			else if (name == "math")
+				subject = 1;
+			else if (name == "cs")
+				subject = 2;
+			else
+				return token.kind == WordToken ? fail("unknown subject " + std::string(token.text)) : unexpected();
+			return true;
+		}
+
+		/** @brief comparison := field operator value */
+		bool parseComparison(std::uint32_t& index)
+		{
+			if (token.kind != WordToken)
+				return unexpected();
+
+			static const QueryColumn averageColumns[4] = {
+				QueryAveragePhisicsGrade, QueryAverageMathGrade, QueryAverageInformGrade, QueryAverageGrade
+			};
+			static const QueryColumn scoreColumns[3] = {
+				QueryPhisicsScores, QueryMathScores, QueryInformScores
+			};
+
+			Node node;
+			node.kind = CompareNode;
+
+			const std::string name = lowercase(token.text);
+			if (name == "surname")
+			{
+				node.operand = SurnameOperand;
+				node.column = QuerySurname;
+			}
+			else if (name == "group")
+			{
+				node.operand = GroupOperand;
+				node.column = QueryGroupNumber;
+			}
+			else if (name == "gpa" || name == "physics" || name == "math" || name == "cs")
+			{
+				node.operand = AverageOperand;
+				if (name == "gpa")
+					node.subject = 3;
+				else if (!parseSubject(node.subject))
+					return false;
+				node.column = averageColumns[node.subject];
+			}
+			else if (name == "min" || name == "max" || name == "count")
+			{
+				node.operand = name == "min" ? MinScoreOperand : name == "max" ? MaxScoreOperand : ScoreCountOperand;
+				if (!advance())
+					return false;
+				if (token.kind != OpenToken)
+					return unexpected();
+				if (!advance() || !parseSubject(node.subject))
+					return false;
+				if (!advance())
+					return false;
+				if (token.kind != CloseToken)
+					return unexpected();
+				node.column = scoreColumns[node.subject];
+			}
+			else
+				return fail("unknown field " + std::string(token.text));
+
+			if (!advance())
+				return false;
+			if (token.kind != OperatorToken)
+				return unexpected();
+
+			static const std::pair<std::string_view, Comparison> operators[] = {
+				{ "=", Equal }, { "==", Equal }, { "!=", NotEqual }, { "<>", NotEqual },
+				{ "<", Less }, { "<=", LessOrEqual }, { ">", Greater }, { ">=", GreaterOrEqual }
+			};
+			bool knownOperator = false;
+			for (const auto& [symbol, comparison] : operators)
+			{
+				if (token.text == symbol)
+				{
+					node.comparison = comparison;
+					knownOperator = true;
+				}
+			}
+			if (!knownOperator)
+				return unexpected();
+
+			if (!advance())
+				return false;
+
+			if (node.operand == SurnameOperand)
+			{
+				if (token.kind != WordToken && token.kind != StringToken && token.kind != NumberToken)
+					return unexpected();
+
+				node.text = token.text;
+				if (!node.text.empty() && node.text.back() == '*')
+				{
+					if (node.comparison != Equal && node.comparison != NotEqual)
+						return fail("a surname prefix can only be compared with = or !=");
+					node.text.pop_back();
+					node.prefix = true;
+				}
+			}
+			else
+			{
+				if (token.kind != NumberToken)
+					return token.kind == EndToken ? unexpected() : fail("expected a number at position " + std::to_string(token.position + 1));
+
+				// from_chars takes no '+', so a leading one is skipped but must be followed by an unsigned number
+				const char* first = token.text.data();
+				const char* last = first + token.text.size();
+				if (*first == '+' && (++first == last || *first == '-' || *first == '+'))
+					return fail("invalid number " + std::string(token.text));
+
+				// Out-of-range values such as 1e999 are rejected rather than compared as infinity
+				const auto [numberEnd, numberError] = std::from_chars(first, last, node.number);
+				if (numberError != std::errc{} || numberEnd != last)
+					return fail("invalid number " + std::string(token.text));
+
+				const auto [end, error] = std::from_chars(first, last, node.integer);
+				node.integral = error == std::errc{} && end == last;
+			}
+
+			query.referencedColumns |= node.column;
+			index = addNode(std::move(node));
+			return advance();
+		}
+
+		std::string_view text;
+		std::size_t offset = 0;
+		Token token;
+		StudentQuery& query;
+	};
+
+	/**
+	 * @brief Compiles a query, replacing the previous one.
+	 * @param text The text of the query.
+	 * @return True if the query is valid, false otherwise; error() describes the problem.
+	 */
+	bool StudentQuery::compile(std::string_view text)
+	{
+		nodes.clear();
+		referencedColumns = 0;
+		errorMessage.clear();
+
+		if (text.find_first_not_of(" \t\r\n") == std::string_view::npos)
+			return true;
+
+		if (!Compiler(text, *this).run())
+		{
+			nodes.clear();
+			referencedColumns = 0;
+			return false;
+		}
+		return true;
+	}
+
+	/**
+	 * @brief Checks whether a record matches the query.
+	 * @param student The record to check.
+	 * @return True if the record matches, false otherwise.
+	 */
+	bool StudentQuery::matches(const StudentView& student) const
+	{
+		return nodes.empty() || evaluateNode(static_cast<std::uint32_t>(nodes.size() - 1), student, QueryAllColumns) == QueryTrue;
+	}
+
+	/**
+	 * @brief Evaluates the query over a record of which only some fields are known.
+	 * @param student The record; fields outside the known ones are not read.
+	 * @param knownColumns QueryColumn bits of the fields that hold their final values.
+	 * @return QueryTrue or QueryFalse if the known fields decide the outcome, QueryUnknown otherwise.
+	 */
+	QueryResult StudentQuery::evaluate(const StudentView& student, unsigned knownColumns) const
+	{
+		if (nodes.empty())
+			return QueryTrue;
+		return evaluateNode(static_cast<std::uint32_t>(nodes.size() - 1), student, knownColumns);
+	}
+
+	/**
+	 * @brief Evaluates a subtree in three-valued logic.
+	 * @param index Position of the root of the subtree.
+	 * @param student The record.
+	 * @param knownColumns QueryColumn bits of the fields that hold their final values.
+	 * @return The outcome of the subtree.
+	 */
+	QueryResult StudentQuery::evaluateNode(std::uint32_t index, const StudentView& student, unsigned knownColumns) const
+	{
+		const Node& node = nodes[index];
+		switch (node.kind)
+		{
+		case AndNode:
+		{
+			const QueryResult left = evaluateNode(node.left, student, knownColumns);
+			if (left == QueryFalse)
+				return QueryFalse;
+			const QueryResult right = evaluateNode(node.right, student, knownColumns);
+			if (right == QueryFalse)
+				return QueryFalse;
+			return left == QueryTrue && right == QueryTrue ? QueryTrue : QueryUnknown;
+		}
+		case OrNode:
+		{
+			const QueryResult left = evaluateNode(node.left, student, knownColumns);
+			if (left == QueryTrue)
+				return QueryTrue;
+			const QueryResult right = evaluateNode(node.right, student, knownColumns);
+			if (right == QueryTrue)
+				return QueryTrue;
+			return left == QueryFalse && right == QueryFalse ? QueryFalse : QueryUnknown;
+		}
+		case NotNode:
+		{
+			const QueryResult operand = evaluateNode(node.left, student, knownColumns);
+			if (operand == QueryUnknown)
+				return QueryUnknown;
+			return operand == QueryTrue ? QueryFalse : QueryTrue;
+		}
+		default:
+			if ((node.column & knownColumns) == 0)
+				return QueryUnknown;
+			return compare(node, student) ? QueryTrue : QueryFalse;
+		}
+	}
+
+	/**
+	 * @brief Evaluates a comparison node.
+	 * @param node The comparison.
+	 * @param student The record.
+	 * @return The outcome of the comparison.
+	 */
+	bool StudentQuery::compare(const Node& node, const StudentView& student) const
+	{
+		const std::span<const std::uint16_t> scores[3] = { student.phisicsScores, student.mathScores, student.informScores };
+
+		switch (node.operand)
+		{
+		case SurnameOperand:
+			if (node.prefix)
+				return student.surname.starts_with(node.text) == (node.comparison == Equal);
+			return applyComparison(student.surname.compare(node.text), node.comparison, 0);
+
+		case GroupOperand:
+			if (node.integral)
+				return applyComparison(student.groupNumber, node.comparison, node.integer);
+			return applyComparison(static_cast<double>(student.groupNumber), node.comparison, node.number);
+
+		case AverageOperand:
+		{
+			const double averages[4] = {
+				student.averagePhisicsGrade, student.averageMathGrade, student.averageInformGrade, student.averageGrade
+			};
+			return applyComparison(averages[node.subject], node.comparison, node.number);
+		}
+
+		case MinScoreOperand:
+		{
+			double minimum = std::numeric_limits<double>::infinity();
+			for (auto score : scores[node.subject])
+				minimum = score < minimum ? score : minimum;
+			return applyComparison(minimum, node.comparison, node.number);
+		}
+
+		case MaxScoreOperand:
+		{
+			double maximum = -std::numeric_limits<double>::infinity();
+			for (auto score : scores[node.subject])
+				maximum = score > maximum ? score : maximum;
+			return applyComparison(maximum, node.comparison, node.number);
+		}
+
+		default:
+			if (node.integral)
+				return applyComparison(static_cast<std::uint64_t>(scores[node.subject].size()), node.comparison, node.integer);
+			return applyComparison(static_cast<double>(scores[node.subject].size()), node.comparison, node.number);
+		}
+	}
+
+} // database
@@ -0,0 +1,165 @@
+#ifndef STUDENT_QUERY_H
+#define STUDENT_QUERY_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Student.h"
+
+namespace database
+{
+
+	/**
+	 * @brief Fields of a record a query can depend on, as bits of a mask.
+	 *
+	 * Fields that take one number to parse come first, so pushing a query down into
+	 * the parser tries the cheap fields before the score lists.
+	 */
+	enum QueryColumn : std::uint16_t
+	{
+		QuerySurname = 1 << 0,
+		QueryGroupNumber = 1 << 1,
+		QueryAverageGrade = 1 << 2,
+		QueryAveragePhisicsGrade = 1 << 3,
+		QueryAverageMathGrade = 1 << 4,
+		QueryAverageInformGrade = 1 << 5,
+		QueryPhisicsScores = 1 << 6,
+		QueryMathScores = 1 << 7,
+		QueryInformScores = 1 << 8,
+
+		QueryAllColumns = (1 << 9) - 1
+	};
+
+	/** @brief Outcome of evaluating a query over a partly parsed record. */
+	enum QueryResult
+	{
+		QueryFalse,
+		QueryTrue,
+		QueryUnknown ///< The outcome depends on fields that are not parsed yet.
+	};
+
+	/** @brief Query of the individual task: no math or computer science score below 4. */
+	inline constexpr std::string_view individualTaskQuery = "min(math) >= 4 AND min(cs) >= 4";
+
+	/**
+	 * @brief Predicate over student records, compiled from a small query language.
+	 *
+	 * A query is a boolean expression of comparisons joined with AND, OR and NOT and
+	 * grouped with parentheses; AND binds tighter than OR, and keywords and names
+	 * are case-insensitive:
+	 *
+	 * @code
+	 * group = 4351 AND min(math) >= 4 AND gpa > 3.5
+	 * surname = 'Ko*' OR NOT (count(physics) >= 3)
+	 * @endcode
+	 *
+	 * A comparison has a field on the left, one of = == != <> < <= > >= and a value
+	 * on the right. The fields are surname, group, gpa and the subject averages
+	 * physics, math and cs, and min, max and count of the scores of a subject.
+	 * Surnames compare as text with a quoted or bare word, where a trailing '*'
+	 * makes = and != match a prefix. The minimum of no scores is larger and the
+	 * maximum smaller than any value, so min(math) >= 4 reads "no math score is
+	 * below 4" for every student.
+	 *
+	 * The expression is compiled to a tree stored in one vector. Besides the plain
+	 * match, a query can be evaluated over a record whose fields are only partly
+	 * known, which lets readers drop a record before parsing the rest of it.
+	 * An empty query matches every record.
+	 */
+	class StudentQuery
+	{
+	public:
+		/**
+		 * @brief Compiles a query, replacing the previous one.
+		 * @param text The text of the query.
+		 * @return True if the query is valid, false otherwise; error() describes the problem.
+		 */
+		bool compile(std::string_view text);
+
+		/** @brief Returns the problem found by the last failed compile. */
+		const std::string& error() const { return errorMessage; }
+
+		/** @brief Checks whether the query has no predicate and matches every record. */
+		bool empty() const { return nodes.empty(); }
+
+		/** @brief Returns the QueryColumn bits of the fields the query depends on. */
+		unsigned columns() const { return referencedColumns; }
+
+		/**
+		 * @brief Checks whether a record matches the query.
+		 * @param student The record to check.
+		 * @return True if the record matches, false otherwise.
+		 */
+		bool matches(const StudentView& student) const;
+
+		/**
+		 * @brief Evaluates the query over a record of which only some fields are known.
+		 * @param student The record; fields outside the known ones are not read.
+		 * @param knownColumns QueryColumn bits of the fields that hold their final values.
+		 * @return QueryTrue or QueryFalse if the known fields decide the outcome, QueryUnknown otherwise.
+		 */
+		QueryResult evaluate(const StudentView& student, unsigned knownColumns) const;
+
+	private:
+		enum NodeKind : std::uint8_t
+		{
+			AndNode,
+			OrNode,
+			NotNode,
+			CompareNode
+		};
+
+		enum Operand : std::uint8_t
+		{
+			SurnameOperand,
+			GroupOperand,
+			AverageOperand,
+			MinScoreOperand,
+			MaxScoreOperand,
+			ScoreCountOperand
+		};
+
+		enum Comparison : std::uint8_t
+		{
+			Equal,
+			NotEqual,
+			Less,
+			LessOrEqual,
+			Greater,
+			GreaterOrEqual
+		};
+
+		/** @brief Node of the compiled tree; children are positions in the node vector. */
+		struct Node
+		{
+			NodeKind kind{};
+			std::uint32_t left{};
+			std::uint32_t right{};
+
+			Operand operand{};
+			int subject{}; ///< Subject of an average or score operand: 0 physics, 1 math, 2 CS, 3 the overall GPA.
+			Comparison comparison{};
+			unsigned column{}; ///< QueryColumn the comparison reads.
+
+			double number{};
+			std::uint64_t integer{};
+			bool integral{}; ///< Whether the value is a whole number that fits integer.
+			std::string text{};
+			bool prefix{}; ///< Whether a surname value ends with '*' and matches a prefix.
+		};
+
+		class Compiler;
+
+		QueryResult evaluateNode(std::uint32_t index, const StudentView& student, unsigned knownColumns) const;
+		bool compare(const Node& node, const StudentView& student) const;
+
+		std::vector<Node> nodes; ///< The tree, with the root last.
+		unsigned referencedColumns = 0;
+		std::string errorMessage;
+	};
+
+} // database
+
+#endif // STUDENT_QUERY_H
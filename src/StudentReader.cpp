@@ -0,0 +1,140 @@
+#include "StudentReader.h"
+
+#include <filesystem>
+#include <ranges>
+
+#include "AsyncOperation.h"
+#include "StudentBinary.h"
+#include "StudentLog.h"
+
+namespace database
+{
+
+	static_assert(std::ranges::input_range<StudentReader>);
+
+	/**
+	 * @brief Copies a record into a student, reusing the student's buffers.
+	 * @param student The student that receives the record.
+	 * @param view The record to copy.
+	 */
+	static void assignStudent(Student& student, const StudentView& view)
+	{
+		student.surname.assign(view.surname);
+		student.groupNumber = view.groupNumber;
+
+		student.phisicsScores.assign(view.phisicsScores.begin(), view.phisicsScores.end());
+		student.mathScores.assign(view.mathScores.begin(), view.mathScores.end());
+		student.informScores.assign(view.informScores.begin(), view.informScores.end());
+
+		student.averagePhisicsGrade = view.averagePhisicsGrade;
+		student.averageMathGrade = view.averageMathGrade;
+		student.averageInformGrade = view.averageInformGrade;
+		student.averageGrade = view.averageGrade;
+	}
+
+	/**
+	 * @brief Opens a student file for reading.
+	 * @param filename Name of the file to read.
+	 * @param checkpoint Whether to fold the pending write-ahead log into the file first.
+	 */
+	StudentReader::StudentReader(const std::string& filename, bool checkpoint)
+	{
+		if (checkpoint && !checkpointStudentFile(filename))
+			return;
+
+		if (isBinaryStudentFile(filename))
+		{
+			binary = true;
+			opened = binaryFile.open(filename);
+
+			std::error_code error;
+			if (opened)
+				size = std::filesystem::file_size(filename, error);
+			return;
+		}
+
+		opened = textFile.open(filename);
+		if (opened)
+		{
+			parser = StudentParser(textFile.data(), textFile.data() + textFile.size());
+			size = textFile.size();
+		}
+	}
+
+	/**
+	 * @brief Opens a student file for reading only the records that match a query.
+	 * @param filename Name of the file to read.
+	 * @param query The query records must match; it must outlive the reader.
+	 * @param checkpoint Whether to fold the pending write-ahead log into the file first.
+	 */
+	StudentReader::StudentReader(const std::string& filename, const StudentQuery& query, bool checkpoint)
+		: StudentReader(filename, checkpoint)
+	{
+		if (!query.empty())
+			filter = &query;
+	}
+
+	/** @brief Returns how many bytes of the file the records read so far span. */
+	std::uint64_t StudentReader::bytesRead() const
+	{
+		if (!opened)
+			return 0;
+
+		if (!binary)
+			return static_cast<std::uint64_t>(parser.position() - textFile.data());
+
+		return binaryFile.size() == 0 ? size : size * binaryPosition / binaryFile.size();
+	}
+
+	/** @brief Reads the first record and returns an iterator to it. */
+	StudentReader::iterator StudentReader::begin()
+	{
+		advance();
+		return iterator(this);
+	}
+
+	/** @brief Reports the records read since the last report. */
+	void StudentReader::report()
+	{
+		const std::uint64_t position = hasCurrent ? bytesRead() : size;
+
+		progress->addRead(unreportedRecords, position - reportedBytes);
+		reportedBytes = position;
+		unreportedRecords = 0;
+	}
+
+	/** @brief Reads the next record into the buffer. */
+	void StudentReader::advance()
+	{
+		if (!opened)
+		{
+			hasCurrent = false;
+			return;
+		}
+
+		if (!binary)
+			hasCurrent = filter != nullptr ? parser.next(current, *filter) : parser.next(current);
+		else
+		{
+			while (filter != nullptr && binaryPosition < binaryFile.size() && !filter->matches(binaryFile[binaryPosition]))
+				binaryPosition++;
+
+			hasCurrent = binaryPosition < binaryFile.size();
+			if (hasCurrent)
+				assignStudent(current, binaryFile[binaryPosition++]);
+		}
+
+		if (progress == nullptr)
+			return;
+
+		if (hasCurrent)
+			unreportedRecords++;
+		if (unreportedRecords == progressReportRecords || !hasCurrent)
+		{
+			report();
+			if (progress->cancelled())
+				hasCurrent = false;
+		}
+	}
+
+} // database
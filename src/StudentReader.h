@@ -0,0 +1,151 @@
+#ifndef STUDENT_READER_H
+#define STUDENT_READER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <string>
+
+#include "MappedFile.h"
+#include "MappedStudentFile.h"
+#include "Student.h"
+#include "StudentParser.h"
+#include "StudentQuery.h"
+
+namespace database
+{
+
+	class OperationProgress;
+
+	/**
+	 * @brief Input range over the records of a student file.
+	 *
+	 * Records are produced one at a time into a single reused Student buffer, so
+	 * iterating a file runs in constant memory regardless of its size. Both the text
+	 * and the binary format are accepted; the format is detected when the file is opened.
+	 *
+	 * The range can be traversed once. The reference returned by the iterator stays
+	 * valid until the iterator is incremented.
+	 *
+	 * @code
+	 * for (const Student& student : StudentReader("storage/group.txt"))
+	 *     std::cout << student.surname << '\n';
+	 * @endcode
+	 */
+	class StudentReader
+	{
+	public:
+		class iterator
+		{
+		public:
+			using iterator_concept = std::input_iterator_tag;
+			using value_type = Student;
+			using difference_type = std::ptrdiff_t;
+
+			iterator() = default;
+
+			const Student& operator*() const { return reader->current; }
+			const Student* operator->() const { return &reader->current; }
+
+			iterator& operator++()
+			{
+				reader->advance();
+				return *this;
+			}
+
+			void operator++(int) { ++*this; }
+
+			friend bool operator==(const iterator& it, std::default_sentinel_t) { return it.atEnd(); }
+
+		private:
+			friend class StudentReader;
+
+			explicit iterator(StudentReader* reader) : reader(reader) {}
+
+			bool atEnd() const { return !reader->hasCurrent; }
+
+			StudentReader* reader = nullptr;
+		};
+
+		/**
+		 * @brief Opens a student file for reading.
+		 * @param filename Name of the file to read.
+		 * @param checkpoint Whether to fold the pending write-ahead log into the file first;
+		 *        the reader is not open if that fails.
+		 */
+		explicit StudentReader(const std::string& filename, bool checkpoint = false);
+
+		/**
+		 * @brief Opens a student file for reading only the records that match a query.
+		 *
+		 * The query is pushed down: text records are dropped before the fields it does
+		 * not depend on are parsed, and binary records are checked in place and copied
+		 * only when they match.
+		 *
+		 * @param filename Name of the file to read.
+		 * @param query The query records must match; it must outlive the reader.
+		 * @param checkpoint Whether to fold the pending write-ahead log into the file first;
+		 *        the reader is not open if that fails.
+		 */
+		StudentReader(const std::string& filename, const StudentQuery& query, bool checkpoint = false);
+
+		StudentReader(const StudentReader&) = delete;
+		StudentReader& operator=(const StudentReader&) = delete;
+
+		/** @brief Checks whether the file was opened successfully. */
+		bool isOpen() const { return opened; }
+
+		/** @brief Returns the size of the file in bytes. */
+		std::uint64_t fileSize() const { return size; }
+
+		/**
+		 * @brief Returns how many bytes of the file the records read so far span.
+		 *
+		 * Text files report the parser position; binary files store every field in its own
+		 * column, so their position is estimated from the share of records read.
+		 */
+		std::uint64_t bytesRead() const;
+
+		/**
+		 * @brief Reports the records read and the bytes they span to a progress.
+		 *
+		 * Reports are made every progressReportRecords records and at the end of the
+		 * file. Once the progress is cancelled the range ends early.
+		 *
+		 * @param progress The progress, or null to stop reporting.
+		 */
+		void reportTo(OperationProgress* progress) { this->progress = progress; }
+
+		/** @brief Reads the first record and returns an iterator to it. */
+		iterator begin();
+
+		/** @brief Returns the sentinel marking the end of the file. */
+		std::default_sentinel_t end() const { return std::default_sentinel; }
+
+	private:
+		/** @brief Reads the next record into the buffer. */
+		void advance();
+
+		MappedFile textFile;
+		MappedStudentFile binaryFile;
+		StudentParser parser{ nullptr, nullptr };
+		/** @brief Reports the records read since the last report. */
+		void report();
+
+		const StudentQuery* filter = nullptr; ///< Query records must match, or null to read all of them.
+		OperationProgress* progress = nullptr;
+		std::size_t unreportedRecords = 0;
+		std::uint64_t reportedBytes = 0;
+
+		bool opened = false;
+		bool binary = false;
+		std::uint64_t size = 0;
+		std::size_t binaryPosition = 0;
+
+		Student current;
+		bool hasCurrent = false;
+	};
+
+} // database
+
+#endif // STUDENT_READER_H
@@ -0,0 +1,57 @@
+#include "StudentSidecars.h"
+
+#include <filesystem>
+
+#include "StudentLog.h"
+
+namespace database
+{
+
+	/**
+	 * @brief Opens the sidecar index and the B+-trees that already exist for a data file.
+	 * @param dataFilename Name of the data file.
+	 */
+	void StudentSidecars::open(const std::string& dataFilename)
+	{
+		indexOpened = index.open(dataFilename);
+
+		for (std::size_t i = 0; i < treeCount; i++)
+		{
+			const SortingMethod sortingMethod = static_cast<SortingMethod>(i);
+			treeOpened[i] = std::filesystem::exists(treeFilename(dataFilename, sortingMethod))
+				&& trees[i].open(dataFilename, sortingMethod);
+		}
+	}
+
+	/**
+	 * @brief Adds a record appended to the data file to every opened sidecar.
+	 * @param student The appended student.
+	 * @param recordOffset Offset of the appended record.
+	 */
+	void StudentSidecars::append(const StudentView& student, std::uint64_t recordOffset)
+	{
+		if (indexOpened)
+			index.append(student, recordOffset);
+
+		for (std::size_t i = 0; i < treeCount; i++)
+		{
+			if (treeOpened[i])
+				trees[i].insert(student, recordOffset);
+		}
+	}
+
+	/**
+	 * @brief Deletes every sidecar file of a data file.
+	 * @param dataFilename Name of the data file.
+	 */
+	void removeStudentSidecars(const std::string& dataFilename)
+	{
+		std::error_code error;
+		std::filesystem::remove(indexFilename(dataFilename), error);
+		std::filesystem::remove(logFilename(dataFilename), error);
+
+		for (std::size_t i = 0; i < StudentSidecars::treeCount; i++)
+			std::filesystem::remove(treeFilename(dataFilename, static_cast<SortingMethod>(i)), error);
+	}
+
+} // database
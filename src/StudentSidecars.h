@@ -0,0 +1,56 @@
+#ifndef STUDENT_SIDECARS_H
+#define STUDENT_SIDECARS_H
+
+#include <array>
+#include <cstdint>
+#include <string>
+
+#include "Student.h"
+#include "StudentIndex.h"
+#include "StudentTree.h"
+
+namespace database
+{
+
+	/**
+	 * @brief The sidecar index and existing B+-trees of a data file, kept in step with appends.
+	 *
+	 * The sidecars must be opened before the data file is modified, so that a stale
+	 * sidecar is rebuilt from the old contents; every appended record is then added
+	 * incrementally instead of rescanning the file.
+	 */
+	class StudentSidecars
+	{
+	public:
+		static constexpr std::size_t treeCount = SortByAverageInformGrade + 1; ///< One B+-tree per sorting field.
+
+		/**
+		 * @brief Opens the sidecar index and the B+-trees that already exist for a data file.
+		 * @param dataFilename Name of the data file.
+		 */
+		void open(const std::string& dataFilename);
+
+		/**
+		 * @brief Adds a record appended to the data file to every opened sidecar.
+		 * @param student The appended student.
+		 * @param recordOffset Offset of the appended record.
+		 */
+		void append(const StudentView& student, std::uint64_t recordOffset);
+
+	private:
+		StudentIndex index;
+		bool indexOpened = false;
+
+		std::array<StudentTree, treeCount> trees;
+		std::array<bool, treeCount> treeOpened{};
+	};
+
+	/**
+	 * @brief Deletes every sidecar file of a data file.
+	 * @param dataFilename Name of the data file.
+	 */
+	void removeStudentSidecars(const std::string& dataFilename);
+
+} // database
+
+#endif // STUDENT_SIDECARS_H
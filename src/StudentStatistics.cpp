@@ -0,0 +1,427 @@
+#include "StudentStatistics.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <limits>
+#include <numbers>
+#include <ostream>
+#include <sstream>
+
+#include "AsyncOperation.h"
+#include "StudentReader.h"
+
+namespace database
+{
+
+	/**
+	 * @brief Creates an empty digest.
+	 * @param compression Bound on the number of centroids; higher is more accurate.
+	 */
+	TDigest::TDigest(double compression)
+		: compression((std::max)(compression, 10.0))
+	{
+	}
+
+	/**
+	 * @brief Adds a value.
+	 * @param value The value to add.
+	 */
+	void TDigest::add(double value)
+	{
+		if (std::isnan(value))
+			return;
+
+		if (totalWeight == 0)
+			minimum = maximum = value;
+		minimum = (std::min)(minimum, value);
+		maximum = (std::max)(maximum, value);
+		totalWeight += 1;
+
+		buffer.push_back({ value, 1 });
+		if (buffer.size() >= static_cast<std::size_t>(5 * compression))
+			compress();
+	}
+
+	/**
+	 * @brief Adds every value of another digest.
+	 * @param other The digest to merge.
+	 */
+	void TDigest::merge(const TDigest& other)
+	{
+		if (other.totalWeight == 0)
+			return;
+
+		if (totalWeight == 0)
+		{
+			minimum = other.minimum;
+			maximum = other.maximum;
+		}
+		minimum = (std::min)(minimum, other.minimum);
+		maximum = (std::max)(maximum, other.maximum);
+		totalWeight += other.totalWeight;
+
+		buffer.insert(buffer.end(), other.centroids.begin(), other.centroids.end());
+		buffer.insert(buffer.end(), other.buffer.begin(), other.buffer.end());
+		compress();
+	}
+
+	/**
+	 * @brief Merges the buffered values into the centroids.
+	 *
+	 * All centroids are sorted by mean and swept once; a centroid absorbs its neighbour
+	 * while the quantile range it covers stays within one unit of the scale function
+	 * k(q) = compression / (2 pi) * asin(2q - 1).
+	 */
+	void TDigest::compress() const
+	{
+		if (buffer.empty())
+			return;
+
+		buffer.insert(buffer.end(), centroids.begin(), centroids.end());
+		std::sort(buffer.begin(), buffer.end(), [](const Centroid& a, const Centroid& b) { return a.mean < b.mean; });
+
+		const double scale = compression / (2 * std::numbers::pi);
+		const auto nextLimit = [this, scale](double weightBefore) {
+			const double k = scale * std::asin(2 * weightBefore / totalWeight - 1) + 1;
+			return k >= compression / 4 ? 1.0 : (std::sin(k / scale) + 1) / 2;
+		};
+
+		centroids.clear();
+		Centroid current = buffer.front();
+		double weightBefore = 0;
+		double limit = nextLimit(weightBefore);
+
+		for (std::size_t i = 1; i < buffer.size(); i++)
+		{
+			const Centroid& next = buffer[i];
+			if ((weightBefore + current.weight + next.weight) / totalWeight <= limit)
+			{
+				current.weight += next.weight;
+				current.mean += (next.mean - current.mean) * next.weight / current.weight;
+			}
+			else
+			{
+				weightBefore += current.weight;
+				centroids.push_back(current);
+				limit = nextLimit(weightBefore);
+				current = next;
+			}
+		}
+		centroids.push_back(current);
+
+		buffer.clear();
+	}
+
+	/**
+	 * @brief Estimates a quantile.
+	 *
+	 * Every centroid is placed at the middle of the weight it covers; the smallest value
+	 * sits at weight zero and the largest at the total weight, and the quantile is
+	 * interpolated linearly between the two points around it.
+	 *
+	 * @param q The quantile, from 0 for the minimum to 1 for the maximum.
+	 * @return The estimated value, or NaN if the digest is empty.
+	 */
+	double TDigest::quantile(double q) const
+	{
+		if (totalWeight == 0)
+			return std::numeric_limits<double>::quiet_NaN();
+
+		compress();
+
+		const double position = (std::clamp)(q, 0.0, 1.0) * totalWeight;
+
+		double previousPosition = 0;
+		double previousMean = minimum;
+		double weightBefore = 0;
+		for (const auto& centroid : centroids)
+		{
+			const double centre = weightBefore + centroid.weight / 2;
+			if (position < centre)
+			{
+				if (centre == previousPosition)
+					return centroid.mean;
+				return previousMean + (centroid.mean - previousMean) * (position - previousPosition) / (centre - previousPosition);
+			}
+
+			previousPosition = centre;
+			previousMean = centroid.mean;
+			weightBefore += centroid.weight;
+		}
+
+		if (totalWeight == previousPosition)
+			return maximum;
+		return previousMean + (maximum - previousMean) * (position - previousPosition) / (totalWeight - previousPosition);
+	}
+
+	/**
+	 * @brief Adds a value; NaN values are ignored.
+	 * @param value The value to add.
+	 */
+	void FieldStatistics::add(double value)
+	{
+		if (std::isnan(value))
+			return;
+
+		if (count == 0)
+			minimum = maximum = value;
+		minimum = (std::min)(minimum, value);
+		maximum = (std::max)(maximum, value);
+		sum += value;
+		count++;
+		digest.add(value);
+	}
+
+	/**
+	 * @brief Adds the values of another summary.
+	 * @param other The summary to merge.
+	 */
+	void FieldStatistics::merge(const FieldStatistics& other)
+	{
+		if (other.count == 0)
+			return;
+
+		if (count == 0)
+		{
+			minimum = other.minimum;
+			maximum = other.maximum;
+		}
+		minimum = (std::min)(minimum, other.minimum);
+		maximum = (std::max)(maximum, other.maximum);
+		sum += other.sum;
+		count += other.count;
+		digest.merge(other.digest);
+	}
+
+	/**
+	 * @brief Returns the mean, or NaN if there are no values.
+	 */
+	double FieldStatistics::mean() const
+	{
+		return count == 0 ? std::numeric_limits<double>::quiet_NaN() : sum / static_cast<double>(count);
+	}
+
+	/**
+	 * @brief Adds a student.
+	 * @param student The student to add.
+	 */
+	void StudentStatistics::add(const StudentView& student)
+	{
+		studentCount++;
+
+		gpa.add(student.averageGrade);
+		physics.add(student.averagePhisicsGrade);
+		math.add(student.averageMathGrade);
+		cs.add(student.averageInformGrade);
+
+		const bool failing[3] = {
+			hasFailingScore(student.phisicsScores),
+			hasFailingScore(student.mathScores),
+			hasFailingScore(student.informScores)
+		};
+
+		if (!std::isnan(student.averageGrade))
+			gpaHistogram[static_cast<std::int64_t>(std::floor(student.averageGrade / gpaHistogramBinWidth))]++;
+
+		GroupStatistics& group = groups[student.groupNumber];
+		group.groupNumber = student.groupNumber;
+		group.studentCount++;
+		group.gpa.add(student.averageGrade);
+
+		for (int subject = 0; subject < 3; subject++)
+		{
+			failingCounts[subject] += failing[subject];
+			group.failingCounts[subject] += failing[subject];
+		}
+		group.failingStudents += failing[0] || failing[1] || failing[2];
+	}
+
+	/**
+	 * @brief Adds the students of other statistics.
+	 * @param other The statistics to merge.
+	 */
+	void StudentStatistics::merge(const StudentStatistics& other)
+	{
+		studentCount += other.studentCount;
+
+		gpa.merge(other.gpa);
+		physics.merge(other.physics);
+		math.merge(other.math);
+		cs.merge(other.cs);
+
+		for (int subject = 0; subject < 3; subject++)
+			failingCounts[subject] += other.failingCounts[subject];
+
+		for (const auto& [bin, count] : other.gpaHistogram)
+			gpaHistogram[bin] += count;
+
+		for (const auto& [groupNumber, otherGroup] : other.groups)
+		{
+			GroupStatistics& group = groups[groupNumber];
+			group.groupNumber = groupNumber;
+			group.studentCount += otherGroup.studentCount;
+			group.gpa.merge(otherGroup.gpa);
+			for (int subject = 0; subject < 3; subject++)
+				group.failingCounts[subject] += otherGroup.failingCounts[subject];
+			group.failingStudents += otherGroup.failingStudents;
+		}
+	}
+
+	/**
+	 * @brief Returns the groups ordered by group number.
+	 * @return Pointers to the group statistics, valid while the statistics are unchanged.
+	 */
+	std::vector<const GroupStatistics*> StudentStatistics::sortedGroups() const
+	{
+		std::vector<const GroupStatistics*> sorted;
+		sorted.reserve(groups.size());
+		for (const auto& entry : groups)
+			sorted.push_back(&entry.second);
+
+		std::sort(sorted.begin(), sorted.end(), [](const GroupStatistics* a, const GroupStatistics* b) {
+			return a->groupNumber < b->groupNumber;
+			});
+		return sorted;
+	}
+
+	/**
+	 * @brief Computes the statistics of a text or binary student file in one pass.
+	 *
+	 * The pending write-ahead log of the file is folded into it first.
+	 *
+	 * @param filename Name of the file.
+	 * @param statistics Receives the statistics.
+	 * @param progress Progress that receives the size of the file and the records and bytes read, or null.
+	 *        Once it is cancelled the file is no longer read and the statistics are incomplete.
+	 * @return True if the file was read, false if it could not be brought up to date or opened or the progress was cancelled.
+	 */
+	bool computeStatistics(const std::string& filename, StudentStatistics& statistics, OperationProgress* progress)
+	{
+		StudentReader reader(filename, true);
+		if (!reader.isOpen())
+			return false;
+
+		if (progress != nullptr)
+			progress->setTotalBytes(reader.fileSize());
+		reader.reportTo(progress);
+
+		statistics = StudentStatistics{};
+		for (const Student& student : reader)
+			statistics.add(makeStudentView(student));
+		return progress == nullptr || !progress->cancelled();
+	}
+
+	/**
+	 * @brief Prints a value right-aligned with three decimals, or a dash if it is NaN.
+	 * @param out Output stream to print to.
+	 * @param value The value to print.
+	 * @param width Width of the column.
+	 */
+	static void printValue(std::ostream& out, double value, int width)
+	{
+		if (std::isnan(value))
+			out << std::setw(width) << "-";
+		else
+			out << std::setw(width) << value;
+	}
+
+	/**
+	 * @brief Prints a count followed by its share of a total.
+	 * @param out Output stream to print to.
+	 * @param count The count.
+	 * @param total The total the share is taken of.
+	 */
+	static void printShare(std::ostream& out, std::uint64_t count, std::uint64_t total)
+	{
+		out << std::setw(10) << count << std::setw(8) << std::setprecision(1)
+			<< (total == 0 ? 0.0 : 100.0 * count / total) << "%" << std::setprecision(3);
+	}
+
+	/**
+	 * @brief Prints a report of statistics: totals, field quantiles, failing students,
+	 * the GPA histogram and a table of the groups.
+	 * @param out Output stream to print to.
+	 * @param statistics The statistics to report.
+	 */
+	void printStatistics(std::ostream& out, const StudentStatistics& statistics)
+	{
+		constexpr double notANumber = std::numeric_limits<double>::quiet_NaN();
+
+		const auto flags = out.flags();
+		const auto precision = out.precision();
+		out << std::fixed << std::setprecision(3);
+
+		out << std::left << std::setw(9) << "RECORDS:" << statistics.studentCount << '\n';
+		out << std::left << std::setw(9) << "GROUPS:" << statistics.groups.size() << '\n';
+
+		if (statistics.studentCount != 0)
+		{
+			out << '\n' << std::left << std::setw(8) << "FIELD" << std::right
+				<< std::setw(7) << "MIN" << std::setw(7) << "MEAN" << std::setw(7) << "MEDIAN"
+				<< std::setw(7) << "P90" << std::setw(7) << "MAX" << '\n';
+
+			const std::pair<const char*, const FieldStatistics*> fields[] = {
+				{ "GPA", &statistics.gpa }, { "PHYSICS", &statistics.physics },
+				{ "MATH", &statistics.math }, { "CS", &statistics.cs }
+			};
+			for (const auto& [name, field] : fields)
+			{
+				out << std::left << std::setw(8) << name << std::right;
+				printValue(out, field->count == 0 ? notANumber : field->minimum, 7);
+				printValue(out, field->mean(), 7);
+				printValue(out, field->quantile(0.5), 7);
+				printValue(out, field->quantile(0.9), 7);
+				printValue(out, field->count == 0 ? notANumber : field->maximum, 7);
+				out << '\n';
+			}
+
+			out << "\nFAILING (A SCORE BELOW " << failingScore << ")\n";
+			const char* subjects[3] = { "PHYSICS", "MATH", "CS" };
+			for (int subject = 0; subject < 3; subject++)
+			{
+				out << std::left << std::setw(8) << subjects[subject] << std::right;
+				printShare(out, statistics.failingCounts[subject], statistics.studentCount);
+				out << '\n';
+			}
+
+			if (!statistics.gpaHistogram.empty())
+			{
+				out << "\nGPA HISTOGRAM\n";
+
+				std::uint64_t largestBin = 0;
+				for (const auto& [bin, count] : statistics.gpaHistogram)
+					largestBin = (std::max)(largestBin, count);
+
+				for (const auto& [bin, count] : statistics.gpaHistogram)
+				{
+					const double low = bin * gpaHistogramBinWidth;
+					std::ostringstream range;
+					range << std::fixed << std::setprecision(1) << low << '-' << low + gpaHistogramBinWidth;
+
+					const std::size_t barLength = static_cast<std::size_t>((count * 20 + largestBin - 1) / largestBin);
+					out << std::right << std::setw(10) << range.str() << std::setw(9) << count << ' '
+						<< std::string(barLength, '#') << '\n';
+				}
+			}
+
+			out << '\n' << std::left << std::setw(8) << "GROUP" << std::right
+				<< std::setw(8) << "COUNT" << std::setw(7) << "MEAN" << std::setw(7) << "MEDIAN"
+				<< std::setw(7) << "P90" << std::setw(8) << "FAIL" << '\n';
+
+			for (const GroupStatistics* group : statistics.sortedGroups())
+			{
+				out << std::left << std::setw(8) << group->groupNumber << std::right
+					<< std::setw(8) << group->studentCount;
+				printValue(out, group->gpa.mean(), 7);
+				printValue(out, group->gpa.quantile(0.5), 7);
+				printValue(out, group->gpa.quantile(0.9), 7);
+				out << std::setw(8) << group->failingStudents << '\n';
+			}
+		}
+
+		out.flags(flags);
+		out.precision(precision);
+	}
+
+} // database
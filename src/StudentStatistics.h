@@ -0,0 +1,192 @@
+#ifndef STUDENT_STATISTICS_H
+#define STUDENT_STATISTICS_H
+
+#include <cstdint>
+#include <iosfwd>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Student.h"
+
+namespace database
+{
+
+	class OperationProgress;
+
+	inline constexpr double defaultDigestCompression = 100; ///< Compression of the quantile digests; higher is more accurate.
+	inline constexpr double gpaHistogramBinWidth = 0.5; ///< Width of a bin of the GPA histogram.
+
+	/**
+	 * @brief Merging t-digest: a fixed-size sketch of a distribution for approximate quantiles.
+	 *
+	 * Values are buffered and merged into weighted centroids whose size is bounded by
+	 * the arcsine scale function, so centroids near the tails stay small and extreme
+	 * quantiles stay accurate. While there are few values every centroid holds one of
+	 * them and quantiles are exact. Digests of parts of the data can be merged.
+	 */
+	class TDigest
+	{
+	public:
+		/** @brief Creates an empty digest with the default compression. */
+		TDigest() : TDigest(defaultDigestCompression) {}
+
+		/**
+		 * @brief Creates an empty digest.
+		 * @param compression Bound on the number of centroids; higher is more accurate.
+		 */
+		explicit TDigest(double compression);
+
+		/**
+		 * @brief Adds a value.
+		 * @param value The value to add.
+		 */
+		void add(double value);
+
+		/**
+		 * @brief Adds every value of another digest.
+		 * @param other The digest to merge.
+		 */
+		void merge(const TDigest& other);
+
+		/** @brief Returns the number of values added. */
+		double count() const { return totalWeight; }
+
+		/**
+		 * @brief Estimates a quantile.
+		 *
+		 * The quantile is interpolated between the centres of the centroids, and between
+		 * the extreme centroids and the smallest and largest value.
+		 *
+		 * @param q The quantile, from 0 for the minimum to 1 for the maximum.
+		 * @return The estimated value, or NaN if the digest is empty.
+		 */
+		double quantile(double q) const;
+
+	private:
+		/** @brief A weighted mean of neighbouring values. */
+		struct Centroid
+		{
+			double mean;
+			double weight;
+		};
+
+		/** @brief Merges the buffered values into the centroids. */
+		void compress() const;
+
+		double compression;
+		double totalWeight = 0;
+		double minimum = 0;
+		double maximum = 0;
+
+		mutable std::vector<Centroid> centroids;
+		mutable std::vector<Centroid> buffer;
+	};
+
+	/** @brief Summary of one numeric field. */
+	struct FieldStatistics
+	{
+		std::uint64_t count{}; ///< Number of values; NaN values are not counted.
+		double sum{};
+		double minimum{};
+		double maximum{};
+		TDigest digest;
+
+		/**
+		 * @brief Adds a value; NaN values are ignored.
+		 * @param value The value to add.
+		 */
+		void add(double value);
+
+		/**
+		 * @brief Adds the values of another summary.
+		 * @param other The summary to merge.
+		 */
+		void merge(const FieldStatistics& other);
+
+		/** @brief Returns the mean, or NaN if there are no values. */
+		double mean() const;
+
+		/** @brief Returns an estimate of a quantile, or NaN if there are no values. */
+		double quantile(double q) const { return digest.quantile(q); }
+	};
+
+	/** @brief Statistics of the students of one group. */
+	struct GroupStatistics
+	{
+		std::uint64_t groupNumber{};
+		std::uint64_t studentCount{};
+		FieldStatistics gpa;
+		std::uint64_t failingCounts[3]{}; ///< Students with a failing score, per subject in physics, math and CS order.
+		std::uint64_t failingStudents{}; ///< Students with a failing score in any subject.
+	};
+
+	/**
+	 * @brief Aggregates of a student file, computed in one pass.
+	 *
+	 * Groups are aggregated in a hash table keyed by group number. Quantiles come from
+	 * t-digests, so memory use depends on the number of groups but not of students.
+	 * Statistics of parts of a file can be merged.
+	 */
+	struct StudentStatistics
+	{
+		std::uint64_t studentCount{};
+
+		FieldStatistics gpa;
+		FieldStatistics physics;
+		FieldStatistics math;
+		FieldStatistics cs;
+
+		std::uint64_t failingCounts[3]{}; ///< Students with a failing score, per subject in physics, math and CS order.
+		std::map<std::int64_t, std::uint64_t> gpaHistogram; ///< Student count per GPA bin; bin i covers [i, i + 1) times the bin width.
+
+		std::unordered_map<std::uint64_t, GroupStatistics> groups;
+
+		/**
+		 * @brief Adds a student.
+		 * @param student The student to add.
+		 */
+		void add(const StudentView& student);
+
+		/**
+		 * @brief Adds the students of other statistics.
+		 * @param other The statistics to merge.
+		 */
+		void merge(const StudentStatistics& other);
+
+		/**
+		 * @brief Returns the groups ordered by group number.
+		 * @return Pointers to the group statistics, valid while the statistics are unchanged.
+		 */
+		std::vector<const GroupStatistics*> sortedGroups() const;
+	};
+
+	/**
+	 * @brief Computes the statistics of a text or binary student file in one pass.
+	 *
+	 * The pending write-ahead log of the file is folded into it first.
+	 *
+	 * @param filename Name of the file.
+	 * @param statistics Receives the statistics.
+	 * @param progress Progress that receives the size of the file and the records and bytes read, or null.
+	 *        Once it is cancelled the file is no longer read and the statistics are incomplete.
+	 * @return True if the file was read, false if it could not be brought up to date or opened or the progress was cancelled.
+	 */
+	bool computeStatistics(const std::string& filename, StudentStatistics& statistics, OperationProgress* progress = nullptr);
+
+	/**
+	 * @brief Prints a report of statistics: totals, field quantiles, failing students,
+	 * the GPA histogram and a table of the groups.
+	 *
+	 * Lines are at most 47 characters wide so the report fits the text box of the
+	 * console interface.
+	 *
+	 * @param out Output stream to print to.
+	 * @param statistics The statistics to report.
+	 */
+	void printStatistics(std::ostream& out, const StudentStatistics& statistics);
+
+} // database
+
+#endif // STUDENT_STATISTICS_H
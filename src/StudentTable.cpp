@@ -0,0 +1,224 @@
+#include "StudentTable.h"
+
+#include "AsyncOperation.h"
+#include "MappedFile.h"
+#include "ParallelParser.h"
+#include "StudentBinary.h"
+#include "StudentReader.h"
+
+namespace database
+{
+
+	StudentTable::StudentTable()
+	{
+		clear();
+	}
+
+	/**
+	 * @brief Reserves storage for a number of students.
+	 * @param count The number of students to reserve space for.
+	 */
+	void StudentTable::reserve(std::size_t count)
+	{
+		surnameOffsets.reserve(count + 1);
+		groupNumberColumn.reserve(count);
+		averagePhisicsGradeColumn.reserve(count);
+		averageMathGradeColumn.reserve(count);
+		averageInformGradeColumn.reserve(count);
+		averageGradeColumn.reserve(count);
+		scoreOffsetColumn.reserve(3 * count + 1);
+	}
+
+	/** @brief Removes all students from the table. */
+	void StudentTable::clear()
+	{
+		surnameHeap.clear();
+		surnameOffsets.assign(1, 0);
+
+		groupNumberColumn.clear();
+		averagePhisicsGradeColumn.clear();
+		averageMathGradeColumn.clear();
+		averageInformGradeColumn.clear();
+		averageGradeColumn.clear();
+
+		scorePool.clear();
+		scoreOffsetColumn.assign(1, 0);
+	}
+
+	/** @brief Returns the number of bytes held by the table's columns. */
+	std::size_t StudentTable::memoryUsage() const
+	{
+		return surnameHeap.size()
+			+ (surnameOffsets.size() + groupNumberColumn.size() + scoreOffsetColumn.size()) * sizeof(std::uint64_t)
+			+ 4 * averageGradeColumn.size() * sizeof(double)
+			+ scorePool.size() * sizeof(std::uint16_t);
+	}
+
+	/**
+	 * @brief Appends a copy of a student record to the table.
+	 * @param student The student to append.
+	 */
+	void StudentTable::append(const StudentView& student)
+	{
+		surnameHeap.append(student.surname);
+		surnameOffsets.push_back(surnameHeap.size());
+
+		groupNumberColumn.push_back(student.groupNumber);
+		averagePhisicsGradeColumn.push_back(student.averagePhisicsGrade);
+		averageMathGradeColumn.push_back(student.averageMathGrade);
+		averageInformGradeColumn.push_back(student.averageInformGrade);
+		averageGradeColumn.push_back(student.averageGrade);
+
+		scorePool.insert(scorePool.end(), student.phisicsScores.begin(), student.phisicsScores.end());
+		scoreOffsetColumn.push_back(scorePool.size());
+		scorePool.insert(scorePool.end(), student.mathScores.begin(), student.mathScores.end());
+		scoreOffsetColumn.push_back(scorePool.size());
+		scorePool.insert(scorePool.end(), student.informScores.begin(), student.informScores.end());
+		scoreOffsetColumn.push_back(scorePool.size());
+	}
+
+	/**
+	 * @brief Appends copies of all students of another table, column by column.
+	 * @param other The table whose students are appended.
+	 */
+	void StudentTable::append(const StudentTable& other)
+	{
+		const std::uint64_t surnameBase = surnameHeap.size();
+		surnameHeap += other.surnameHeap;
+		for (std::size_t i = 1; i < other.surnameOffsets.size(); i++)
+			surnameOffsets.push_back(surnameBase + other.surnameOffsets[i]);
+
+		groupNumberColumn.insert(groupNumberColumn.end(), other.groupNumberColumn.begin(), other.groupNumberColumn.end());
+		averagePhisicsGradeColumn.insert(averagePhisicsGradeColumn.end(), other.averagePhisicsGradeColumn.begin(), other.averagePhisicsGradeColumn.end());
+		averageMathGradeColumn.insert(averageMathGradeColumn.end(), other.averageMathGradeColumn.begin(), other.averageMathGradeColumn.end());
+		averageInformGradeColumn.insert(averageInformGradeColumn.end(), other.averageInformGradeColumn.begin(), other.averageInformGradeColumn.end());
+		averageGradeColumn.insert(averageGradeColumn.end(), other.averageGradeColumn.begin(), other.averageGradeColumn.end());
+
+		const std::uint64_t scoreBase = scorePool.size();
+		scorePool.insert(scorePool.end(), other.scorePool.begin(), other.scorePool.end());
+		for (std::size_t i = 1; i < other.scoreOffsetColumn.size(); i++)
+			scoreOffsetColumn.push_back(scoreBase + other.scoreOffsetColumn[i]);
+	}
+
+	/** @brief Returns the surname of the student at the given position without building a full view. */
+	std::string_view StudentTable::surname(std::size_t index) const
+	{
+		return std::string_view(surnameHeap).substr(surnameOffsets[index], surnameOffsets[index + 1] - surnameOffsets[index]);
+	}
+
+	/**
+	 * @brief Returns a row proxy for the student at the given position.
+	 * @param index Position of the student in the table.
+	 * @return A view referring to the table's columns; invalidated by any modification.
+	 */
+	StudentView StudentTable::operator[](std::size_t index) const
+	{
+		const std::uint64_t* offsets = scoreOffsetColumn.data() + 3 * index;
+		const std::uint16_t* pool = scorePool.data();
+
+		StudentView view;
+		view.surname = surname(index);
+		view.groupNumber = groupNumberColumn[index];
+		view.phisicsScores = { pool + offsets[0], static_cast<std::size_t>(offsets[1] - offsets[0]) };
+		view.mathScores = { pool + offsets[1], static_cast<std::size_t>(offsets[2] - offsets[1]) };
+		view.informScores = { pool + offsets[2], static_cast<std::size_t>(offsets[3] - offsets[2]) };
+		view.averagePhisicsGrade = averagePhisicsGradeColumn[index];
+		view.averageMathGrade = averageMathGradeColumn[index];
+		view.averageInformGrade = averageInformGradeColumn[index];
+		view.averageGrade = averageGradeColumn[index];
+		return view;
+	}
+
+	/**
+	 * @brief Gathers the elements of a column in a new order.
+	 * @param column The column to reorder.
+	 * @param order The old positions of the elements, listed in their new order.
+	 */
+	template <typename T>
+	static void gatherColumn(std::vector<T>& column, const std::vector<std::size_t>& order)
+	{
+		std::vector<T> reordered;
+		reordered.reserve(column.size());
+
+		for (std::size_t index : order)
+			reordered.push_back(column[index]);
+
+		column.swap(reordered);
+	}
+
+	/**
+	 * @brief Reorders the rows of the table.
+	 * @param order The old positions of the rows, listed in their new order.
+	 */
+	void StudentTable::permute(const std::vector<std::size_t>& order)
+	{
+		std::string reorderedSurnames;
+		std::vector<std::uint64_t> reorderedSurnameOffsets;
+		std::vector<std::uint16_t> reorderedScores;
+		std::vector<std::uint64_t> reorderedScoreOffsets;
+
+		reorderedSurnames.reserve(surnameHeap.size());
+		reorderedSurnameOffsets.reserve(surnameOffsets.size());
+		reorderedScores.reserve(scorePool.size());
+		reorderedScoreOffsets.reserve(scoreOffsetColumn.size());
+
+		reorderedSurnameOffsets.push_back(0);
+		reorderedScoreOffsets.push_back(0);
+
+		for (std::size_t index : order)
+		{
+			reorderedSurnames.append(surname(index));
+			reorderedSurnameOffsets.push_back(reorderedSurnames.size());
+
+			for (std::size_t subject = 0; subject < 3; subject++)
+			{
+				const std::uint64_t first = scoreOffsetColumn[3 * index + subject];
+				const std::uint64_t last = scoreOffsetColumn[3 * index + subject + 1];
+
+				reorderedScores.insert(reorderedScores.end(), scorePool.begin() + first, scorePool.begin() + last);
+				reorderedScoreOffsets.push_back(reorderedScores.size());
+			}
+		}
+
+		surnameHeap.swap(reorderedSurnames);
+		surnameOffsets.swap(reorderedSurnameOffsets);
+		scorePool.swap(reorderedScores);
+		scoreOffsetColumn.swap(reorderedScoreOffsets);
+
+		gatherColumn(groupNumberColumn, order);
+		gatherColumn(averagePhisicsGradeColumn, order);
+		gatherColumn(averageMathGradeColumn, order);
+		gatherColumn(averageInformGradeColumn, order);
+		gatherColumn(averageGradeColumn, order);
+	}
+
+	/**
+	 * @brief Reads a text or binary student file straight into a table.
+	 * @param filename Name of the file to read from.
+	 * @param table Table that receives the students; existing rows are kept.
+	 * @param progress Progress that receives the records and bytes read, or null.
+	 * @return True if the file was read, false if it could not be opened or the progress was cancelled.
+	 */
+	bool readStudentTable(const std::string& filename, StudentTable& table, OperationProgress* progress)
+	{
+		if (!isBinaryStudentFile(filename))
+		{
+			MappedFile file;
+			if (!file.open(filename))
+				return false;
+			parseStudentTableParallel(file.data(), file.data() + file.size(), table, 0, progress);
+			return progress == nullptr || !progress->cancelled();
+		}
+
+		StudentReader reader(filename);
+		if (!reader.isOpen())
+			return false;
+
+		reader.reportTo(progress);
+		for (const Student& student : reader)
+			table.append(student);
+
+		return progress == nullptr || !progress->cancelled();
+	}
+
+} // database
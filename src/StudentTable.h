@@ -0,0 +1,135 @@
+#ifndef STUDENT_TABLE_H
+#define STUDENT_TABLE_H
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Student.h"
+
+namespace database
+{
+
+	class OperationProgress;
+
+	/**
+	 * @brief Structure-of-arrays container for student records.
+	 *
+	 * Every field is kept in its own contiguous column: surnames share one character
+	 * heap, and the scores of all students share one pool addressed by per-student
+	 * offset ranges (three ranges per student, in physics/math/CS order). Rows are
+	 * accessed through StudentView proxies, which expose the same field names as Student.
+	 */
+	class StudentTable
+	{
+	public:
+		StudentTable();
+
+		/** @brief Returns the number of students in the table. */
+		std::size_t size() const { return groupNumberColumn.size(); }
+
+		/** @brief Checks whether the table holds no students. */
+		bool empty() const { return groupNumberColumn.empty(); }
+
+		/**
+		 * @brief Reserves storage for a number of students.
+		 * @param count The number of students to reserve space for.
+		 */
+		void reserve(std::size_t count);
+
+		/** @brief Removes all students from the table. */
+		void clear();
+
+		/** @brief Returns the number of bytes held by the table's columns. */
+		std::size_t memoryUsage() const;
+
+		/**
+		 * @brief Appends a copy of a student record to the table.
+		 * @param student The student to append.
+		 */
+		void append(const StudentView& student);
+
+		/**
+		 * @brief Appends a copy of a student object to the table.
+		 * @param student The student to append.
+		 */
+		void append(const Student& student) { append(makeStudentView(student)); }
+
+		/**
+		 * @brief Appends copies of all students of another table, column by column.
+		 * @param other The table whose students are appended.
+		 */
+		void append(const StudentTable& other);
+
+		/**
+		 * @brief Returns a row proxy for the student at the given position.
+		 * @param index Position of the student in the table.
+		 * @return A view referring to the table's columns; invalidated by any modification.
+		 */
+		StudentView operator[](std::size_t index) const;
+
+		/** @brief Returns the surname of the student at the given position without building a full view. */
+		std::string_view surname(std::size_t index) const;
+
+		/**
+		 * @brief Copies the student at the given position into a Student object.
+		 * @param index Position of the student in the table.
+		 * @return A Student object owning a copy of the row.
+		 */
+		Student toStudent(std::size_t index) const { return database::toStudent((*this)[index]); }
+
+		/**
+		 * @brief Reorders the rows of the table.
+		 * @param order The old positions of the rows, listed in their new order.
+		 */
+		void permute(const std::vector<std::size_t>& order);
+
+		std::span<const std::uint64_t> groupNumbers() const { return groupNumberColumn; }
+		std::span<const double> averagePhisicsGrades() const { return averagePhisicsGradeColumn; }
+		std::span<const double> averageMathGrades() const { return averageMathGradeColumn; }
+		std::span<const double> averageInformGrades() const { return averageInformGradeColumn; }
+		std::span<const double> averageGrades() const { return averageGradeColumn; }
+
+		std::span<double> averagePhisicsGrades() { return averagePhisicsGradeColumn; }
+		std::span<double> averageMathGrades() { return averageMathGradeColumn; }
+		std::span<double> averageInformGrades() { return averageInformGradeColumn; }
+		std::span<double> averageGrades() { return averageGradeColumn; }
+
+		/** @brief Returns the pool holding the scores of all students. */
+		std::span<const std::uint16_t> scores() const { return scorePool; }
+
+		/** @brief Returns the score offsets; student i's subject s spans [offsets[3i+s], offsets[3i+s+1]). */
+		std::span<const std::uint64_t> scoreOffsets() const { return scoreOffsetColumn; }
+
+	private:
+		std::string surnameHeap;
+		std::vector<std::uint64_t> surnameOffsets;
+
+		std::vector<std::uint64_t> groupNumberColumn;
+		std::vector<double> averagePhisicsGradeColumn;
+		std::vector<double> averageMathGradeColumn;
+		std::vector<double> averageInformGradeColumn;
+		std::vector<double> averageGradeColumn;
+
+		std::vector<std::uint16_t> scorePool;
+		std::vector<std::uint64_t> scoreOffsetColumn;
+	};
+
+	/**
+	 * @brief Reads a text or binary student file straight into a table.
+	 *
+	 * Large text files are parsed on several threads with the same result as a
+	 * sequential read.
+	 *
+	 * @param filename Name of the file to read from.
+	 * @param table Table that receives the students; existing rows are kept.
+	 * @param progress Progress that receives the records and bytes read, or null.
+	 * @return True if the file was read, false if it could not be opened or the progress was cancelled.
+	 */
+	bool readStudentTable(const std::string& filename, StudentTable& table, OperationProgress* progress = nullptr);
+
+} // database
+
+#endif // STUDENT_TABLE_H
@@ -0,0 +1,587 @@
+#include "StudentTree.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+#include "StudentIndex.h"
+
+namespace database
+{
+
+	/** @brief Header shared by leaf and inner nodes. */
+	struct NodeHeader
+	{
+		std::uint16_t isLeaf;
+		std::uint16_t count;
+		std::uint32_t next; ///< Next leaf in key order, or zero for the last leaf.
+	};
+
+	static constexpr std::size_t leafCapacity = (BufferPool::pageSize - sizeof(NodeHeader)) / sizeof(StudentTree::Key);
+	static constexpr std::size_t innerCapacity =
+		(BufferPool::pageSize - sizeof(NodeHeader) - sizeof(std::uint32_t)) / (sizeof(StudentTree::Key) + sizeof(std::uint32_t));
+
+	/** @brief Leaf page: sorted keys, each carrying its record offset. */
+	struct LeafNode
+	{
+		NodeHeader header;
+		StudentTree::Key keys[leafCapacity];
+	};
+
+	/** @brief Inner page: children separated by the first key of every child but the first. */
+	struct InnerNode
+	{
+		NodeHeader header;
+		std::uint32_t children[innerCapacity + 1];
+		StudentTree::Key keys[innerCapacity];
+	};
+
+	static_assert(sizeof(LeafNode) <= BufferPool::pageSize);
+	static_assert(sizeof(InnerNode) <= BufferPool::pageSize);
+	static_assert(sizeof(TreeFileHeader) <= BufferPool::pageSize);
+
+	/**
+	 * @brief Compares two keys by field, then by record offset.
+	 * @param a The first key.
+	 * @param b The second key.
+	 * @return True if a orders before b.
+	 */
+	static bool keyLess(const StudentTree::Key& a, const StudentTree::Key& b)
+	{
+		const int order = std::memcmp(a.field.data(), b.field.data(), treeKeySize);
+		return order != 0 ? order < 0 : a.recordOffset < b.recordOffset;
+	}
+
+	/**
+	 * @brief Encodes a GPA so that byte-wise comparison matches numeric order.
+	 * @param value The value to encode.
+	 * @return The encoded field.
+	 */
+	static std::array<unsigned char, treeKeySize> encodeValue(double value)
+	{
+		const std::uint64_t key = orderPreservingKey(value);
+
+		std::array<unsigned char, treeKeySize> field{};
+		for (int i = 0; i < 8; i++)
+			field[i] = static_cast<unsigned char>(key >> (56 - 8 * i));
+		return field;
+	}
+
+	/**
+	 * @brief Encodes the first bytes of a surname.
+	 * @param surname The surname to encode.
+	 * @return The encoded field.
+	 */
+	static std::array<unsigned char, treeKeySize> encodeSurname(std::string_view surname)
+	{
+		std::array<unsigned char, treeKeySize> field{};
+		std::memcpy(field.data(), surname.data(), (std::min)(surname.size(), treeKeySize));
+		return field;
+	}
+
+	/**
+	 * @brief Builds the key of a record.
+	 * @param student The record.
+	 * @param sortingMethod The field the tree is keyed by.
+	 * @param recordOffset Offset of the record in the data file.
+	 * @return The key of the record.
+	 */
+	static StudentTree::Key makeKey(const StudentView& student, SortingMethod sortingMethod, std::uint64_t recordOffset)
+	{
+		StudentTree::Key key;
+		key.recordOffset = recordOffset;
+
+		switch (sortingMethod)
+		{
+		case SortBySurname:
+			key.field = encodeSurname(student.surname);
+			break;
+		case SortByAverageGrade:
+			key.field = encodeValue(student.averageGrade);
+			break;
+		case SortByAveragePhisicsGrade:
+			key.field = encodeValue(student.averagePhisicsGrade);
+			break;
+		case SortByAverageMathGrade:
+			key.field = encodeValue(student.averageMathGrade);
+			break;
+		case SortByAverageInformGrade:
+			key.field = encodeValue(student.averageInformGrade);
+			break;
+		}
+		return key;
+	}
+
+	/**
+	 * @brief Returns the name of the B+-tree file of a data file for a field.
+	 * @param dataFilename Name of the data file.
+	 * @param sortingMethod The field the tree is keyed by.
+	 * @return The name of the tree file.
+	 */
+	std::string treeFilename(const std::string& dataFilename, SortingMethod sortingMethod)
+	{
+		switch (sortingMethod)
+		{
+		case SortBySurname:
+			return dataFilename + ".surname.bpt";
+		case SortByAverageGrade:
+			return dataFilename + ".gpa.bpt";
+		case SortByAveragePhisicsGrade:
+			return dataFilename + ".phisics.bpt";
+		case SortByAverageMathGrade:
+			return dataFilename + ".math.bpt";
+		case SortByAverageInformGrade:
+			return dataFilename + ".cs.bpt";
+		}
+		return dataFilename + ".bpt";
+	}
+
+	/**
+	 * @brief Opens the tree of a data file for a field, rebuilding it if it is missing or stale.
+	 * @param dataFilename Name of the data file.
+	 * @param sortingMethod The field the tree is keyed by.
+	 * @return True if the tree is available, false if a file could not be read or written.
+	 */
+	bool StudentTree::open(const std::string& dataFilename, SortingMethod sortingMethod)
+	{
+		close();
+		this->dataFilename = dataFilename;
+		this->sortingMethod = sortingMethod;
+
+		std::uint64_t dataSize = 0;
+		std::int64_t dataModified = 0;
+		if (!readDataStamp(dataFilename, dataSize, dataModified))
+			return false;
+
+		if (pool.open(treeFilename(dataFilename, sortingMethod), false) && pool.pageCount() > 1)
+		{
+			PinnedPage page(pool, 0);
+			const TreeFileHeader* stored = page ? page.read<TreeFileHeader>() : nullptr;
+
+			if (stored && std::memcmp(stored->magic, treeFileMagic, sizeof(stored->magic)) == 0
+				&& stored->version == treeFileVersion && stored->sortingMethod == sortingMethod
+				&& stored->dataSize == dataSize && stored->dataModified == dataModified
+				&& stored->rootPage != 0 && stored->rootPage < pool.pageCount())
+			{
+				header = *stored;
+				return true;
+			}
+		}
+
+		return rebuild();
+	}
+
+	/**
+	 * @brief Writes pending changes and closes the tree file.
+	 * @return True if every change was written, false otherwise.
+	 */
+	bool StudentTree::close()
+	{
+		header = {};
+		return pool.close();
+	}
+
+	/**
+	 * @brief Rebuilds the tree from the data file by bulk loading its sorted entries.
+	 * @return True if the tree was rebuilt, false if a file could not be read or written.
+	 */
+	bool StudentTree::rebuild()
+	{
+		std::vector<Key> keys;
+		const bool read = forEachRecord(dataFilename, [&](const StudentView& student, std::uint64_t recordOffset) {
+			keys.push_back(makeKey(student, sortingMethod, recordOffset));
+			});
+		if (!read)
+			return false;
+
+		std::sort(keys.begin(), keys.end(), keyLess);
+
+		if (!pool.open(treeFilename(dataFilename, sortingMethod), true))
+			return false;
+
+		header = {};
+		std::memcpy(header.magic, treeFileMagic, sizeof(header.magic));
+		header.version = treeFileVersion;
+		header.sortingMethod = sortingMethod;
+		header.entryCount = keys.size();
+
+		if (!PinnedPage::allocate(pool))
+			return false;
+
+		/** @brief A built node and the smallest key below it. */
+		struct BuiltNode
+		{
+			std::uint32_t page;
+			Key first;
+		};
+		std::vector<BuiltNode> level;
+
+		// Leaves are filled completely and chained in key order
+		std::size_t position = 0;
+		do
+		{
+			PinnedPage page = PinnedPage::allocate(pool);
+			if (!page)
+				return false;
+
+			LeafNode* leaf = page.as<LeafNode>();
+			const std::size_t count = (std::min)(leafCapacity, keys.size() - position);
+
+			leaf->header.isLeaf = 1;
+			leaf->header.count = static_cast<std::uint16_t>(count);
+			std::copy(keys.begin() + position, keys.begin() + position + count, leaf->keys);
+
+			if (!level.empty())
+			{
+				PinnedPage previous(pool, level.back().page);
+				if (!previous)
+					return false;
+				previous.as<LeafNode>()->header.next = page.id();
+			}
+
+			level.push_back({ page.id(), count > 0 ? keys[position] : Key{} });
+			position += count;
+		} while (position < keys.size());
+
+		// Every inner level groups the nodes of the level below
+		while (level.size() > 1)
+		{
+			std::vector<BuiltNode> parents;
+			for (std::size_t first = 0; first < level.size(); first += innerCapacity + 1)
+			{
+				PinnedPage page = PinnedPage::allocate(pool);
+				if (!page)
+					return false;
+
+				InnerNode* node = page.as<InnerNode>();
+				const std::size_t count = (std::min)(innerCapacity + 1, level.size() - first);
+
+				node->header.isLeaf = 0;
+				node->header.count = static_cast<std::uint16_t>(count - 1);
+				for (std::size_t i = 0; i < count; i++)
+				{
+					node->children[i] = level[first + i].page;
+					if (i > 0)
+						node->keys[i - 1] = level[first + i].first;
+				}
+
+				parents.push_back({ page.id(), level[first].first });
+			}
+			level.swap(parents);
+		}
+
+		header.rootPage = level.front().page;
+		readDataStamp(dataFilename, header.dataSize, header.dataModified);
+
+		return writeHeader() && pool.flush();
+	}
+
+	/**
+	 * @brief Adds a record appended to the data file.
+	 *
+	 * The tree must have been opened before the data file was modified.
+	 *
+	 * @param student The appended student.
+	 * @param recordOffset Offset of the appended record in the data file.
+	 * @return True if the tree was updated, false otherwise.
+	 */
+	bool StudentTree::insert(const StudentView& student, std::uint64_t recordOffset)
+	{
+		if (!pool.isOpen())
+			return false;
+
+		std::optional<Split> split;
+		if (!insertInto(header.rootPage, makeKey(student, sortingMethod, recordOffset), split))
+			return false;
+
+		// A split root is replaced by a new root above both halves
+		if (split)
+		{
+			PinnedPage page = PinnedPage::allocate(pool);
+			if (!page)
+				return false;
+
+			InnerNode* root = page.as<InnerNode>();
+			root->header.isLeaf = 0;
+			root->header.count = 1;
+			root->children[0] = header.rootPage;
+			root->children[1] = split->rightPage;
+			root->keys[0] = split->separator;
+
+			header.rootPage = page.id();
+		}
+
+		header.entryCount++;
+		readDataStamp(dataFilename, header.dataSize, header.dataModified);
+
+		return writeHeader() && pool.flush();
+	}
+
+	/**
+	 * @brief Inserts a key into a subtree.
+	 * @param pageId Root page of the subtree.
+	 * @param key The key to insert.
+	 * @param split Receives the split of the subtree root, if it overflowed.
+	 * @return True if the key was inserted, false if a page could not be read or written.
+	 */
+	bool StudentTree::insertInto(std::uint32_t pageId, const Key& key, std::optional<Split>& split)
+	{
+		PinnedPage page(pool, pageId);
+		if (!page)
+			return false;
+
+		if (page.read<NodeHeader>()->isLeaf)
+		{
+			LeafNode* leaf = page.as<LeafNode>();
+			const std::size_t count = leaf->header.count;
+			const std::size_t position = std::upper_bound(leaf->keys, leaf->keys + count, key, keyLess) - leaf->keys;
+
+			if (count < leafCapacity)
+			{
+				std::copy_backward(leaf->keys + position, leaf->keys + count, leaf->keys + count + 1);
+				leaf->keys[position] = key;
+				leaf->header.count++;
+				return true;
+			}
+
+			std::vector<Key> keys(leaf->keys, leaf->keys + count);
+			keys.insert(keys.begin() + position, key);
+
+			PinnedPage rightPage = PinnedPage::allocate(pool);
+			if (!rightPage)
+				return false;
+
+			LeafNode* right = rightPage.as<LeafNode>();
+			const std::size_t half = keys.size() / 2;
+
+			leaf->header.count = static_cast<std::uint16_t>(half);
+			std::copy(keys.begin(), keys.begin() + half, leaf->keys);
+
+			right->header.isLeaf = 1;
+			right->header.count = static_cast<std::uint16_t>(keys.size() - half);
+			std::copy(keys.begin() + half, keys.end(), right->keys);
+
+			right->header.next = leaf->header.next;
+			leaf->header.next = rightPage.id();
+
+			split = Split{ keys[half], rightPage.id() };
+			return true;
+		}
+
+		const InnerNode* current = page.read<InnerNode>();
+		const std::size_t count = current->header.count;
+		const std::size_t position = std::upper_bound(current->keys, current->keys + count, key, keyLess) - current->keys;
+
+		std::optional<Split> childSplit;
+		if (!insertInto(current->children[position], key, childSplit))
+			return false;
+		if (!childSplit)
+			return true;
+
+		InnerNode* node = page.as<InnerNode>();
+		if (count < innerCapacity)
+		{
+			std::copy_backward(node->keys + position, node->keys + count, node->keys + count + 1);
+			std::copy_backward(node->children + position + 1, node->children + count + 1, node->children + count + 2);
+			node->keys[position] = childSplit->separator;
+			node->children[position + 1] = childSplit->rightPage;
+			node->header.count++;
+			return true;
+		}
+
+		std::vector<Key> keys(node->keys, node->keys + count);
+		std::vector<std::uint32_t> children(node->children, node->children + count + 1);
+		keys.insert(keys.begin() + position, childSplit->separator);
+		children.insert(children.begin() + position + 1, childSplit->rightPage);
+
+		PinnedPage rightPage = PinnedPage::allocate(pool);
+		if (!rightPage)
+			return false;
+
+		// The middle key moves up; the keys on either side stay in the two halves
+		InnerNode* right = rightPage.as<InnerNode>();
+		const std::size_t middle = keys.size() / 2;
+
+		node->header.count = static_cast<std::uint16_t>(middle);
+		std::copy(keys.begin(), keys.begin() + middle, node->keys);
+		std::copy(children.begin(), children.begin() + middle + 1, node->children);
+
+		right->header.isLeaf = 0;
+		right->header.count = static_cast<std::uint16_t>(keys.size() - middle - 1);
+		std::copy(keys.begin() + middle + 1, keys.end(), right->keys);
+		std::copy(children.begin() + middle + 1, children.end(), right->children);
+
+		split = Split{ keys[middle], rightPage.id() };
+		return true;
+	}
+
+	/**
+	 * @brief Collects the keys of a closed range by walking the leaf chain.
+	 * @param low The smallest key to include.
+	 * @param high The largest key to include.
+	 * @param keys Receives the keys in ascending order.
+	 * @return True if every page was read, false otherwise.
+	 */
+	bool StudentTree::scan(const Key& low, const Key& high, std::vector<Key>& keys)
+	{
+		keys.clear();
+		if (!pool.isOpen())
+			return false;
+
+		// Every page is visited at most once, which also stops a corrupt tree from looping
+		std::uint32_t pageId = header.rootPage;
+		std::uint32_t remainingPages = pool.pageCount();
+
+		while (true)
+		{
+			PinnedPage page(pool, pageId);
+			if (!page || remainingPages-- == 0)
+				return false;
+
+			if (page.read<NodeHeader>()->isLeaf)
+				break;
+
+			const InnerNode* node = page.read<InnerNode>();
+			const std::size_t count = (std::min)(static_cast<std::size_t>(node->header.count), innerCapacity);
+			pageId = node->children[std::upper_bound(node->keys, node->keys + count, low, keyLess) - node->keys];
+		}
+
+		while (pageId != 0)
+		{
+			PinnedPage page(pool, pageId);
+			if (!page || remainingPages-- == 0)
+				return false;
+
+			const LeafNode* leaf = page.read<LeafNode>();
+			const std::size_t count = (std::min)(static_cast<std::size_t>(leaf->header.count), leafCapacity);
+
+			for (const Key* key = std::lower_bound(leaf->keys, leaf->keys + count, low, keyLess); key != leaf->keys + count; ++key)
+			{
+				if (keyLess(high, *key))
+					return true;
+				keys.push_back(*key);
+			}
+			pageId = leaf->header.next;
+		}
+
+		return true;
+	}
+
+	/**
+	 * @brief Lists every record in the order of the field.
+	 * @param sortingType The order of the listing; equal keys stay in file order either way.
+	 * @param recordOffsets Receives the record offsets in sorted order.
+	 * @return True if the tree was read, false otherwise.
+	 */
+	bool StudentTree::scanAll(SortingType sortingType, std::vector<std::uint64_t>& recordOffsets)
+	{
+		Key low;
+		Key high;
+		high.field.fill(0xFF);
+		high.recordOffset = (std::numeric_limits<std::uint64_t>::max)();
+
+		std::vector<Key> keys;
+		recordOffsets.clear();
+		if (!scan(low, high, keys))
+			return false;
+
+		if (sortingType == Ascending)
+		{
+			for (const auto& key : keys)
+				recordOffsets.push_back(key.recordOffset);
+			return true;
+		}
+
+		// NaN fields sort after every number in both directions, so they stay at the tail
+		std::size_t numbers = keys.size();
+		if (sortingMethod != SortBySurname)
+		{
+			const auto nanField = encodeValue(std::numeric_limits<double>::quiet_NaN());
+			while (numbers > 0 && keys[numbers - 1].field == nanField)
+				numbers--;
+		}
+
+		// Runs of equal fields are emitted last to first, each run still in file order
+		std::size_t end = numbers;
+		while (end > 0)
+		{
+			std::size_t begin = end - 1;
+			while (begin > 0 && keys[begin - 1].field == keys[end - 1].field)
+				begin--;
+
+			for (std::size_t i = begin; i < end; i++)
+				recordOffsets.push_back(keys[i].recordOffset);
+			end = begin;
+		}
+		for (std::size_t i = numbers; i < keys.size(); i++)
+			recordOffsets.push_back(keys[i].recordOffset);
+		return true;
+	}
+
+	/**
+	 * @brief Lists the records whose GPA field lies in a closed range.
+	 * @param low The smallest value to include.
+	 * @param high The largest value to include.
+	 * @param recordOffsets Receives the record offsets in ascending order of the field.
+	 * @return True if the tree was read, false if it could not be read or is keyed by surname.
+	 */
+	bool StudentTree::scanRange(double low, double high, std::vector<std::uint64_t>& recordOffsets)
+	{
+		recordOffsets.clear();
+		if (sortingMethod == SortBySurname)
+			return false;
+
+		Key lowKey{ encodeValue(low), 0 };
+		Key highKey{ encodeValue(high), (std::numeric_limits<std::uint64_t>::max)() };
+
+		std::vector<Key> keys;
+		if (!scan(lowKey, highKey, keys))
+			return false;
+
+		for (const auto& key : keys)
+			recordOffsets.push_back(key.recordOffset);
+		return true;
+	}
+
+	/**
+	 * @brief Lists the records whose surname lies in a range bounded by prefixes.
+	 * @param low The smallest surname to include.
+	 * @param high The prefix of the largest surnames to include, or empty for no upper bound.
+	 * @param recordOffsets Receives the record offsets in ascending order of surname.
+	 * @return True if the tree was read, false if it could not be read or is not keyed by surname.
+	 */
+	bool StudentTree::scanRange(std::string_view low, std::string_view high, std::vector<std::uint64_t>& recordOffsets)
+	{
+		recordOffsets.clear();
+		if (sortingMethod != SortBySurname)
+			return false;
+
+		// Padding the upper bound with 0xFF bytes, which no UTF-8 text contains, makes it a prefix
+		Key lowKey{ encodeSurname(low), 0 };
+		Key highKey{ encodeSurname(high), (std::numeric_limits<std::uint64_t>::max)() };
+		std::fill(highKey.field.begin() + (std::min)(high.size(), treeKeySize), highKey.field.end(), 0xFF);
+
+		std::vector<Key> keys;
+		if (!scan(lowKey, highKey, keys))
+			return false;
+
+		for (const auto& key : keys)
+			recordOffsets.push_back(key.recordOffset);
+		return true;
+	}
+
+	/**
+	 * @brief Writes the header page.
+	 * @return True if the header was written, false otherwise.
+	 */
+	bool StudentTree::writeHeader()
+	{
+		PinnedPage page(pool, 0);
+		if (!page)
+			return false;
+
+		*page.as<TreeFileHeader>() = header;
+		return true;
+	}
+
+} // database
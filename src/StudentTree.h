@@ -0,0 +1,184 @@
+#ifndef STUDENT_TREE_H
+#define STUDENT_TREE_H
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "BufferPool.h"
+#include "SortEngine.h"
+#include "Student.h"
+
+namespace database
+{
+
+	/**
+	 * @brief Header stored in the first page of a B+-tree file.
+	 */
+	struct TreeFileHeader
+	{
+		char magic[4]{};
+
+		std::uint32_t version{};
+		std::uint32_t sortingMethod{};
+		std::uint32_t rootPage{};
+
+		std::uint64_t dataSize{};
+		std::int64_t dataModified{};
+
+		std::uint64_t entryCount{};
+	};
+
+	inline constexpr char treeFileMagic[4] = { 'S', 'D', 'B', 'T' }; ///< Marks a B+-tree file.
+	inline constexpr std::uint32_t treeFileVersion = 1; ///< Current version of the tree layout.
+	inline constexpr std::size_t treeKeySize = 32; ///< Bytes of a field stored in a tree key.
+
+	/**
+	 * @brief Returns the name of the B+-tree file of a data file for a field.
+	 * @param dataFilename Name of the data file.
+	 * @param sortingMethod The field the tree is keyed by.
+	 * @return The name of the tree file.
+	 */
+	std::string treeFilename(const std::string& dataFilename, SortingMethod sortingMethod);
+
+	/**
+	 * @brief On-disk B+-tree over a student file, keyed by one of the sorting fields.
+	 *
+	 * The tree maps field values to record offsets (the byte offset of a record in a
+	 * text file, or its position in a binary file). Nodes are page sized and are
+	 * accessed through a buffer pool; leaves are chained, so ordered and range scans
+	 * read one leaf after another without going back through the inner nodes.
+	 *
+	 * GPA fields are keyed by their exact value. Surnames are keyed by their first
+	 * 32 bytes, so longer surnames are ordered and compared on that prefix. Equal keys
+	 * are kept in file order.
+	 *
+	 * The tree lives in a file next to the data file and is rebuilt when the data
+	 * file's size or modification time no longer match.
+	 */
+	class StudentTree
+	{
+	public:
+		/** @brief Key of a tree entry: the encoded field followed by the record offset. */
+		struct Key
+		{
+			std::array<unsigned char, treeKeySize> field{};
+			std::uint64_t recordOffset{};
+		};
+
+		StudentTree() = default;
+		~StudentTree() { close(); }
+
+		StudentTree(const StudentTree&) = delete;
+		StudentTree& operator=(const StudentTree&) = delete;
+
+		/**
+		 * @brief Opens the tree of a data file for a field, rebuilding it if it is missing or stale.
+		 * @param dataFilename Name of the data file.
+		 * @param sortingMethod The field the tree is keyed by.
+		 * @return True if the tree is available, false if a file could not be read or written.
+		 */
+		bool open(const std::string& dataFilename, SortingMethod sortingMethod);
+
+		/**
+		 * @brief Writes pending changes and closes the tree file.
+		 * @return True if every change was written, false otherwise.
+		 */
+		bool close();
+
+		/**
+		 * @brief Rebuilds the tree from the data file by bulk loading its sorted entries.
+		 * @return True if the tree was rebuilt, false if a file could not be read or written.
+		 */
+		bool rebuild();
+
+		/**
+		 * @brief Adds a record appended to the data file.
+		 *
+		 * The tree must have been opened before the data file was modified.
+		 *
+		 * @param student The appended student.
+		 * @param recordOffset Offset of the appended record in the data file.
+		 * @return True if the tree was updated, false otherwise.
+		 */
+		bool insert(const StudentView& student, std::uint64_t recordOffset);
+
+		/** @brief Returns the number of entries in the tree. */
+		std::size_t size() const { return static_cast<std::size_t>(header.entryCount); }
+
+		/**
+		 * @brief Lists every record in the order of the field.
+		 * @param sortingType The order of the listing; equal keys stay in file order and NaN GPAs come last either way.
+		 * @param recordOffsets Receives the record offsets in sorted order.
+		 * @return True if the tree was read, false otherwise.
+		 */
+		bool scanAll(SortingType sortingType, std::vector<std::uint64_t>& recordOffsets);
+
+		/**
+		 * @brief Lists the records whose GPA field lies in a closed range.
+		 * @param low The smallest value to include.
+		 * @param high The largest value to include.
+		 * @param recordOffsets Receives the record offsets in ascending order of the field.
+		 * @return True if the tree was read, false if it could not be read or is keyed by surname.
+		 */
+		bool scanRange(double low, double high, std::vector<std::uint64_t>& recordOffsets);
+
+		/**
+		 * @brief Lists the records whose surname lies in a range bounded by prefixes.
+		 *
+		 * The upper bound is a prefix, so every surname starting with it is included:
+		 * "A" to "M" lists the surnames from "A" up to those starting with "M". An empty
+		 * upper bound includes every surname from the lower one on.
+		 *
+		 * @param low The smallest surname to include.
+		 * @param high The prefix of the largest surnames to include, or empty for no upper bound.
+		 * @param recordOffsets Receives the record offsets in ascending order of surname.
+		 * @return True if the tree was read, false if it could not be read or is not keyed by surname.
+		 */
+		bool scanRange(std::string_view low, std::string_view high, std::vector<std::uint64_t>& recordOffsets);
+
+	private:
+		/** @brief Separator and new right sibling produced by a node split. */
+		struct Split
+		{
+			Key separator;
+			std::uint32_t rightPage;
+		};
+
+		/**
+		 * @brief Inserts a key into a subtree.
+		 * @param pageId Root page of the subtree.
+		 * @param key The key to insert.
+		 * @param split Receives the split of the subtree root, if it overflowed.
+		 * @return True if the key was inserted, false if a page could not be read or written.
+		 */
+		bool insertInto(std::uint32_t pageId, const Key& key, std::optional<Split>& split);
+
+		/**
+		 * @brief Collects the keys of a closed range by walking the leaf chain.
+		 * @param low The smallest key to include.
+		 * @param high The largest key to include.
+		 * @param keys Receives the keys in ascending order.
+		 * @return True if every page was read, false otherwise.
+		 */
+		bool scan(const Key& low, const Key& high, std::vector<Key>& keys);
+
+		/**
+		 * @brief Writes the header page.
+		 * @return True if the header was written, false otherwise.
+		 */
+		bool writeHeader();
+
+		BufferPool pool;
+		TreeFileHeader header{};
+
+		std::string dataFilename;
+		SortingMethod sortingMethod{};
+	};
+
+} // database
+
+#endif // STUDENT_TREE_H
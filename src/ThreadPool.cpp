@@ -0,0 +1,198 @@
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <exception>
+
+namespace database
+{
+
+	static thread_local const ThreadPool* currentPool = nullptr; ///< Pool the calling thread works for, if any.
+	static thread_local std::size_t currentWorker = 0; ///< Index of the calling worker within currentPool.
+
+	/**
+	 * @brief Starts the workers.
+	 * @param threadCount Number of worker threads; zero picks one per hardware thread.
+	 */
+	ThreadPool::ThreadPool(std::size_t threadCount)
+	{
+		if (threadCount == 0)
+			threadCount = (std::max)(1u, std::thread::hardware_concurrency());
+
+		for (std::size_t i = 0; i <= threadCount; i++)
+			queues.push_back(std::make_unique<TaskQueue>());
+
+		workers.reserve(threadCount);
+		for (std::size_t i = 0; i < threadCount; i++)
+			workers.emplace_back([this, i]() { workerLoop(i); });
+	}
+
+	/** @brief Runs the tasks still queued and stops the workers. */
+	ThreadPool::~ThreadPool()
+	{
+		{
+			std::lock_guard<std::mutex> lock(wakeMutex);
+			stopping = true;
+		}
+		wake.notify_all();
+
+		for (auto& worker : workers)
+			worker.join();
+	}
+
+	/** @brief Returns the pool shared by the whole process. */
+	ThreadPool& ThreadPool::shared()
+	{
+		static ThreadPool pool;
+		return pool;
+	}
+
+	/**
+	 * @brief Queues a task on the deque of the calling worker or on the shared queue.
+	 * @param task The task.
+	 */
+	void ThreadPool::push(std::function<void()> task)
+	{
+		// Counting the task before it is visible keeps the count from dropping below the queued tasks
+		{
+			std::lock_guard<std::mutex> lock(wakeMutex);
+			pendingCount++;
+		}
+
+		TaskQueue& queue = currentPool == this ? *queues[currentWorker] : *queues.back();
+		{
+			std::lock_guard<std::mutex> lock(queue.mutex);
+			queue.tasks.push_back(std::move(task));
+		}
+		wake.notify_one();
+	}
+
+	/**
+	 * @brief Takes a task for the calling thread.
+	 * @param task Receives the task.
+	 * @return True if a task was taken.
+	 */
+	bool ThreadPool::pop(std::function<void()>& task)
+	{
+		if (pendingCount.load() == 0)
+			return false;
+
+		const std::size_t workerCount = workers.size();
+		const bool isWorker = currentPool == this;
+
+		// A worker continues with the newest task of its own deque
+		if (isWorker)
+		{
+			TaskQueue& own = *queues[currentWorker];
+			std::lock_guard<std::mutex> lock(own.mutex);
+			if (!own.tasks.empty())
+			{
+				task = std::move(own.tasks.back());
+				own.tasks.pop_back();
+				pendingCount--;
+				return true;
+			}
+		}
+
+		// Then the shared queue and the other deques are tried oldest task first
+		const std::size_t first = isWorker ? currentWorker + 1 : 0;
+		for (std::size_t i = 0; i <= workerCount; i++)
+		{
+			const std::size_t index = i == 0 ? workerCount : (first + i - 1) % workerCount;
+			if (isWorker && index == currentWorker)
+				continue;
+
+			TaskQueue& queue = *queues[index];
+			std::lock_guard<std::mutex> lock(queue.mutex);
+			if (!queue.tasks.empty())
+			{
+				task = std::move(queue.tasks.front());
+				queue.tasks.pop_front();
+				pendingCount--;
+				return true;
+			}
+		}
+		return false;
+	}
+
+	/**
+	 * @brief Runs one queued task on the calling thread.
+	 * @return True if a task was run, false if none was queued.
+	 */
+	bool ThreadPool::runPendingTask()
+	{
+		std::function<void()> task;
+		if (!pop(task))
+			return false;
+
+		task();
+		return true;
+	}
+
+	/**
+	 * @brief Runs tasks on a worker until the pool stops.
+	 * @param index Index of the worker.
+	 */
+	void ThreadPool::workerLoop(std::size_t index)
+	{
+		currentPool = this;
+		currentWorker = index;
+
+		while (true)
+		{
+			if (runPendingTask())
+				continue;
+
+			std::unique_lock<std::mutex> lock(wakeMutex);
+			wake.wait(lock, [this]() { return stopping || pendingCount.load() != 0; });
+			if (stopping && pendingCount.load() == 0)
+				return;
+		}
+	}
+
+	/**
+	 * @brief Calls a function for every index of a range on the pool and waits for all calls.
+	 * @param count Number of indexes.
+	 * @param body Function called with every index in [0, count).
+	 */
+	void ThreadPool::parallelFor(std::size_t count, const std::function<void(std::size_t)>& body)
+	{
+		if (count <= 1 || workers.empty())
+		{
+			for (std::size_t i = 0; i < count; i++)
+				body(i);
+			return;
+		}
+
+		// Indexes are handed out one at a time, so a helper that starts late finds none left
+		std::atomic<std::size_t> nextIndex{ 0 };
+		const auto work = [&]() {
+			for (std::size_t i = nextIndex++; i < count; i = nextIndex++)
+				body(i);
+		};
+
+		std::vector<TaskFuture<void>> helpers;
+		const std::size_t helperCount = (std::min)(count - 1, workers.size());
+		helpers.reserve(helperCount);
+		for (std::size_t i = 0; i < helperCount; i++)
+			helpers.push_back(submit(work));
+
+		// Every helper is finished before an exception leaves the loop, since they all use work
+		std::exception_ptr error;
+		try
+		{
+			work();
+		}
+		catch (...)
+		{
+			error = std::current_exception();
+		}
+
+		for (auto& helper : helpers)
+			helper.wait();
+		if (error)
+			std::rethrow_exception(error);
+		for (auto& helper : helpers)
+			helper.get();
+	}
+
+} // database
@@ -0,0 +1,255 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace database
+{
+
+	class ThreadPool;
+
+	/**
+	 * @brief Shared flag through which a task is asked to stop.
+	 *
+	 * Copies of a token share one flag, so a token handed to a task can be cancelled
+	 * through any other copy. Cancellation is cooperative: a task that has started
+	 * only stops where it checks cancelled().
+	 */
+	class CancellationToken
+	{
+	public:
+		/** @brief Creates a token that is not cancelled. */
+		CancellationToken() : state(std::make_shared<std::atomic<bool>>(false)) {}
+
+		/** @brief Asks every holder of the token to stop. */
+		void cancel() const { state->store(true, std::memory_order_relaxed); }
+
+		/** @brief Returns whether the token has been cancelled. */
+		bool cancelled() const { return state->load(std::memory_order_relaxed); }
+
+	private:
+		std::shared_ptr<std::atomic<bool>> state;
+	};
+
+	/**
+	 * @brief Result of a task submitted to a ThreadPool.
+	 *
+	 * Unlike std::future, waiting on a TaskFuture from a pool thread runs other queued
+	 * tasks in the meantime, so tasks may wait on the tasks they submit.
+	 */
+	template <typename T>
+	class TaskFuture
+	{
+	public:
+		TaskFuture() = default;
+
+		/** @brief Returns whether the future refers to a task. */
+		bool valid() const { return future.valid(); }
+
+		/** @brief Returns whether the task has finished, without blocking. */
+		bool ready() const { return waitFor(std::chrono::milliseconds(0)); }
+
+		/**
+		 * @brief Blocks until the task has finished or a timeout has passed.
+		 * @param timeout The longest time to wait.
+		 * @return True if the task has finished.
+		 */
+		bool waitFor(std::chrono::milliseconds timeout) const
+		{
+			return future.wait_for(timeout) == std::future_status::ready;
+		}
+
+		/** @brief Waits for the task, running other queued tasks of the pool meanwhile. */
+		void wait() const;
+
+		/**
+		 * @brief Waits for the task and returns its result.
+		 *
+		 * An exception thrown by the task is rethrown here. A task cancelled before it
+		 * started yields a value-initialized result.
+		 *
+		 * @return The result of the task.
+		 */
+		T get()
+		{
+			wait();
+			return future.get();
+		}
+
+		/** @brief Asks the task to stop; a task that has not started yet is skipped. */
+		void cancel() const { cancellation.cancel(); }
+
+		/** @brief Returns the token through which the task is cancelled. */
+		const CancellationToken& token() const { return cancellation; }
+
+	private:
+		friend class ThreadPool;
+
+		TaskFuture(std::future<T> future, CancellationToken cancellation, ThreadPool* pool)
+			: future(std::move(future)), cancellation(std::move(cancellation)), pool(pool)
+		{
+		}
+
+		std::future<T> future;
+		CancellationToken cancellation;
+		ThreadPool* pool = nullptr;
+	};
+
+	/** @brief Result type of a task, which is called with its CancellationToken if it accepts one. */
+	template <typename Function>
+	using TaskResult = typename std::conditional_t<std::is_invocable_v<Function&, const CancellationToken&>,
+		std::invoke_result<Function&, const CancellationToken&>, std::invoke_result<Function&>>::type;
+
+	/**
+	 * @brief Fixed set of worker threads that run queued tasks.
+	 *
+	 * Every worker owns a task deque. A task submitted from a worker goes to the back
+	 * of that worker's deque and is taken from the back again, so nested work stays
+	 * on the thread that created it; tasks submitted from other threads go to a shared
+	 * queue. An idle worker takes from the shared queue and then steals from the
+	 * front of the other workers' deques, where the oldest and largest tasks are.
+	 */
+	class ThreadPool
+	{
+	public:
+		/**
+		 * @brief Starts the workers.
+		 * @param threadCount Number of worker threads; zero picks one per hardware thread.
+		 */
+		explicit ThreadPool(std::size_t threadCount = 0);
+
+		/** @brief Runs the tasks still queued and stops the workers. */
+		~ThreadPool();
+
+		ThreadPool(const ThreadPool&) = delete;
+		ThreadPool& operator=(const ThreadPool&) = delete;
+
+		/** @brief Returns the pool shared by the whole process. */
+		static ThreadPool& shared();
+
+		/** @brief Returns the number of worker threads. */
+		std::size_t size() const { return workers.size(); }
+
+		/**
+		 * @brief Queues a task.
+		 *
+		 * A function that takes a const CancellationToken& receives the token of its
+		 * future and may return early once it is cancelled.
+		 *
+		 * @param function The task; it is called with no arguments or with the token.
+		 * @return The future of the task.
+		 */
+		template <typename Function>
+		auto submit(Function&& function)
+		{
+			using Result = TaskResult<std::decay_t<Function>>;
+			static_assert(std::is_void_v<Result> || std::is_default_constructible_v<Result>,
+				"the result of a task must be default constructible");
+
+			CancellationToken cancellation;
+			auto task = std::make_shared<std::packaged_task<Result()>>(
+				[function = std::forward<Function>(function), cancellation]() mutable -> Result {
+					if (cancellation.cancelled())
+						return Result();
+					return invokeTask(function, cancellation);
+				});
+
+			TaskFuture<Result> future(task->get_future(), cancellation, this);
+			push([task]() { (*task)(); });
+			return future;
+		}
+
+		/**
+		 * @brief Calls a function for every index of a range on the pool and waits for all calls.
+		 *
+		 * The calling thread takes part, so the loop completes even when every worker is
+		 * busy, and calling it from inside a task does not deadlock.
+		 *
+		 * @param count Number of indexes.
+		 * @param body Function called with every index in [0, count).
+		 */
+		void parallelFor(std::size_t count, const std::function<void(std::size_t)>& body);
+
+		/**
+		 * @brief Runs one queued task on the calling thread.
+		 * @return True if a task was run, false if none was queued.
+		 */
+		bool runPendingTask();
+
+	private:
+		/** @brief Task deque of one worker, or the shared queue. */
+		struct TaskQueue
+		{
+			std::mutex mutex;
+			std::deque<std::function<void()>> tasks;
+		};
+
+		/**
+		 * @brief Calls a task with the token if it accepts one.
+		 * @param function The task.
+		 * @param cancellation The token of the task.
+		 * @return The result of the call.
+		 */
+		template <typename Function>
+		static decltype(auto) invokeTask(Function& function, const CancellationToken& cancellation)
+		{
+			if constexpr (std::is_invocable_v<Function&, const CancellationToken&>)
+				return function(cancellation);
+			else
+				return function();
+		}
+
+		/**
+		 * @brief Queues a task on the deque of the calling worker or on the shared queue.
+		 * @param task The task.
+		 */
+		void push(std::function<void()> task);
+
+		/**
+		 * @brief Takes a task for the calling thread.
+		 * @param task Receives the task.
+		 * @return True if a task was taken.
+		 */
+		bool pop(std::function<void()>& task);
+
+		/**
+		 * @brief Runs tasks on a worker until the pool stops.
+		 * @param index Index of the worker.
+		 */
+		void workerLoop(std::size_t index);
+
+		std::vector<std::unique_ptr<TaskQueue>> queues; ///< One deque per worker followed by the shared queue.
+		std::vector<std::thread> workers;
+
+		std::mutex wakeMutex;
+		std::condition_variable wake;
+		std::atomic<std::size_t> pendingCount{ 0 }; ///< Tasks queued and not yet taken; never below the true count.
+		bool stopping = false;
+	};
+
+	/** @brief Waits for the task, running other queued tasks of the pool meanwhile. */
+	template <typename T>
+	void TaskFuture<T>::wait() const
+	{
+		while (!ready())
+		{
+			if (pool == nullptr || !pool->runPendingTask())
+				std::this_thread::yield();
+		}
+	}
+
+} // database
+
+#endif // THREAD_POOL_H
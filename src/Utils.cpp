@@ -2,9 +2,11 @@
 
 #include <climits>
 #include "../consoleGUI/GUI.h"
+#include "FileStorage.h"
 #include <fstream>
 #include <algorithm>
 #include <sstream>
+#include <iomanip>
 
 namespace Utils
 {
@@ -12,7 +14,7 @@ namespace Utils
     void paintOverBackground()
     {
         setColorBackground(BrightBlue);
-        system("cls");
+        clearScreen(); // The menu drawn next is presented as one frame with the cleared background
     }
 
     /** @brief Prints the logo at specified coordinates.
@@ -56,23 +58,11 @@ namespace Utils
      */
     void loadFiles(const std::string& path, std::vector<std::string>& files)
     {
-        std::ifstream file(path);
-
-        if (!file.is_open())
+        if (!database::readFileList(path, files))
         {
             setcur(0, 0);
             std::cout << "FILE DOWNLOAD ERROR";
-            return;
         }
-
-        std::string line;
-        while (std::getline(file, line))
-        {
-            files.push_back(line);
-        }
-        file.close();
-
-        std::sort(files.begin(), files.end()); // Sort the filenames alphabetically
     }
 
     /** @brief Saves filenames from a vector to a specified path.
@@ -81,21 +71,11 @@ namespace Utils
      */
     void saveFiles(const std::string& path, const std::vector<std::string>& files)
     {
-        std::ofstream file(path);
-
-        if (!file.is_open())
+        if (!database::writeFileList(path, files))
         {
             setcur(0, 0);
             std::cout << "SAVE ERROR!";
-            return;
         }
-
-        for (const auto& fileName : files)
-        {
-            file << fileName << std::endl; // Write each filename to the file
-        }
-
-        file.close();
     }
 
     /** @brief Converts an array of uint16_t to a string.
@@ -229,4 +209,89 @@ namespace Utils
         }
     }
 
+    /** @brief Displays the progress window of a file operation.
+     *  @param head Title of the operation.
+     */
+    void showProgressWindow(const std::string& head)
+    {
+        Window progressWindow(61, 9, 30, 10);
+        progressWindow.addWindowName("progress", 1, 0);
+        progressWindow.show(); // Show the progress window
+
+        setcur(61 / 2 - head.size() / 2 + 30, 11);
+        std::cout << head; // Display the operation title
+
+        updateProgressWindow(database::OperationProgress());
+    }
+
+    /** @brief Formats a byte count in mebibytes with one decimal.
+     *  @param bytes The byte count.
+     *  @return The formatted count.
+     */
+    static std::string formatMebibytes(std::uint64_t bytes)
+    {
+        std::stringstream ss;
+        ss << std::fixed << std::setprecision(1) << bytes / 1048576.0 << " MB";
+        return ss.str();
+    }
+
+    /** @brief Redraws the progress bar, the counters and the time estimate of the progress window.
+     *  @param progress The progress of the operation.
+     */
+    void updateProgressWindow(const database::OperationProgress& progress)
+    {
+        const int barWidth = 51;
+        const int filled = static_cast<int>(progress.fraction() * barWidth);
+
+        setcur(35, 13);
+        for (int i = 0; i < barWidth; i++)
+        {
+            std::cout << (i < filled ? char(219) : char(176));
+        }
+
+        std::stringstream counters;
+        counters << "RECORDS: " << progress.recordsRead()
+            << "  READ: " << formatMebibytes(progress.bytesRead())
+            << "  WRITTEN: " << formatMebibytes(progress.bytesWritten());
+
+        std::stringstream status;
+        std::chrono::seconds timeLeft;
+        if (progress.cancelled())
+            status << "CANCELLING...";
+        else if (progress.estimateTimeLeft(timeLeft))
+            status << "ETA: " << timeLeft.count() / 60 << ':' << std::setw(2) << std::setfill('0') << timeLeft.count() % 60 << "   ESC - CANCEL";
+        else
+            status << "ESC - CANCEL";
+
+        // Both lines are padded so a shorter text covers the previous one
+        std::string line = counters.str();
+        line.resize(barWidth, ' ');
+        setcur(35, 15); std::cout << line;
+
+        line = status.str();
+        line.resize(barWidth, ' ');
+        setcur(35, 16); std::cout << line;
+
+        std::cout.flush();
+    }
+
+    /** @brief Discards the pending console input.
+     *  @return True if ESC was pressed since the last call, false otherwise.
+     */
+    bool escapePressed()
+    {
+        TerminalEvent event;
+        bool escape = false;
+
+        // Clicks made while the operation runs would otherwise fire once the menu resumes
+        while (Terminal::get().pollEvent(event))
+        {
+            if (event.type == TerminalEvent::Type::Key && event.key == 27)
+            {
+                escape = true;
+            }
+        }
+        return escape;
+    }
+
 } // namespace Utils
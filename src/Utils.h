@@ -1,11 +1,15 @@
 #ifndef UTILS_H
 #define UTILS_H
 
+#include <chrono>
+#include <cstddef>
 #include <iostream>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "global.h"
+#include "AsyncOperation.h"
 
 namespace Utils
 {
@@ -91,6 +95,49 @@ namespace Utils
      */
     void notificationWindow(const std::string& head, int width, int height, int posX, int posY);
 
+    /** @brief Displays the progress window of a file operation.
+     *  @param head Title of the operation.
+     */
+    void showProgressWindow(const std::string& head);
+
+    /** @brief Redraws the progress bar, the counters and the time estimate of the progress window.
+     *  @param progress The progress of the operation.
+     */
+    void updateProgressWindow(const database::OperationProgress& progress);
+
+    /** @brief Discards the pending console input.
+     *  @return True if ESC was pressed since the last call, false otherwise.
+     */
+    bool escapePressed();
+
+    /** @brief Runs a file operation off the input thread and shows its progress until it completes.
+     *
+     *  The operation runs on the thread pool while the progress window is redrawn every
+     *  100 ms; ESC cancels it, and every other key or click made meanwhile is discarded.
+     *  The caller redraws its menu afterwards, since the window covers part of it.
+     *
+     *  @param head Title of the operation.
+     *  @param function The operation; it is called with the OperationProgress it reports to and must not draw on the console.
+     *  @param cancelled Receives whether the user cancelled the operation.
+     *  @return The result of the operation.
+     */
+    template <typename Function>
+    auto runOperation(const std::string& head, Function&& function, bool& cancelled)
+    {
+        auto operation = database::startOperation(std::forward<Function>(function));
+
+        showProgressWindow(head);
+        while (!operation.waitFor(std::chrono::milliseconds(100)))
+        {
+            if (escapePressed())
+                operation.cancel();
+            updateProgressWindow(operation.progress());
+        }
+
+        cancelled = operation.cancelled();
+        return operation.get();
+    }
+
     /** @brief Clears the current line in the input buffer. */
     inline void eatline() { while (std::cin.get() != '\n') continue; }
 
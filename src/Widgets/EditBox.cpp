@@ -2,6 +2,7 @@
 #include "../../consoleGUI/GUI.h"
 #include <fstream>
 #include "../Utils.h"
+#include "../StudentLog.h"
 
 namespace widgets
 {
@@ -16,6 +17,9 @@ namespace widgets
         const int editBoxPositionX = 40;
         const int editBoxPositionY = 5;
 
+        // The lines as loaded, which saved edits are compared against
+        static std::vector<std::string> originalContent;
+
         /**
          * Renders the edit box frame on the console.
          *
@@ -31,24 +35,28 @@ namespace widgets
         /**
          * Loads file content into the edit box and initializes the sliding window.
          */
-        void setup(const std::string& path) {
+        bool setup(const std::string& path) {
             currentContent.clear();  // Clear previous content
-            getFileContent(path);    // Load content from file
+            if (!getFileContent(path)) { // Load content from file
+                return false;
+            }
             render();                // Render the edit box frame
             initializeSlidingWindow(); // Set up the sliding window for scrolling
+            return true;
         }
 
         /**
          * Reads the file content and adjusts it to fit the edit box dimensions.
          */
-        void getFileContent(const std::string& path) {
+        bool getFileContent(const std::string& path) {
             currentContent.clear();
-            std::ifstream file("storage/" + path);
+            originalContent.clear();
 
-            if (!file.is_open()) {
-                // File open error handling
+            // The editor starts from the file with its pending log folded in, or not at all
+            std::ifstream file;
+            if (!database::openCheckpointed("storage/" + path, file)) {
                 Utils::applicationErrorWindow("FILE OPENING ERROR", 61, 9, 30, 10);
-                return;
+                return false;
             }
 
             std::string line;
@@ -56,6 +64,7 @@ namespace widgets
             while (getline(file, line)) {
                 currentContent.push_back(line);
             }
+            originalContent = currentContent;
 
             // Padding the content to match the height of the edit box
             while (currentContent.size() < editBoxHeight) {
@@ -73,6 +82,7 @@ namespace widgets
             }
 
             file.close();
+            return true;
         }
 
         /**
@@ -141,17 +151,50 @@ namespace widgets
 
         /**
          * Saves the current content of the edit box into a file.
+         *
+         * Only the lines that changed are written: the edited range is recorded in the
+         * file's write-ahead log and committed, and the log is folded into the file once
+         * it grows past the checkpoint threshold.
          */
         void saveChanges(const std::string& path) {
-            std::ofstream file(path);
-            if (!file.is_open()) {
+            // Strip the padding added to fit the edit box
+            std::vector<std::string> lines = currentContent;
+            for (auto& line : lines) {
+                line.erase(line.find_last_not_of(' ') + 1);
+            }
+            while (lines.size() > originalContent.size() && lines.back().empty()) {
+                lines.pop_back();
+            }
+
+            // Lines that are unchanged at the start and at the end are left out of the log
+            std::size_t first = 0;
+            while (first < lines.size() && first < originalContent.size() && lines[first] == originalContent[first]) {
+                ++first;
+            }
+
+            std::size_t lastEdited = lines.size(), lastOriginal = originalContent.size();
+            while (lastEdited > first && lastOriginal > first && lines[lastEdited - 1] == originalContent[lastOriginal - 1]) {
+                --lastEdited;
+                --lastOriginal;
+            }
+
+            if (first == lastEdited && first == lastOriginal)
+                return;
+
+            database::StudentLog log;
+            if (!log.open(path)) {
                 // Error handling when the file can't be opened
                 Utils::applicationErrorWindow("ERROR OPENING FILE", 61, 9, 30, 10);
                 return;
             }
-            for (const auto& line : currentContent) {
-                file << line << std::endl;
+
+            log.replaceLines(first, lastOriginal - first, std::vector<std::string>(lines.begin() + first, lines.begin() + lastEdited));
+            if (!log.commit() || (log.size() >= database::logCheckpointThreshold && !log.checkpoint())) {
+                Utils::applicationErrorWindow("ERROR WRITING FILE", 61, 9, 30, 10);
+                return;
             }
+
+            originalContent = std::move(lines);
         }
 
         /**
@@ -184,7 +227,7 @@ namespace widgets
          */
         void processInput(int ch, int& cursorX, int& cursorY) {
             if (ch == 224) { // Arrow keys
-                ch = _getch();
+                ch = readKey();
                 switch (ch) {
                 case 72: // Up arrow
                     if (cursorY > 0)
@@ -223,7 +266,7 @@ namespace widgets
             displayCursor(cursorX, cursorY);
 
             while (true) {
-                int ch = _getch();
+                int ch = readKey();
                 if (ch == 27) { // Escape key to exit
                     break;
                 }
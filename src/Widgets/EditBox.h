@@ -26,14 +26,16 @@ namespace widgets
         /**
          * @brief Initializes the edit box with the content from the specified file.
          * @param path Path to the file to load content from.
+         * @return True if the file was loaded, false if it could not be brought up to date or opened.
          */
-        void setup(const std::string& path);
+        bool setup(const std::string& path);
 
         /**
          * @brief Loads content from the specified file into currentContent.
          * @param path Path to the file to load content from.
+         * @return True if the file was loaded, false if it could not be brought up to date or opened.
          */
-        void getFileContent(const std::string& path);
+        bool getFileContent(const std::string& path);
 
         // Cursor and text display functions
         /**
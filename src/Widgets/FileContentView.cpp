@@ -0,0 +1,128 @@
+#include "FileContentView.h"
+
+#include "../../consoleGUI/GUI.h"
+#include "../Utils.h"
+#include "../global.h"
+#include "FileSlider.h"
+#include "ScrollableTextBox.h"
+
+namespace widgets
+{
+    namespace fileContentView
+    {
+        static PushButton back; ///< Button to navigate back in the menu
+
+        static bool running; ///< Flag to control the menu state
+
+        /** @brief Renders the menu components. */
+        static void render()
+        {
+            fileSlider::renderFileSlider(9, 4);
+            scrollableTextBox::render();
+            back.allowChanges();
+            back.show();
+        }
+
+        /** @brief Handles file selection and displays its content.
+          * @param index The index of the selected file.
+          * @param loadContent Fills the text box for the selected file.
+          */
+        static void workWithFile(int index, const ContentLoader& loadContent) {
+            database::activeFile = fileSlider::getFileName(fileSlider::slidingFileWindow[index]);
+
+            if (database::activeFile.empty())
+                return;
+
+            loadContent(database::activeFile);
+
+            // The progress window covered part of the menu and the space around it
+            Utils::paintOverBackground();
+            render();
+            scrollableTextBox::showFileContent();
+        }
+
+        /** @brief Creates buttons for file navigation and display. */
+        static void createButtons()
+        {
+            fileSlider::createFilesButtons(10, 5);
+            scrollableTextBox::create(37, 5);
+            back = PushButton(20, 5, "BACK", 90, 21);
+        }
+
+        /** @brief Sets up colors for all buttons. */
+        static void setupButtons()
+        {
+            fileSlider::setupFileButtons();
+            scrollableTextBox::setup();
+
+            back.setBackgroundColor(White);
+            back.setForegroundColor(Black);
+        }
+
+        /** @brief Connects button actions to their respective functions.
+          * @param loadContent Fills the text box for the selected file.
+          */
+        static void connectButtons(const ContentLoader& loadContent) {
+            fileSlider::upFile.connect([]() {
+                fileSlider::moveSlidingFileWindowUp();
+                fileSlider::updateFileButtonNames();
+                });
+
+            fileSlider::file1.connect([loadContent]() { workWithFile(0, loadContent); });
+            fileSlider::file2.connect([loadContent]() { workWithFile(1, loadContent); });
+            fileSlider::file3.connect([loadContent]() { workWithFile(2, loadContent); });
+            fileSlider::file4.connect([loadContent]() { workWithFile(3, loadContent); });
+            fileSlider::file5.connect([loadContent]() { workWithFile(4, loadContent); });
+
+            fileSlider::downFile.connect([]() {
+                fileSlider::moveSlidingFileWindowDown();
+                fileSlider::updateFileButtonNames();
+                });
+
+            scrollableTextBox::upFileContent.connect([]() {
+                scrollableTextBox::scrollFileContentsUp();
+                scrollableTextBox::showFileContent();
+                });
+
+            scrollableTextBox::downFileContent.connect([]() {
+                scrollableTextBox::scrollFileContentsDown();
+                scrollableTextBox::showFileContent();
+                });
+
+            back.connect([]() {
+                running = false;
+                });
+        }
+
+        /** @brief Runs a menu of the file slider, the scrollable text box and a back button.
+          * @param loadContent Fills the text box for the selected file.
+          */
+        void run(const ContentLoader& loadContent) {
+            running = true;
+
+            fileSlider::setupSlidingFileWindow();
+            createButtons();
+            setupButtons();
+            render();
+            connectButtons(loadContent);
+
+            setupInputHandling();
+            invisibleCursor();
+
+            while (running) {
+                mouseButtonInteraction(&fileSlider::upFile,
+                    &fileSlider::file1,
+                    &fileSlider::file2,
+                    &fileSlider::file3,
+                    &fileSlider::file4,
+                    &fileSlider::file5,
+                    &fileSlider::downFile,
+                    &scrollableTextBox::upFileContent,
+                    &scrollableTextBox::downFileContent,
+                    &back);
+            }
+        }
+
+    } // namespace fileContentView
+
+} // namespace widgets
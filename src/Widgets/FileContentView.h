@@ -0,0 +1,29 @@
+#ifndef FILE_CONTENT_VIEW_H
+#define FILE_CONTENT_VIEW_H
+
+#include <functional>
+#include <string>
+
+namespace widgets
+{
+    namespace fileContentView
+    {
+        /** @brief Fills the scrollable text box with what is shown for a file.
+          * @param path The name of the selected file in the storage directory.
+          */
+        using ContentLoader = std::function<void(const std::string& path)>;
+
+        /** @brief Runs a menu of the file slider, the scrollable text box and a back button.
+          *
+          * Selecting a file makes it the active file and passes it to the loader, whose
+          * lines are then shown; the menu returns when the back button is pressed.
+          *
+          * @param loadContent Fills the text box for the selected file.
+          */
+        void run(const ContentLoader& loadContent);
+
+    } // namespace fileContentView
+
+} // namespace widgets
+
+#endif // FILE_CONTENT_VIEW_H
@@ -1,5 +1,14 @@
 #include "ScrollableTextBox.h"
 
+#include <filesystem>
+#include <sstream>
+
+#include "../StudentBinary.h"
+#include "../StudentLog.h"
+#include "../StudentParser.h"
+#include "../StudentReader.h"
+#include "../Utils.h"
+
 namespace widgets
 {
     namespace scrollableTextBox
@@ -56,35 +65,66 @@ namespace widgets
           * @param path The path of the file to read.
           */
         void getFileContent(const std::string& path) {
-            currentContent.clear();
-            std::ifstream file("storage/" + path);
+            std::vector<std::string> lines;
+
+            // The file is read off the input thread while its progress is shown, and ESC cancels it
+            bool cancelled = false;
+            const bool opened = Utils::runOperation("LOADING FILE", [&path, &lines](database::OperationProgress& progress) {
+                if (database::isBinaryStudentFile("storage/" + path)) {
+                    database::StudentReader reader("storage/" + path);
+                    if (!reader.isOpen()) {
+                        return false;
+                    }
+
+                    progress.setTotalBytes(reader.fileSize());
+                    reader.reportTo(&progress);
+
+                    std::string line;
+                    for (const database::Student& student : reader) {
+                        std::stringstream text;
+                        database::writeStudent(text, student);
+                        while (getline(text, line)) {
+                            lines.push_back(line);
+                        }
+                    }
+                    return true;
+                }
 
-            if (!file.is_open()) {
-                setcur(0, 0);
-                std::cout << "Failed to open file!" << std::endl;
-                return;
-            }
+                std::ifstream file;
+                if (!database::openCheckpointed("storage/" + path, file)) {
+                    return false;
+                }
 
-            std::string line;
-            while (getline(file, line)) {
-                currentContent.push_back(line);
-            }
+                std::error_code error;
+                progress.setTotalBytes(std::filesystem::file_size("storage/" + path, error));
+
+                std::string line;
+                std::size_t records = 0;
+                std::uint64_t bytes = 0;
+                while (!progress.cancelled() && getline(file, line)) {
+                    lines.push_back(line);
+
+                    bytes += line.size() + 1;
+                    if (line.find(database::studentRecordMarker) != std::string::npos && ++records == database::progressReportRecords) {
+                        progress.addRead(records, bytes);
+                        records = 0;
+                        bytes = 0;
+                    }
+                }
+                progress.addRead(records, bytes);
+                return true;
+                }, cancelled);
 
-            // Ensure the file content fits the text box dimensions
-            while (currentContent.size() < textBoxHeight) {
-                currentContent.push_back("");
+            // A cancelled load shows an empty file
+            if (cancelled) {
+                lines.clear();
             }
-
-            for (auto& line : currentContent) {
-                while (line.size() < textBoxWidth) {
-                    line += " ";
-                }
-                if (line.size() > textBoxWidth) {
-                    line.resize(textBoxWidth);
-                }
+            else if (!opened) {
+                Utils::applicationErrorWindow("ERROR OPENING FILE", 61, 9, 30, 10);
+                lines.clear();
             }
 
-            file.close();
+            setContent(std::move(lines));
         }
 
         /** @brief Scrolls the content up by one line. */
@@ -98,28 +138,44 @@ namespace widgets
 
         /** @brief Scrolls the content down by one line. */
         void scrollFileContentsDown() {
-            if (!slidingWindow.empty() && slidingWindow[textBoxHeight - 1] < currentContent.size() - 1) {
+            if (!slidingWindow.empty() && slidingWindow[textBoxHeight - 1] + 1 < static_cast<int>(currentContent.size())) {
                 for (auto& element : slidingWindow) {
                     element++;
                 }
             }
         }
 
+        /** @brief Shows lines in the text box from the first one, padded and cut to its size.
+          * @param lines The lines to show.
+          */
+        void setContent(std::vector<std::string> lines) {
+            currentContent = std::move(lines);
+
+            // Ensure the content fits the text box dimensions
+            if (currentContent.size() < static_cast<std::size_t>(textBoxHeight)) {
+                currentContent.resize(textBoxHeight);
+            }
+
+            for (auto& line : currentContent) {
+                line.resize(textBoxWidth, ' ');
+            }
+
+            slidingWindow.resize(textBoxHeight);
+            for (int i = 0; i < textBoxHeight; ++i) {
+                slidingWindow[i] = i;
+            }
+        }
+
         /** @brief Sets up the current open file and initializes the sliding window.
           * @param path The path of the file to open.
           */
         void setupCurrentOpenFile(const std::string& path) {
             getFileContent(path);
-            slidingWindow.resize(textBoxHeight);
-
-            for (int i = 0; i < (std::min)(static_cast<int>(currentContent.size()), textBoxHeight); ++i) {
-                slidingWindow[i] = i;
-            }
         }
 
         /** @brief Displays the current content of the file on the screen. */
         void showFileContent() {
-            for (int i = 0; i < slidingWindow.size(); ++i) {
+            for (int i = 0; i < static_cast<int>(slidingWindow.size()); ++i) {
                 setcur(textBoxPositionX, textBoxPositionY + i);
                 std::cout << currentContent[slidingWindow[i]];
             }
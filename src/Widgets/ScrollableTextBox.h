@@ -2,6 +2,7 @@
 #define SCROLLABLE_TEXT_BOX_H
 
 #include <vector>
+#include <string>
 #include <fstream>
 #include "../../consoleGUI/GUI.h"
 
@@ -38,6 +39,11 @@ namespace widgets
         /** @brief Scrolls the content down by one line. */
         void scrollFileContentsDown();
 
+        /** @brief Shows lines in the text box from the first one, padded and cut to its size.
+          * @param lines The lines to show.
+          */
+        void setContent(std::vector<std::string> lines);
+
         /** @brief Sets up the current open file and initializes the sliding window.
           * @param path The path of the file to open.
           */
@@ -1,5 +1,7 @@
 #include "global.h"
 
+#include "ExternalSort.h"
+
 namespace database
 {
 
@@ -8,4 +10,6 @@ namespace database
 	std::string activeFile = ""; ///< Initializes the active file as an empty string.
 	std::string pathToFileStorage = "storage/fileStorage.txt"; ///< Sets the default path to file storage.
 
+	std::size_t sortMemoryBudget = defaultSortMemoryBudget; ///< Sets the default in-memory sort budget.
+
 } // namespace database 
@@ -1,6 +1,7 @@
 #ifndef GLOBAL_H
 #define GLOBAL_H
 
+#include <cstddef>
 #include <vector>
 #include <string>
 
@@ -12,6 +13,8 @@ namespace database
 	extern std::string activeFile; ///< Currently active file in use.
 	extern std::string pathToFileStorage; ///< Path to the file storage location.
 
+	extern std::size_t sortMemoryBudget; ///< Bytes a sort may hold in memory before it spills runs to disk.
+
 } // namespace database
 
 #endif // GLOBAL_H
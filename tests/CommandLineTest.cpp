@@ -0,0 +1,58 @@
+#include <initializer_list>
+
+#include "Test.h"
+#include "../src/CommandLine.h"
+#include "../src/StudentGenerator.h"
+
+using namespace database;
+
+/**
+ * @brief Runs a command line the way the program's main function does.
+ * @param arguments The arguments after the program name.
+ * @return The exit status of the command.
+ */
+static int run(std::initializer_list<std::string> arguments)
+{
+	std::vector<std::string> storage = { "studentdb" };
+	storage.insert(storage.end(), arguments.begin(), arguments.end());
+
+	std::vector<char*> argv;
+	for (auto& argument : storage)
+		argv.push_back(argument.data());
+	argv.push_back(nullptr);
+
+	return runCommandLine(static_cast<int>(storage.size()), argv.data());
+}
+
+TEST(commandLineExitCodes)
+{
+	tests::TestDirectory directory("command_line");
+	const std::string dataFilename = directory.file("students.txt");
+	const std::string missingFilename = directory.file("missing.txt");
+	const std::string sortedFilename = directory.file("sorted.txt");
+
+	if (!CHECK(generateStudentFile(dataFilename, GeneratorOptions(), 500, false)))
+		return;
+
+	// Successful commands exit with 0
+	CHECK(run({ "help" }) == 0);
+	CHECK(run({ "stats", dataFilename }) == 0);
+	CHECK(run({ "sort", "--by", "gpa", "--desc", "-o", sortedFilename, dataFilename }) == 0);
+	CHECK(run({ "query", dataFilename, "--by", "surname", "--max", "M" }) == 0);
+	CHECK(run({ "query", dataFilename, "--where", "gpa > +4.5" }) == 0);
+
+	// Commands that fail on a file exit with 1
+	CHECK(run({ "stats", missingFilename }) == 1);
+	CHECK(run({ "sort", "--by", "gpa", missingFilename }) == 1);
+	CHECK(run({ "query", missingFilename, "--surname", "Ivanov" }) == 1);
+
+	// Usage errors exit with 2
+	CHECK(run({}) == 2);
+	CHECK(run({ "frobnicate" }) == 2);
+	CHECK(run({ "stats" }) == 2);
+	CHECK(run({ "sort", "--by", "height", dataFilename }) == 2);
+	CHECK(run({ "sort", "--colour", dataFilename }) == 2);
+	CHECK(run({ "query", dataFilename, "--where", "gpa > 1e999" }) == 2);
+	CHECK(run({ "query", dataFilename, "--by", "gpa", "--min", "high" }) == 2);
+	CHECK(run({ "generate", dataFilename }) == 2);
+}
@@ -0,0 +1,52 @@
+#include "Test.h"
+#include "../src/ExternalSort.h"
+#include "../src/SortEngine.h"
+#include "../src/StudentGenerator.h"
+
+using namespace database;
+
+TEST(externalSortMatchesInMemorySort)
+{
+	tests::TestDirectory directory("external_sort");
+	const std::string inputFilename = directory.file("students.txt");
+	const std::string inMemoryFilename = directory.file("in_memory.txt");
+	const std::string externalFilename = directory.file("external.txt");
+
+	// Few surnames and repeated records make ties, which both sorts must keep in input order
+	GeneratorOptions options;
+	options.surnameCount = 40;
+	options.duplicateRate = 0.2;
+	if (!CHECK(generateStudentFile(inputFilename, options, 20000, false)))
+		return;
+
+	const std::size_t inputSize = tests::readFile(inputFilename).size();
+	const std::size_t smallBudget = std::size_t{ 64 } << 10;
+
+	const SortingMethod methods[] = { SortBySurname, SortByAverageGrade, SortByAveragePhisicsGrade, SortByAverageMathGrade, SortByAverageInformGrade };
+	for (SortingMethod method : methods)
+	{
+		for (SortingType type : { Ascending, Descending })
+		{
+			CHECK(sortStudentFile(inputFilename, inMemoryFilename, method, type));
+			CHECK(sortStudentFile(inputFilename, externalFilename, method, type, smallBudget));
+
+			const std::string inMemory = tests::readFile(inMemoryFilename);
+			CHECK(inMemory.size() == inputSize);
+			CHECK(inMemory == tests::readFile(externalFilename));
+		}
+	}
+}
+
+TEST(externalSortInPlace)
+{
+	tests::TestDirectory directory("external_sort_in_place");
+	const std::string inputFilename = directory.file("students.txt");
+	const std::string sortedFilename = directory.file("sorted.txt");
+
+	if (!CHECK(generateStudentFile(inputFilename, GeneratorOptions(), 5000, false)))
+		return;
+
+	CHECK(sortStudentFile(inputFilename, sortedFilename, SortByAverageGrade, Descending));
+	CHECK(externalSortStudents(inputFilename, inputFilename, SortByAverageGrade, Descending, std::size_t{ 32 } << 10));
+	CHECK(tests::readFile(inputFilename) == tests::readFile(sortedFilename));
+}
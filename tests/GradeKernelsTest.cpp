@@ -0,0 +1,36 @@
+#include <random>
+
+#include "Test.h"
+#include "../src/GradeKernels.h"
+
+using namespace database;
+
+TEST(gradeKernelsMatchScalarSums)
+{
+	// Ranges of every length up to a few vectors, some of them long and of the largest
+	// scores, with the last one ending at the end of the array
+	std::mt19937_64 random(7);
+	std::vector<std::uint16_t> scores;
+	std::vector<std::uint64_t> offsets = { 0 };
+	for (std::size_t i = 0; i < 4000; i++)
+	{
+		const std::size_t length = i % 50 == 0 ? 70000 : random() % 40;
+		const bool largest = i % 50 == 0;
+		for (std::size_t j = 0; j < length; j++)
+			scores.push_back(largest ? 65535 : static_cast<std::uint16_t>(random() % 11));
+		offsets.push_back(scores.size());
+	}
+
+	std::vector<std::uint64_t> expected(offsets.size() - 1);
+	sumScoreRanges(scores, offsets, expected, ScalarGradeKernel);
+
+	for (GradeKernel kernel : { Sse2GradeKernel, Avx2GradeKernel })
+	{
+		if (!gradeKernelSupported(kernel))
+			continue;
+
+		std::vector<std::uint64_t> sums(expected.size());
+		sumScoreRanges(scores, offsets, sums, kernel);
+		CHECK(sums == expected);
+	}
+}
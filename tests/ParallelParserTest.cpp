@@ -0,0 +1,109 @@
+#include <sstream>
+
+#include "Test.h"
+#include "../src/ParallelParser.h"
+#include "../src/StudentGenerator.h"
+#include "../src/StudentParser.h"
+#include "../src/StudentTable.h"
+
+using namespace database;
+
+/**
+ * @brief Appends generated records to a text until the next one would reach a position.
+ * @param text The text.
+ * @param generator Generator of the records.
+ * @param index Position of the next generated record; advanced past the added ones.
+ * @param limit Position the records stay before.
+ */
+static void appendRecordsBefore(std::string& text, const StudentGenerator& generator, std::uint64_t& index, std::size_t limit)
+{
+	Student student;
+	std::ostringstream record;
+	while (true)
+	{
+		generator.generate(index, student);
+		record.str("");
+		writeStudent(record, student);
+		if (text.size() + record.str().size() >= limit)
+			return;
+
+		text += record.str();
+		index++;
+	}
+}
+
+/**
+ * @brief Builds a text of three parse ranges with records broken across both range boundaries.
+ *
+ * The record across the first boundary is cut short after two lines, so the serial
+ * parser reads the first lines of the record after it as its remaining fields, while
+ * the next range resynchronizes on that record. The record across the second boundary
+ * is a complete one split in the middle of a line.
+ *
+ * @return The text, exactly three ranges long.
+ */
+static std::string makeBrokenText()
+{
+	const std::size_t size = 3 * parallelParseRangeSize;
+	const StudentGenerator generator{ GeneratorOptions() };
+	std::uint64_t index = 0;
+	std::string text;
+
+	appendRecordsBefore(text, generator, index, parallelParseRangeSize - 64);
+	text.append(parallelParseRangeSize - 20 - text.size(), '\n');
+	text += "STUDENT'S NAME: Torn\n";
+	text += "GROUP NUMBER: 1\n";
+
+	appendRecordsBefore(text, generator, index, 2 * parallelParseRangeSize);
+	Student student;
+	generator.generate(index++, student);
+	std::ostringstream record;
+	writeStudent(record, student);
+	text.append(2 * parallelParseRangeSize - record.str().size() / 2 - text.size(), '\n');
+	text += record.str();
+
+	appendRecordsBefore(text, generator, index, size);
+	text.append(size - text.size(), '\n');
+	return text;
+}
+
+TEST(parallelParserMatchesSerialParser)
+{
+	const std::string text = makeBrokenText();
+	const char* begin = text.data();
+	const char* end = begin + text.size();
+
+	const std::vector<Student> serial = parseStudents(begin, end);
+	CHECK(!serial.empty());
+
+	for (std::size_t threadCount : { std::size_t{ 0 }, std::size_t{ 1 }, std::size_t{ 2 }, std::size_t{ 3 } })
+	{
+		CHECK(tests::sameStudents(parseStudentsParallel(begin, end, threadCount), serial));
+
+		StudentTable table;
+		parseStudentTableParallel(begin, end, table, threadCount);
+		if (!CHECK(table.size() == serial.size()))
+			continue;
+
+		bool same = true;
+		for (std::size_t i = 0; i < serial.size() && same; i++)
+			same = tests::sameStudent(toStudent(table[i]), serial[i]);
+		CHECK(same);
+	}
+}
+
+TEST(parallelParserHandlesCarriageReturns)
+{
+	const std::string text = makeBrokenText();
+	std::string crlfText;
+	for (char symbol : text)
+	{
+		if (symbol == '\n')
+			crlfText += '\r';
+		crlfText += symbol;
+	}
+
+	const char* begin = crlfText.data();
+	const char* end = begin + crlfText.size();
+	CHECK(tests::sameStudents(parseStudentsParallel(begin, end), parseStudents(begin, end)));
+}
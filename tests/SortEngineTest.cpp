@@ -0,0 +1,67 @@
+#include <cmath>
+#include <limits>
+
+#include "Test.h"
+#include "../src/MappedStudentFile.h"
+#include "../src/SortEngine.h"
+#include "../src/StudentGenerator.h"
+#include "../src/StudentTable.h"
+
+using namespace database;
+
+TEST(sortOrderKeepsNaNLast)
+{
+	const double nan = std::numeric_limits<double>::quiet_NaN();
+	const double grades[] = { 3.5, nan, -1.0, 4.0, nan, 0.0 };
+
+	StudentTable table;
+	for (double grade : grades)
+	{
+		Student student;
+		student.surname = "Student";
+		student.averageGrade = grade;
+		table.append(student);
+	}
+
+	// Both directions order the numbers and leave the NaN rows at the end in input order
+	const std::vector<std::size_t> ascending = { 2, 5, 0, 3, 1, 4 };
+	const std::vector<std::size_t> descending = { 3, 0, 5, 2, 1, 4 };
+	CHECK(sortOrder(table, SortByAverageGrade, Ascending) == ascending);
+	CHECK(sortOrder(table, SortByAverageGrade, Descending) == descending);
+
+	CHECK(sortKey(nan, Ascending) > sortKey((std::numeric_limits<double>::infinity)(), Ascending));
+	CHECK(sortKey(nan, Descending) > sortKey(-(std::numeric_limits<double>::infinity)(), Descending));
+}
+
+TEST(parallelSortMatchesSerialSort)
+{
+	tests::TestDirectory directory("parallel_sort");
+	const std::string textFilename = directory.file("students.txt");
+	const std::string binaryFilename = directory.file("students.sdb");
+
+	// Few surnames and repeated records make ties across the chunks of the parallel merge
+	GeneratorOptions options;
+	options.surnameCount = 300;
+	options.duplicateRate = 0.2;
+	const std::size_t count = parallelSortThreshold + 4321;
+	if (!CHECK(generateStudentFile(textFilename, options, count, false)) || !CHECK(generateStudentFile(binaryFilename, options, count, true)))
+		return;
+
+	StudentTable table;
+	MappedStudentFile file;
+	if (!CHECK(readStudentTable(textFilename, table)) || !CHECK(file.open(binaryFilename)))
+		return;
+	CHECK(table.size() == count && file.size() == count);
+
+	const SortingMethod methods[] = { SortBySurname, SortByAverageGrade, SortByAveragePhisicsGrade, SortByAverageMathGrade, SortByAverageInformGrade };
+	for (SortingMethod method : methods)
+	{
+		for (SortingType type : { Ascending, Descending })
+		{
+			const std::vector<std::size_t> serial = sortOrder(table, method, type, 1);
+			CHECK(sortOrder(table, method, type, 2) == serial);
+			CHECK(sortOrder(table, method, type, 7) == serial);
+			CHECK(sortOrder(file, method, type, 1) == sortOrder(file, method, type, 4));
+		}
+	}
+}
@@ -0,0 +1,110 @@
+#include <sstream>
+
+#include "Test.h"
+#include "../src/StudentBinary.h"
+#include "../src/StudentGenerator.h"
+#include "../src/StudentParser.h"
+
+using namespace database;
+
+/**
+ * @brief Makes students that cover empty surnames and score lists besides generated ones.
+ * @param count Number of generated students.
+ * @return The students.
+ */
+static std::vector<Student> makeStudents(std::size_t count)
+{
+	GeneratorOptions options;
+	options.minScoresPerSubject = 0;
+	const StudentGenerator generator(options);
+
+	std::vector<Student> students(count);
+	for (std::size_t i = 0; i < count; i++)
+		generator.generate(i, students[i]);
+
+	Student empty;
+	students.push_back(empty);
+	return students;
+}
+
+/**
+ * @brief Splits text into lines without their terminators.
+ * @param text The text.
+ * @return The lines.
+ */
+static std::vector<std::string> splitLines(const std::string& text)
+{
+	std::vector<std::string> lines;
+	std::istringstream stream(text);
+	for (std::string line; std::getline(stream, line);)
+		lines.push_back(line);
+	return lines;
+}
+
+TEST(textToBinaryRoundTrip)
+{
+	tests::TestDirectory directory("binary_round_trip");
+	const std::string textFilename = directory.file("students.txt");
+	const std::string binaryFilename = directory.file("students.bin");
+
+	tests::writeTextFile(textFilename, makeStudents(3000));
+	const std::string text = tests::readFile(textFilename);
+	const std::vector<Student> textStudents = parseStudents(text.data(), text.data() + text.size());
+	CHECK(textStudents.size() == 3001);
+
+	if (!CHECK(convertTextToBinary(textFilename, binaryFilename)))
+		return;
+	CHECK(isBinaryStudentFile(binaryFilename));
+	CHECK(!isBinaryStudentFile(textFilename));
+
+	std::vector<Student> binaryStudents;
+	CHECK(readStudentsBinary(binaryFilename, binaryStudents));
+	CHECK(tests::sameStudents(binaryStudents, textStudents));
+
+	std::vector<std::string> lines;
+	CHECK(readStudentsBinaryAsText(binaryFilename, lines));
+	CHECK(lines == splitLines(text));
+}
+
+TEST(textToBinaryRejectsMissingSource)
+{
+	tests::TestDirectory directory("binary_missing_source");
+	const std::string binaryFilename = directory.file("students.bin");
+
+	CHECK(!convertTextToBinary(directory.file("missing.txt"), binaryFilename));
+	CHECK(!std::filesystem::exists(binaryFilename));
+}
+
+TEST(binaryWriteRoundTrip)
+{
+	tests::TestDirectory directory("binary_write");
+	const std::string binaryFilename = directory.file("students.bin");
+
+	const std::vector<Student> students = makeStudents(500);
+	if (!CHECK(writeStudentsBinary(binaryFilename, students)))
+		return;
+
+	std::vector<Student> read;
+	CHECK(readStudentsBinary(binaryFilename, read));
+	CHECK(tests::sameStudents(read, students));
+
+	std::vector<StudentView> views;
+	for (const auto& student : students)
+		views.push_back(makeStudentView(student));
+	CHECK(writeStudentsBinary(binaryFilename, views));
+	CHECK(readStudentsBinary(binaryFilename, read));
+	CHECK(tests::sameStudents(read, students));
+}
+
+TEST(binaryRejectsTruncatedFile)
+{
+	tests::TestDirectory directory("binary_truncated");
+	const std::string binaryFilename = directory.file("students.bin");
+
+	if (!CHECK(writeStudentsBinary(binaryFilename, makeStudents(100))))
+		return;
+
+	std::filesystem::resize_file(binaryFilename, std::filesystem::file_size(binaryFilename) - 16);
+	std::vector<Student> read;
+	CHECK(!readStudentsBinary(binaryFilename, read));
+}
@@ -0,0 +1,79 @@
+#include <filesystem>
+
+#include "Test.h"
+#include "../src/StudentGenerator.h"
+#include "../src/StudentImport.h"
+
+using namespace database;
+
+TEST(importWritesRejectFile)
+{
+	tests::TestDirectory directory("import_rejects");
+	const std::string csvFilename = directory.file("registrar.csv");
+	const std::string targetFilename = directory.file("students.txt");
+
+	{
+		std::ofstream csv(csvFilename, std::ios::binary);
+		csv << "surname,group,physics,math,cs\r\n"
+			<< "Ivanov,4351,5 4,3;4,5\r\n"
+			<< "Petrov,43x1,5,5,5\n"
+			<< "\"Smith, Jr\",4352,4,4,4\n"
+			<< "Sidorov,4351,5,,4\n"
+			<< "\n"
+			<< "Kozlov,4353,2\n"
+			<< "Orlov,4351,5,4,x\n"
+			<< "Volkov,4353,3,3,3";
+	}
+
+	ImportSummary summary;
+	if (!CHECK(importStudents(csvFilename, targetFilename, summary, 2)))
+		return;
+	CHECK(summary.importedCount == 3);
+	CHECK(summary.rejectedCount == 4);
+
+	const std::vector<Student> students = readStudents(targetFilename);
+	if (!CHECK(students.size() == 3))
+		return;
+	CHECK(students[0].surname == "Ivanov" && students[0].phisicsScores == std::vector<std::uint16_t>({ 5, 4 }));
+	CHECK(students[0].mathScores == std::vector<std::uint16_t>({ 3, 4 }) && students[0].averagePhisicsGrade == 4.5);
+	CHECK(students[1].surname == "Smith, Jr" && students[1].groupNumber == 4352);
+	CHECK(students[2].surname == "Volkov");
+
+	// Every rejected row is reported with its line number in the source and the reason
+	CHECK(tests::readFile(rejectFilename(csvFilename)) ==
+		"line 3: invalid group number: Petrov,43x1,5,5,5\n"
+		"line 5: subject without scores: Sidorov,4351,5,,4\n"
+		"line 7: expected 5 fields: Kozlov,4353,2\n"
+		"line 8: invalid score: Orlov,4351,5,4,x\n");
+
+	// A later import in which every row passes removes the stale reject file
+	{
+		std::ofstream csv(csvFilename, std::ios::binary | std::ios::trunc);
+		csv << "Lebedev\t4354\t5\t5\t5\n";
+	}
+	CHECK(importStudents(csvFilename, targetFilename, summary));
+	CHECK(summary.importedCount == 1 && summary.rejectedCount == 0);
+	CHECK(!std::filesystem::exists(rejectFilename(csvFilename)));
+	CHECK(readStudents(targetFilename).size() == 4);
+}
+
+TEST(importReadsBackExportAcrossChunks)
+{
+	tests::TestDirectory directory("import_round_trip");
+	const std::string sourceFilename = directory.file("source.txt");
+	const std::string csvFilename = directory.file("export.csv");
+	const std::string targetFilename = directory.file("target.txt");
+
+	// Enough rows for the export to span more than one import chunk; chunks must be appended in input order
+	if (!CHECK(generateStudentFile(sourceFilename, GeneratorOptions(), 150000, false)))
+		return;
+	if (!CHECK(exportStudentsCsv(sourceFilename, csvFilename)))
+		return;
+	CHECK(std::filesystem::file_size(csvFilename) > importChunkSize);
+
+	ImportSummary summary;
+	if (!CHECK(importStudents(csvFilename, targetFilename, summary, 4)))
+		return;
+	CHECK(summary.importedCount == 150000 && summary.rejectedCount == 0);
+	CHECK(tests::readFile(targetFilename) == tests::readFile(sourceFilename));
+}
@@ -0,0 +1,185 @@
+#include <algorithm>
+#include <filesystem>
+#include <map>
+
+#include "Test.h"
+#include "../src/BufferedWriter.h"
+#include "../src/StudentGenerator.h"
+#include "../src/StudentIndex.h"
+
+using namespace database;
+
+/**
+ * @brief Checks every lookup of an index against a scan of its data file.
+ * @param index The index to check.
+ * @param dataFilename Name of the data file.
+ * @return True if every lookup matched, false otherwise.
+ */
+static bool matchesScan(const StudentIndex& index, const std::string& dataFilename)
+{
+	std::vector<std::pair<std::string, std::uint64_t>> surnames;
+	std::map<std::uint64_t, std::vector<std::uint64_t>> groups;
+	forEachRecord(dataFilename, [&](const StudentView& student, std::uint64_t recordOffset) {
+		surnames.emplace_back(std::string(student.surname), recordOffset);
+		groups[student.groupNumber].push_back(recordOffset);
+		});
+
+	bool matched = CHECK(index.size() == surnames.size());
+
+	// Records were collected in file order, so a stable sort gives the expected surname order
+	std::stable_sort(surnames.begin(), surnames.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+	for (std::size_t first = 0, last = 0; first < surnames.size(); first = last)
+	{
+		std::vector<std::uint64_t> expected;
+		for (last = first; last < surnames.size() && surnames[last].first == surnames[first].first; last++)
+			expected.push_back(surnames[last].second);
+		matched = CHECK(index.findBySurname(surnames[first].first) == expected) && matched;
+	}
+
+	for (const std::string prefix : { "", "A", "K", "Ko", "Zz" })
+	{
+		std::vector<std::uint64_t> expected;
+		for (const auto& [surname, recordOffset] : surnames)
+		{
+			if (surname.starts_with(prefix))
+				expected.push_back(recordOffset);
+		}
+		matched = CHECK(index.findBySurnamePrefix(prefix) == expected) && matched;
+	}
+
+	for (const auto& [groupNumber, expected] : groups)
+		matched = CHECK(index.findByGroup(groupNumber) == expected) && matched;
+	return CHECK(index.findByGroup(1).empty() && index.findBySurname("Missing").empty()) && matched;
+}
+
+/**
+ * @brief Appends students to a text data file and to its index.
+ * @param index The index of the file.
+ * @param dataFilename Name of the data file.
+ * @param students The students to append.
+ * @return True if every record was written and every index update saved, false otherwise.
+ */
+static bool appendStudents(StudentIndex& index, const std::string& dataFilename, const std::vector<Student>& students)
+{
+	std::vector<std::uint64_t> recordOffsets;
+	{
+		const std::uint64_t baseSize = std::filesystem::file_size(dataFilename);
+		BufferedWriter file;
+		if (!file.open(dataFilename, true))
+			return false;
+
+		for (const auto& student : students)
+		{
+			recordOffsets.push_back(baseSize + file.position());
+			writeStudent(file, makeStudentView(student));
+		}
+		if (!file.close())
+			return false;
+	}
+
+	bool saved = true;
+	for (std::size_t i = 0; i < students.size(); i++)
+		saved = index.append(makeStudentView(students[i]), recordOffsets[i]) && saved;
+	return saved;
+}
+
+TEST(indexAppendsDeltaAndMerges)
+{
+	tests::TestDirectory directory("index_delta");
+	const std::string dataFilename = directory.file("students.txt");
+	const std::string extraFilename = directory.file("extra.txt");
+
+	// Few surnames and groups make long runs of equal keys across the base and the delta
+	GeneratorOptions options;
+	options.surnameCount = 30;
+	options.groupCount = 12;
+	if (!CHECK(generateStudentFile(dataFilename, options, 3000, false)))
+		return;
+	options.seed = 7;
+	if (!CHECK(generateStudentFile(extraFilename, options, indexDeltaLimit + 500, false)))
+		return;
+	const std::vector<Student> extra = readStudents(extraFilename);
+
+	StudentIndex index;
+	if (!CHECK(index.open(dataFilename)))
+		return;
+	CHECK(matchesScan(index, dataFilename));
+
+	// One append adds one delta entry to the end of the sidecar instead of rewriting it
+	const std::string sidecarFilename = indexFilename(dataFilename);
+	const std::uint64_t sidecarSize = std::filesystem::file_size(sidecarFilename);
+	CHECK(appendStudents(index, dataFilename, { extra.front() }));
+	CHECK(std::filesystem::file_size(sidecarFilename) == sidecarSize + sizeof(IndexDeltaEntry) + extra.front().surname.size());
+
+	CHECK(appendStudents(index, dataFilename, std::vector<Student>(extra.begin() + 1, extra.begin() + 200)));
+	CHECK(matchesScan(index, dataFilename));
+
+	// A reopened index reads the delta back without rebuilding
+	{
+		StudentIndex reopened;
+		CHECK(reopened.open(dataFilename));
+		CHECK(matchesScan(reopened, dataFilename));
+		CHECK(std::filesystem::file_size(sidecarFilename) > sidecarSize);
+	}
+
+	// Passing the delta limit merges the delta into a rewritten base
+	CHECK(appendStudents(index, dataFilename, std::vector<Student>(extra.begin() + 200, extra.end())));
+	CHECK(matchesScan(index, dataFilename));
+
+	StudentIndex merged;
+	CHECK(merged.open(dataFilename));
+	CHECK(matchesScan(merged, dataFilename));
+
+	// The appends that reached the limit are in the base, the later ones in a new delta
+	IndexFileHeader header{};
+	std::ifstream sidecar(sidecarFilename, std::ios::binary);
+	CHECK(sidecar.read(reinterpret_cast<char*>(&header), sizeof(header)) && header.entryCount == 3000 + indexDeltaLimit);
+	CHECK(header.deltaSize >= (extra.size() - indexDeltaLimit) * sizeof(IndexDeltaEntry));
+}
+
+TEST(indexRebuildsWhenStale)
+{
+	tests::TestDirectory directory("index_stale");
+	const std::string dataFilename = directory.file("students.txt");
+
+	GeneratorOptions options;
+	options.surnameCount = 50;
+	if (!CHECK(generateStudentFile(dataFilename, options, 1000, false)))
+		return;
+
+	{
+		StudentIndex index;
+		CHECK(index.open(dataFilename));
+	}
+
+	// Records appended behind the index's back change the data file's stamp
+	std::vector<Student> students;
+	for (std::size_t i = 0; i < 10; i++)
+	{
+		Student student;
+		student.surname = "Appended";
+		student.groupNumber = 1000 + i;
+		students.push_back(student);
+	}
+	{
+		BufferedWriter file;
+		CHECK(file.open(dataFilename, true));
+		for (const auto& student : students)
+			writeStudent(file, makeStudentView(student));
+	}
+
+	StudentIndex index;
+	if (!CHECK(index.open(dataFilename)))
+		return;
+	CHECK(index.findBySurname("Appended").size() == students.size());
+	CHECK(matchesScan(index, dataFilename));
+
+	// A damaged sidecar is rebuilt as well
+	{
+		std::ofstream sidecar(indexFilename(dataFilename), std::ios::binary | std::ios::trunc);
+		sidecar << "SDBI";
+	}
+	StudentIndex rebuilt;
+	CHECK(rebuilt.open(dataFilename));
+	CHECK(matchesScan(rebuilt, dataFilename));
+}
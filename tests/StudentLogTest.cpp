@@ -0,0 +1,159 @@
+#include "Test.h"
+#include "../src/Student.h"
+#include "../src/StudentLog.h"
+#include "../src/StudentReader.h"
+
+using namespace database;
+
+/**
+ * @brief Makes a student with a given surname and scores.
+ * @param surname The surname.
+ * @param score The score of every subject.
+ * @return The student.
+ */
+static Student makeStudent(const std::string& surname, std::uint16_t score)
+{
+	Student student;
+	student.surname = surname;
+	student.groupNumber = 4351;
+	student.phisicsScores = { score, score };
+	student.mathScores = { score };
+	student.informScores = { score, score, score };
+	calculateAverageGrade(student);
+	return student;
+}
+
+/**
+ * @brief Writes a base file and commits two batches to its log, the last of which is then damaged.
+ * @param dataFilename Name of the base file.
+ * @param first Changes of the first batch.
+ * @param second Changes of the second batch.
+ * @return The size of the log after the first batch.
+ */
+template <typename First, typename Second>
+static std::uint64_t writeLog(const std::string& dataFilename, First first, Second second)
+{
+	tests::writeTextFile(dataFilename, { makeStudent("Ivanov", 5), makeStudent("Petrov", 6), makeStudent("Sidorov", 7) });
+
+	StudentLog log;
+	if (!CHECK(log.open(dataFilename)))
+		return 0;
+
+	first(log);
+	CHECK(log.commit());
+	const std::uint64_t firstSize = log.size();
+
+	second(log);
+	CHECK(log.commit());
+	CHECK(log.size() > firstSize);
+	return firstSize;
+}
+
+/**
+ * @brief Returns the surnames of a text student file.
+ * @param filename Name of the file.
+ * @return The surnames in file order.
+ */
+static std::vector<std::string> surnames(const std::string& filename)
+{
+	std::vector<std::string> result;
+	for (const auto& student : readStudents(filename))
+		result.push_back(student.surname);
+	return result;
+}
+
+TEST(logReplaysAppendsBeforeTornTail)
+{
+	tests::TestDirectory directory("log_torn_append");
+	const std::string dataFilename = directory.file("students.txt");
+
+	const std::uint64_t firstSize = writeLog(dataFilename,
+		[](StudentLog& log) { log.addStudent(makeStudent("Kozlov", 8)); log.addStudent(makeStudent("Orlov", 9)); },
+		[](StudentLog& log) { log.addStudent(makeStudent("Torn", 4)); });
+
+	// A crash in the middle of the second write leaves part of its record behind
+	const std::string walFilename = logFilename(dataFilename);
+	std::filesystem::resize_file(walFilename, std::filesystem::file_size(walFilename) - 3);
+
+	CHECK(checkpointStudentFile(dataFilename));
+	CHECK(surnames(dataFilename) == std::vector<std::string>({ "Ivanov", "Petrov", "Sidorov", "Kozlov", "Orlov" }));
+	CHECK(std::filesystem::file_size(walFilename) == sizeof(LogFileHeader));
+	CHECK(firstSize > sizeof(LogFileHeader));
+
+	const std::vector<Student> students = readStudents(dataFilename);
+	CHECK(students.size() == 5 && tests::sameStudent(students[4], makeStudent("Orlov", 9)));
+}
+
+TEST(logReplaysChangesBeforeCorruptTail)
+{
+	tests::TestDirectory directory("log_corrupt_update");
+	const std::string dataFilename = directory.file("students.txt");
+
+	const std::uint64_t firstSize = writeLog(dataFilename,
+		[](StudentLog& log) { log.updateStudent(1, makeStudent("Volkov", 9)); log.removeStudent(0); },
+		[](StudentLog& log) { log.addStudent(makeStudent("Torn", 4)); });
+
+	// The second record is complete in size but its payload no longer matches the checksum
+	const std::string walFilename = logFilename(dataFilename);
+	std::fstream wal(walFilename, std::ios::in | std::ios::out | std::ios::binary);
+	wal.seekp(static_cast<std::streamoff>(firstSize + sizeof(LogRecordHeader) + 2));
+	wal.put('#');
+	wal.close();
+
+	CHECK(checkpointStudentFile(dataFilename));
+	CHECK(surnames(dataFilename) == std::vector<std::string>({ "Volkov", "Sidorov" }));
+	CHECK(std::filesystem::file_size(walFilename) == sizeof(LogFileHeader));
+}
+
+TEST(logReopenCutsTornTail)
+{
+	tests::TestDirectory directory("log_reopen");
+	const std::string dataFilename = directory.file("students.txt");
+
+	const std::uint64_t firstSize = writeLog(dataFilename,
+		[](StudentLog& log) { log.addStudent(makeStudent("Kozlov", 8)); },
+		[](StudentLog& log) { log.addStudent(makeStudent("Torn", 4)); });
+
+	const std::string walFilename = logFilename(dataFilename);
+	std::filesystem::resize_file(walFilename, firstSize + sizeof(LogRecordHeader) - 1);
+
+	// Changes committed after the torn record must not be hidden behind it
+	StudentLog log;
+	if (!CHECK(log.open(dataFilename)))
+		return;
+	CHECK(log.size() == firstSize);
+	log.addStudent(makeStudent("Orlov", 9));
+	CHECK(log.checkpoint());
+	log.close();
+
+	CHECK(surnames(dataFilename) == std::vector<std::string>({ "Ivanov", "Petrov", "Sidorov", "Kozlov", "Orlov" }));
+}
+
+TEST(readersFoldPendingLog)
+{
+	tests::TestDirectory directory("log_readers");
+	const std::string dataFilename = directory.file("students.txt");
+
+	writeLog(dataFilename,
+		[](StudentLog& log) { log.addStudent(makeStudent("Kozlov", 8)); },
+		[](StudentLog& log) { log.removeStudent(0); });
+
+	// Without the fold a reader sees the base file only
+	std::size_t records = 0;
+	for ([[maybe_unused]] const Student& student : StudentReader(dataFilename))
+		records++;
+	CHECK(records == 3);
+
+	std::vector<std::string> folded;
+	StudentReader reader(dataFilename, true);
+	if (!CHECK(reader.isOpen()))
+		return;
+	for (const Student& student : reader)
+		folded.push_back(student.surname);
+	CHECK(folded == std::vector<std::string>({ "Petrov", "Sidorov", "Kozlov" }));
+	CHECK(std::filesystem::file_size(logFilename(dataFilename)) == sizeof(LogFileHeader));
+
+	std::ifstream file, missing;
+	CHECK(openCheckpointed(dataFilename, file));
+	CHECK(!openCheckpointed(directory.file("missing.txt"), missing));
+}
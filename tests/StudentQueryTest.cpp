@@ -0,0 +1,116 @@
+#include <sstream>
+
+#include "Test.h"
+#include "../src/StudentGenerator.h"
+#include "../src/StudentParser.h"
+#include "../src/StudentQuery.h"
+
+using namespace database;
+
+/** @brief Queries over every field, combined with every operator. */
+static const char* const queries[] = {
+	"",
+	"min(math) >= 4 AND min(cs) >= 4",
+	"group = 4351 OR gpa > 6.5",
+	"surname = 'Ba*' AND NOT (count(physics) >= 5)",
+	"max(cs) < 9 OR physics >= 6.5",
+	"group <> 4300 AND (min(physics) > 3 OR max(math) = 10)",
+	"NOT (math <= 5 OR cs < 5) AND surname != Kobaov",
+	"count(math) = 0 OR count(cs) > 7 OR min(physics) == 10"
+};
+
+/**
+ * @brief Makes a text of generated records, some of them with empty score lists.
+ * @return The text.
+ */
+static std::string makeText()
+{
+	GeneratorOptions options;
+	options.minScoresPerSubject = 0;
+	options.surnameCount = 300;
+	const StudentGenerator generator(options);
+
+	std::ostringstream text;
+	Student student;
+	for (std::uint64_t i = 0; i < 5000; i++)
+	{
+		generator.generate(i, student);
+		writeStudent(text, student);
+	}
+	return text.str();
+}
+
+TEST(queryPushdownMatchesFullEvaluation)
+{
+	const std::string text = makeText();
+	const char* begin = text.data();
+	const char* end = begin + text.size();
+	const std::vector<Student> students = parseStudents(begin, end);
+
+	for (const char* queryText : queries)
+	{
+		StudentQuery query;
+		if (!CHECK(query.compile(queryText)))
+			continue;
+
+		std::vector<Student> expected;
+		for (const auto& student : students)
+		{
+			if (query.matches(makeStudentView(student)))
+				expected.push_back(student);
+		}
+
+		std::vector<Student> pushedDown;
+		StudentParser parser(begin, end);
+		Student student;
+		while (parser.next(student, query))
+			pushedDown.push_back(student);
+
+		CHECK(tests::sameStudents(pushedDown, expected));
+	}
+}
+
+TEST(queryPartialEvaluationAgreesWithMatch)
+{
+	const std::string text = makeText();
+	const std::vector<Student> students = parseStudents(text.data(), text.data() + text.size());
+
+	for (const char* queryText : queries)
+	{
+		StudentQuery query;
+		if (!CHECK(query.compile(queryText)))
+			continue;
+
+		// A decided outcome over any subset of the fields must be the final one
+		bool agrees = true;
+		for (std::size_t i = 0; i < students.size(); i += 25)
+		{
+			const StudentView view = makeStudentView(students[i]);
+			const QueryResult full = query.matches(view) ? QueryTrue : QueryFalse;
+			agrees = agrees && query.evaluate(view, QueryAllColumns) == full;
+
+			for (unsigned known = 0; known < QueryAllColumns; known++)
+			{
+				const QueryResult partial = query.evaluate(view, known);
+				agrees = agrees && (partial == QueryUnknown || partial == full);
+			}
+		}
+		CHECK(agrees);
+	}
+}
+
+TEST(queryRejectsInvalidText)
+{
+	const char* const invalid[] = { "gpa >", "group = 4351 AND", "(math > 3", "height > 3", "min(gpa) > 3", "surname < 'A",
+		"gpa > +", "gpa > +-5", "gpa > ++5", "gpa < 1e999" };
+	for (const char* queryText : invalid)
+	{
+		StudentQuery query;
+		CHECK(!query.compile(queryText));
+		CHECK(!query.error().empty());
+	}
+
+	// A single leading sign is still accepted
+	StudentQuery query;
+	CHECK(query.compile("gpa > +4.5 AND math >= -1"));
+}
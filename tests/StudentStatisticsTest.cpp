@@ -0,0 +1,122 @@
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+#include "Test.h"
+#include "../src/StudentGenerator.h"
+#include "../src/StudentStatistics.h"
+
+using namespace database;
+
+/**
+ * @brief Returns the exact quantile of sorted values, interpolating between ranks.
+ * @param sorted The values in ascending order.
+ * @param q The quantile.
+ * @return The quantile.
+ */
+static double exactQuantile(const std::vector<double>& sorted, double q)
+{
+	const double rank = q * static_cast<double>(sorted.size() - 1);
+	const std::size_t below = static_cast<std::size_t>(rank);
+	const std::size_t above = (std::min)(below + 1, sorted.size() - 1);
+	return sorted[below] + (sorted[above] - sorted[below]) * (rank - static_cast<double>(below));
+}
+
+TEST(tdigestQuantilesAndMerge)
+{
+	TDigest empty;
+	CHECK(std::isnan(empty.quantile(0.5)));
+
+	// With few values every centroid holds one value
+	TDigest small;
+	for (int value = 99; value >= 0; value--)
+		small.add(value);
+	CHECK(small.count() == 100);
+	CHECK(small.quantile(0) == 0 && small.quantile(1) == 99);
+	CHECK(std::abs(small.quantile(0.5) - 49.5) < 0.51);
+
+	// Digests of four parts merge into an estimate as good as one digest of everything
+	std::mt19937_64 random(42);
+	std::lognormal_distribution<double> distribution(0, 1);
+	std::vector<double> values(200000);
+	for (double& value : values)
+		value = distribution(random);
+
+	TDigest whole;
+	TDigest parts[4];
+	for (std::size_t i = 0; i < values.size(); i++)
+	{
+		whole.add(values[i]);
+		parts[i % 4].add(values[i]);
+	}
+	TDigest merged;
+	for (const TDigest& part : parts)
+		merged.merge(part);
+	CHECK(merged.count() == static_cast<double>(values.size()));
+
+	std::sort(values.begin(), values.end());
+	CHECK(merged.quantile(0) == values.front() && merged.quantile(1) == values.back());
+	for (double q : { 0.001, 0.01, 0.1, 0.5, 0.9, 0.99, 0.999 })
+	{
+		// Accuracy is measured in rank, which the scale function keeps tight near the tails
+		const double tolerance = 0.01 * std::sqrt(q * (1 - q)) + 1e-4;
+		for (const TDigest* digest : { &whole, &merged })
+		{
+			const double estimate = digest->quantile(q);
+			CHECK(estimate >= exactQuantile(values, (std::max)(0.0, q - tolerance))
+				&& estimate <= exactQuantile(values, (std::min)(1.0, q + tolerance)));
+		}
+	}
+}
+
+TEST(statisticsMergeMatchesSinglePass)
+{
+	tests::TestDirectory directory("statistics");
+	const std::string dataFilename = directory.file("students.txt");
+
+	GeneratorOptions options;
+	options.groupCount = 20;
+	if (!CHECK(generateStudentFile(dataFilename, options, 20000, false)))
+		return;
+	const std::vector<Student> students = readStudents(dataFilename);
+
+	StudentStatistics whole;
+	if (!CHECK(computeStatistics(dataFilename, whole)))
+		return;
+
+	StudentStatistics first, second;
+	for (std::size_t i = 0; i < students.size(); i++)
+		(i < students.size() / 3 ? first : second).add(makeStudentView(students[i]));
+	first.merge(second);
+
+	// Counts are exact and match a direct count; sums only differ by rounding
+	std::uint64_t failing[3]{};
+	for (const auto& student : students)
+	{
+		failing[0] += hasFailingScore(student.phisicsScores);
+		failing[1] += hasFailingScore(student.mathScores);
+		failing[2] += hasFailingScore(student.informScores);
+	}
+	for (const StudentStatistics* statistics : { &whole, &first })
+	{
+		CHECK(statistics->studentCount == students.size());
+		CHECK(statistics->gpa.count == students.size());
+		for (int subject = 0; subject < 3; subject++)
+			CHECK(statistics->failingCounts[subject] == failing[subject]);
+	}
+
+	CHECK(first.gpa.minimum == whole.gpa.minimum && first.gpa.maximum == whole.gpa.maximum);
+	CHECK(std::abs(first.gpa.mean() - whole.gpa.mean()) < 1e-9);
+	CHECK(std::abs(first.math.quantile(0.5) - whole.math.quantile(0.5)) < 0.05);
+	CHECK(first.gpaHistogram == whole.gpaHistogram);
+
+	CHECK(first.groups.size() == options.groupCount && whole.groups.size() == options.groupCount);
+	for (const auto& [groupNumber, group] : whole.groups)
+	{
+		const auto merged = first.groups.find(groupNumber);
+		if (!CHECK(merged != first.groups.end()))
+			continue;
+		CHECK(merged->second.studentCount == group.studentCount && merged->second.failingStudents == group.failingStudents);
+		CHECK(std::equal(std::begin(group.failingCounts), std::end(group.failingCounts), std::begin(merged->second.failingCounts)));
+	}
+}
@@ -0,0 +1,223 @@
+#include <cstring>
+#include <filesystem>
+
+#include "Test.h"
+#include "../src/BufferPool.h"
+#include "../src/BufferedWriter.h"
+#include "../src/SortEngine.h"
+#include "../src/StudentGenerator.h"
+#include "../src/StudentIndex.h"
+#include "../src/StudentTable.h"
+#include "../src/StudentTree.h"
+
+using namespace database;
+
+/**
+ * @brief Checks the ordered scans of every tree of a data file against the sort engine.
+ * @param trees One opened tree per sorting field.
+ * @param dataFilename Name of the data file.
+ * @return True if every scan matched, false otherwise.
+ */
+static bool scansMatchSortOrder(StudentTree (&trees)[SortByAverageInformGrade + 1], const std::string& dataFilename)
+{
+	StudentTable table;
+	std::vector<std::uint64_t> fileOffsets;
+	forEachRecord(dataFilename, [&](const StudentView& student, std::uint64_t recordOffset) {
+		table.append(student);
+		fileOffsets.push_back(recordOffset);
+		});
+
+	bool matched = true;
+	for (std::size_t method = 0; method <= SortByAverageInformGrade; method++)
+	{
+		matched = CHECK(trees[method].size() == table.size()) && matched;
+		for (SortingType type : { Ascending, Descending })
+		{
+			std::vector<std::uint64_t> expected;
+			for (std::size_t row : sortOrder(table, static_cast<SortingMethod>(method), type))
+				expected.push_back(fileOffsets[row]);
+
+			std::vector<std::uint64_t> scanned;
+			matched = CHECK(trees[method].scanAll(type, scanned)) && matched;
+			matched = CHECK(scanned == expected) && matched;
+		}
+	}
+	return matched;
+}
+
+TEST(treeInsertsMatchSortOrder)
+{
+	tests::TestDirectory directory("tree_inserts");
+	const std::string dataFilename = directory.file("students.txt");
+	const std::string extraFilename = directory.file("extra.txt");
+
+	// Few surnames and repeated records make runs of equal keys that span several leaves
+	GeneratorOptions options;
+	options.surnameCount = 200;
+	options.duplicateRate = 0.1;
+	if (!CHECK(generateStudentFile(dataFilename, options, 50, false)))
+		return;
+	options.seed = 5;
+	if (!CHECK(generateStudentFile(extraFilename, options, 12000, false)))
+		return;
+
+	StudentTree trees[SortByAverageInformGrade + 1];
+	for (std::size_t method = 0; method <= SortByAverageInformGrade; method++)
+	{
+		if (!CHECK(trees[method].open(dataFilename, static_cast<SortingMethod>(method))))
+			return;
+	}
+
+	// Records inserted one at a time split leaves and inner nodes far beyond the pool's frames
+	const std::vector<Student> extra = readStudents(extraFilename);
+	std::vector<std::uint64_t> recordOffsets;
+	{
+		const std::uint64_t baseSize = std::filesystem::file_size(dataFilename);
+		BufferedWriter file;
+		if (!CHECK(file.open(dataFilename, true)))
+			return;
+		for (const auto& student : extra)
+		{
+			recordOffsets.push_back(baseSize + file.position());
+			writeStudent(file, makeStudentView(student));
+		}
+		CHECK(file.close());
+	}
+
+	for (std::size_t method = 0; method <= SortByAverageInformGrade; method++)
+	{
+		for (std::size_t i = 0; i < extra.size(); i++)
+		{
+			if (!CHECK(trees[method].insert(makeStudentView(extra[i]), recordOffsets[i])))
+				return;
+		}
+	}
+	CHECK(scansMatchSortOrder(trees, dataFilename));
+
+	// The trees written through the pool read back the same after reopening
+	for (std::size_t method = 0; method <= SortByAverageInformGrade; method++)
+	{
+		CHECK(trees[method].close());
+		CHECK(trees[method].open(dataFilename, static_cast<SortingMethod>(method)));
+	}
+	CHECK(scansMatchSortOrder(trees, dataFilename));
+}
+
+TEST(treeRebuildsWhenStale)
+{
+	tests::TestDirectory directory("tree_stale");
+	const std::string dataFilename = directory.file("students.txt");
+
+	if (!CHECK(generateStudentFile(dataFilename, GeneratorOptions(), 3000, false)))
+		return;
+
+	StudentTree trees[SortByAverageInformGrade + 1];
+	for (std::size_t method = 0; method <= SortByAverageInformGrade; method++)
+	{
+		CHECK(trees[method].open(dataFilename, static_cast<SortingMethod>(method)));
+		CHECK(trees[method].close());
+	}
+
+	// A record appended behind the trees' back changes the data file's stamp
+	Student student;
+	student.surname = "Appended";
+	student.groupNumber = 4351;
+	student.phisicsScores = { 5 };
+	student.mathScores = { 5 };
+	student.informScores = { 5 };
+	calculateAverageGrade(student);
+	{
+		BufferedWriter file;
+		CHECK(file.open(dataFilename, true));
+		writeStudent(file, makeStudentView(student));
+	}
+
+	// A damaged header is not trusted either
+	{
+		std::fstream tree(treeFilename(dataFilename, SortByAverageGrade), std::ios::binary | std::ios::in | std::ios::out);
+		tree.write("XXXX", 4);
+	}
+
+	for (std::size_t method = 0; method <= SortByAverageInformGrade; method++)
+		CHECK(trees[method].open(dataFilename, static_cast<SortingMethod>(method)));
+	CHECK(trees[0].size() == 3001);
+	CHECK(scansMatchSortOrder(trees, dataFilename));
+}
+
+TEST(treeSurnameRangeUsesPrefix)
+{
+	tests::TestDirectory directory("tree_range");
+	const std::string dataFilename = directory.file("students.txt");
+
+	const char* const surnames[] = { "Abramov", "Kozlov", "M", "Mironov", "Morozov", "Nikitin", "Zaitsev" };
+	std::vector<Student> students;
+	for (const char* surname : surnames)
+	{
+		Student student;
+		student.surname = surname;
+		students.push_back(student);
+	}
+	tests::writeTextFile(dataFilename, students);
+
+	std::vector<std::uint64_t> fileOffsets;
+	forEachRecord(dataFilename, [&](const StudentView&, std::uint64_t recordOffset) { fileOffsets.push_back(recordOffset); });
+
+	StudentTree tree;
+	if (!CHECK(tree.open(dataFilename, SortBySurname)))
+		return;
+
+	// The upper bound takes in every surname that starts with it
+	std::vector<std::uint64_t> recordOffsets;
+	CHECK(tree.scanRange("K", "M", recordOffsets));
+	CHECK(recordOffsets == std::vector<std::uint64_t>({ fileOffsets[1], fileOffsets[2], fileOffsets[3], fileOffsets[4] }));
+
+	CHECK(tree.scanRange("Mi", "Mi", recordOffsets));
+	CHECK(recordOffsets == std::vector<std::uint64_t>({ fileOffsets[3] }));
+
+	CHECK(tree.scanRange("N", "", recordOffsets));
+	CHECK(recordOffsets == std::vector<std::uint64_t>({ fileOffsets[5], fileOffsets[6] }));
+
+	CHECK(!tree.scanRange(0.0, 5.0, recordOffsets));
+}
+
+TEST(bufferPoolEvictsAndGrows)
+{
+	tests::TestDirectory directory("buffer_pool");
+	const std::string filename = directory.file("pages.bin");
+
+	// Two frames for eight pages: every new page evicts a dirty one, which must be written back
+	BufferPool pool(2);
+	if (!CHECK(pool.open(filename, true)))
+		return;
+	for (std::uint32_t i = 0; i < 8; i++)
+	{
+		PinnedPage page = PinnedPage::allocate(pool);
+		if (!CHECK(page && page.id() == i))
+			return;
+		std::memset(page.as<char>(), 'a' + static_cast<int>(i), BufferPool::pageSize);
+	}
+	CHECK(pool.pageCount() == 8);
+
+	for (std::uint32_t i = 0; i < 8; i++)
+	{
+		PinnedPage page(pool, i);
+		CHECK(page && page.read<char>()[0] == 'a' + static_cast<int>(i) && page.read<char>()[BufferPool::pageSize - 1] == 'a' + static_cast<int>(i));
+	}
+
+	// With every frame pinned the pool grows instead of failing
+	{
+		PinnedPage first(pool, 0);
+		PinnedPage second(pool, 1);
+		PinnedPage third(pool, 2);
+		CHECK(first && second && third && third.read<char>()[0] == 'c');
+		third.as<char>()[0] = 'z';
+	}
+
+	CHECK(pool.close());
+	CHECK(std::filesystem::file_size(filename) == 8 * BufferPool::pageSize);
+
+	BufferPool reopened(2);
+	CHECK(reopened.open(filename, false) && reopened.pageCount() == 8);
+	PinnedPage page(reopened, 2);
+	CHECK(page && page.read<char>()[0] == 'z' && page.read<char>()[1] == 'c');
+}
@@ -0,0 +1,155 @@
+#ifndef STUDENTDB_TEST_H
+#define STUDENTDB_TEST_H
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "../src/Student.h"
+
+namespace tests
+{
+
+	/** @brief A named test function. */
+	struct TestCase
+	{
+		const char* name;
+		void (*run)();
+	};
+
+	/** @brief Returns every test registered with TEST. */
+	inline std::vector<TestCase>& testCases()
+	{
+		static std::vector<TestCase> cases;
+		return cases;
+	}
+
+	/** @brief Returns the number of checks that failed so far. */
+	inline int& failedChecks()
+	{
+		static int count = 0;
+		return count;
+	}
+
+	/** @brief Adds a test to the registry when the program starts. */
+	struct TestRegistration
+	{
+		TestRegistration(const char* name, void (*run)()) { testCases().push_back({ name, run }); }
+	};
+
+	/**
+	 * @brief Records the outcome of a check, printing the failed ones.
+	 * @param passed Whether the check passed.
+	 * @param expression Text of the checked expression.
+	 * @param file Source file of the check.
+	 * @param line Source line of the check.
+	 * @return The outcome, so a test can stop after a failed precondition.
+	 */
+	inline bool check(bool passed, const char* expression, const char* file, int line)
+	{
+		if (!passed)
+		{
+			std::fprintf(stderr, "%s:%d: check failed: %s\n", file, line, expression);
+			failedChecks()++;
+		}
+		return passed;
+	}
+
+	/**
+	 * @brief Directory of scratch files that is removed with everything in it.
+	 *
+	 * It is created in the working directory, which ctest sets to the build tree.
+	 */
+	class TestDirectory
+	{
+	public:
+		explicit TestDirectory(const std::string& name) : directory(std::filesystem::absolute("test_" + name))
+		{
+			std::filesystem::remove_all(directory);
+			std::filesystem::create_directories(directory);
+		}
+
+		~TestDirectory()
+		{
+			std::error_code error;
+			std::filesystem::remove_all(directory, error);
+		}
+
+		TestDirectory(const TestDirectory&) = delete;
+		TestDirectory& operator=(const TestDirectory&) = delete;
+
+		/** @brief Returns the path of a file inside the directory. */
+		std::string file(const std::string& name) const { return (directory / name).string(); }
+
+	private:
+		std::filesystem::path directory;
+	};
+
+	/**
+	 * @brief Reads a whole file into a string.
+	 * @param filename Name of the file.
+	 * @return The bytes of the file, or an empty string if it cannot be read.
+	 */
+	inline std::string readFile(const std::string& filename)
+	{
+		std::ifstream file(filename, std::ios::binary);
+		std::ostringstream content;
+		content << file.rdbuf();
+		return content.str();
+	}
+
+	/**
+	 * @brief Writes students to a file in the text format.
+	 * @param filename Name of the file.
+	 * @param students The students to write.
+	 */
+	inline void writeTextFile(const std::string& filename, const std::vector<database::Student>& students)
+	{
+		std::ofstream file(filename, std::ios::binary);
+		for (const auto& student : students)
+			database::writeStudent(file, student);
+	}
+
+	/** @brief Checks whether two students hold the same values in every field. */
+	inline bool sameStudent(const database::Student& left, const database::Student& right)
+	{
+		return left.surname == right.surname
+			&& left.groupNumber == right.groupNumber
+			&& left.phisicsScores == right.phisicsScores
+			&& left.mathScores == right.mathScores
+			&& left.informScores == right.informScores
+			&& left.averagePhisicsGrade == right.averagePhisicsGrade
+			&& left.averageMathGrade == right.averageMathGrade
+			&& left.averageInformGrade == right.averageInformGrade
+			&& left.averageGrade == right.averageGrade;
+	}
+
+	/** @brief Checks whether two lists hold the same students in the same order. */
+	inline bool sameStudents(const std::vector<database::Student>& left, const std::vector<database::Student>& right)
+	{
+		if (left.size() != right.size())
+			return false;
+
+		for (std::size_t i = 0; i < left.size(); i++)
+		{
+			if (!sameStudent(left[i], right[i]))
+				return false;
+		}
+		return true;
+	}
+
+} // tests
+
+/** @brief Defines a test function and registers it under its name. */
+#define TEST(name) \
+	static void name(); \
+	static const tests::TestRegistration name##Registration(#name, name); \
+	static void name()
+
+/** @brief Checks a condition and evaluates to its outcome. */
+#define CHECK(condition) tests::check(static_cast<bool>(condition), #condition, __FILE__, __LINE__)
+
+#endif // STUDENTDB_TEST_H
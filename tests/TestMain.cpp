@@ -0,0 +1,30 @@
+#include <cstdio>
+#include <cstring>
+
+#include "Test.h"
+
+/**
+ * @brief Runs the test named on the command line, or every test without arguments.
+ * @return Zero if every check passed, one otherwise.
+ */
+int main(int argc, char* argv[])
+{
+	int run = 0;
+	for (const auto& test : tests::testCases())
+	{
+		if (argc > 1 && std::strcmp(argv[1], test.name) != 0)
+			continue;
+
+		const int failedBefore = tests::failedChecks();
+		test.run();
+		std::printf("%s %s\n", tests::failedChecks() == failedBefore ? "PASS" : "FAIL", test.name);
+		run++;
+	}
+
+	if (run == 0)
+	{
+		std::fprintf(stderr, "No test named %s\n", argc > 1 ? argv[1] : "");
+		return 1;
+	}
+	return tests::failedChecks() == 0 ? 0 : 1;
+}
@@ -0,0 +1,123 @@
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+#include "Test.h"
+#include "../src/ThreadPool.h"
+
+using namespace database;
+
+/**
+ * @brief Waits until a condition holds or a few seconds have passed, without running pool tasks.
+ * @param condition The condition to wait for.
+ * @return True if the condition holds.
+ */
+template <typename Condition>
+static bool waitUntil(Condition condition)
+{
+	const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+	while (!condition())
+	{
+		if (std::chrono::steady_clock::now() > deadline)
+			return false;
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+	return true;
+}
+
+TEST(threadPoolCancelsTasks)
+{
+	ThreadPool pool(1);
+
+	// The only worker is held busy while the other tasks are queued behind it
+	std::atomic<bool> release = false;
+	auto blocker = pool.submit([&release]() {
+		while (!release)
+			std::this_thread::yield();
+		return 1;
+		});
+
+	std::atomic<bool> skippedRan = false;
+	auto skipped = pool.submit([&skippedRan]() { skippedRan = true; return 7; });
+	skipped.cancel();
+
+	std::atomic<bool> started = false;
+	auto running = pool.submit([&started](const CancellationToken& token) {
+		started = true;
+		int checks = 1;
+		while (!token.cancelled())
+			checks++;
+		return checks;
+		});
+
+	// Waiting with get() would run the queued tasks on this thread, so the futures are polled
+	release = true;
+	CHECK(waitUntil([&blocker]() { return blocker.ready(); }));
+	CHECK(blocker.get() == 1);
+
+	// A task cancelled before it starts is skipped and yields a default result
+	CHECK(waitUntil([&skipped]() { return skipped.ready(); }));
+	CHECK(skipped.get() == 0);
+	CHECK(!skippedRan);
+
+	// A running task stops where it checks its token
+	CHECK(waitUntil([&started]() { return started.load(); }));
+	running.cancel();
+	CHECK(waitUntil([&running]() { return running.ready(); }));
+	CHECK(running.get() > 0);
+}
+
+TEST(threadPoolStealsFromBusyWorker)
+{
+	ThreadPool pool(2);
+
+	// Nested tasks go to the deque of the worker that submits them; while it spins,
+	// only the other worker can run them by stealing
+	static constexpr int taskCount = 8;
+	std::mutex mutex;
+	std::vector<std::thread::id> runners;
+	std::atomic<int> done = 0;
+	std::thread::id owner;
+
+	auto outer = pool.submit([&]() {
+		owner = std::this_thread::get_id();
+
+		std::vector<TaskFuture<void>> tasks;
+		for (int i = 0; i < taskCount; i++)
+		{
+			tasks.push_back(pool.submit([&]() {
+				{
+					std::lock_guard<std::mutex> lock(mutex);
+					runners.push_back(std::this_thread::get_id());
+				}
+				done++;
+				}));
+		}
+		return waitUntil([&done]() { return done.load() == taskCount; });
+		});
+
+	CHECK(waitUntil([&outer]() { return outer.ready(); }));
+	CHECK(outer.get());
+	CHECK(runners.size() == taskCount);
+	for (const auto& runner : runners)
+		CHECK(runner != owner);
+}
+
+TEST(threadPoolNestedWaitRunsQueuedTasks)
+{
+	// With a single worker, a task waiting for its own subtasks must run them itself
+	ThreadPool pool(1);
+
+	auto outer = pool.submit([&pool]() {
+		auto inner = pool.submit([]() { return 21; });
+		const int doubled = inner.get() * 2;
+
+		std::atomic<int> sum = 0;
+		pool.parallelFor(100, [&sum](std::size_t i) { sum += static_cast<int>(i); });
+		return doubled + sum;
+		});
+
+	CHECK(waitUntil([&outer]() { return outer.ready(); }));
+	CHECK(outer.get() == 42 + 4950);
+}